@@ -103,7 +103,9 @@ const struct {
 /// <summary>
 /// Initializes a new instance of the CWIdTX class.
 /// </summary>
-CWIdTX::CWIdTX() :
+/// <param name="modem">Modem channel the instance belongs to.</param>
+CWIdTX::CWIdTX(sdr::Modem* modem) :
+    ModemContext(modem),
     m_poBuffer(),
     m_poLen(0U),
     m_poPtr(0U),
@@ -32,16 +32,17 @@
 #define __CWID_TX_H__
 
 #include "Defines.h"
+#include "ModemContext.h"
 
 // ---------------------------------------------------------------------------
 //  Class Declaration
 //      Implements logic to transmit a CW ID.
 // ---------------------------------------------------------------------------
 
-class DSP_FW_API CWIdTX {
+class DSP_FW_API CWIdTX : public ModemContext {
 public:
     /// <summary>Initializes a new instance of the CWIdTX class.</summary>
-    CWIdTX();
+    CWIdTX(sdr::Modem* modem = NULL);
 
     /// <summary>Process local buffer and transmit on the air interface.</summary>
     void process();
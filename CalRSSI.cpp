@@ -38,7 +38,9 @@
 /// <summary>
 /// Initializes a new instance of the CalRSSI class.
 /// </summary>
-CalRSSI::CalRSSI() :
+/// <param name="modem">Modem channel the instance belongs to.</param>
+CalRSSI::CalRSSI(sdr::Modem* modem) :
+    ModemContext(modem),
     m_count(0U),
     m_accum(0U),
     m_min(0xFFFFU),
@@ -52,7 +54,7 @@ CalRSSI::CalRSSI() :
 /// </summary>
 /// <param name="rssi"></param>
 /// <param name="length"></param>
-void CalRSSI::samples(const uint16_t* rssi, uint8_t length)
+void CalRSSI::samples(const uint16_t* rssi, uint16_t length)
 {
     for (uint16_t i = 0U; i < length; i++) {
         uint16_t ss = rssi[i];
@@ -31,19 +31,20 @@
 #define __CAL_RSSI_H__
 
 #include "Defines.h"
+#include "ModemContext.h"
 
 // ---------------------------------------------------------------------------
 //  Class Declaration
 //      Implements logic for RSSI calibration mode.
 // ---------------------------------------------------------------------------
 
-class DSP_FW_API CalRSSI {
+class DSP_FW_API CalRSSI : public ModemContext {
 public:
     /// <summary>Initializes a new instance of the CalRSSI class.</summary>
-    CalRSSI();
+    CalRSSI(sdr::Modem* modem = NULL);
 
     /// <summary>Sample RSSI values from the air interface.</summary>
-    void samples(const uint16_t* rssi, uint8_t length);
+    void samples(const uint16_t* rssi, uint16_t length);
 
 private:
     uint32_t m_count;
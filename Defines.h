@@ -145,6 +145,9 @@ typedef unsigned long long  ulong64_t;
 // Pass RSSI information to the host
 // #define SEND_RSSI_DATA
 
+// Per-stage DSP timing counters, read by the host with CMD_GET_STATS
+// #define DSP_STATS
+
 #define DESCR_DMR        "DMR, "
 #define DESCR_P25        "P25, "
 #define DESCR_NXDN       "NXDN, "
@@ -161,7 +164,13 @@ typedef unsigned long long  ulong64_t;
 #define DESCR_RSSI        ""
 #endif
 
-#define DESCRIPTION        __PROG_NAME__ " (" DESCR_DMR DESCR_P25 DESCR_NXDN DESCR_OSC DESCR_RSSI "CW Id)"
+#if defined(DSP_STATS)
+#define DESCR_STATS       "Stats, "
+#else
+#define DESCR_STATS       ""
+#endif
+
+#define DESCRIPTION        __PROG_NAME__ " (" DESCR_DMR DESCR_P25 DESCR_NXDN DESCR_OSC DESCR_RSSI DESCR_STATS "CW Id)"
 
 const uint8_t BIT_MASK_TABLE[] = { 0x80U, 0x40U, 0x20U, 0x10U, 0x08U, 0x04U, 0x02U, 0x01U };
 
@@ -170,6 +179,56 @@ const uint8_t BIT_MASK_TABLE[] = { 0x80U, 0x40U, 0x20U, 0x10U, 0x08U, 0x04U, 0x0
 #define CPU_TYPE_STM32 0x02U
 #define CPU_TYPE_NATIVE_SDR 0xF0U
 
+enum DVM_STATE {
+    STATE_IDLE = 0U,
+    // DMR
+    STATE_DMR = 1U,
+    // Project 25
+    STATE_P25 = 2U,
+    // NXDN
+    STATE_NXDN = 3U,
+
+    // CW
+    STATE_CW = 10U,
+
+    // Calibration States
+    STATE_P25_CAL_1K = 92U,
+
+    STATE_DMR_DMO_CAL_1K = 93U,
+    STATE_DMR_CAL_1K = 94U,
+    STATE_DMR_LF_CAL = 95U,
+
+    STATE_RSSI_CAL = 96U,
+
+    STATE_P25_CAL = 97U,
+    STATE_DMR_CAL = 98U,
+    STATE_NXDN_CAL = 99U
+};
+
+// Rx samples filtered per pass, and the largest block the Rx filter states in IO.h are sized for
+const uint16_t RX_BLOCK_SIZE = 2U;
+#if defined(NATIVE_SDR)
+const uint16_t RX_BLOCK_SIZE_MAX = 480U;
+#else
+const uint16_t RX_BLOCK_SIZE_MAX = RX_BLOCK_SIZE;
+#endif
+
+// Bytes of 4 symbols the Tx modulators generate per call; the native build fills the
+// free space of the Tx ring buffer in one pass
+#if defined(NATIVE_SDR)
+const uint16_t TX_BYTE_BLOCK_MAX = 24U;
+#else
+const uint16_t TX_BYTE_BLOCK_MAX = 1U;
+#endif
+
+// Padding used to keep data written by different threads on separate cache lines
+#if defined(NATIVE_SDR)
+#define CACHE_LINE_SIZE 64U
+#define CACHE_LINE_PAD(name) uint8_t name[CACHE_LINE_SIZE]
+#else
+#define CACHE_LINE_PAD(name)
+#endif
+
 // ---------------------------------------------------------------------------
 //  Macros
 // ---------------------------------------------------------------------------
@@ -0,0 +1,310 @@
+/**
+* Digital Voice Modem - DSP Firmware
+* GPLv2 Open Source. Use is subject to license terms.
+* DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+*
+* @package DVM / DSP Firmware
+*
+*/
+/*
+*   Copyright (C) 2022 Bryan Biedenkapp N2PLL
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 2 of the License, or
+*   (at your option) any later version.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program; if not, write to the Free Software
+*   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*/
+#if !defined(__FIR_Q15_H__)
+#define __FIR_Q15_H__
+
+#include "Defines.h"
+
+#if defined(NATIVE_SDR)
+#include <cassert>
+#endif
+
+// ---------------------------------------------------------------------------
+//  Class Declaration
+//      Implements a Q15 FIR filter with a tap count and maximum block size
+//      fixed at compile time, owning its state.
+// ---------------------------------------------------------------------------
+
+template <uint16_t Taps, uint16_t Block>
+class FirQ15 {
+public:
+    /// <summary>Initializes a new instance of the FirQ15 class.</summary>
+    /// <param name="coeffs">Filter coefficients, the table length must match the tap count.</param>
+    FirQ15(q15_t (&coeffs)[Taps]) :
+        m_filter(),
+        m_state()
+    {
+        ::arm_fir_init_q15(&m_filter, Taps, coeffs, m_state, Block);
+    }
+
+    /// <summary>Filters a block of samples, longer blocks are filtered in pieces of the maximum block size.</summary>
+    /// <param name="in">Block of input data.</param>
+    /// <param name="out">Block of output data.</param>
+    /// <param name="length">Number of samples.</param>
+    void process(q15_t* in, q15_t* out, uint32_t length)
+    {
+        while (length > 0U) {
+            uint32_t n = (length < Block) ? length : Block;
+#if defined(NATIVE_SDR)
+            // without a SIMD kernel the unrolled fixed length loop is the fastest path
+            if (::arm_fir_get_kernel() == ARM_FIR_KERNEL_GENERIC)
+                processFixed(in, out, n);
+            else
+                ::arm_fir_fast_q15(&m_filter, in, out, n);
+#else
+            ::arm_fir_fast_q15(&m_filter, in, out, n);
+#endif
+            in += n;
+            out += n;
+            length -= n;
+        }
+    }
+
+private:
+    arm_fir_instance_q15 m_filter;
+#if defined(NATIVE_SDR)
+    q15_t m_state[Taps + Block - 1U];
+#else
+    // CMSIS clears numTaps + blockSize state words and its fast kernel reads one past the history
+    q15_t m_state[Taps + Block];
+#endif
+
+#if defined(NATIVE_SDR)
+    /// <summary>Fixed length filter loop, bit exact with arm_fir_fast_q15.</summary>
+    /// <param name="in">Block of input data.</param>
+    /// <param name="out">Block of output data.</param>
+    /// <param name="length">Number of samples, no more than the maximum block size.</param>
+    void processFixed(const q15_t* in, q15_t* out, uint32_t length)
+    {
+        const q15_t* c = m_filter.pCoeffs;
+        ::memcpy(m_state + (Taps - 1U), in, length * sizeof(q15_t));
+
+        // the accumulators wrap modulo 2^32 as the SMLAD emulation does
+        uint32_t i = 0U;
+        for (; (i + 4U) <= length; i += 4U) {
+            const q15_t* x = m_state + i;
+            uint32_t acc0 = 0U, acc1 = 0U, acc2 = 0U, acc3 = 0U;
+            for (uint32_t k = 0U; k < Taps; k++) {
+                uint32_t ck = uint32_t(int32_t(c[k]));
+                acc0 += ck * uint32_t(int32_t(x[k + 0U]));
+                acc1 += ck * uint32_t(int32_t(x[k + 1U]));
+                acc2 += ck * uint32_t(int32_t(x[k + 2U]));
+                acc3 += ck * uint32_t(int32_t(x[k + 3U]));
+            }
+
+            out[i + 0U] = q15_t(__SSAT((q31_t(acc0) >> 15), 16));
+            out[i + 1U] = q15_t(__SSAT((q31_t(acc1) >> 15), 16));
+            out[i + 2U] = q15_t(__SSAT((q31_t(acc2) >> 15), 16));
+            out[i + 3U] = q15_t(__SSAT((q31_t(acc3) >> 15), 16));
+        }
+
+        for (; i < length; i++) {
+            const q15_t* x = m_state + i;
+            uint32_t acc = 0U;
+            for (uint32_t k = 0U; k < Taps; k++)
+                acc += uint32_t(int32_t(c[k])) * uint32_t(int32_t(x[k]));
+
+            out[i] = q15_t(__SSAT((q31_t(acc) >> 15), 16));
+        }
+
+        ::memmove(m_state, m_state + length, (Taps - 1U) * sizeof(q15_t));
+    }
+#endif
+};
+
+// ---------------------------------------------------------------------------
+//  Class Declaration
+//      Implements a Q15 polyphase FIR interpolator with an interpolation
+//      factor, phase length and maximum block size fixed at compile time,
+//      owning its state.
+// ---------------------------------------------------------------------------
+
+template <uint8_t L, uint16_t PhaseLength, uint16_t Block>
+class FirInterpolateQ15 {
+public:
+    /// <summary>Initializes a new instance of the FirInterpolateQ15 class.</summary>
+    /// <param name="coeffs">Filter coefficients, the table length must be the interpolation factor times the phase length.</param>
+    FirInterpolateQ15(q15_t (&coeffs)[L * PhaseLength]) :
+        m_filter(),
+        m_state()
+    {
+        ::arm_fir_interpolate_init_q15(&m_filter, L, L * PhaseLength, coeffs, m_state, Block);
+#if defined(NATIVE_SDR)
+        // split the phases out in the order the outputs are written
+        for (uint32_t j = 0U; j < L; j++) {
+            for (uint32_t k = 0U; k < PhaseLength; k++)
+                m_phases[j][k] = coeffs[(L - 1U - j) + (k * L)];
+        }
+#endif
+    }
+
+    /// <summary>Interpolates a block of samples, longer blocks are interpolated in pieces of the maximum block size.</summary>
+    /// <param name="in">Block of input data.</param>
+    /// <param name="out">Block of output data, the interpolation factor times the input length.</param>
+    /// <param name="length">Number of input samples.</param>
+    void process(q15_t* in, q15_t* out, uint32_t length)
+    {
+        while (length > 0U) {
+            uint32_t n = (length < Block) ? length : Block;
+#if defined(NATIVE_SDR)
+            // without a SIMD kernel the unrolled fixed length loop is the fastest path
+            if (::arm_fir_get_kernel() == ARM_FIR_KERNEL_GENERIC)
+                processFixed(in, out, n);
+            else
+                ::arm_fir_interpolate_q15(&m_filter, in, out, n);
+#else
+            ::arm_fir_interpolate_q15(&m_filter, in, out, n);
+#endif
+            in += n;
+            out += n * L;
+            length -= n;
+        }
+    }
+
+private:
+    arm_fir_interpolate_instance_q15 m_filter;
+    q15_t m_state[PhaseLength + Block - 1U];
+
+#if defined(NATIVE_SDR)
+    q15_t m_phases[L][PhaseLength];
+
+    /// <summary>Fixed length interpolator loop, bit exact with arm_fir_interpolate_q15.</summary>
+    /// <param name="in">Block of input data.</param>
+    /// <param name="out">Block of output data.</param>
+    /// <param name="length">Number of input samples, no more than the maximum block size.</param>
+    void processFixed(const q15_t* in, q15_t* out, uint32_t length)
+    {
+        ::memcpy(m_state + (PhaseLength - 1U), in, length * sizeof(q15_t));
+
+        for (uint32_t i = 0U; i < length; i++) {
+            const q15_t* x = m_state + i;
+            for (uint32_t j = 0U; j < L; j++) {
+                q63_t sum = 0;
+                for (uint32_t k = 0U; k < PhaseLength; k++)
+                    sum += q31_t(x[k]) * m_phases[j][k];
+
+                *out++ = q15_t(__SSAT((sum >> 15), 16));
+            }
+        }
+
+        ::memmove(m_state, m_state + length, (PhaseLength - 1U) * sizeof(q15_t));
+    }
+#endif
+};
+
+// ---------------------------------------------------------------------------
+//  Class Declaration
+//      Implements a Q15 boxcar FIR filter as a running sum, one add and one
+//      subtract per sample, bit exact with the same filter run through
+//      arm_fir_fast_q15. The native build only runs the sum without a SIMD
+//      kernel, which is as fast or faster than the sum at these tap counts.
+// ---------------------------------------------------------------------------
+
+template <uint16_t Taps, uint16_t Block>
+class BoxcarQ15 {
+public:
+    /// <summary>Initializes a new instance of the BoxcarQ15 class.</summary>
+    /// <param name="coeffs">Filter coefficients, a run of equal taps followed by zero taps.</param>
+    BoxcarQ15(q15_t (&coeffs)[Taps]) :
+#if defined(NATIVE_SDR)
+        m_fir(coeffs),
+#endif
+        m_gain(coeffs[0U]),
+        m_delay(0U),
+        m_sum(0),
+        m_state()
+    {
+        // the coefficients are applied time reversed, so trailing zero taps delay the window
+        uint16_t span = 1U;
+        while (span < Taps && coeffs[span] == m_gain)
+            span++;
+        m_delay = Taps - span;
+
+#if defined(NATIVE_SDR)
+        // any other shape is not a boxcar, and the running sum would silently filter it wrong
+        for (uint16_t k = span; k < Taps; k++)
+            assert(coeffs[k] == 0);
+#endif
+    }
+
+    /// <summary>Filters a block of samples.</summary>
+    /// <param name="in">Block of input data.</param>
+    /// <param name="out">Block of output data.</param>
+    /// <param name="length">Number of samples.</param>
+    void process(q15_t* in, q15_t* out, uint32_t length)
+    {
+#if defined(NATIVE_SDR)
+        // the kernel is selected once at startup, so the two paths never hand over history
+        if (::arm_fir_get_kernel() != ARM_FIR_KERNEL_GENERIC) {
+            m_fir.process(in, out, length);
+            return;
+        }
+#endif
+        processSum(in, out, length);
+    }
+
+    /// <summary>Filters a block of samples with the running sum, whichever kernel is selected.</summary>
+    /// <param name="in">Block of input data.</param>
+    /// <param name="out">Block of output data.</param>
+    /// <param name="length">Number of samples.</param>
+    void processSum(const q15_t* in, q15_t* out, uint32_t length)
+    {
+        uint32_t gain = uint32_t(int32_t(m_gain));
+        int32_t sum = m_sum;
+
+        // the window slides over the last Taps samples of history, then over the block itself
+        uint32_t i = 0U;
+        for (; i < length && i < Taps; i++) {
+            sum -= m_state[i];
+            sum += (i >= m_delay) ? in[i - m_delay] : m_state[Taps - m_delay + i];
+            out[i] = q15_t(__SSAT((q31_t(gain * uint32_t(sum)) >> 15), 16));
+        }
+
+        const q15_t* enter = in - m_delay;
+        const q15_t* leave = in - Taps;
+        for (; i < length; i++) {
+            sum += int32_t(enter[i]) - int32_t(leave[i]);
+
+            // the product wraps modulo 2^32 as the FIR accumulator does
+            out[i] = q15_t(__SSAT((q31_t(gain * uint32_t(sum)) >> 15), 16));
+        }
+
+        // keep the last Taps samples as the history for the next block
+        if (length >= Taps) {
+            for (uint32_t k = 0U; k < Taps; k++)
+                m_state[k] = in[length - Taps + k];
+        }
+        else {
+            for (uint32_t k = 0U; k < (Taps - length); k++)
+                m_state[k] = m_state[k + length];
+            for (uint32_t k = 0U; k < length; k++)
+                m_state[Taps - length + k] = in[k];
+        }
+
+        m_sum = sum;
+    }
+
+private:
+#if defined(NATIVE_SDR)
+    FirQ15<Taps, Block> m_fir;
+#endif
+    q15_t m_gain;
+    uint16_t m_delay;
+    int32_t m_sum;
+    q15_t m_state[Taps];
+};
+
+#endif // __FIR_Q15_H__
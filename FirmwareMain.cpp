@@ -31,9 +31,14 @@
 *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
 */
 #include "Globals.h"
+#include "Firmware.h"
 
 #if defined(NATIVE_SDR)
 #include "sdr/port/PseudoPTYPort.h"
+#include "sdr/Benchmark.h"
+#include "sdr/ChannelPool.h"
+#include "sdr/Decoder.h"
+#include "sdr/Modem.h"
 
 #include <sys/types.h>
 #include <unistd.h>
@@ -45,7 +50,7 @@
 #include <cstdlib>
 #include <cstring>
 
-#include <zmq.hpp>
+#include <vector>
 #endif
 
 // ---------------------------------------------------------------------------
@@ -54,12 +59,15 @@
 
 #if defined(NATIVE_SDR)
 #define IS(s) (::strcmp(argv[i], s) == 0)
+
+#define EVENT_LOOP_TICK_US 10000U   // watchdog and LED housekeeping tick
 #endif
 
 // ---------------------------------------------------------------------------
 //  Globals Variables
 // ---------------------------------------------------------------------------
 
+#if !defined(NATIVE_SDR)
 DVM_STATE m_modemState = STATE_IDLE;
 
 bool m_dmrEnable = true;
@@ -100,10 +108,19 @@ CalRSSI calRSSI;
 /** CW */
 CWIdTX cwIdTX;
 
+#if defined(DSP_STATS)
+/** Stage timing counters */
+StageStats stats;
+#endif
+
 /** RS232 and Air Interface I/O */
 SerialPort serial;
 IO io;
 
+/** Firmware setup and main loop */
+Firmware firmware;
+#endif // !defined(NATIVE_SDR)
+
 #if defined(DIGIPOT_ENABLED)
 /** Digipot */
 Digipot digipot;
@@ -112,10 +129,22 @@ Digipot digipot;
 #if defined(NATIVE_SDR)
 std::string g_progExe = std::string(__EXE_NAME__);
 
-std::string m_zmqRx = std::string("ipc:///tmp/dvm-rx.ipc");
-std::string m_zmqTx = std::string("ipc:///tmp/dvm-tx.ipc");
+/** Modem channels; the per-channel options apply to the last one given */
+std::vector<sdr::ChannelConfig> g_channels = std::vector<sdr::ChannelConfig>(1U);
+uint32_t g_workers = 0U;
+
+/** Wideband front end channelizing the Rx of the channels given an --offset */
+sdr::WidebandFrontEnd g_wideband;
+
+sdr::ThreadPolicy m_mainPolicy;
+bool m_memLock = false;
 
-std::string m_ptyPort = std::string("/dev/ptmx");
+bool g_bench = false;
+std::string g_benchName = std::string();
+
+bool g_decode = false;
+std::string g_decodeInput = std::string();
+std::string g_decodeOutput = std::string();
 
 std::string g_logFileName = std::string("dsp.log");
 
@@ -125,18 +154,26 @@ int g_signal = 0;
 bool g_killed = false;
 
 bool g_daemon = false;
-
-extern sdr::port::PseudoPTYPort* m_serialPort;
-
-extern zmq::socket_t m_zmqSocketTx;
-extern zmq::socket_t m_zmqSocketRx;
 #endif
 
 // ---------------------------------------------------------------------------
-//  Global Functions
+//  Public Class Members
 // ---------------------------------------------------------------------------
 
-void setup()
+/// <summary>
+/// Initializes a new instance of the Firmware class.
+/// </summary>
+/// <param name="modem">Modem channel the instance belongs to.</param>
+Firmware::Firmware(sdr::Modem* modem) :
+    ModemContext(modem)
+{
+    /* stub */
+}
+
+/// <summary>
+/// Starts the modem.
+/// </summary>
+void Firmware::setup()
 {
     serial.start();
 #if defined(DIGIPOT_ENABLED)
@@ -144,40 +181,59 @@ void setup()
 #endif
 }
 
-void loop()
+/// <summary>
+/// Runs one pass of the modem main loop.
+/// </summary>
+void Firmware::loop()
 {
-    serial.process();
+    STATS_TIME(STATS_SERIAL_PROCESS, serial.process());
 
     io.process();
 
     // The following is for transmitting
     if (m_dmrEnable && m_modemState == STATE_DMR) {
         if (m_duplex)
-            dmrTX.process();
+            STATS_TIME(STATS_DMR_TX, dmrTX.process());
         else
-            dmrDMOTX.process();
+            STATS_TIME(STATS_DMR_DMO_TX, dmrDMOTX.process());
     }
 
     if (m_p25Enable && m_modemState == STATE_P25)
-        p25TX.process();
+        STATS_TIME(STATS_P25_TX, p25TX.process());
 
     if (m_nxdnEnable && m_modemState == STATE_NXDN)
-        nxdnTX.process();
+        STATS_TIME(STATS_NXDN_TX, nxdnTX.process());
 
     if (m_modemState == STATE_DMR_DMO_CAL_1K || m_modemState == STATE_DMR_CAL_1K ||
         m_modemState == STATE_DMR_LF_CAL || m_modemState == STATE_DMR_CAL)
-        calDMR.process();
+        STATS_TIME(STATS_CAL_TX, calDMR.process());
 
     if (m_modemState == STATE_P25_CAL_1K || m_modemState == STATE_P25_CAL)
-        calP25.process();
+        STATS_TIME(STATS_CAL_TX, calP25.process());
 
     if (m_modemState == STATE_NXDN_CAL)
-        calNXDN.process();
+        STATS_TIME(STATS_CAL_TX, calNXDN.process());
 
     if (m_modemState == STATE_CW || m_modemState == STATE_IDLE)
-        cwIdTX.process();
+        STATS_TIME(STATS_CW_ID_TX, cwIdTX.process());
+}
+
+#if !defined(NATIVE_SDR)
+// ---------------------------------------------------------------------------
+//  Global Functions
+// ---------------------------------------------------------------------------
+
+void setup()
+{
+    firmware.setup();
 }
 
+void loop()
+{
+    firmware.loop();
+}
+#endif // !defined(NATIVE_SDR)
+
 #if defined(__SAM3X8E__) && defined(ARDUINO_SAM_DUE)
 /*
     main.cpp - Main loop for Arduino sketches
@@ -300,12 +356,60 @@ void usage(const char* message, const char* arg)
         ::fprintf(stderr, "\n\n");
     }
 
-    ::fprintf(stdout, "usage: %s [-bdvh] [-r <ZeroMQ Rx IPC Endpoint>] [-t <ZeroMQ Tx IPC Endpoint>] [-p <PTY port>] [-l <log filename>]\n\n"
-        "  -r       ZeroMQ Rx IPC Endpoint\n"
-        "  -t       ZeroMQ Tx IPC Endpoint\n"
-        "  -p       PTY Port\n"
+    ::fprintf(stdout, "usage: %s [-bdvh] [-r <ZeroMQ Rx IPC Endpoint>] [-t <ZeroMQ Tx IPC Endpoint>] [-s <shared memory name>] [-p <PTY port>] [-l <log filename>]\n"
+        "          [--tx-lead <samples>] [--rx-block <samples>] [--rx-format <audio|cs16|cf32>] [--rx-rssi]\n"
+        "          [--rx-rate <Hz>] [--tx-rate <Hz>] [--drift-comp] [--drift-target <ms>]\n"
+        "          [--rt-rx <prio>] [--rt-tx <prio>] [--rt-main <prio>] [--cpu-rx <cpus>] [--cpu-tx <cpus>] [--cpu-main <cpus>] [--mlock]\n"
+        "          [--wideband <endpoint>] [--wideband-rate <Hz>] [--wideband-format <cs16|cf32>] [--spacing <Hz>] [--offset <Hz>]\n"
+        "          [--rt-wideband <prio>] [--cpu-wideband <cpus>] [--capture <path>] [--replay <recording>] [--replay-fast]\n"
+        "          [--blackbox <path>] [--blackbox-time <seconds>]\n"
+        "          [--channel ...] [--workers <count>] [--bench [name]] [--decode <recording>] [--decode-out <path>]\n\n"
+        "  -r       ZeroMQ Rx IPC Endpoint, udp://host:port or unix:///path to receive datagrams on, file:///path to read samples from, or loopback://\n"
+        "  -t       ZeroMQ Tx IPC Endpoint, udp://host:port or unix:///path to send datagrams to, file:///path to write samples to, or loopback://\n"
+        "  -s       Shared memory transport name, uses <name>-rx and <name>-tx instead of ZeroMQ\n"
+        "  -p       PTY Port, the path of the symlink made to the channel pseudo terminal, required for each channel\n"
         "  -l       Log Filename\n"
         "\n"
+        "  --tx-lead    number of Tx samples to keep queued ahead of the SDR (default 1440)\n"
+        "  --rx-block   number of Rx samples processed per pass, even, 2 to 480 (default 48)\n"
+        "  --rx-format  Rx payload, FM demodulated audio or complex baseband IQ (default audio)\n"
+        "  --rx-rssi    Rx audio samples are each followed by a 12-bit RSSI word (IQ input measures its own)\n"
+        "  --rx-rate    sample rate of the Rx transport, resampled to 24000 (default 24000)\n"
+        "  --tx-rate    sample rate of the Tx transport, resampled from 24000 (default 24000)\n"
+        "  --drift-comp compensate for the SDR sample clock drifting against the host clock\n"
+        "  --drift-target  latency (in ms) the drift compensation holds the Rx buffer at (default 20)\n"
+        "  --rt-rx      SCHED_FIFO priority (1 to 99) of the Rx sample thread (default SCHED_OTHER)\n"
+        "  --rt-tx      SCHED_FIFO priority (1 to 99) of the Tx sample thread (default SCHED_OTHER)\n"
+        "  --rt-main    SCHED_FIFO priority (1 to 99) of the main loop workers (default SCHED_OTHER)\n"
+        "  --cpu-rx     CPUs the Rx sample thread may run on, e.g. 2 or 0,2-3 (default any)\n"
+        "  --cpu-tx     CPUs the Tx sample thread may run on (default any)\n"
+        "  --cpu-main   CPUs the main loop workers may run on (default any)\n"
+        "  --mlock      lock the process memory and prefault the thread stacks\n"
+        "  --wideband   endpoint (as -r) of one complex baseband stream the channels given an --offset are received from\n"
+        "  --wideband-rate    sample rate of the wideband stream, a power of 2 channels of 4 to 1024 (default 200000)\n"
+        "  --wideband-format  wideband payload, cs16 or cf32 (default cs16)\n"
+        "  --spacing    channel spacing of the wideband stream, channels are received at twice this rate (default 12500)\n"
+        "  --offset     receive the channel at this offset (in Hz) from the wideband center, a multiple of the spacing;\n"
+        "               the channel Tx is discarded\n"
+        "  --rt-wideband  SCHED_FIFO priority (1 to 99) of the wideband front end thread (default SCHED_OTHER)\n"
+        "  --cpu-wideband CPUs the wideband front end thread may run on (default any)\n"
+        "  --capture    record the Rx samples, RSSI and control marks the DSP reads and the Tx samples it writes\n"
+        "               as SigMF, to <path>-rx.sigmf-data/meta and <path>-tx.sigmf-data/meta\n"
+        "  --replay     feed an Rx SigMF recording made by --capture into the DSP instead of the transport Rx samples\n"
+        "  --replay-fast  replay as fast as the DSP consumes the samples, rather than at real time\n"
+        "  --blackbox   keep the last seconds of Rx samples in memory and snapshot them as SigMF, to\n"
+        "               <path>-<time>-<trigger>.sigmf-data/meta, on P25, DMR or NXDN sync loss, Rx overflow or SIGUSR1\n"
+        "  --blackbox-time  seconds of Rx samples the black box keeps (default 10)\n"
+        "  --channel    start the options of another modem channel, which begins as a copy of the previous\n"
+        "               one; -r, -t, -s, -p, --offset, --capture, --replay*, --blackbox* and the --tx-*, --rx-*, --drift-*, --rt-rx/tx and --cpu-rx/tx\n"
+        "               options are per channel\n"
+        "  --workers    number of threads running the channel main loops (default one per channel, up to the CPUs)\n"
+        "  --bench      run the named (or all) DSP benchmarks and exit\n"
+        "  --decode     decode a recording as fast as possible, without a PTY or any threads, and exit; a SigMF recording\n"
+        "               made by --capture (.sigmf-meta or .sigmf-data), or any other file of samples in the Rx format of the\n"
+        "               channel options\n"
+        "  --decode-out file the decoded frames are written to, as the modem would send them to the host (default stdout)\n"
+        "\n"
         "  -b       background process\n"
         "\n"
         "  -d       enable debug\n"
@@ -327,6 +431,9 @@ int checkArgs(int argc, char* argv[])
             break;
         }
 
+        // per-channel options apply to the last channel started with --channel
+        sdr::ChannelConfig& channel = g_channels.back();
+
         if (*argv[i] != '-') {
             continue;
         }
@@ -337,9 +444,9 @@ int checkArgs(int argc, char* argv[])
         else if (IS("-r")) {
             if ((argc - 1) <= 0)
                 usage("error: %s", "must specify the ZeroMQ Rx IPC Endpoint");
-            m_zmqRx = std::string(argv[++i]);
+            channel.zmqRx = std::string(argv[++i]);
 
-            if (m_zmqRx == "")
+            if (channel.zmqRx == "")
                 usage("error: %s", "IPC endpoint cannot be blank!");
 
             p += 2;
@@ -347,19 +454,33 @@ int checkArgs(int argc, char* argv[])
         else if (IS("-t")) {
             if ((argc - 1) <= 0)
                 usage("error: %s", "must specify the ZeroMQ Tx IPC Endpoint");
-            m_zmqTx = std::string(argv[++i]);
+            channel.zmqTx = std::string(argv[++i]);
 
-            if (m_zmqTx == "")
+            if (channel.zmqTx == "")
                 usage("error: %s", "IPC endpoint cannot be blank!");
 
             p += 2;
         }
+        else if (IS("-s")) {
+            if ((argc - 1) <= 0)
+                usage("error: %s", "must specify the shared memory transport name");
+            channel.shmName = std::string(argv[++i]);
+
+            if (channel.shmName == "")
+                usage("error: %s", "shared memory transport name cannot be blank!");
+
+            // POSIX shared memory object names start with a single slash
+            if (channel.shmName[0] != '/')
+                channel.shmName = "/" + channel.shmName;
+
+            p += 2;
+        }
         else if (IS("-p")) {
             if ((argc - 1) <= 0)
                 usage("error: %s", "must specify the PTY port");
-            m_ptyPort = std::string(argv[++i]);
+            channel.ptyPort = std::string(argv[++i]);
 
-            if (m_ptyPort == "")
+            if (channel.ptyPort == "")
                 usage("error: %s", "PTY port cannot be blank!");
 
             p += 2;
@@ -374,6 +495,246 @@ int checkArgs(int argc, char* argv[])
 
             p += 2;
         }
+        else if (IS("--tx-lead")) {
+            if ((argc - 1) <= 0 || argv[i + 1] == nullptr)
+                usage("error: %s", "must specify the Tx lead in samples");
+            channel.txLead = (uint32_t)::atoi(argv[++i]);
+
+            if (channel.txLead < 1U || channel.txLead > 24000U)
+                usage("error: %s", "Tx lead must be between 1 and 24000 samples!");
+
+            p += 2;
+        }
+        else if (IS("--rx-block")) {
+            if ((argc - 1) <= 0 || argv[i + 1] == nullptr)
+                usage("error: %s", "must specify the Rx block size in samples");
+            int blockSize = ::atoi(argv[++i]);
+
+            if (blockSize < (int)RX_BLOCK_SIZE || blockSize > (int)RX_BLOCK_SIZE_MAX || (blockSize % RX_BLOCK_SIZE) != 0)
+                usage("error: %s", "Rx block size must be an even number between 2 and 480 samples!");
+            channel.rxBlockSize = (uint16_t)blockSize;
+
+            p += 2;
+        }
+        else if (IS("--rx-format")) {
+            if ((argc - 1) <= 0 || argv[i + 1] == nullptr)
+                usage("error: %s", "must specify the Rx payload format");
+
+            if (!sdr::FMDiscriminator::parseFormat(argv[++i], channel.rxIQFormat))
+                usage("error: %s", "Rx payload format must be audio, cs16 or cf32!");
+
+            p += 2;
+        }
+        else if (IS("--rx-rate")) {
+            if ((argc - 1) <= 0 || argv[i + 1] == nullptr)
+                usage("error: %s", "must specify the Rx sample rate");
+            channel.rxSampleRate = (uint32_t)::atoi(argv[++i]);
+
+            if (channel.rxSampleRate < SDR_SAMPLE_RATE_MIN || channel.rxSampleRate > RX_SAMPLE_RATE_MAX)
+                usage("error: %s", "Rx sample rate must be between 8000 and 960000 Hz!");
+
+            p += 2;
+        }
+        else if (IS("--tx-rate")) {
+            if ((argc - 1) <= 0 || argv[i + 1] == nullptr)
+                usage("error: %s", "must specify the Tx sample rate");
+            channel.txSampleRate = (uint32_t)::atoi(argv[++i]);
+
+            if (channel.txSampleRate < SDR_SAMPLE_RATE_MIN || channel.txSampleRate > TX_SAMPLE_RATE_MAX)
+                usage("error: %s", "Tx sample rate must be between 8000 and 192000 Hz!");
+
+            p += 2;
+        }
+        else if (IS("--rx-rssi")) {
+            ++p;
+            channel.rxRSSI = true;
+        }
+        else if (IS("--drift-comp")) {
+            ++p;
+            channel.driftComp = true;
+        }
+        else if (IS("--drift-target")) {
+            if ((argc - 1) <= 0 || argv[i + 1] == nullptr)
+                usage("error: %s", "must specify the drift compensation target latency");
+            channel.driftTarget = (uint32_t)::atoi(argv[++i]);
+
+            if (channel.driftTarget < 1U || channel.driftTarget > 500U)
+                usage("error: %s", "Drift compensation target latency must be between 1 and 500 ms!");
+
+            p += 2;
+        }
+        else if (IS("--rt-rx") || IS("--rt-tx") || IS("--rt-main") || IS("--rt-wideband")) {
+            if ((argc - 1) <= 0 || argv[i + 1] == nullptr)
+                usage("error: %s", "must specify the SCHED_FIFO priority");
+            sdr::ThreadPolicy& policy = IS("--rt-rx") ? channel.rxPolicy : (IS("--rt-tx") ? channel.txPolicy :
+                (IS("--rt-main") ? m_mainPolicy : g_wideband.getPolicy()));
+            int priority = ::atoi(argv[++i]);
+
+            if (priority < 1 || priority > 99)
+                usage("error: %s", "SCHED_FIFO priority must be between 1 and 99!");
+
+            policy.setPriority(priority);
+            p += 2;
+        }
+        else if (IS("--cpu-rx") || IS("--cpu-tx") || IS("--cpu-main") || IS("--cpu-wideband")) {
+            if ((argc - 1) <= 0 || argv[i + 1] == nullptr)
+                usage("error: %s", "must specify the CPU list");
+            sdr::ThreadPolicy& policy = IS("--cpu-rx") ? channel.rxPolicy : (IS("--cpu-tx") ? channel.txPolicy :
+                (IS("--cpu-main") ? m_mainPolicy : g_wideband.getPolicy()));
+
+            if (!policy.setCPUs(std::string(argv[++i])))
+                usage("error: %s", "CPU list must be CPU numbers or ranges, e.g. 0,2-3!");
+
+            p += 2;
+        }
+        else if (IS("--wideband")) {
+            if ((argc - 1) <= 0 || argv[i + 1] == nullptr)
+                usage("error: %s", "must specify the wideband endpoint");
+            g_wideband.setEndpoint(std::string(argv[++i]));
+
+            if (g_wideband.getEndpoint().empty())
+                usage("error: %s", "wideband endpoint cannot be blank!");
+
+            p += 2;
+        }
+        else if (IS("--wideband-rate")) {
+            if ((argc - 1) <= 0 || argv[i + 1] == nullptr)
+                usage("error: %s", "must specify the wideband sample rate");
+            int rate = ::atoi(argv[++i]);
+
+            if (rate < (int)SDR_SAMPLE_RATE_MIN || rate > (int)sdr::WIDEBAND_SAMPLE_RATE_MAX)
+                usage("error: %s", "wideband sample rate must be between 8000 and 20000000 Hz!");
+            g_wideband.setSampleRate((uint32_t)rate);
+
+            p += 2;
+        }
+        else if (IS("--wideband-format")) {
+            if ((argc - 1) <= 0 || argv[i + 1] == nullptr)
+                usage("error: %s", "must specify the wideband payload format");
+
+            sdr::IQ_FORMAT format;
+            if (!sdr::FMDiscriminator::parseFormat(argv[++i], format) || format == sdr::IQ_FORMAT_NONE)
+                usage("error: %s", "wideband payload format must be cs16 or cf32!");
+            g_wideband.setFormat(format);
+
+            p += 2;
+        }
+        else if (IS("--spacing")) {
+            if ((argc - 1) <= 0 || argv[i + 1] == nullptr)
+                usage("error: %s", "must specify the channel spacing");
+            int spacing = ::atoi(argv[++i]);
+
+            if (spacing < 1000 || spacing > 100000)
+                usage("error: %s", "channel spacing must be between 1000 and 100000 Hz!");
+            g_wideband.setSpacing((uint32_t)spacing);
+
+            p += 2;
+        }
+        else if (IS("--offset")) {
+            if ((argc - 1) <= 0 || argv[i + 1] == nullptr)
+                usage("error: %s", "must specify the channel offset");
+            channel.offset = (int32_t)::atoi(argv[++i]);
+            channel.channelized = true;
+
+            p += 2;
+        }
+        else if (IS("--capture")) {
+            if ((argc - 1) <= 0 || argv[i + 1] == nullptr)
+                usage("error: %s", "must specify the capture path");
+            channel.capturePath = std::string(argv[++i]);
+
+            if (channel.capturePath.empty())
+                usage("error: %s", "capture path cannot be blank!");
+
+            p += 2;
+        }
+        else if (IS("--replay")) {
+            if ((argc - 1) <= 0 || argv[i + 1] == nullptr)
+                usage("error: %s", "must specify the recording to replay");
+            channel.replayPath = std::string(argv[++i]);
+
+            if (channel.replayPath.empty())
+                usage("error: %s", "replay recording cannot be blank!");
+
+            p += 2;
+        }
+        else if (IS("--replay-fast")) {
+            ++p;
+            channel.replayFast = true;
+        }
+        else if (IS("--blackbox")) {
+            if ((argc - 1) <= 0 || argv[i + 1] == nullptr)
+                usage("error: %s", "must specify the black box path");
+            channel.blackBoxPath = std::string(argv[++i]);
+
+            if (channel.blackBoxPath.empty())
+                usage("error: %s", "black box path cannot be blank!");
+
+            p += 2;
+        }
+        else if (IS("--blackbox-time")) {
+            if ((argc - 1) <= 0 || argv[i + 1] == nullptr)
+                usage("error: %s", "must specify the black box time");
+            int seconds = ::atoi(argv[++i]);
+
+            if (seconds < 1 || seconds > (int)sdr::BLACKBOX_TIME_MAX)
+                usage("error: %s", "black box time must be between 1 and 600 seconds!");
+            channel.blackBoxTime = (uint32_t)seconds;
+
+            p += 2;
+        }
+        else if (IS("--channel")) {
+            // a new channel starts from the options of the previous one
+            sdr::ChannelConfig next = channel;
+            g_channels.push_back(next);
+
+            if (g_channels.size() > sdr::MODEM_CHANNELS_MAX)
+                usage("error: %s", "too many channels!");
+
+            ++p;
+        }
+        else if (IS("--workers")) {
+            if ((argc - 1) <= 0 || argv[i + 1] == nullptr)
+                usage("error: %s", "must specify the number of worker threads");
+            int workers = ::atoi(argv[++i]);
+
+            if (workers < 1 || workers > (int)sdr::MODEM_CHANNELS_MAX)
+                usage("error: %s", "number of worker threads must be between 1 and 32!");
+            g_workers = (uint32_t)workers;
+
+            p += 2;
+        }
+        else if (IS("--mlock")) {
+            ++p;
+            m_memLock = true;
+        }
+        else if (IS("--bench")) {
+            g_bench = true;
+            if (argv[i + 1] != nullptr && *argv[i + 1] != '-') {
+                g_benchName = std::string(argv[++i]);
+                ++p;
+            }
+
+            ++p;
+        }
+        else if (IS("--decode")) {
+            if ((argc - 1) <= 0 || argv[i + 1] == nullptr)
+                usage("error: %s", "must specify the recording to decode");
+            g_decodeInput = std::string(argv[++i]);
+            g_decode = true;
+
+            if (g_decodeInput.empty())
+                usage("error: %s", "decode recording cannot be blank!");
+
+            p += 2;
+        }
+        else if (IS("--decode-out")) {
+            if ((argc - 1) <= 0 || argv[i + 1] == nullptr)
+                usage("error: %s", "must specify the decode output");
+            g_decodeOutput = std::string(argv[++i]);
+
+            p += 2;
+        }
         else if (IS("-b")) {
             ++p;
             g_daemon = true;
@@ -406,21 +767,84 @@ int checkArgs(int argc, char* argv[])
     return ++p;
 }
 
+void checkChannels()
+{
+    // an offline decode runs one channel from its recording
+    if (g_decode && (g_channels.size() > 1U || g_wideband.isEnabled() || g_channels[0U].channelized))
+        usage("error: %s", "--decode runs a single channel, without --channel, --wideband or --offset!");
+
+    // channelized channels receive complex baseband from the wideband front end
+    for (size_t i = 0U; i < g_channels.size(); i++) {
+        sdr::ChannelConfig& channel = g_channels[i];
+        if (!channel.channelized)
+            continue;
+
+        if (!g_wideband.isEnabled())
+            usage("error: %s", "--offset requires a --wideband endpoint!");
+        if (!g_wideband.checkOffset(channel.offset))
+            usage("error: %s", "channel offset must be a multiple of the spacing inside the wideband stream!");
+
+        channel.rxIQFormat = sdr::IQ_FORMAT_CF32;
+        channel.rxSampleRate = g_wideband.getChannelRate();
+        channel.rxRSSI = false;
+    }
+
+    // the PTY port is a symlink made to the channel pseudo terminal, which an offline decode does not open
+    for (size_t i = 0U; i < g_channels.size() && !g_decode; i++) {
+        if (g_channels[i].ptyPort.empty())
+            usage("error: %s", "each channel must be given a PTY port with -p!");
+    }
+
+    for (size_t i = 0U; i < g_channels.size(); i++) {
+        for (size_t j = i + 1U; j < g_channels.size(); j++) {
+            const sdr::ChannelConfig& a = g_channels[i];
+            const sdr::ChannelConfig& b = g_channels[j];
+
+            if (a.ptyPort == b.ptyPort)
+                usage("error: %s", "each channel must use its own PTY port!");
+
+            if (!a.capturePath.empty() && a.capturePath == b.capturePath)
+                usage("error: %s", "each channel must capture to its own path!");
+
+            if (!a.blackBoxPath.empty() && a.blackBoxPath == b.blackBoxPath)
+                usage("error: %s", "each channel must snapshot its black box to its own path!");
+
+            if (a.channelized || b.channelized) {
+                if (a.channelized && b.channelized && a.offset == b.offset)
+                    usage("error: %s", "each channel must use its own wideband offset!");
+                continue;
+            }
+
+            if (!a.shmName.empty() || !b.shmName.empty()) {
+                if (a.shmName == b.shmName)
+                    usage("error: %s", "each channel must use its own shared memory transport!");
+                continue;
+            }
+
+            // loopback transports are private to their channel
+            if ((a.zmqRx == b.zmqRx && a.zmqRx != "loopback://") || (a.zmqTx == b.zmqTx && a.zmqTx != "loopback://"))
+                usage("error: %s", "each channel must use its own Rx and Tx endpoints!");
+        }
+    }
+}
+
 static void sigHandler(int signum)
 {
     g_killed = true;
     g_signal = signum;
 }
 
+static void sigSnapshot(int signum)
+{
+    sdr::BlackBox::request();
+}
+
 // ---------------------------------------------------------------------------
 //  Program Entry Point
 // ---------------------------------------------------------------------------
 
 int main(int argc, char** argv)
 {
-    m_zmqRx = std::string("ipc:///tmp/dvm-rx.ipc");
-    m_zmqTx = std::string("ipc:///tmp/dvm-tx.ipc");
-
     if (argv[0] != nullptr && *argv[0] != 0)
         g_progExe = std::string(argv[0]);
 
@@ -437,17 +861,30 @@ int main(int argc, char** argv)
         }
     }
 
+    if (g_bench)
+        return sdr::runBenchmark(g_benchName);
+
+    checkChannels();
+
     ::signal(SIGINT, sigHandler);
     ::signal(SIGTERM, sigHandler);
     ::signal(SIGHUP, sigHandler);
+    ::signal(SIGUSR1, sigSnapshot);
 
-    // initialize system logging
-    bool ret = ::LogInitialise(".", g_logFileName.c_str(), 1U, 1U);
+    // initialize system logging; decoded frames may go to stdout, so an offline decode
+    // only logs to the file
+    bool ret = ::LogInitialise(".", g_logFileName.c_str(), 1U, g_decode ? 0U : 1U);
     if (!ret) {
         ::fprintf(stderr, "unable to open the log file\n");
         return 1;
     }
 
+    if (g_decode) {
+        int code = sdr::runDecoder(g_channels[0U], g_decodeInput, g_decodeOutput, &g_killed);
+        ::LogFinalise();
+        return code;
+    }
+
     // handle POSIX process forking
     if (g_daemon) {
         // create new process
@@ -481,6 +918,49 @@ int main(int argc, char** argv)
         ::close(STDERR_FILENO);
     }
 
+    // lock memory before any of the sample threads exist, so their stacks are locked too
+    if (m_memLock)
+        sdr::ThreadPolicy::lockMemory();
+    m_mainPolicy.apply("Main");
+
+    // one context and event loop per channel, run by a pool of workers
+    uint32_t workers = g_workers;
+    if (workers == 0U) {
+        long cpus = ::sysconf(_SC_NPROCESSORS_ONLN);
+        workers = (uint32_t)g_channels.size();
+        if (cpus > 0 && (long)workers > cpus)
+            workers = (uint32_t)cpus;
+    }
+
+    sdr::ChannelPool pool;
+    if (!pool.open()) {
+        ::LogFinalise();
+        return EXIT_FAILURE;
+    }
+
+    std::vector<sdr::Modem*> modems;
+    std::vector<int32_t> offsets;
+    for (size_t i = 0U; i < g_channels.size(); i++) {
+        sdr::Modem* modem = new sdr::Modem((uint32_t)(i + 1U), g_channels[i]);
+        if (!modem->open(EVENT_LOOP_TICK_US) || !pool.add(modem)) {
+            ::LogFinalise();
+            return EXIT_FAILURE;
+        }
+
+        modems.push_back(modem);
+        if (g_channels[i].channelized)
+            offsets.push_back(g_channels[i].offset);
+    }
+
+    // the channel transports are created on setup, so the front end opens first
+    if (!offsets.empty()) {
+        if (!g_wideband.open(offsets) || !g_wideband.start()) {
+            ::LogFinalise();
+            return EXIT_FAILURE;
+        }
+    }
+
+    bool failed = false;
     do {
         g_signal = 0;
 
@@ -490,13 +970,27 @@ int main(int argc, char** argv)
             ::LogInfo("Portions Copyright (c) 2015-2021 by Jonathan Naylor, G4KLX and others");
 
             ::LogInfoEx(LOG_DSP, "DSP is performing initialization and warmup");
-            setup();
-
-            ::LogInfoEx(LOG_DSP, "DSP is up and running");
-            while (!g_killed) {
-                loop();
-                ::usleep(1);
+            ::LogInfoEx(LOG_DSP, "FIR kernel: %s", ::arm_fir_kernel_name(::arm_fir_get_kernel()));
+            for (std::vector<sdr::Modem*>::iterator it = modems.begin(); it != modems.end(); ++it) {
+                sdr::Modem* modem = *it;
+                modem->m_firmware.setup();
+
+                if (modem->m_serialPort == nullptr) {
+                    ::LogError(LOG_DSP, "Channel %u has no PTY, stopping", modem->getId());
+                    failed = true;
+                    break;
+                }
+
+                modem->m_eventLoop.add(modem->m_serialPort->getFd());
             }
+
+            if (failed)
+                break;
+
+            ::LogInfoEx(LOG_DSP, "DSP is up and running, %u channel(s) on %u worker(s)", (uint32_t)modems.size(), workers);
+
+            // sleeps until a channel has PTY data, its Rx/Tx threads signal work or its housekeeping tick
+            pool.run(workers, m_mainPolicy, &g_killed);
         }
 
         if (g_signal == 2)
@@ -511,20 +1005,14 @@ int main(int argc, char** argv)
 
     ::LogInfoEx(LOG_DSP, "DSP is shutting down");
 
-    if (m_serialPort != nullptr) {
-        m_serialPort->close();
-        delete m_serialPort;
-    }
+    pool.close();
+    g_wideband.close();
 
-    try
-    {
-        m_zmqSocketTx.close();
-        m_zmqSocketRx.close();
-    }
-    catch(const zmq::error_t& zmqE) { /* stub */ }
-    catch(const std::exception& e) { /* stub */ }
+    // the sample threads are still running, so the channel contexts are left to the process exit
+    for (std::vector<sdr::Modem*>::iterator it = modems.begin(); it != modems.end(); ++it)
+        (*it)->close();
 
     ::LogFinalise();
-    return 0;
+    return failed ? EXIT_FAILURE : 0;
 }
 #endif // defined(NATIVE_SDR)
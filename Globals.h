@@ -56,11 +56,15 @@
 #include "nxdn/CalNXDN.h"
 #if defined(NATIVE_SDR)
 #include "sdr/Log.h"
+#include "sdr/FMDiscriminator.h"
+#include "sdr/ThreadPolicy.h"
+#include "sdr/WidebandFrontEnd.h"
 #endif
 #include "CalRSSI.h"
 #include "CWIdTX.h"
 #include "Digipot.h"
 #include "IO.h"
+#include "StageStats.h"
 
 #if defined(NATIVE_SDR)
 #include <cstring>
@@ -74,10 +78,25 @@ const uint8_t   MARK_SLOT1 = 0x08U;
 const uint8_t   MARK_SLOT2 = 0x04U;
 const uint8_t   MARK_NONE = 0x00U;
 
-const uint16_t  RX_BLOCK_SIZE = 2U;
-
 const uint16_t  TX_RINGBUFFER_SIZE = 500U;
+#if defined(NATIVE_SDR)
+const uint16_t  RX_RINGBUFFER_SIZE = 2400U;   // room for several of the largest Rx blocks
+#else
 const uint16_t  RX_RINGBUFFER_SIZE = 600U;
+#endif
+
+#if defined(NATIVE_SDR)
+const uint32_t  SDR_SAMPLE_RATE_MIN = 8000U;
+const uint32_t  RX_SAMPLE_RATE_MAX = 960000U;
+const uint32_t  TX_SAMPLE_RATE_MAX = 192000U;
+
+const uint32_t  SAMPLE_RATE = 24000U;
+const uint32_t  TX_FRAME_LENGTH = 720U;       // 30ms at 24 kHz
+const uint32_t  TX_FRAME_LENGTH_MAX = (TX_SAMPLE_RATE_MAX * TX_FRAME_LENGTH) / SAMPLE_RATE;
+const uint32_t  TX_FRAME_POOL_SIZE = 16U;
+
+const float     RX_FM_DEVIATION = 3000.0F;    // Hz at full scale Rx audio, IQ input only
+#endif
 
 // ---------------------------------------------------------------------------
 //  Macros
@@ -94,6 +113,19 @@ const uint16_t  RX_RINGBUFFER_SIZE = 600U;
 //  Global Externs
 // ---------------------------------------------------------------------------
 
+#if defined(NATIVE_SDR)
+#include "sdr/Modem.h"
+
+// the native build hosts several modem channels in one process; each sdr::Modem owns
+// the state and objects the MCU builds keep as the globals below, and its components
+// reach them through their ModemContext
+
+extern sdr::ThreadPolicy m_mainPolicy;
+extern bool m_memLock;
+extern sdr::WidebandFrontEnd g_wideband;
+extern bool g_debug;
+extern bool g_decode;
+#else
 extern DVM_STATE m_modemState;
 
 extern bool m_dmrEnable;
@@ -137,16 +169,15 @@ extern CalRSSI calRSSI;
 /** CW */
 extern CWIdTX cwIdTX;
 
+#if defined(DSP_STATS)
+/** Stage timing counters */
+extern StageStats stats;
+#endif
+
 #if defined(DIGIPOT_ENABLED)
 /** Digipot */
 extern Digipot digitpot;
 #endif
-
-#if defined(NATIVE_SDR)
-extern std::string m_zmqRx;
-extern std::string m_zmqTx;
-extern std::string m_ptyPort;
-extern bool g_debug;
-#endif
+#endif // defined(NATIVE_SDR)
 
 #endif // __GLOBALS_H__
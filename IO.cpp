@@ -42,7 +42,6 @@ static q15_t RRC_0_2_FILTER[] = {
     401, 104, -340, -731, -847, -553, 112, 909, 1472, 1450, 683, -675, -2144, -3040, -2706, -770, 2667, 6995,
     11237, 14331, 15464, 14331, 11237, 6995, 2667, -770, -2706, -3040, -2144, -675, 683, 1450, 1472, 909, 112,
     -553, -847, -731, -340, 104, 401, 0 };
-const uint16_t RRC_0_2_FILTER_LEN = 42U;
 
 // One symbol boxcar filter
 #if defined(P25_RX_NORMAL_BOXCAR)
@@ -51,12 +50,10 @@ static q15_t BOXCAR_5_FILTER[] = { 12000, 12000, 12000, 12000, 12000, 0 };
 #if defined(P25_RX_NARROW_BOXCAR)
 static q15_t BOXCAR_5_FILTER[] = { 9600, 9600, 9600, 9600, 9600, 0 };
 #endif
-const uint16_t BOXCAR_5_FILTER_LEN = 6U;
 
 #if defined(NXDN_BOXCAR_FILTER)
 // One symbol boxcar filter
 static q15_t BOXCAR_10_FILTER[] = { 6000, 6000, 6000, 6000, 6000, 6000, 6000, 6000, 6000, 6000 };
-const uint16_t BOXCAR_10_FILTER_LEN = 10U;
 #else
 // Generated using rcosdesign(0.2, 8, 10, 'sqrt') in MATLAB
 static q15_t NXDN_0_2_FILTER[] = {
@@ -66,13 +63,11 @@ static q15_t NXDN_0_2_FILTER[] = {
     -1915, -1516, -1016, -477, 39, 483, 819, 1026, 1097, 1041, 880, 643, 364, 79, -181, -391, -533, -599, -590,
     -517, -393, -240, -78, 73, 198, 284, 0
 };
-const uint16_t NXDN_0_2_FILTER_LEN = 82U;
 
 static q15_t NXDN_ISINC_FILTER[] = {
     790, -1085, -1073, -553, 747, 2341, 3156, 2152, -893, -4915, -7834, -7536, -3102, 4441, 12354, 17394, 17394,
     12354, 4441, -3102, -7536, -7834, -4915, -893, 2152, 3156, 2341, 747, -553, -1073, -1085, 790
 };
-const uint16_t NXDN_ISINC_FILTER_LEN = 32U;
 #endif
 
 // Generated using [b, a] = butter(1, 0.001) in MATLAB
@@ -88,16 +83,22 @@ const uint16_t DC_OFFSET = 2048U;
 /// <summary>
 /// Initializes a new instance of the IO class.
 /// </summary>
-IO::IO() :
+/// <param name="modem">Modem channel the instance belongs to.</param>
+IO::IO(sdr::Modem* modem) :
+    ModemContext(modem),
     m_started(false),
     m_rxBuffer(RX_RINGBUFFER_SIZE),
     m_txBuffer(TX_RINGBUFFER_SIZE),
     m_rssiBuffer(RX_RINGBUFFER_SIZE),
-    m_rrc_0_2_Filter(),
-    m_boxcar_5_Filter(),
+    m_rrc_0_2_Filter(RRC_0_2_FILTER),
+    m_boxcar_5_Filter(BOXCAR_5_FILTER),
     m_dcFilter(),
-    m_rrc_0_2_State(),
-    m_boxcar_5_State(),
+#if defined(NXDN_BOXCAR_FILTER)
+    m_boxcar_10_Filter(BOXCAR_10_FILTER),
+#else
+    m_nxdn_0_2_Filter(NXDN_0_2_FILTER),
+    m_nxdn_ISinc_Filter(NXDN_ISINC_FILTER),
+#endif
     m_dcState(),
     m_pttInvert(false),
     m_rxLevel(128 * 128),
@@ -113,47 +114,65 @@ IO::IO() :
     m_adcOverflow(0U),
     m_dacOverflow(0U),
     m_watchdog(0U),
+#if defined(NATIVE_SDR)
+    m_lockout(false),
+    m_threadTx(),
+    m_txLock(),
+    m_threadRx(),
+    m_txFramePool(TX_FRAME_POOL_SIZE, TX_FRAME_LENGTH_MAX),
+    m_txFrameLength(TX_FRAME_LENGTH),
+    m_txFrame(NULL),
+    m_txFramePtr(0U),
+    m_txFrameExhausted(0U),
+    m_watchdogTime(),
+    m_watchdogFrac(0U),
+    m_txPacer(SAMPLE_RATE, TX_FRAME_LENGTH * 2U),
+    m_txResampler(),
+    m_txResampled(),
+    m_txPending(),
+    m_txPendingPtr(0U),
+    m_txPendingLen(0U),
+    m_fmDisc(SAMPLE_RATE, RX_FM_DEVIATION),
+    m_rxResampler(),
+    m_rxResampled(),
+    m_rxSampleSize(sizeof(short)),
+    m_rxDrift(SAMPLE_RATE, 0U),
+    m_rxDrifted(),
+    m_rxDriftAnchored(false),
+    m_rxDriftEpoch(),
+    m_rxDriftSamples(0U),
+    m_rxDriftUpdate(0),
+    m_rxDriftLog(0),
+    m_driftPPB(0),
+    m_txPacerPPB(0),
+    m_transport(NULL),
+    m_transportStats(),
+    m_rxArrivalAnchored(false),
+    m_rxArrivalEpoch(),
+    m_rxArrivalExpected(0),
+    m_rxArrivalFrac(0U),
+    m_rxArrivalMin(0),
+    m_rxArrivalWindow(0),
+    m_rxWakeup(),
+    m_recorder(),
+    m_replay(),
+    m_cosInt(false)
+#else
     m_lockout(false)
+#endif
 {
-    ::memset(m_rrc_0_2_State, 0x00U, 70U * sizeof(q15_t));
-    ::memset(m_boxcar_5_State, 0x00U, 30U * sizeof(q15_t));
-
     ::memset(m_dcState, 0x00U, 4U * sizeof(q31_t));
 
-    m_rrc_0_2_Filter.numTaps = RRC_0_2_FILTER_LEN;
-    m_rrc_0_2_Filter.pState = m_rrc_0_2_State;
-    m_rrc_0_2_Filter.pCoeffs = RRC_0_2_FILTER;
-
-    m_boxcar_5_Filter.numTaps = BOXCAR_5_FILTER_LEN;
-    m_boxcar_5_Filter.pState = m_boxcar_5_State;
-    m_boxcar_5_Filter.pCoeffs = BOXCAR_5_FILTER;
-
-#if NXDN_BOXCAR_FILTER
-    ::memset(m_boxcar_10_State, 0x00U, 40U * sizeof(q15_t));
-    
-    m_boxcar_10_Filter.numTaps = BOXCAR10_FILTER_LEN;
-    m_boxcar_10_Filter.pState  = m_boxcar_10_State;
-    m_boxcar_10_Filter.pCoeffs = BOXCAR10_FILTER;
-#else
-    ::memset(m_nxdn_0_2_State, 0x00U, 110U * sizeof(q15_t));
-    ::memset(m_nxdn_ISinc_State, 0x00U, 60U * sizeof(q15_t));
-
-    m_nxdn_0_2_Filter.numTaps = NXDN_0_2_FILTER_LEN;
-    m_nxdn_0_2_Filter.pState  = m_nxdn_0_2_State;
-    m_nxdn_0_2_Filter.pCoeffs = NXDN_0_2_FILTER;
-    
-    m_nxdn_ISinc_Filter.numTaps = NXDN_ISINC_FILTER_LEN;
-    m_nxdn_ISinc_Filter.pState  = m_nxdn_ISinc_State;
-    m_nxdn_ISinc_Filter.pCoeffs = NXDN_ISINC_FILTER;
-#endif
-
     m_dcFilter.numStages = DC_FILTER_STAGES;
     m_dcFilter.pState = m_dcState;
     m_dcFilter.pCoeffs = DC_FILTER;
     m_dcFilter.postShift = 0;
 
     initInt();
+#if !defined(NATIVE_SDR)
+    // the native build has no LEDs to blink, and each channel would sit out the delays
     selfTest();
+#endif
 }
 
 /// <summary>
@@ -215,15 +234,29 @@ void IO::process()
         setPTTInt(m_pttInvert ? true : false);
     }
 
-    if (m_rxBuffer.getData() >= RX_BLOCK_SIZE) {
-        q15_t samples[RX_BLOCK_SIZE];
-        uint8_t control[RX_BLOCK_SIZE];
-        uint16_t rssi[RX_BLOCK_SIZE];
+#if defined(NATIVE_SDR)
+    uint16_t blockSize = m_modem->m_config.rxBlockSize;
+#else
+    uint16_t blockSize = RX_BLOCK_SIZE;
+#endif
 
-        for (uint16_t i = 0U; i < RX_BLOCK_SIZE; i++) {
-            uint16_t sample;
-            m_rxBuffer.get(sample, control[i]);
-            m_rssiBuffer.get(rssi[i]);
+    if (m_rxBuffer.getData() >= blockSize) {
+        q15_t samples[RX_BLOCK_SIZE_MAX];
+        uint8_t control[RX_BLOCK_SIZE_MAX];
+        uint16_t rssi[RX_BLOCK_SIZE_MAX];
+
+        STATS_BEGIN(conditionStart);
+
+        uint16_t raw[RX_BLOCK_SIZE_MAX];
+        m_rxBuffer.getBlock(raw, control, blockSize);
+        m_rssiBuffer.getBlock(rssi, blockSize);
+#if defined(NATIVE_SDR)
+        m_recorder.recordRx(raw, rssi, control, blockSize);
+        m_modem->m_blackBox.record(raw, rssi, control, blockSize);
+#endif
+
+        for (uint16_t i = 0U; i < blockSize; i++) {
+            uint16_t sample = raw[i];
 
             // Detect ADC overflow
             if (m_detect && (sample == 0U || sample == 4095U))
@@ -234,115 +267,125 @@ void IO::process()
             samples[i] = q15_t(__SSAT((res2 >> 15), 16));
         }
 
+        STATS_END(STATS_IO_PROCESS, conditionStart);
+
         if (m_lockout)
             return;
 
-        q15_t dcSamples[RX_BLOCK_SIZE];
+        q15_t dcSamples[RX_BLOCK_SIZE_MAX];
         if (m_dcBlockerEnable) {
-            q31_t q31Samples[RX_BLOCK_SIZE];
+            STATS_BEGIN(dcStart);
+
+            q31_t q31Samples[RX_BLOCK_SIZE_MAX];
 
-            ::arm_q15_to_q31(samples, q31Samples, RX_BLOCK_SIZE);
+            ::arm_q15_to_q31(samples, q31Samples, blockSize);
 
-            q31_t dcValues[RX_BLOCK_SIZE];
-            ::arm_biquad_cascade_df1_q31(&m_dcFilter, q31Samples, dcValues, RX_BLOCK_SIZE);
+            q31_t dcValues[RX_BLOCK_SIZE_MAX];
+            ::arm_biquad_cascade_df1_q31(&m_dcFilter, q31Samples, dcValues, blockSize);
 
-            q31_t dcLevel = 0;
-            for (uint8_t i = 0U; i < RX_BLOCK_SIZE; i++)
-                dcLevel += dcValues[i];
-            dcLevel /= RX_BLOCK_SIZE;
+            // the offset is averaged over each RX_BLOCK_SIZE run of samples so a larger
+            // block produces exactly the same output as the base block size
+            for (uint16_t j = 0U; j < blockSize; j += RX_BLOCK_SIZE) {
+                q31_t dcLevel = 0;
+                for (uint16_t i = j; i < (j + RX_BLOCK_SIZE); i++)
+                    dcLevel += dcValues[i];
+                dcLevel /= RX_BLOCK_SIZE;
 
-            q15_t offset = q15_t(__SSAT((dcLevel >> 16), 16));;
+                q15_t offset = q15_t(__SSAT((dcLevel >> 16), 16));;
 
-            for (uint8_t i = 0U; i < RX_BLOCK_SIZE; i++)
-                dcSamples[i] = samples[i] - offset;
+                for (uint16_t i = j; i < (j + RX_BLOCK_SIZE); i++)
+                    dcSamples[i] = samples[i] - offset;
+            }
+
+            STATS_END(STATS_DC_BLOCKER, dcStart);
         }
 
         /** Idle Modem State */
         if (m_modemState == STATE_IDLE) {
             /** Project 25 */
             if (m_p25Enable) {
-                q15_t c4fmSamples[RX_BLOCK_SIZE];
+                q15_t c4fmSamples[RX_BLOCK_SIZE_MAX];
                 if (m_dcBlockerEnable) {
-                    ::arm_fir_fast_q15(&m_boxcar_5_Filter, dcSamples, c4fmSamples, RX_BLOCK_SIZE);
+                    STATS_TIME(STATS_FIR_BOXCAR_5, m_boxcar_5_Filter.process(dcSamples, c4fmSamples, blockSize));
                 }
                 else {
-                    ::arm_fir_fast_q15(&m_boxcar_5_Filter, samples, c4fmSamples, RX_BLOCK_SIZE);
+                    STATS_TIME(STATS_FIR_BOXCAR_5, m_boxcar_5_Filter.process(samples, c4fmSamples, blockSize));
                 }
 
-                p25RX.samples(c4fmSamples, rssi, RX_BLOCK_SIZE);
+                STATS_TIME(STATS_P25_RX, p25RX.samples(c4fmSamples, rssi, blockSize));
             }
 
             /** Digital Mobile Radio */
             if (m_dmrEnable) {
-                q15_t c4fmSamples[RX_BLOCK_SIZE];
-                ::arm_fir_fast_q15(&m_rrc_0_2_Filter, samples, c4fmSamples, RX_BLOCK_SIZE);
+                q15_t c4fmSamples[RX_BLOCK_SIZE_MAX];
+                STATS_TIME(STATS_FIR_RRC_0_2, m_rrc_0_2_Filter.process(samples, c4fmSamples, blockSize));
 
                 if (m_dmrEnable) {
                     if (m_duplex)
-                        dmrIdleRX.samples(c4fmSamples, RX_BLOCK_SIZE);
+                        STATS_TIME(STATS_DMR_IDLE_RX, dmrIdleRX.samples(c4fmSamples, blockSize));
                     else
-                        dmrDMORX.samples(c4fmSamples, rssi, RX_BLOCK_SIZE);
+                        STATS_TIME(STATS_DMR_DMO_RX, dmrDMORX.samples(c4fmSamples, rssi, blockSize));
                 }
             }
 
             /** Next Generation Digital Narrowband */
             if (m_nxdnEnable) {
-                q15_t c4fmSamples[RX_BLOCK_SIZE];
-#if NXDN_BOXCAR_FILTER
+                q15_t c4fmSamples[RX_BLOCK_SIZE_MAX];
+#if defined(NXDN_BOXCAR_FILTER)
                 if (m_dcBlockerEnable) {
-                    ::arm_fir_fast_q15(&m_boxcar_10_Filter, dcSamples, c4fmSamples, RX_BLOCK_SIZE);
+                    STATS_TIME(STATS_FIR_BOXCAR_10, m_boxcar_10_Filter.process(dcSamples, c4fmSamples, blockSize));
                 }
                 else {
-                    ::arm_fir_fast_q15(&m_boxcar_10_Filter, samples, c4fmSamples, RX_BLOCK_SIZE);
+                    STATS_TIME(STATS_FIR_BOXCAR_10, m_boxcar_10_Filter.process(samples, c4fmSamples, blockSize));
                 }
 #else
-                q15_t c4fmRCSamples[RX_BLOCK_SIZE];
+                q15_t c4fmRCSamples[RX_BLOCK_SIZE_MAX];
                 if (m_dcBlockerEnable) {
-                    ::arm_fir_fast_q15(&m_nxdn_0_2_Filter, dcSamples, c4fmRCSamples, RX_BLOCK_SIZE);
+                    STATS_TIME(STATS_FIR_NXDN_0_2, m_nxdn_0_2_Filter.process(dcSamples, c4fmRCSamples, blockSize));
                 }
                 else {
-                    ::arm_fir_fast_q15(&m_nxdn_0_2_Filter, samples, c4fmRCSamples, RX_BLOCK_SIZE);
+                    STATS_TIME(STATS_FIR_NXDN_0_2, m_nxdn_0_2_Filter.process(samples, c4fmRCSamples, blockSize));
                 }
 
-                ::arm_fir_fast_q15(&m_nxdn_ISinc_Filter, c4fmRCSamples, c4fmSamples, RX_BLOCK_SIZE);
+                STATS_TIME(STATS_FIR_NXDN_ISINC, m_nxdn_ISinc_Filter.process(c4fmRCSamples, c4fmSamples, blockSize));
 #endif
-                nxdnRX.samples(c4fmSamples, rssi, RX_BLOCK_SIZE);
+                STATS_TIME(STATS_NXDN_RX, nxdnRX.samples(c4fmSamples, rssi, blockSize));
             }
         }
         else if (m_modemState == STATE_DMR) {        // DMR State
             /** Digital Mobile Radio */
             if (m_dmrEnable) {
-                q15_t c4fmSamples[RX_BLOCK_SIZE];
-                ::arm_fir_fast_q15(&m_rrc_0_2_Filter, samples, c4fmSamples, RX_BLOCK_SIZE);
+                q15_t c4fmSamples[RX_BLOCK_SIZE_MAX];
+                STATS_TIME(STATS_FIR_RRC_0_2, m_rrc_0_2_Filter.process(samples, c4fmSamples, blockSize));
 
                 if (m_duplex) {
                     // If the transmitter isn't on, use the DMR idle RX to detect the wakeup CSBKs
                     if (m_tx)
-                        dmrRX.samples(c4fmSamples, rssi, control, RX_BLOCK_SIZE);
+                        STATS_TIME(STATS_DMR_RX, dmrRX.samples(c4fmSamples, rssi, control, blockSize));
                     else
-                        dmrIdleRX.samples(c4fmSamples, RX_BLOCK_SIZE);
+                        STATS_TIME(STATS_DMR_IDLE_RX, dmrIdleRX.samples(c4fmSamples, blockSize));
                 }
                 else {
-                    dmrDMORX.samples(c4fmSamples, rssi, RX_BLOCK_SIZE);
+                    STATS_TIME(STATS_DMR_DMO_RX, dmrDMORX.samples(c4fmSamples, rssi, blockSize));
                 }
             }
         }
         else if (m_modemState == STATE_P25) {        // P25 State
             /** Project 25 */
             if (m_p25Enable) {
-                q15_t c4fmSamples[RX_BLOCK_SIZE];
+                q15_t c4fmSamples[RX_BLOCK_SIZE_MAX];
                 if (m_dcBlockerEnable) {
-                    ::arm_fir_fast_q15(&m_boxcar_5_Filter, dcSamples, c4fmSamples, RX_BLOCK_SIZE);
+                    STATS_TIME(STATS_FIR_BOXCAR_5, m_boxcar_5_Filter.process(dcSamples, c4fmSamples, blockSize));
                 }
                 else {
-                    ::arm_fir_fast_q15(&m_boxcar_5_Filter, samples, c4fmSamples, RX_BLOCK_SIZE);
+                    STATS_TIME(STATS_FIR_BOXCAR_5, m_boxcar_5_Filter.process(samples, c4fmSamples, blockSize));
                 }
 
-                p25RX.samples(c4fmSamples, rssi, RX_BLOCK_SIZE);
+                STATS_TIME(STATS_P25_RX, p25RX.samples(c4fmSamples, rssi, blockSize));
             }
         }
         else if (m_modemState == STATE_RSSI_CAL) {
-            calRSSI.samples(rssi, RX_BLOCK_SIZE);
+            calRSSI.samples(rssi, blockSize);
         }
     }
 }
@@ -384,20 +427,46 @@ void IO::write(DVM_STATE mode, q15_t* samples, uint16_t length, const uint8_t* c
         break;
     }
 
-    for (uint16_t i = 0U; i < length; i++) {
-        q31_t res1 = samples[i] * txLevel;
-        q15_t res2 = q15_t(__SSAT((res1 >> 15), 16));
-        uint16_t res3 = uint16_t(res2 + m_txDCOffset);
+    // scale straight into the free regions of the Tx ring buffer, samples that do not
+    // fit are dropped and flag the buffer as overflowed
+    SampleSpan spans[2U];
+    uint16_t space = m_txBuffer.beginPut(spans);
+    if (length > space) {
+        m_txBuffer.setOverflow();
+        length = space;
+    }
 
-        // Detect DAC overflow
-        if (res3 > 4095U)
-            m_dacOverflow++;
+    uint16_t n = 0U;
+    for (uint8_t s = 0U; s < 2U && n < length; s++) {
+        uint16_t count = spans[s].length;
+        if (count > (length - n))
+            count = length - n;
+
+        uint16_t* out = spans[s].samples;
+        for (uint16_t i = 0U; i < count; i++) {
+            q31_t res1 = samples[n + i] * txLevel;
+            q15_t res2 = q15_t(__SSAT((res1 >> 15), 16));
+            uint16_t res3 = uint16_t(res2 + m_txDCOffset);
+
+            // Detect DAC overflow
+            if (res3 > 4095U)
+                m_dacOverflow++;
+
+            out[i] = res3;
+        }
 
         if (control == NULL)
-            m_txBuffer.put(res3, MARK_NONE);
+            ::memset(spans[s].control, MARK_NONE, count);
         else
-            m_txBuffer.put(res3, control[i]);
+            ::memcpy(spans[s].control, control + n, count);
+#if defined(NATIVE_SDR)
+        m_recorder.recordTx(out, spans[s].control, count);
+#endif
+
+        n += count;
     }
+
+    m_txBuffer.commitPut(length);
 }
 
 /// <summary>
@@ -32,19 +32,48 @@
 #define __IO_H__
 
 #include "Defines.h"
+#include "ModemContext.h"
 #include "Globals.h"
+#include "FirQ15.h"
 #include "SampleBuffer.h"
 #include "RSSIBuffer.h"
 
+#if defined(NATIVE_SDR)
+#include "sdr/DriftCompensator.h"
+#include "sdr/FMDiscriminator.h"
+#include "sdr/Resampler.h"
+#include "sdr/SampleFramePool.h"
+#include "sdr/SigMFRecorder.h"
+#include "sdr/SigMFReplay.h"
+#include "sdr/TxPacer.h"
+#include "sdr/WakeupLatency.h"
+#include "sdr/transport/ISampleTransport.h"
+
+#include <pthread.h>
+#include <time.h>
+
+#include <vector>
+#endif
+
+// ---------------------------------------------------------------------------
+//  Constants
+// ---------------------------------------------------------------------------
+
+const uint16_t RRC_0_2_FILTER_LEN = 42U;
+const uint16_t BOXCAR_5_FILTER_LEN = 6U;
+const uint16_t BOXCAR_10_FILTER_LEN = 10U;
+const uint16_t NXDN_0_2_FILTER_LEN = 82U;
+const uint16_t NXDN_ISINC_FILTER_LEN = 32U;
+
 // ---------------------------------------------------------------------------
 //  Class Declaration
 //      Implements the input/output data path with the radio air interface.
 // ---------------------------------------------------------------------------
 
-class DSP_FW_API IO {
+class DSP_FW_API IO : public ModemContext {
 public:
     /// <summary>Initializes a new instance of the IO class.</summary>
-    IO();
+    IO(sdr::Modem* modem = NULL);
 
     /// <summary>Starts air interface sampler.</summary>
     void start();
@@ -101,6 +130,18 @@ public:
     /// <summary></summary>
     void selfTest();
 
+#if defined(NATIVE_SDR)
+    /// <summary>Flag indicating the RX ring buffer holds at least one block of samples.</summary>
+    bool hasRXBlock() const;
+
+    /// <summary>Closes the sample transport.</summary>
+    void closeTransport();
+    /// <summary>Completes the sample capture; the main loop must be stopped.</summary>
+    void closeCapture();
+    /// <summary>Feeds the next samples of an offline decode into the Rx ring buffers.</summary>
+    uint32_t decodeRx();
+#endif
+
 #if I2C_ENABLED
     /// <summary>Writes a buffer of data to the I2C bus at the specified address</summary>
     void I2C_Write(uint8_t addr, uint8_t *buf, uint8_t count);
@@ -115,24 +156,16 @@ private:
     SampleBuffer m_txBuffer;
     RSSIBuffer m_rssiBuffer;
 
-    arm_fir_instance_q15 m_rrc_0_2_Filter;
-    arm_fir_instance_q15 m_boxcar_5_Filter;
+    FirQ15<RRC_0_2_FILTER_LEN, RX_BLOCK_SIZE_MAX> m_rrc_0_2_Filter;
+    BoxcarQ15<BOXCAR_5_FILTER_LEN, RX_BLOCK_SIZE_MAX> m_boxcar_5_Filter;
 
     arm_biquad_casd_df1_inst_q31 m_dcFilter;
 
-    q15_t m_rrc_0_2_State[70U];      // NoTaps + BlockSize - 1, 42 + 20 - 1 plus some spare
-    q15_t m_boxcar_5_State[30U];     // NoTaps + BlockSize - 1, 6 + 20 - 1 plus some spare
-
-#if NXDN_BOXCAR_FILTER
-    arm_fir_instance_q15 m_boxcar_10_Filter;
-
-    q15_t m_boxcar_10_State[40U];   // NoTaps + BlockSize - 1, 10 + 20 - 1 plus some spare
+#if defined(NXDN_BOXCAR_FILTER)
+    BoxcarQ15<BOXCAR_10_FILTER_LEN, RX_BLOCK_SIZE_MAX> m_boxcar_10_Filter;
 #else
-    arm_fir_instance_q15 m_nxdn_0_2_Filter;
-    arm_fir_instance_q15 m_nxdn_ISinc_Filter;
-    
-    q15_t m_nxdn_0_2_State[110U];   // NoTaps + BlockSize - 1, 82 + 20 - 1 plus some spare
-    q15_t m_nxdn_ISinc_State[60U];  // NoTaps + BlockSize - 1, 32 + 20 - 1 plus some spare
+    FirQ15<NXDN_0_2_FILTER_LEN, RX_BLOCK_SIZE_MAX> m_nxdn_0_2_Filter;
+    FirQ15<NXDN_ISINC_FILTER_LEN, RX_BLOCK_SIZE_MAX> m_nxdn_ISinc_Filter;
 #endif
 
     q31_t m_dcState[4];
@@ -160,6 +193,58 @@ private:
 
     bool m_lockout;
 
+#if defined(NATIVE_SDR)
+    pthread_t m_threadTx;
+    pthread_mutex_t m_txLock;
+    pthread_t m_threadRx;
+
+    sdr::SampleFramePool m_txFramePool;
+    uint32_t m_txFrameLength;
+    short* m_txFrame;
+    uint32_t m_txFramePtr;
+    uint32_t m_txFrameExhausted;
+    timespec m_watchdogTime;
+    uint64_t m_watchdogFrac;
+    sdr::TxPacer m_txPacer;
+    sdr::Resampler m_txResampler;
+    std::vector<float> m_txResampled;
+    std::vector<short> m_txPending;
+    uint32_t m_txPendingPtr;
+    uint32_t m_txPendingLen;
+
+    sdr::FMDiscriminator m_fmDisc;
+    sdr::Resampler m_rxResampler;
+    std::vector<float> m_rxResampled;
+    uint32_t m_rxSampleSize;
+
+    sdr::DriftCompensator m_rxDrift;
+    std::vector<float> m_rxDrifted;
+    bool m_rxDriftAnchored;
+    timespec m_rxDriftEpoch;
+    uint64_t m_rxDriftSamples;
+    int64_t m_rxDriftUpdate;
+    int64_t m_rxDriftLog;
+
+    // Rx clock offset (in parts per billion) handed to the Tx pacer; written by the Rx thread only
+    int32_t m_driftPPB;
+    int32_t m_txPacerPPB;
+
+    sdr::transport::ISampleTransport* m_transport;
+    timespec m_transportStats;
+    bool m_rxArrivalAnchored;
+    timespec m_rxArrivalEpoch;
+    int64_t m_rxArrivalExpected;
+    uint64_t m_rxArrivalFrac;
+    int64_t m_rxArrivalMin;
+    int64_t m_rxArrivalWindow;
+    sdr::WakeupLatency m_rxWakeup;
+
+    sdr::SigMFRecorder m_recorder;
+    sdr::SigMFReplay m_replay;
+
+    bool m_cosInt;
+#endif
+
     // Hardware specific routines
     /// <summary>Initializes hardware interrupts.</summary>
     void initInt();
@@ -192,6 +277,28 @@ private:
     void interruptRx();
     /// <summary></summary>
     static void* rxThreadHelper(void* arg);
+
+#if defined(NATIVE_SDR)
+    /// <summary>Helper to copy queued Tx samples into the current frame.</summary>
+    uint32_t fillTxFrame();
+    /// <summary>Helper to resample queued Tx samples into the current frame.</summary>
+    uint32_t fillTxFrameResampled();
+    /// <summary>Helper to deliver a received payload into the Rx ring buffer.</summary>
+    void deliverRx(const uint8_t* data, uint32_t length);
+    /// <summary>Helper to convert a received payload to 24 kHz samples in the Rx ring buffer.</summary>
+    uint32_t convertRx(const uint8_t* data, uint32_t length);
+    /// <summary>Helper to feed the next replayed samples into the Rx ring buffers.</summary>
+    void replayRx();
+
+    /// <summary>Helper to create the sample transport selected by the channel options.</summary>
+    sdr::transport::ISampleTransport* createTransport();
+    /// <summary>Helper to hand the completed Tx frame to the sample transport on its deadline.</summary>
+    void sendTxFrame();
+    /// <summary>Helper to run the Rx drift compensation loop after samples were delivered.</summary>
+    void trackRxDrift(uint32_t samples);
+    /// <summary>Helper to record how late the Rx thread woke for the samples the transport delivered.</summary>
+    void trackRxArrival(const timespec& now, uint32_t samples);
+#endif
 };
 
 #endif // __IO_H__
@@ -0,0 +1,140 @@
+/**
+* Digital Voice Modem - DSP Firmware
+* GPLv2 Open Source. Use is subject to license terms.
+* DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+*
+* @package DVM / DSP Firmware
+*
+*/
+/*
+*   Copyright (C) 2022 Bryan Biedenkapp N2PLL
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 2 of the License, or
+*   (at your option) any later version.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program; if not, write to the Free Software
+*   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*/
+#if !defined(__MODEM_CONTEXT_H__)
+#define __MODEM_CONTEXT_H__
+
+#include "Defines.h"
+
+namespace sdr
+{
+    class Modem;
+} // namespace sdr
+
+#if defined(NATIVE_SDR)
+class SerialPort;
+class IO;
+class CalRSSI;
+class CWIdTX;
+class StageStats;
+
+namespace dmr
+{
+    class DMRIdleRX;
+    class DMRRX;
+    class DMRTX;
+    class DMRDMORX;
+    class DMRDMOTX;
+    class CalDMR;
+} // namespace dmr
+
+namespace p25
+{
+    class P25RX;
+    class P25TX;
+    class CalP25;
+} // namespace p25
+
+namespace nxdn
+{
+    class NXDNRX;
+    class NXDNTX;
+    class CalNXDN;
+} // namespace nxdn
+#endif
+
+// ---------------------------------------------------------------------------
+//  Class Declaration
+//      Implements the modem state and objects a firmware component works
+//      with. The MCU builds keep these as globals and the context is empty;
+//      the native build hosts several modem channels in one process, so the
+//      context binds the same names to the members of one sdr::Modem.
+// ---------------------------------------------------------------------------
+
+class DSP_FW_API ModemContext {
+public:
+#if defined(NATIVE_SDR)
+    /// <summary>Initializes a new instance of the ModemContext class.</summary>
+    ModemContext(sdr::Modem* modem);
+#else
+    /// <summary>Initializes a new instance of the ModemContext class.</summary>
+    ModemContext(sdr::Modem*) { /* stub */ }
+#endif
+
+#if defined(NATIVE_SDR)
+protected:
+    sdr::Modem* m_modem;
+
+    /** Modem state */
+    DVM_STATE& m_modemState;
+
+    bool& m_dmrEnable;
+    bool& m_p25Enable;
+    bool& m_nxdnEnable;
+
+    bool& m_dcBlockerEnable;
+    bool& m_cosLockoutEnable;
+
+    bool& m_duplex;
+
+    bool& m_tx;
+    bool& m_dcd;
+
+    /** RS232 and Air Interface I/O */
+    SerialPort& serial;
+    IO& io;
+
+    /** DMR BS */
+    dmr::DMRIdleRX& dmrIdleRX;
+    dmr::DMRRX& dmrRX;
+    dmr::DMRTX& dmrTX;
+
+    /** DMR MS-DMO */
+    dmr::DMRDMORX& dmrDMORX;
+    dmr::DMRDMOTX& dmrDMOTX;
+
+    /** P25 BS */
+    p25::P25RX& p25RX;
+    p25::P25TX& p25TX;
+
+    /** NXDN BS */
+    nxdn::NXDNRX& nxdnRX;
+    nxdn::NXDNTX& nxdnTX;
+
+    /** Calibration */
+    dmr::CalDMR& calDMR;
+    p25::CalP25& calP25;
+    nxdn::CalNXDN& calNXDN;
+    CalRSSI& calRSSI;
+
+    /** CW */
+    CWIdTX& cwIdTX;
+
+    /** Stage timing counters */
+    StageStats& stats;
+#endif
+};
+
+#endif // __MODEM_CONTEXT_H__
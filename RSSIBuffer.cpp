@@ -32,6 +32,19 @@
 */
 #include "RSSIBuffer.h"
 
+#include <cstring>
+
+// ---------------------------------------------------------------------------
+//  Macros
+// ---------------------------------------------------------------------------
+
+// The head index is only written by the producer and the tail index only by the
+// consumer; each side publishes its index with release semantics after touching
+// the storage, and reads the other side's index with acquire semantics.
+#define LOAD_ACQUIRE(v)         __atomic_load_n(&(v), __ATOMIC_ACQUIRE)
+#define LOAD_RELAXED(v)         __atomic_load_n(&(v), __ATOMIC_RELAXED)
+#define STORE_RELEASE(v, x)     __atomic_store_n(&(v), (x), __ATOMIC_RELEASE)
+
 // ---------------------------------------------------------------------------
 //  Public Class Members
 // ---------------------------------------------------------------------------
@@ -39,16 +52,23 @@
 /// <summary>
 /// Initializes a new instance of the RSSIBuffer class.
 /// </summary>
+/// <remarks>The storage is rounded up to a power of two so the free running indices
+/// can be masked, the buffer still holds at most length samples.</remarks>
 /// <param name="length"></param>
 RSSIBuffer::RSSIBuffer(uint16_t length) :
     m_length(length),
+    m_mask(0U),
     m_rssi(NULL),
     m_head(0U),
-    m_tail(0U),
-    m_full(false),
-    m_overflow(false)
+    m_overflow(false),
+    m_tail(0U)
 {
-    m_rssi = new uint16_t[length];
+    uint32_t size = 1U;
+    while (size < length)
+        size <<= 1;
+    m_mask = size - 1U;
+
+    m_rssi = new uint16_t[size];
 }
 
 /// <summary>
@@ -57,19 +77,7 @@ RSSIBuffer::RSSIBuffer(uint16_t length) :
 /// <returns></returns>
 uint16_t RSSIBuffer::getSpace() const
 {
-    uint16_t n = 0U;
-
-    if (m_tail == m_head)
-        n = m_full ? 0U : m_length;
-    else if (m_tail < m_head)
-        n = m_length - m_head + m_tail;
-    else
-        n = m_tail - m_head;
-
-    if (n > m_length)
-        n = 0U;
-
-    return n;
+    return m_length - getData();
 }
 
 /// <summary>
@@ -78,12 +86,14 @@ uint16_t RSSIBuffer::getSpace() const
 /// <returns></returns>
 uint16_t RSSIBuffer::getData() const
 {
-    if (m_tail == m_head)
-        return m_full ? m_length : 0U;
-    else if (m_tail < m_head)
-        return m_head - m_tail;
-    else
-        return m_length - m_tail + m_head;
+    uint32_t tail = LOAD_ACQUIRE(m_tail);
+    uint32_t head = LOAD_ACQUIRE(m_head);
+
+    uint32_t n = head - tail;
+    if (n > m_length)
+        n = m_length;
+
+    return uint16_t(n);
 }
 
 /// <summary>
@@ -93,19 +103,17 @@ uint16_t RSSIBuffer::getData() const
 /// <returns></returns>
 bool RSSIBuffer::put(uint16_t rssi)
 {
-    if (m_full) {
-        m_overflow = true;
+    uint32_t head = LOAD_RELAXED(m_head);
+    uint32_t tail = LOAD_ACQUIRE(m_tail);
+
+    if ((head - tail) >= m_length) {
+        STORE_RELEASE(m_overflow, true);
         return false;
     }
 
-    m_rssi[m_head] = rssi;
+    m_rssi[head & m_mask] = rssi;
 
-    m_head++;
-    if (m_head >= m_length)
-        m_head = 0U;
-
-    if (m_head == m_tail)
-        m_full = true;
+    STORE_RELEASE(m_head, head + 1U);
 
     return true;
 }
@@ -117,29 +125,188 @@ bool RSSIBuffer::put(uint16_t rssi)
 /// <returns></returns>
 bool RSSIBuffer::get(uint16_t& rssi)
 {
-    if (m_head == m_tail && !m_full)
-        return false;
+    uint32_t tail = LOAD_RELAXED(m_tail);
+    uint32_t head = LOAD_ACQUIRE(m_head);
 
-    rssi = m_rssi[m_tail];
+    if (head == tail)
+        return false;
 
-    m_full = false;
+    rssi = m_rssi[tail & m_mask];
 
-    m_tail++;
-    if (m_tail >= m_length)
-        m_tail = 0U;
+    STORE_RELEASE(m_tail, tail + 1U);
 
     return true;
 }
 
 /// <summary>
-/// Flag indicating whether or not the ring buffer has overflowed.
+/// Gets up to two contiguous regions of free space; returns the total length.
 /// </summary>
+/// <remarks>Only the producer may call this.</remarks>
+/// <param name="spans"></param>
 /// <returns></returns>
-bool RSSIBuffer::hasOverflowed()
+uint16_t RSSIBuffer::beginPut(RSSISpan spans[2U])
+{
+    uint32_t head = LOAD_RELAXED(m_head);
+    uint32_t tail = LOAD_ACQUIRE(m_tail);
+
+    uint32_t space = m_length - (head - tail);
+    uint32_t start = head & m_mask;
+    uint32_t first = (m_mask + 1U) - start;
+    if (first > space)
+        first = space;
+
+    spans[0U].rssi = m_rssi + start;
+    spans[0U].length = uint16_t(first);
+
+    spans[1U].rssi = m_rssi;
+    spans[1U].length = uint16_t(space - first);
+
+    return uint16_t(space);
+}
+
+/// <summary>
+/// Publishes the given number of values written into the regions from beginPut.
+/// </summary>
+/// <param name="count"></param>
+void RSSIBuffer::commitPut(uint16_t count)
+{
+    STORE_RELEASE(m_head, LOAD_RELAXED(m_head) + count);
+}
+
+/// <summary>
+/// Gets up to two contiguous regions of queued values; returns the total length.
+/// </summary>
+/// <remarks>Only the consumer may call this.</remarks>
+/// <param name="spans"></param>
+/// <returns></returns>
+uint16_t RSSIBuffer::beginGet(RSSISpan spans[2U]) const
+{
+    uint32_t tail = LOAD_RELAXED(m_tail);
+    uint32_t head = LOAD_ACQUIRE(m_head);
+
+    uint32_t data = head - tail;
+    uint32_t start = tail & m_mask;
+    uint32_t first = (m_mask + 1U) - start;
+    if (first > data)
+        first = data;
+
+    spans[0U].rssi = m_rssi + start;
+    spans[0U].length = uint16_t(first);
+
+    spans[1U].rssi = m_rssi;
+    spans[1U].length = uint16_t(data - first);
+
+    return uint16_t(data);
+}
+
+/// <summary>
+/// Releases the given number of values read from the regions from beginGet.
+/// </summary>
+/// <param name="count"></param>
+void RSSIBuffer::commitGet(uint16_t count)
+{
+    STORE_RELEASE(m_tail, LOAD_RELAXED(m_tail) + count);
+}
+
+/// <summary>
+/// Copies a block of RSSI values into the ring buffer; returns the number of values written.
+/// </summary>
+/// <param name="rssi"></param>
+/// <param name="length"></param>
+/// <returns></returns>
+uint16_t RSSIBuffer::putBlock(const uint16_t* rssi, uint16_t length)
+{
+    RSSISpan spans[2U];
+    uint16_t space = beginPut(spans);
+    if (length > space) {
+        setOverflow();
+        length = space;
+    }
+
+    uint16_t n = 0U;
+    for (uint8_t i = 0U; i < 2U && n < length; i++) {
+        uint16_t count = spans[i].length;
+        if (count > (length - n))
+            count = length - n;
+
+        ::memcpy(spans[i].rssi, rssi + n, count * sizeof(uint16_t));
+        n += count;
+    }
+
+    commitPut(length);
+    return length;
+}
+
+/// <summary>
+/// Fills the ring buffer with a repeated RSSI value; returns the number of values written.
+/// </summary>
+/// <param name="rssi"></param>
+/// <param name="length"></param>
+/// <returns></returns>
+uint16_t RSSIBuffer::putFill(uint16_t rssi, uint16_t length)
+{
+    RSSISpan spans[2U];
+    uint16_t space = beginPut(spans);
+    if (length > space) {
+        setOverflow();
+        length = space;
+    }
+
+    uint16_t n = 0U;
+    for (uint8_t i = 0U; i < 2U && n < length; i++) {
+        uint16_t count = spans[i].length;
+        if (count > (length - n))
+            count = length - n;
+
+        for (uint16_t j = 0U; j < count; j++)
+            spans[i].rssi[j] = rssi;
+        n += count;
+    }
+
+    commitPut(length);
+    return length;
+}
+
+/// <summary>
+/// Copies a block of RSSI values out of the ring buffer; returns the number of values read.
+/// </summary>
+/// <param name="rssi"></param>
+/// <param name="length"></param>
+/// <returns></returns>
+uint16_t RSSIBuffer::getBlock(uint16_t* rssi, uint16_t length)
 {
-    bool overflow = m_overflow;
+    RSSISpan spans[2U];
+    uint16_t data = beginGet(spans);
+    if (length > data)
+        length = data;
+
+    uint16_t n = 0U;
+    for (uint8_t i = 0U; i < 2U && n < length; i++) {
+        uint16_t count = spans[i].length;
+        if (count > (length - n))
+            count = length - n;
+
+        ::memcpy(rssi + n, spans[i].rssi, count * sizeof(uint16_t));
+        n += count;
+    }
 
-    m_overflow = false;
+    commitGet(length);
+    return length;
+}
+
+/// <summary>
+/// Flags the ring buffer as overflowed after data was dropped.
+/// </summary>
+void RSSIBuffer::setOverflow()
+{
+    STORE_RELEASE(m_overflow, true);
+}
 
-    return overflow;
+/// <summary>
+/// Flag indicating whether or not the ring buffer has overflowed.
+/// </summary>
+/// <returns></returns>
+bool RSSIBuffer::hasOverflowed()
+{
+    return __atomic_exchange_n(&m_overflow, false, __ATOMIC_ACQ_REL);
 }
@@ -35,9 +35,20 @@
 
 #include "Defines.h"
 
+// ---------------------------------------------------------------------------
+//  Structure Declaration
+//      Contiguous region of a RSSI ring buffer.
+// ---------------------------------------------------------------------------
+
+struct RSSISpan {
+    uint16_t* rssi;
+    uint16_t length;
+};
+
 // ---------------------------------------------------------------------------
 //  Class Declaration
-//      Implements a circular buffer for RSSI data.
+//      Implements a lock-free single-producer/single-consumer circular buffer
+//      for RSSI data.
 // ---------------------------------------------------------------------------
 
 class DSP_FW_API RSSIBuffer {
@@ -57,19 +68,44 @@ public:
     /// <summary></summary>
     bool get(uint16_t& rssi);
 
+    /// <summary>Gets up to two contiguous regions of free space; returns the total length.</summary>
+    uint16_t beginPut(RSSISpan spans[2U]);
+    /// <summary>Publishes the given number of values written into the regions from beginPut.</summary>
+    void commitPut(uint16_t count);
+    /// <summary>Gets up to two contiguous regions of queued values; returns the total length.</summary>
+    uint16_t beginGet(RSSISpan spans[2U]) const;
+    /// <summary>Releases the given number of values read from the regions from beginGet.</summary>
+    void commitGet(uint16_t count);
+
+    /// <summary>Copies a block of RSSI values into the ring buffer; returns the number of values written.</summary>
+    uint16_t putBlock(const uint16_t* rssi, uint16_t length);
+    /// <summary>Fills the ring buffer with a repeated RSSI value; returns the number of values written.</summary>
+    uint16_t putFill(uint16_t rssi, uint16_t length);
+    /// <summary>Copies a block of RSSI values out of the ring buffer; returns the number of values read.</summary>
+    uint16_t getBlock(uint16_t* rssi, uint16_t length);
+
+    /// <summary>Flags the ring buffer as overflowed after data was dropped.</summary>
+    void setOverflow();
     /// <summary>Flag indicating whether or not the ring buffer has overflowed.</summary>
     bool hasOverflowed();
 
 private:
     uint16_t m_length;
-    volatile uint16_t* m_rssi;
-
-    volatile uint16_t m_head;
-    volatile uint16_t m_tail;
+    uint32_t m_mask;
+    uint16_t* m_rssi;
 
-    volatile bool m_full;
+    CACHE_LINE_PAD(m_pad0);
 
+    // written only by the producer
+    uint32_t m_head;
     bool m_overflow;
+
+    CACHE_LINE_PAD(m_pad1);
+
+    // written only by the consumer
+    uint32_t m_tail;
+
+    CACHE_LINE_PAD(m_pad2);
 };
 
 #endif // __RSSI_RB_H__
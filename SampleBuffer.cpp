@@ -32,6 +32,19 @@
 */
 #include "SampleBuffer.h"
 
+#include <cstring>
+
+// ---------------------------------------------------------------------------
+//  Macros
+// ---------------------------------------------------------------------------
+
+// The head index is only written by the producer and the tail index only by the
+// consumer; each side publishes its index with release semantics after touching
+// the storage, and reads the other side's index with acquire semantics.
+#define LOAD_ACQUIRE(v)         __atomic_load_n(&(v), __ATOMIC_ACQUIRE)
+#define LOAD_RELAXED(v)         __atomic_load_n(&(v), __ATOMIC_RELAXED)
+#define STORE_RELEASE(v, x)     __atomic_store_n(&(v), (x), __ATOMIC_RELEASE)
+
 // ---------------------------------------------------------------------------
 //  Public Class Members
 // ---------------------------------------------------------------------------
@@ -39,18 +52,25 @@
 /// <summary>
 /// Initializes a new instance of the SampleBuffer class.
 /// </summary>
+/// <remarks>The storage is rounded up to a power of two so the free running indices
+/// can be masked, the buffer still holds at most length samples.</remarks>
 /// <param name="length"></param>
 SampleBuffer::SampleBuffer(uint16_t length) :
     m_length(length),
+    m_mask(0U),
     m_samples(NULL),
     m_control(NULL),
     m_head(0U),
-    m_tail(0U),
-    m_full(false),
-    m_overflow(false)
+    m_overflow(false),
+    m_tail(0U)
 {
-    m_samples = new uint16_t[length];
-    m_control = new uint8_t[length];
+    uint32_t size = 1U;
+    while (size < length)
+        size <<= 1;
+    m_mask = size - 1U;
+
+    m_samples = new uint16_t[size];
+    m_control = new uint8_t[size];
 }
 
 /// <summary>
@@ -59,19 +79,7 @@ SampleBuffer::SampleBuffer(uint16_t length) :
 /// <returns></returns>
 uint16_t SampleBuffer::getSpace() const
 {
-    uint16_t n = 0U;
-
-    if (m_tail == m_head)
-        n = m_full ? 0U : m_length;
-    else if (m_tail < m_head)
-        n = m_length - m_head + m_tail;
-    else
-        n = m_tail - m_head;
-
-    if (n > m_length)
-        n = 0U;
-
-    return n;
+    return m_length - getData();
 }
 
 /// <summary>
@@ -80,12 +88,14 @@ uint16_t SampleBuffer::getSpace() const
 /// <returns></returns>
 uint16_t SampleBuffer::getData() const
 {
-    if (m_tail == m_head)
-        return m_full ? m_length : 0U;
-    else if (m_tail < m_head)
-        return m_head - m_tail;
-    else
-        return m_length - m_tail + m_head;
+    uint32_t tail = LOAD_ACQUIRE(m_tail);
+    uint32_t head = LOAD_ACQUIRE(m_head);
+
+    uint32_t n = head - tail;
+    if (n > m_length)
+        n = m_length;
+
+    return uint16_t(n);
 }
 
 /// <summary>
@@ -96,20 +106,18 @@ uint16_t SampleBuffer::getData() const
 /// <returns></returns>
 bool SampleBuffer::put(uint16_t sample, uint8_t control)
 {
-    if (m_full) {
-        m_overflow = true;
+    uint32_t head = LOAD_RELAXED(m_head);
+    uint32_t tail = LOAD_ACQUIRE(m_tail);
+
+    if ((head - tail) >= m_length) {
+        STORE_RELEASE(m_overflow, true);
         return false;
     }
 
-    m_samples[m_head] = sample;
-    m_control[m_head] = control;
-
-    m_head++;
-    if (m_head >= m_length)
-        m_head = 0U;
+    m_samples[head & m_mask] = sample;
+    m_control[head & m_mask] = control;
 
-    if (m_head == m_tail)
-        m_full = true;
+    STORE_RELEASE(m_head, head + 1U);
 
     return true;
 }
@@ -122,30 +130,172 @@ bool SampleBuffer::put(uint16_t sample, uint8_t control)
 /// <returns></returns>
 bool SampleBuffer::get(uint16_t& sample, uint8_t& control)
 {
-    if (m_head == m_tail && !m_full)
-        return false;
+    uint32_t tail = LOAD_RELAXED(m_tail);
+    uint32_t head = LOAD_ACQUIRE(m_head);
 
-    sample = m_samples[m_tail];
-    control = m_control[m_tail];
+    if (head == tail)
+        return false;
 
-    m_full = false;
+    sample = m_samples[tail & m_mask];
+    control = m_control[tail & m_mask];
 
-    m_tail++;
-    if (m_tail >= m_length)
-        m_tail = 0U;
+    STORE_RELEASE(m_tail, tail + 1U);
 
     return true;
 }
 
 /// <summary>
-/// Flag indicating whether or not the ring buffer has overflowed.
+/// Gets up to two contiguous regions of free space; returns the total length.
 /// </summary>
+/// <remarks>Only the producer may call this.</remarks>
+/// <param name="spans"></param>
 /// <returns></returns>
-bool SampleBuffer::hasOverflowed()
+uint16_t SampleBuffer::beginPut(SampleSpan spans[2U])
+{
+    uint32_t head = LOAD_RELAXED(m_head);
+    uint32_t tail = LOAD_ACQUIRE(m_tail);
+
+    uint32_t space = m_length - (head - tail);
+    uint32_t start = head & m_mask;
+    uint32_t first = (m_mask + 1U) - start;
+    if (first > space)
+        first = space;
+
+    spans[0U].samples = m_samples + start;
+    spans[0U].control = m_control + start;
+    spans[0U].length = uint16_t(first);
+
+    spans[1U].samples = m_samples;
+    spans[1U].control = m_control;
+    spans[1U].length = uint16_t(space - first);
+
+    return uint16_t(space);
+}
+
+/// <summary>
+/// Publishes the given number of samples written into the regions from beginPut.
+/// </summary>
+/// <param name="count"></param>
+void SampleBuffer::commitPut(uint16_t count)
+{
+    STORE_RELEASE(m_head, LOAD_RELAXED(m_head) + count);
+}
+
+/// <summary>
+/// Gets up to two contiguous regions of queued samples; returns the total length.
+/// </summary>
+/// <remarks>Only the consumer may call this.</remarks>
+/// <param name="spans"></param>
+/// <returns></returns>
+uint16_t SampleBuffer::beginGet(SampleSpan spans[2U]) const
+{
+    uint32_t tail = LOAD_RELAXED(m_tail);
+    uint32_t head = LOAD_ACQUIRE(m_head);
+
+    uint32_t data = head - tail;
+    uint32_t start = tail & m_mask;
+    uint32_t first = (m_mask + 1U) - start;
+    if (first > data)
+        first = data;
+
+    spans[0U].samples = m_samples + start;
+    spans[0U].control = m_control + start;
+    spans[0U].length = uint16_t(first);
+
+    spans[1U].samples = m_samples;
+    spans[1U].control = m_control;
+    spans[1U].length = uint16_t(data - first);
+
+    return uint16_t(data);
+}
+
+/// <summary>
+/// Releases the given number of samples read from the regions from beginGet.
+/// </summary>
+/// <param name="count"></param>
+void SampleBuffer::commitGet(uint16_t count)
 {
-    bool overflow = m_overflow;
+    STORE_RELEASE(m_tail, LOAD_RELAXED(m_tail) + count);
+}
 
-    m_overflow = false;
+/// <summary>
+/// Copies a block of samples into the ring buffer; returns the number of samples written.
+/// </summary>
+/// <remarks>If control is NULL the samples are written with MARK_NONE (0), samples that
+/// do not fit are dropped and flag the buffer as overflowed.</remarks>
+/// <param name="samples"></param>
+/// <param name="control"></param>
+/// <param name="length"></param>
+/// <returns></returns>
+uint16_t SampleBuffer::putBlock(const uint16_t* samples, const uint8_t* control, uint16_t length)
+{
+    SampleSpan spans[2U];
+    uint16_t space = beginPut(spans);
+    if (length > space) {
+        setOverflow();
+        length = space;
+    }
 
-    return overflow;
+    uint16_t n = 0U;
+    for (uint8_t i = 0U; i < 2U && n < length; i++) {
+        uint16_t count = spans[i].length;
+        if (count > (length - n))
+            count = length - n;
+
+        ::memcpy(spans[i].samples, samples + n, count * sizeof(uint16_t));
+        if (control != NULL)
+            ::memcpy(spans[i].control, control + n, count * sizeof(uint8_t));
+        else
+            ::memset(spans[i].control, 0x00U, count * sizeof(uint8_t));
+        n += count;
+    }
+
+    commitPut(length);
+    return length;
+}
+
+/// <summary>
+/// Copies a block of samples out of the ring buffer; returns the number of samples read.
+/// </summary>
+/// <param name="samples"></param>
+/// <param name="control"></param>
+/// <param name="length"></param>
+/// <returns></returns>
+uint16_t SampleBuffer::getBlock(uint16_t* samples, uint8_t* control, uint16_t length)
+{
+    SampleSpan spans[2U];
+    uint16_t data = beginGet(spans);
+    if (length > data)
+        length = data;
+
+    uint16_t n = 0U;
+    for (uint8_t i = 0U; i < 2U && n < length; i++) {
+        uint16_t count = spans[i].length;
+        if (count > (length - n))
+            count = length - n;
+
+        ::memcpy(samples + n, spans[i].samples, count * sizeof(uint16_t));
+        ::memcpy(control + n, spans[i].control, count * sizeof(uint8_t));
+        n += count;
+    }
+
+    commitGet(length);
+    return length;
+}
+
+/// <summary>
+/// Flags the ring buffer as overflowed after data was dropped.
+/// </summary>
+void SampleBuffer::setOverflow()
+{
+    STORE_RELEASE(m_overflow, true);
+}
+
+/// <summary>
+/// Flag indicating whether or not the ring buffer has overflowed.
+/// </summary>
+/// <returns></returns>
+bool SampleBuffer::hasOverflowed()
+{
+    return __atomic_exchange_n(&m_overflow, false, __ATOMIC_ACQ_REL);
 }
@@ -35,9 +35,21 @@
 
 #include "Defines.h"
 
+// ---------------------------------------------------------------------------
+//  Structure Declaration
+//      Contiguous region of a sample ring buffer.
+// ---------------------------------------------------------------------------
+
+struct SampleSpan {
+    uint16_t* samples;
+    uint8_t* control;
+    uint16_t length;
+};
+
 // ---------------------------------------------------------------------------
 //  Class Declaration
-//      Implements a circular buffer for sample data.
+//      Implements a lock-free single-producer/single-consumer circular buffer
+//      for sample data.
 // ---------------------------------------------------------------------------
 
 class DSP_FW_API SampleBuffer {
@@ -57,20 +69,43 @@ public:
     /// <summary></summary>
     bool get(uint16_t& sample, uint8_t& control);
 
+    /// <summary>Gets up to two contiguous regions of free space; returns the total length.</summary>
+    uint16_t beginPut(SampleSpan spans[2U]);
+    /// <summary>Publishes the given number of samples written into the regions from beginPut.</summary>
+    void commitPut(uint16_t count);
+    /// <summary>Gets up to two contiguous regions of queued samples; returns the total length.</summary>
+    uint16_t beginGet(SampleSpan spans[2U]) const;
+    /// <summary>Releases the given number of samples read from the regions from beginGet.</summary>
+    void commitGet(uint16_t count);
+
+    /// <summary>Copies a block of samples into the ring buffer; returns the number of samples written.</summary>
+    uint16_t putBlock(const uint16_t* samples, const uint8_t* control, uint16_t length);
+    /// <summary>Copies a block of samples out of the ring buffer; returns the number of samples read.</summary>
+    uint16_t getBlock(uint16_t* samples, uint8_t* control, uint16_t length);
+
+    /// <summary>Flags the ring buffer as overflowed after data was dropped.</summary>
+    void setOverflow();
     /// <summary>Flag indicating whether or not the ring buffer has overflowed.</summary>
     bool hasOverflowed();
 
 private:
     uint16_t m_length;
-    volatile uint16_t* m_samples;
-    volatile uint8_t* m_control;
-
-    volatile uint16_t m_head;
-    volatile uint16_t m_tail;
+    uint32_t m_mask;
+    uint16_t* m_samples;
+    uint8_t* m_control;
 
-    volatile bool m_full;
+    CACHE_LINE_PAD(m_pad0);
 
+    // written only by the producer
+    uint32_t m_head;
     bool m_overflow;
+
+    CACHE_LINE_PAD(m_pad1);
+
+    // written only by the consumer
+    uint32_t m_tail;
+
+    CACHE_LINE_PAD(m_pad2);
 };
 
 #endif // __SAMPLE_RB_H__
@@ -48,7 +48,9 @@ const uint8_t PROTOCOL_VERSION = 3U;
 /// <summary>
 /// Initializes a new instance of the SerialPort class.
 /// </summary>
-SerialPort::SerialPort() :
+/// <param name="modem">Modem channel the instance belongs to.</param>
+SerialPort::SerialPort(sdr::Modem* modem) :
+    ModemContext(modem),
     m_buffer(),
     m_ptr(0U),
     m_len(0U),
@@ -105,6 +107,12 @@ void SerialPort::process()
                     getVersion();
                     break;
 
+                case CMD_GET_STATS:
+                    err = getStats(m_buffer + 3U, m_len - 3U);
+                    if (err != RSN_OK)
+                        sendNAK(err);
+                    break;
+
                 case CMD_SET_CONFIG:
                     err = setConfig(m_buffer + 3U, m_len - 3U);
                     if (err == RSN_OK)
@@ -909,6 +917,50 @@ void SerialPort::getVersion()
     writeInt(1U, reply, count);
 }
 
+/// <summary>
+/// Write the timing counters of a DSP processing stage.
+/// </summary>
+/// <remarks>
+/// The request carries the stage number; STATS_RESET instead clears the counters of
+/// all stages.
+/// </remarks>
+/// <param name="data"></param>
+/// <param name="length"></param>
+/// <returns></returns>
+uint8_t SerialPort::getStats(const uint8_t* data, uint8_t length)
+{
+#if defined(DSP_STATS)
+    if (length < 1U)
+        return RSN_ILLEGAL_LENGTH;
+
+    if (data[0U] == STATS_RESET) {
+        stats.reset();
+        sendACK();
+        return RSN_OK;
+    }
+
+    if (data[0U] >= STATS_STAGE_COUNT)
+        return RSN_INVALID_REQUEST;
+
+    uint8_t reply[100U];
+
+    reply[0U] = DVM_FRAME_START;
+    reply[1U] = 0U;
+    reply[2U] = CMD_GET_STATS;
+
+    uint8_t count = 3U + stats.encode(data[0U], reply + 3U);
+
+    reply[1U] = count;
+
+    writeInt(1U, reply, count);
+    return RSN_OK;
+#else
+    (void)data;
+    (void)length;
+    return RSN_INVALID_REQUEST;
+#endif
+}
+
 /// <summary>
 /// Helper to validate the passed modem state is valid.
 /// </summary>
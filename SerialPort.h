@@ -32,6 +32,7 @@
 #define __SERIAL_PORT_H__
 
 #include "Defines.h"
+#include "ModemContext.h"
 #include "Globals.h"
 #include "SerialBuffer.h"
 
@@ -39,32 +40,6 @@
 //  Constants
 // ---------------------------------------------------------------------------
 
-enum DVM_STATE {
-    STATE_IDLE = 0U,
-    // DMR
-    STATE_DMR = 1U,
-    // Project 25
-    STATE_P25 = 2U,
-    // NXDN
-    STATE_NXDN = 3U,
-
-    // CW
-    STATE_CW = 10U,
-
-    // Calibration States
-    STATE_P25_CAL_1K = 92U,
-
-    STATE_DMR_DMO_CAL_1K = 93U,
-    STATE_DMR_CAL_1K = 94U,
-    STATE_DMR_LF_CAL = 95U,
-
-    STATE_RSSI_CAL = 96U,
-
-    STATE_P25_CAL = 97U,
-    STATE_DMR_CAL = 98U,
-    STATE_NXDN_CAL = 99U
-};
-
 enum DVM_COMMANDS {
     CMD_GET_VERSION = 0x00U,
     CMD_GET_STATUS = 0x01U,
@@ -80,6 +55,8 @@ enum DVM_COMMANDS {
 
     CMD_SEND_CWID = 0x0AU,
 
+    CMD_GET_STATS = 0x0BU,
+
     CMD_DMR_DATA1 = 0x18U,
     CMD_DMR_LOST1 = 0x19U,
     CMD_DMR_DATA2 = 0x1AU,
@@ -147,10 +124,10 @@ const uint8_t DVM_FRAME_START = 0xFEU;
 //      Implements the RS232 serial bus to communicate with the HOST S/W.
 // ---------------------------------------------------------------------------
 
-class DSP_FW_API SerialPort {
+class DSP_FW_API SerialPort : public ModemContext {
 public:
     /// <summary>Initializes a new instance of the SerialPort class.</summary>
-    SerialPort();
+    SerialPort(sdr::Modem* modem = NULL);
 
     /// <summary>Starts serial port communications.</summary>
     void start();
@@ -213,6 +190,8 @@ private:
     void getStatus();
     /// <summary>Write modem DSP version.</summary>
     void getVersion();
+    /// <summary>Write the timing counters of a DSP processing stage.</summary>
+    uint8_t getStats(const uint8_t* data, uint8_t length);
     ///  <summary>Helper to validate the passed modem state is valid.</summary>
     uint8_t modemStateCheck(DVM_STATE state);
     /// <summary>Set modem DSP configuration from serial port data.</summary>
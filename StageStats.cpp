@@ -0,0 +1,131 @@
+/**
+* Digital Voice Modem - DSP Firmware
+* GPLv2 Open Source. Use is subject to license terms.
+* DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+*
+* @package DVM / DSP Firmware
+*
+*/
+/*
+*   Copyright (C) 2022 Bryan Biedenkapp N2PLL
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 2 of the License, or
+*   (at your option) any later version.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program; if not, write to the Free Software
+*   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*/
+#include "Globals.h"
+#include "StageStats.h"
+
+// ---------------------------------------------------------------------------
+//  Public Class Members
+// ---------------------------------------------------------------------------
+
+/// <summary>
+/// Initializes a new instance of the StageStats class.
+/// </summary>
+StageStats::StageStats() :
+#if defined(NATIVE_SDR)
+    m_stages(),
+    m_resetTicks(0U),
+    m_resetTime(0U)
+#else
+    m_stages()
+#endif
+{
+#if !defined(NATIVE_SDR)
+    // start the Cortex-M cycle counter
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0U;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+#endif
+    reset();
+}
+
+/// <summary>
+/// Clears the counters of all stages.
+/// </summary>
+void StageStats::reset()
+{
+    ::memset(m_stages, 0x00U, sizeof(m_stages));
+
+#if defined(NATIVE_SDR)
+    timespec ts;
+    ::clock_gettime(CLOCK_MONOTONIC, &ts);
+    m_resetTime = uint64_t(ts.tv_sec) * 1000000000ULL + ts.tv_nsec;
+#if defined(__x86_64__) || defined(__i386__)
+    m_resetTicks = __rdtsc();
+#endif
+#endif
+}
+
+/// <summary>
+/// Writes the counters of the given stage, big endian, into the buffer.
+/// </summary>
+/// <remarks>
+/// The layout is the stage, the number of stages, the number of histogram buckets, the
+/// tick rate in kHz (32 bits), the run count (32 bits), the total ticks (64 bits), the
+/// longest run in ticks (32 bits) and the histogram bucket counts (32 bits each).
+/// </remarks>
+/// <param name="stage"></param>
+/// <param name="buffer"></param>
+/// <returns>Number of bytes written.</returns>
+uint8_t StageStats::encode(uint8_t stage, uint8_t* buffer) const
+{
+    const Stage& s = m_stages[stage];
+    uint32_t rate = getTickRate();
+
+    uint8_t count = 0U;
+    buffer[count++] = stage;
+    buffer[count++] = STATS_STAGE_COUNT;
+    buffer[count++] = STATS_HIST_BUCKETS;
+
+    for (int8_t shift = 24; shift >= 0; shift -= 8)
+        buffer[count++] = (rate >> shift) & 0xFFU;
+    for (int8_t shift = 24; shift >= 0; shift -= 8)
+        buffer[count++] = (s.count >> shift) & 0xFFU;
+    for (int8_t shift = 56; shift >= 0; shift -= 8)
+        buffer[count++] = (s.total >> shift) & 0xFFU;
+    for (int8_t shift = 24; shift >= 0; shift -= 8)
+        buffer[count++] = (s.max >> shift) & 0xFFU;
+
+    for (uint8_t i = 0U; i < STATS_HIST_BUCKETS; i++) {
+        for (int8_t shift = 24; shift >= 0; shift -= 8)
+            buffer[count++] = (s.hist[i] >> shift) & 0xFFU;
+    }
+
+    return count;
+}
+
+/// <summary>
+/// Gets the tick rate in kHz.
+/// </summary>
+/// <returns></returns>
+uint32_t StageStats::getTickRate() const
+{
+#if defined(NATIVE_SDR)
+#if defined(__x86_64__) || defined(__i386__)
+    // the TSC rate is measured against the monotonic clock over the time since the reset
+    timespec ts;
+    ::clock_gettime(CLOCK_MONOTONIC, &ts);
+    uint64_t elapsed = (uint64_t(ts.tv_sec) * 1000000000ULL + ts.tv_nsec) - m_resetTime;
+    if (elapsed < 1000000U)
+        return 0U;
+
+    return uint32_t((double(__rdtsc() - m_resetTicks) * 1000000.0) / double(elapsed));
+#else
+    return 1000000U;
+#endif
+#else
+    return SystemCoreClock / 1000U;
+#endif
+}
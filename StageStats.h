@@ -0,0 +1,165 @@
+/**
+* Digital Voice Modem - DSP Firmware
+* GPLv2 Open Source. Use is subject to license terms.
+* DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+*
+* @package DVM / DSP Firmware
+*
+*/
+/*
+*   Copyright (C) 2022 Bryan Biedenkapp N2PLL
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 2 of the License, or
+*   (at your option) any later version.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program; if not, write to the Free Software
+*   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*/
+#if !defined(__STAGE_STATS_H__)
+#define __STAGE_STATS_H__
+
+#include "Defines.h"
+
+#if defined(NATIVE_SDR)
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+#include <time.h>
+#endif
+
+// ---------------------------------------------------------------------------
+//  Constants
+// ---------------------------------------------------------------------------
+
+enum STATS_STAGE {
+    STATS_IO_PROCESS = 0U,          // Rx block fetch and level conditioning
+    STATS_DC_BLOCKER = 1U,
+
+    STATS_FIR_BOXCAR_5 = 2U,
+    STATS_FIR_RRC_0_2 = 3U,
+    STATS_FIR_BOXCAR_10 = 4U,
+    STATS_FIR_NXDN_0_2 = 5U,
+    STATS_FIR_NXDN_ISINC = 6U,
+
+    STATS_P25_RX = 7U,
+    STATS_DMR_IDLE_RX = 8U,
+    STATS_DMR_RX = 9U,
+    STATS_DMR_DMO_RX = 10U,
+    STATS_NXDN_RX = 11U,
+
+    STATS_DMR_TX = 12U,
+    STATS_DMR_DMO_TX = 13U,
+    STATS_P25_TX = 14U,
+    STATS_NXDN_TX = 15U,
+    STATS_CAL_TX = 16U,
+    STATS_CW_ID_TX = 17U,
+
+    STATS_SERIAL_PROCESS = 18U,
+
+    STATS_STAGE_COUNT
+};
+
+const uint8_t   STATS_HIST_BUCKETS = 16U;
+// bucket 0 holds everything below 2^(STATS_HIST_SHIFT + 1) ticks, each bucket after
+// it one power of two, the last everything from 2^(STATS_HIST_SHIFT + 15) ticks up
+const uint8_t   STATS_HIST_SHIFT = 6U;
+
+const uint8_t   STATS_RESET = 0xFFU;
+
+// ---------------------------------------------------------------------------
+//  Macros
+// ---------------------------------------------------------------------------
+
+#if defined(DSP_STATS)
+#define STATS_TIME(stage, ...)                                                  \
+    do {                                                                        \
+        uint32_t __statsStart = StageStats::ticks();                            \
+        __VA_ARGS__;                                                            \
+        stats.add(stage, StageStats::ticks() - __statsStart);                   \
+    } while (0)
+
+#define STATS_BEGIN(start)          uint32_t start = StageStats::ticks()
+#define STATS_END(stage, start)     stats.add(stage, StageStats::ticks() - start)
+#else
+#define STATS_TIME(stage, ...) do { __VA_ARGS__; } while (0)
+
+#define STATS_BEGIN(start)
+#define STATS_END(stage, start)
+#endif
+
+// ---------------------------------------------------------------------------
+//  Class Declaration
+//      Implements the per-stage timing counters of the DSP processing chain.
+// ---------------------------------------------------------------------------
+
+class DSP_FW_API StageStats {
+public:
+    /// <summary>Initializes a new instance of the StageStats class.</summary>
+    StageStats();
+
+    /// <summary>Clears the counters of all stages.</summary>
+    void reset();
+
+    /// <summary>Accounts one run of the given stage.</summary>
+    void add(STATS_STAGE stage, uint32_t ticks)
+    {
+        Stage& s = m_stages[stage];
+        s.count++;
+        s.total += ticks;
+        if (ticks > s.max)
+            s.max = ticks;
+
+        uint32_t bucket = 31U - __builtin_clz(ticks | 1U);
+        bucket = (bucket > STATS_HIST_SHIFT) ? bucket - STATS_HIST_SHIFT : 0U;
+        if (bucket >= STATS_HIST_BUCKETS)
+            bucket = STATS_HIST_BUCKETS - 1U;
+        s.hist[bucket]++;
+    }
+
+    /// <summary>Writes the counters of the given stage, big endian, into the buffer.</summary>
+    uint8_t encode(uint8_t stage, uint8_t* buffer) const;
+
+    /// <summary>Gets the tick rate in kHz.</summary>
+    uint32_t getTickRate() const;
+
+    /// <summary>Gets the free running tick counter.</summary>
+    static uint32_t ticks()
+    {
+#if defined(NATIVE_SDR)
+#if defined(__x86_64__) || defined(__i386__)
+        return uint32_t(__rdtsc());
+#else
+        timespec ts;
+        ::clock_gettime(CLOCK_MONOTONIC, &ts);
+        return uint32_t(uint64_t(ts.tv_sec) * 1000000000ULL + ts.tv_nsec);
+#endif
+#else
+        return DWT->CYCCNT;
+#endif
+    }
+
+private:
+    struct Stage {
+        uint32_t count;
+        uint64_t total;
+        uint32_t max;
+        uint32_t hist[STATS_HIST_BUCKETS];
+    };
+
+    Stage m_stages[STATS_STAGE_COUNT];
+
+#if defined(NATIVE_SDR)
+    uint64_t m_resetTicks;
+    uint64_t m_resetTime;
+#endif
+};
+
+#endif // __STAGE_STATS_H__
@@ -98,7 +98,9 @@ const uint8_t SHORTLC_1K[] = { 0x33U, 0x3AU, 0xA0U, 0x30U, 0x00U, 0x55U, 0xA6U,
 /// <summary>
 /// Initializes a new instance of the CalDMR class.
 /// </summary>
-CalDMR::CalDMR() :
+/// <param name="modem">Modem channel the instance belongs to.</param>
+CalDMR::CalDMR(sdr::Modem* modem) :
+    ModemContext(modem),
     m_transmit(false),
     m_state(DMRCAL1K_IDLE),
     m_frameStart(0U),
@@ -33,6 +33,7 @@
 #define __CAL_DMR_H__
 
 #include "Defines.h"
+#include "ModemContext.h"
 #include "dmr/DMRDefines.h"
 
 namespace dmr
@@ -54,10 +55,10 @@ namespace dmr
     //      Implements logic for DMR calibration mode.
     // ---------------------------------------------------------------------------
 
-    class DSP_FW_API CalDMR {
+    class DSP_FW_API CalDMR : public ModemContext {
     public:
         /// <summary>Initializes a new instance of the CalDMR class.</summary>
-        CalDMR();
+        CalDMR(sdr::Modem* modem = NULL);
 
         /// <summary>Process local state and transmit on the air interface.</summary>
         void process();
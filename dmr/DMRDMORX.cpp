@@ -58,7 +58,9 @@ const uint8_t CONTROL_DATA = 0x40U;
 /// <summary>
 /// Initializes a new instance of the DMRDMORX class.
 /// </summary>
-DMRDMORX::DMRDMORX() :
+/// <param name="modem">Modem channel the instance belongs to.</param>
+DMRDMORX::DMRDMORX(sdr::Modem* modem) :
+    ModemContext(modem),
     m_bitBuffer(),
     m_buffer(),
     m_bitPtr(0U),
@@ -101,11 +103,11 @@ void DMRDMORX::reset()
 /// <param name="samples"></param>
 /// <param name="rssi"></param>
 /// <param name="length"></param>
-void DMRDMORX::samples(const q15_t* samples, const uint16_t* rssi, uint8_t length)
+void DMRDMORX::samples(const q15_t* samples, const uint16_t* rssi, uint16_t length)
 {
     bool dcd = false;
 
-    for (uint8_t i = 0U; i < length; i++)
+    for (uint16_t i = 0U; i < length; i++)
         dcd = processSample(samples[i], rssi[i]);
 
     io.setDecode(dcd);
@@ -31,6 +31,7 @@
 #define __DMR_DMO_RX_H__
 
 #include "Defines.h"
+#include "ModemContext.h"
 #include "dmr/DMRDefines.h"
 
 namespace dmr
@@ -52,16 +53,16 @@ namespace dmr
     //      Implements receiver logic for DMR DMO mode operation.
     // ---------------------------------------------------------------------------
 
-    class DSP_FW_API DMRDMORX {
+    class DSP_FW_API DMRDMORX : public ModemContext {
     public:
         /// <summary>Initializes a new instance of the DMRDMORX class.</summary>
-        DMRDMORX();
+        DMRDMORX(sdr::Modem* modem = NULL);
 
         /// <summary>Helper to reset data values to defaults.</summary>
         void reset();
 
         /// <summary>Sample DMR values from the air interface.</summary>
-        void samples(const q15_t* samples, const uint16_t* rssi, uint8_t length);
+        void samples(const q15_t* samples, const uint16_t* rssi, uint16_t length);
 
         /// <summary>Sets the DMR color code.</summary>
         void setColorCode(uint8_t colorCode);
@@ -33,6 +33,8 @@
 #define __DMR_DMO_TX_H__
 
 #include "Defines.h"
+#include "ModemContext.h"
+#include "FirQ15.h"
 #include "dmr/DMRDefines.h"
 #include "SerialBuffer.h"
 
@@ -50,10 +52,10 @@ namespace dmr
     //      Implements transmitter logic for DMR DMO mode operation.
     // ---------------------------------------------------------------------------
 
-    class DSP_FW_API DMRDMOTX {
+    class DSP_FW_API DMRDMOTX : public ModemContext {
     public:
         /// <summary>Initializes a new instance of the DMRDMOTX class.</summary>
-        DMRDMOTX();
+        DMRDMOTX(sdr::Modem* modem = NULL);
 
         /// <summary>Process local buffer and transmit on the air interface.</summary>
         void process();
@@ -72,9 +74,8 @@ namespace dmr
     private:
         SerialBuffer m_fifo;
 
-        arm_fir_interpolate_instance_q15 m_modFilter;
+        FirInterpolateQ15<DMR_RADIO_SYMBOL_LENGTH, RRC_0_2_FILTER_PHASE_LEN, TX_BYTE_BLOCK_MAX * 4U> m_modFilter;
 
-        q15_t m_modState[16U];    // blockSize + phaseLength - 1, 4 + 9 - 1 plus some spare
 
         uint8_t m_poBuffer[1200U];
         uint16_t m_poLen;
@@ -86,7 +87,7 @@ namespace dmr
         int8_t m_symLevel1Adj;
 
         /// <summary></summary>
-        void writeByte(uint8_t c);
+        void writeBytes(const uint8_t* data, uint16_t count);
         /// <summary></summary>
         void writeSilence();
     };
@@ -40,6 +40,8 @@ namespace dmr
 
     const uint32_t  DMR_RADIO_SYMBOL_LENGTH = 5U;      // At 24 kHz sample rate
 
+    const uint16_t  RRC_0_2_FILTER_PHASE_LEN = 9U;     // Tx shaping filter phaseLength = numTaps/L
+
     const uint32_t  DMR_FRAME_LENGTH_BYTES = 33U;
     const uint32_t  DMR_FRAME_LENGTH_BITS = DMR_FRAME_LENGTH_BYTES * 8U;
     const uint32_t  DMR_FRAME_LENGTH_SYMBOLS = DMR_FRAME_LENGTH_BYTES * 4U;
@@ -55,7 +55,9 @@ const uint8_t CONTROL_DATA = 0x40U;
 /// <summary>
 /// Initializes a new instance of the DMRIdleRX class.
 /// </summary>
-DMRIdleRX::DMRIdleRX() :
+/// <param name="modem">Modem channel the instance belongs to.</param>
+DMRIdleRX::DMRIdleRX(sdr::Modem* modem) :
+    ModemContext(modem),
     m_bitBuffer(),
     m_buffer(),
     m_bitPtr(0U),
@@ -87,9 +89,9 @@ void DMRIdleRX::reset()
 /// </summary>
 /// <param name="samples"></param>
 /// <param name="length"></param>
-void DMRIdleRX::samples(const q15_t* samples, uint8_t length)
+void DMRIdleRX::samples(const q15_t* samples, uint16_t length)
 {
-    for (uint8_t i = 0U; i < length; i++)
+    for (uint16_t i = 0U; i < length; i++)
         processSample(samples[i]);
 }
 
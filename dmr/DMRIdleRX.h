@@ -31,6 +31,7 @@
 #define __DMR_IDLE_RX_H__
 
 #include "Defines.h"
+#include "ModemContext.h"
 #include "dmr/DMRDefines.h"
 
 namespace dmr
@@ -40,16 +41,16 @@ namespace dmr
     //      Implements receiver logic for idle DMR mode operation.
     // ---------------------------------------------------------------------------
 
-    class DSP_FW_API DMRIdleRX {
+    class DSP_FW_API DMRIdleRX : public ModemContext {
     public:
         /// <summary>Initializes a new instance of the DMRIdleRX class.</summary>
-        DMRIdleRX();
+        DMRIdleRX(sdr::Modem* modem = NULL);
 
         /// <summary>Helper to reset data values to defaults.</summary>
         void reset();
 
         /// <summary>Sample DMR values from the air interface.</summary>
-        void samples(const q15_t* samples, uint8_t length);
+        void samples(const q15_t* samples, uint16_t length);
 
         /// <summary>Sets the DMR color code.</summary>
         void setColorCode(uint8_t colorCode);
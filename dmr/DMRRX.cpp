@@ -39,9 +39,11 @@ using namespace dmr;
 /// <summary>
 /// Initializes a new instance of the DMRRX class.
 /// </summary>
-DMRRX::DMRRX() :
-    m_slot1RX(false),
-    m_slot2RX(true)
+/// <param name="modem">Modem channel the instance belongs to.</param>
+DMRRX::DMRRX(sdr::Modem* modem) :
+    ModemContext(modem),
+    m_slot1RX(false, modem),
+    m_slot2RX(true, modem)
 {
     /* stub */
 }
@@ -62,7 +64,7 @@ void DMRRX::reset()
 /// <param name="rssi"></param>
 /// <param name="control"></param>
 /// <param name="length"></param>
-void DMRRX::samples(const q15_t* samples, const uint16_t* rssi, const uint8_t* control, uint8_t length)
+void DMRRX::samples(const q15_t* samples, const uint16_t* rssi, const uint8_t* control, uint16_t length)
 {
     bool dcd1 = false;
     bool dcd2 = false;
@@ -31,6 +31,7 @@
 #define __DMR_RX_H__
 
 #include "Defines.h"
+#include "ModemContext.h"
 #include "dmr/DMRSlotRX.h"
 
 namespace dmr
@@ -40,16 +41,16 @@ namespace dmr
     //      Implements receiver logic for duplex DMR mode operation.
     // ---------------------------------------------------------------------------
 
-    class DSP_FW_API DMRRX {
+    class DSP_FW_API DMRRX : public ModemContext {
     public:
         /// <summary>Initializes a new instance of the DMRRX class.</summary>
-        DMRRX();
+        DMRRX(sdr::Modem* modem = NULL);
 
         /// <summary>Helper to reset data values to defaults.</summary>
         void reset();
 
         /// <summary>Sample DMR values from the air interface.</summary>
-        void samples(const q15_t* samples, const uint16_t* rssi, const uint8_t* control, uint8_t length);
+        void samples(const q15_t* samples, const uint16_t* rssi, const uint8_t* control, uint16_t length);
 
         /// <summary>Sets the DMR color code.</summary>
         void setColorCode(uint8_t colorCode);
@@ -61,7 +61,10 @@ const uint8_t CONTROL_DATA = 0x40U;
 /// <summary>
 /// Initializes a new instance of the DMRSlotRX class.
 /// </summary>
-DMRSlotRX::DMRSlotRX(bool slot) :
+/// <param name="slot"></param>
+/// <param name="modem">Modem channel the instance belongs to.</param>
+DMRSlotRX::DMRSlotRX(bool slot, sdr::Modem* modem) :
+    ModemContext(modem),
     m_slot(slot),
     m_bitBuffer(),
     m_buffer(),
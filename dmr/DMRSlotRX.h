@@ -31,6 +31,7 @@
 #define __DMR_SLOT_RX_H__
 
 #include "Defines.h"
+#include "ModemContext.h"
 #include "dmr/DMRDefines.h"
 
 namespace dmr
@@ -50,10 +51,10 @@ namespace dmr
     //      Implements receiver logic for DMR slots.
     // ---------------------------------------------------------------------------
 
-    class DSP_FW_API DMRSlotRX {
+    class DSP_FW_API DMRSlotRX : public ModemContext {
     public:
         /// <summary>Initializes a new instance of the DMRSlotRX class.</summary>
-        DMRSlotRX(bool slot);
+        DMRSlotRX(bool slot, sdr::Modem* modem = NULL);
 
         /// <summary>Helper to set data values for start of Rx.</summary>
         void start();
@@ -45,7 +45,6 @@ static q15_t RRC_0_2_FILTER[] = {
     -5735, -1633, 5651, 14822, 23810, 30367, 32767, 30367, 23810, 14822, 5651, -1633, -5735, -6442,
     -4544, -1431, 1447, 3073, 3120, 1927, 237, -1172, -1795, -1548, -720, 219, 850 
 }; // numTaps = 45, L = 5
-const uint16_t RRC_0_2_FILTER_PHASE_LEN = 9U; // phaseLength = numTaps/L
 
 const q15_t DMR_LEVELA = 1362;
 const q15_t DMR_LEVELB = 454;
@@ -80,10 +79,11 @@ const uint32_t ABORT_COUNT = 6U;
 /// <summary>
 /// Initializes a new instance of the DMRTX class.
 /// </summary>
-DMRTX::DMRTX() :
+/// <param name="modem">Modem channel the instance belongs to.</param>
+DMRTX::DMRTX(sdr::Modem* modem) :
+    ModemContext(modem),
     m_fifo(),
-    m_modFilter(),
-    m_modState(),
+    m_modFilter(RRC_0_2_FILTER),
     m_state(DMRTXSTATE_IDLE),
     m_idle(),
     m_cachPtr(0U),
@@ -103,13 +103,6 @@ DMRTX::DMRTX() :
     m_fifo[0U].reinitialize(DMR_TX_BUFFER_LEN);
     m_fifo[1U].reinitialize(DMR_TX_BUFFER_LEN);
 
-    ::memset(m_modState, 0x00U, 16U * sizeof(q15_t));
-
-    m_modFilter.L = DMR_RADIO_SYMBOL_LENGTH;
-    m_modFilter.phaseLength = RRC_0_2_FILTER_PHASE_LEN;
-    m_modFilter.pCoeffs = RRC_0_2_FILTER;
-    m_modFilter.pState = m_modState;
-
     ::memcpy(m_newShortLC, EMPTY_SHORT_LC, 12U);
     ::memcpy(m_shortLC, EMPTY_SHORT_LC, 12U);
 
@@ -166,13 +159,17 @@ void DMRTX::process()
         uint16_t space = io.getSpace();
 
         while (space > (4U * DMR_RADIO_SYMBOL_LENGTH)) {
-            uint8_t c = m_poBuffer[m_poPtr];
-            uint8_t m = m_markBuffer[m_poPtr];
-            m_poPtr++;
+            // as many bytes as the Tx buffer has room for
+            uint16_t count = (space - 1U) / (4U * DMR_RADIO_SYMBOL_LENGTH);
+            if (count > TX_BYTE_BLOCK_MAX)
+                count = TX_BYTE_BLOCK_MAX;
+            if (count > (m_poLen - m_poPtr))
+                count = m_poLen - m_poPtr;
 
-            writeByte(c, m);
+            writeBytes(m_poBuffer + m_poPtr, m_markBuffer + m_poPtr, count);
+            m_poPtr += count;
 
-            space -= 4U * DMR_RADIO_SYMBOL_LENGTH;
+            space -= count * 4U * DMR_RADIO_SYMBOL_LENGTH;
 
             if (m_poPtr >= m_poLen) {
                 m_poPtr = 0U;
@@ -545,37 +542,42 @@ void DMRTX::createCACH(uint8_t txSlotIndex, uint8_t rxSlotIndex)
 /// <summary>
 ///
 /// </summary>
-/// <param name="c"></param>
+/// <param name="data"></param>
 /// <param name="control"></param>
-void DMRTX::writeByte(uint8_t c, uint8_t control)
+/// <param name="count"></param>
+void DMRTX::writeBytes(const uint8_t* data, const uint8_t* control, uint16_t count)
 {
-    q15_t inBuffer[4U];
-    q15_t outBuffer[DMR_RADIO_SYMBOL_LENGTH * 4U];
+    q15_t inBuffer[TX_BYTE_BLOCK_MAX * 4U];
+    q15_t outBuffer[TX_BYTE_BLOCK_MAX * DMR_RADIO_SYMBOL_LENGTH * 4U];
 
     const uint8_t MASK = 0xC0U;
 
-    for (uint8_t i = 0U; i < 4U; i++, c <<= 2) {
-        switch (c & MASK) {
-        case 0xC0U:
-            inBuffer[i] = (DMR_LEVELA + m_symLevel3Adj); // +3
-            break;
-        case 0x80U:
-            inBuffer[i] = (DMR_LEVELB + m_symLevel1Adj); // +1
-            break;
-        case 0x00U:
-            inBuffer[i] = (DMR_LEVELC + -m_symLevel1Adj); // -1
-            break;
-        default: // 0x40U
-            inBuffer[i] = (DMR_LEVELD + -m_symLevel3Adj); // -3
-            break;
+    for (uint16_t n = 0U; n < count; n++) {
+        uint8_t c = data[n];
+        for (uint8_t i = 0U; i < 4U; i++, c <<= 2) {
+            switch (c & MASK) {
+            case 0xC0U:
+                inBuffer[(n * 4U) + i] = (DMR_LEVELA + m_symLevel3Adj); // +3
+                break;
+            case 0x80U:
+                inBuffer[(n * 4U) + i] = (DMR_LEVELB + m_symLevel1Adj); // +1
+                break;
+            case 0x00U:
+                inBuffer[(n * 4U) + i] = (DMR_LEVELC + -m_symLevel1Adj); // -1
+                break;
+            default: // 0x40U
+                inBuffer[(n * 4U) + i] = (DMR_LEVELD + -m_symLevel3Adj); // -3
+                break;
+            }
         }
     }
 
-    uint8_t controlBuffer[DMR_RADIO_SYMBOL_LENGTH * 4U];
-    ::memset(controlBuffer, MARK_NONE, DMR_RADIO_SYMBOL_LENGTH * 4U * sizeof(uint8_t));
-    controlBuffer[DMR_RADIO_SYMBOL_LENGTH * 2U] = control;
+    uint8_t controlBuffer[TX_BYTE_BLOCK_MAX * DMR_RADIO_SYMBOL_LENGTH * 4U];
+    ::memset(controlBuffer, MARK_NONE, count * DMR_RADIO_SYMBOL_LENGTH * 4U * sizeof(uint8_t));
+    for (uint16_t n = 0U; n < count; n++)
+        controlBuffer[(n * DMR_RADIO_SYMBOL_LENGTH * 4U) + (DMR_RADIO_SYMBOL_LENGTH * 2U)] = control[n];
 
-    ::arm_fir_interpolate_q15(&m_modFilter, inBuffer, outBuffer, 4U);
+    m_modFilter.process(inBuffer, outBuffer, count * 4U);
 
-    io.write(STATE_DMR, outBuffer, DMR_RADIO_SYMBOL_LENGTH * 4U, controlBuffer);
+    io.write(STATE_DMR, outBuffer, count * DMR_RADIO_SYMBOL_LENGTH * 4U, controlBuffer);
 }
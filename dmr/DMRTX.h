@@ -33,6 +33,8 @@
 #define __DMR_TX_H__
 
 #include "Defines.h"
+#include "ModemContext.h"
+#include "FirQ15.h"
 #include "dmr/DMRDefines.h"
 #include "SerialBuffer.h"
 
@@ -56,10 +58,10 @@ namespace dmr
     //      Implements receiver logic for duplex DMR mode operation.
     // ---------------------------------------------------------------------------
 
-    class DSP_FW_API DMRTX {
+    class DSP_FW_API DMRTX : public ModemContext {
     public:
         /// <summary>Initializes a new instance of the DMRTX class.</summary>
-        DMRTX();
+        DMRTX(sdr::Modem* modem = NULL);
 
         /// <summary>Process local buffer and transmit on the air interface.</summary>
         void process();
@@ -101,9 +103,8 @@ namespace dmr
     private:
         SerialBuffer m_fifo[2U];
 
-        arm_fir_interpolate_instance_q15 m_modFilter;
+        FirInterpolateQ15<DMR_RADIO_SYMBOL_LENGTH, RRC_0_2_FILTER_PHASE_LEN, TX_BYTE_BLOCK_MAX * 4U> m_modFilter;
 
-        q15_t m_modState[16U];    // blockSize + phaseLength - 1, 4 + 9 - 1 plus some spare
 
         DMRTXSTATE m_state;
 
@@ -137,7 +138,7 @@ namespace dmr
         void createCal();
 
         /// <summary></summary>
-        void writeByte(uint8_t c, uint8_t control);
+        void writeBytes(const uint8_t* data, const uint8_t* control, uint16_t count);
     };
 } // namespace dmr
 
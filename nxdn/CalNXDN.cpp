@@ -75,7 +75,9 @@ const uint8_t NXDN_CAL1K[4][49] = {
 /// <summary>
 /// Initializes a new instance of the CalNXDN class.
 /// </summary>
-CalNXDN::CalNXDN() :
+/// <param name="modem">Modem channel the instance belongs to.</param>
+CalNXDN::CalNXDN(sdr::Modem* modem) :
+    ModemContext(modem),
     m_transmit(false),
     m_state(NXDNCAL1K_IDLE),
     m_audioSeq(0U)
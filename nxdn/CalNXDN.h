@@ -33,6 +33,7 @@
 #define __CAL_NXDN_H__
 
 #include "Defines.h"
+#include "ModemContext.h"
 #include "nxdn/NXDNDefines.h"
 
 namespace nxdn
@@ -51,10 +52,10 @@ namespace nxdn
     //      Implements logic for NXDN calibration mode.
     // ---------------------------------------------------------------------------
 
-    class DSP_FW_API CalNXDN {
+    class DSP_FW_API CalNXDN : public ModemContext {
     public:
         /// <summary>Initializes a new instance of the CalNXDN class.</summary>
-        CalNXDN();
+        CalNXDN(sdr::Modem* modem = NULL);
 
         /// <summary>Process local state and transmit on the air interface.</summary>
         void process();
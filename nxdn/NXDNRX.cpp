@@ -58,7 +58,9 @@ const uint16_t NOENDPTR = 9999U;
 /// <summary>
 /// Initializes a new instance of the NXDNRX class.
 /// </summary>
-NXDNRX::NXDNRX() :
+/// <param name="modem">Modem channel the instance belongs to.</param>
+NXDNRX::NXDNRX(sdr::Modem* modem) :
+    ModemContext(modem),
     m_bitBuffer(),
     m_buffer(),
     m_bitPtr(0U),
@@ -119,9 +121,9 @@ void NXDNRX::reset()
 /// <param name="samples"></param>
 /// <param name="rssi"></param>
 /// <param name="length"></param>
-void NXDNRX::samples(const q15_t* samples, uint16_t* rssi, uint8_t length)
+void NXDNRX::samples(const q15_t* samples, uint16_t* rssi, uint16_t length)
 {
-    for (uint8_t i = 0U; i < length; i++) {
+    for (uint16_t i = 0U; i < length; i++) {
         q15_t sample = samples[i];
 
         m_rssiAccum += rssi[i];
@@ -31,6 +31,7 @@
 #define __NXDN_RX_H__
 
 #include "Defines.h"
+#include "ModemContext.h"
 #include "nxdn/NXDNDefines.h"
 
 namespace nxdn
@@ -49,16 +50,16 @@ namespace nxdn
     //      Implements receiver logic for DMR slots.
     // ---------------------------------------------------------------------------
 
-    class DSP_FW_API NXDNRX {
+    class DSP_FW_API NXDNRX : public ModemContext {
     public:
         /// <summary>Initializes a new instance of the NXDNRX class.</summary>
-        NXDNRX();
+        NXDNRX(sdr::Modem* modem = NULL);
 
         /// <summary>Helper to reset data values to defaults.</summary>
         void reset();
 
         /// <summary>Sample NXDN values from the air interface.</summary>
-        void samples(const q15_t* samples, uint16_t* rssi, uint8_t length);
+        void samples(const q15_t* samples, uint16_t* rssi, uint16_t length);
 
         /// <summary>Sets the NXDN sync correlation countdown.</summary>
         void setCorrCount(uint8_t count);
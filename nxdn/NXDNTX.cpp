@@ -57,13 +57,11 @@ static q15_t RRC_0_2_FILTER[] = {
     -1597, -1795, -1769, -1548, -1179, -720, -234, 219, 592, 850
 }; // numTaps = 90, L = 10
 #endif
-const uint16_t RRC_0_2_FILTER_PHASE_LEN = 9U; // phaseLength = numTaps/L
 
 static q15_t NXDN_SINC_FILTER[] = { 
     572, -1003, -253, 254, 740, 1290, 1902, 2527, 3090, 3517, 3747, 3747, 3517, 3090, 2527, 1902,
     1290, 740, 254, -253, -1003, 572
 };
-const uint16_t NXDN_SINC_FILTER_LEN = 22U;
 
 #if defined(NXDN_9600_BAUD)
 const q15_t NXDN_LEVELA =  1680;
@@ -84,13 +82,13 @@ const q15_t NXDN_LEVELD = -735;
 /// <summary>
 /// Initializes a new instance of the NXDNTX class.
 /// </summary>
-NXDNTX::NXDNTX() :
+/// <param name="modem">Modem channel the instance belongs to.</param>
+NXDNTX::NXDNTX(sdr::Modem* modem) :
+    ModemContext(modem),
     m_fifo(NXDN_TX_BUFFER_LEN),
     m_state(NXDNTXSTATE_NORMAL),
-    m_modFilter(),
-    m_sincFilter(),
-    m_modState(),
-    m_sincState(),
+    m_modFilter(RRC_0_2_FILTER),
+    m_sincFilter(NXDN_SINC_FILTER),
     m_poBuffer(),
     m_poLen(0U),
     m_poPtr(0U),
@@ -100,17 +98,7 @@ NXDNTX::NXDNTX() :
     m_symLevel3Adj(0U),
     m_symLevel1Adj(0U)
 {
-    ::memset(m_modState, 0x00U, 16U * sizeof(q15_t));
-    ::memset(m_sincState,  0x00U, 70U * sizeof(q15_t));
-
-    m_modFilter.L = NXDN_RADIO_SYMBOL_LENGTH;
-    m_modFilter.phaseLength = RRC_0_2_FILTER_PHASE_LEN;
-    m_modFilter.pCoeffs = RRC_0_2_FILTER;
-    m_modFilter.pState = m_modState;
-
-    m_sincFilter.numTaps = NXDN_SINC_FILTER_LEN;
-    m_sincFilter.pState = m_sincState;
-    m_sincFilter.pCoeffs = NXDN_SINC_FILTER;
+    /* stub */
 }
 
 /// <summary>
@@ -124,10 +112,16 @@ void NXDNTX::process()
         uint16_t space = io.getSpace();
 
         while (space > (4U * NXDN_RADIO_SYMBOL_LENGTH)) {
-            writeSilence();
+            uint16_t count = (space - 1U) / (4U * NXDN_RADIO_SYMBOL_LENGTH);
+            if (count > TX_BYTE_BLOCK_MAX)
+                count = TX_BYTE_BLOCK_MAX;
+            if (count > m_tailCnt)
+                count = m_tailCnt;
+
+            writeSilence(count);
 
-            space -= 4U * NXDN_RADIO_SYMBOL_LENGTH;
-            m_tailCnt--;
+            space -= count * 4U * NXDN_RADIO_SYMBOL_LENGTH;
+            m_tailCnt -= count;
 
             if (m_tailCnt == 0U)
                 return;
@@ -161,11 +155,17 @@ void NXDNTX::process()
         uint16_t space = io.getSpace();
 
         while (space > (4U * NXDN_RADIO_SYMBOL_LENGTH)) {
-            uint8_t c = m_poBuffer[m_poPtr++];
+            // as many bytes as the Tx buffer has room for
+            uint16_t count = (space - 1U) / (4U * NXDN_RADIO_SYMBOL_LENGTH);
+            if (count > TX_BYTE_BLOCK_MAX)
+                count = TX_BYTE_BLOCK_MAX;
+            if (count > (m_poLen - m_poPtr))
+                count = m_poLen - m_poPtr;
 
-            writeByte(c);
+            writeBytes(m_poBuffer + m_poPtr, count);
+            m_poPtr += count;
 
-            space -= 4U * NXDN_RADIO_SYMBOL_LENGTH;
+            space -= count * 4U * NXDN_RADIO_SYMBOL_LENGTH;
             m_tailCnt = m_txHang;
 
             if (m_poPtr >= m_poLen) {
@@ -299,51 +299,57 @@ void NXDNTX::createData()
 /// <summary>
 ///
 /// </summary>
-/// <param name="c"></param>
-void NXDNTX::writeByte(uint8_t c)
+/// <param name="data"></param>
+/// <param name="count"></param>
+void NXDNTX::writeBytes(const uint8_t* data, uint16_t count)
 {
-    q15_t inBuffer[4U];
-    q15_t intBuffer[NXDN_RADIO_SYMBOL_LENGTH * 4U];
-    q15_t outBuffer[NXDN_RADIO_SYMBOL_LENGTH * 4U];
+    q15_t inBuffer[TX_BYTE_BLOCK_MAX * 4U];
+    q15_t intBuffer[TX_BYTE_BLOCK_MAX * NXDN_RADIO_SYMBOL_LENGTH * 4U];
+    q15_t outBuffer[TX_BYTE_BLOCK_MAX * NXDN_RADIO_SYMBOL_LENGTH * 4U];
 
     const uint8_t MASK = 0xC0U;
 
-    for (uint8_t i = 0U; i < 4U; i++, c <<= 2) {
-        switch (c & MASK) {
-        case 0xC0U:
-            inBuffer[i] = (NXDN_LEVELA + m_symLevel3Adj); // +3
-            break;
-        case 0x80U:
-            inBuffer[i] = (NXDN_LEVELB + m_symLevel1Adj); // +1
-            break;
-        case 0x00U:
-            inBuffer[i] = (NXDN_LEVELC + -m_symLevel1Adj); // -1
-            break;
-        default: // 0x40U
-            inBuffer[i] = (NXDN_LEVELD + -m_symLevel3Adj); // -3
-            break;
+    for (uint16_t n = 0U; n < count; n++) {
+        uint8_t c = data[n];
+        for (uint8_t i = 0U; i < 4U; i++, c <<= 2) {
+            switch (c & MASK) {
+            case 0xC0U:
+                inBuffer[(n * 4U) + i] = (NXDN_LEVELA + m_symLevel3Adj); // +3
+                break;
+            case 0x80U:
+                inBuffer[(n * 4U) + i] = (NXDN_LEVELB + m_symLevel1Adj); // +1
+                break;
+            case 0x00U:
+                inBuffer[(n * 4U) + i] = (NXDN_LEVELC + -m_symLevel1Adj); // -1
+                break;
+            default: // 0x40U
+                inBuffer[(n * 4U) + i] = (NXDN_LEVELD + -m_symLevel3Adj); // -3
+                break;
+            }
         }
     }
 
-    ::arm_fir_interpolate_q15(&m_modFilter, inBuffer, intBuffer, 4U);
+    m_modFilter.process(inBuffer, intBuffer, count * 4U);
 
-    ::arm_fir_fast_q15(&m_sincFilter, intBuffer, outBuffer, NXDN_RADIO_SYMBOL_LENGTH * 4U);
+    m_sincFilter.process(intBuffer, outBuffer, count * NXDN_RADIO_SYMBOL_LENGTH * 4U);
 
-    io.write(STATE_NXDN, outBuffer, NXDN_RADIO_SYMBOL_LENGTH * 4U);
+    io.write(STATE_NXDN, outBuffer, count * NXDN_RADIO_SYMBOL_LENGTH * 4U);
 }
 
 /// <summary>
 ///
 /// </summary>
-void NXDNTX::writeSilence()
+/// <param name="count"></param>
+void NXDNTX::writeSilence(uint16_t count)
 {
-    q15_t inBuffer[4U] = {0x00U, 0x00U, 0x00U, 0x00U};
-    q15_t intBuffer[NXDN_RADIO_SYMBOL_LENGTH * 4U];
-    q15_t outBuffer[NXDN_RADIO_SYMBOL_LENGTH * 4U];
+    q15_t inBuffer[TX_BYTE_BLOCK_MAX * 4U];
+    q15_t intBuffer[TX_BYTE_BLOCK_MAX * NXDN_RADIO_SYMBOL_LENGTH * 4U];
+    q15_t outBuffer[TX_BYTE_BLOCK_MAX * NXDN_RADIO_SYMBOL_LENGTH * 4U];
+    ::memset(inBuffer, 0x00U, count * 4U * sizeof(q15_t));
 
-    ::arm_fir_interpolate_q15(&m_modFilter, inBuffer, intBuffer, 4U);
+    m_modFilter.process(inBuffer, intBuffer, count * 4U);
 
-    ::arm_fir_fast_q15(&m_sincFilter, intBuffer, outBuffer, NXDN_RADIO_SYMBOL_LENGTH * 4U);
+    m_sincFilter.process(intBuffer, outBuffer, count * NXDN_RADIO_SYMBOL_LENGTH * 4U);
 
-    io.write(STATE_NXDN, outBuffer, NXDN_RADIO_SYMBOL_LENGTH * 4U);
+    io.write(STATE_NXDN, outBuffer, count * NXDN_RADIO_SYMBOL_LENGTH * 4U);
 }
@@ -33,7 +33,10 @@
 #define __NXDN_TX_H__
 
 #include "Defines.h"
+#include "ModemContext.h"
+#include "FirQ15.h"
 #include "SerialBuffer.h"
+#include "nxdn/NXDNDefines.h"
 
 namespace nxdn
 {
@@ -43,6 +46,9 @@ namespace nxdn
 
     #define NXDN_FIXED_TX_HANG 600
 
+    const uint16_t RRC_0_2_FILTER_PHASE_LEN = 9U; // phaseLength = numTaps/L
+    const uint16_t NXDN_SINC_FILTER_LEN = 22U;
+
     enum NXDNTXSTATE {
         NXDNTXSTATE_NORMAL,
         NXDNTXSTATE_CAL
@@ -53,10 +59,10 @@ namespace nxdn
     //      Implements transmitter logic for NXDN mode operation.
     // ---------------------------------------------------------------------------
 
-    class DSP_FW_API NXDNTX {
+    class DSP_FW_API NXDNTX : public ModemContext {
     public:
         /// <summary>Initializes a new instance of the NXDNTX class.</summary>
-        NXDNTX();
+        NXDNTX(sdr::Modem* modem = NULL);
 
         /// <summary>Process local buffer and transmit on the air interface.</summary>
         void process();
@@ -84,11 +90,8 @@ namespace nxdn
 
         NXDNTXSTATE m_state;
 
-        arm_fir_interpolate_instance_q15 m_modFilter;
-        arm_fir_instance_q15 m_sincFilter;
-
-        q15_t m_modState[16U];  // blockSize + phaseLength - 1, 4 + 9 - 1 plus some spare
-        q15_t m_sincState[70U]; // NoTaps + BlockSize - 1, 22 + 40 - 1 plus some spare
+        FirInterpolateQ15<NXDN_RADIO_SYMBOL_LENGTH, RRC_0_2_FILTER_PHASE_LEN, TX_BYTE_BLOCK_MAX * 4U> m_modFilter;
+        FirQ15<NXDN_SINC_FILTER_LEN, TX_BYTE_BLOCK_MAX * NXDN_RADIO_SYMBOL_LENGTH * 4U> m_sincFilter;
 
         uint8_t m_poBuffer[1200U];
         uint16_t m_poLen;
@@ -105,9 +108,9 @@ namespace nxdn
         void createData();
 
         /// <summary></summary>
-        void writeByte(uint8_t c);
+        void writeBytes(const uint8_t* data, uint16_t count);
         /// <summary></summary>
-        void writeSilence();
+        void writeSilence(uint16_t count);
     };
 } // namespace nxdn
 
@@ -73,7 +73,9 @@ unsigned char LDU2_1K[] = { 0x00,
 /// <summary>
 /// Initializes a new instance of the CalP25 class.
 /// </summary>
-CalP25::CalP25() :
+/// <param name="modem">Modem channel the instance belongs to.</param>
+CalP25::CalP25(sdr::Modem* modem) :
+    ModemContext(modem),
     m_transmit(false),
     m_state(P25CAL1K_IDLE)
 {
@@ -31,6 +31,7 @@
 #define __CAL_P25_H__
 
 #include "Defines.h"
+#include "ModemContext.h"
 #include "p25/P25Defines.h"
 
 namespace p25
@@ -50,10 +51,10 @@ namespace p25
     //      Implements logic for P25 calibration mode.
     // ---------------------------------------------------------------------------
 
-    class DSP_FW_API CalP25 {
+    class DSP_FW_API CalP25 : public ModemContext {
     public:
         /// <summary>Initializes a new instance of the CalP25 class.</summary>
-        CalP25();
+        CalP25(sdr::Modem* modem = NULL);
 
         /// <summary>Process local state and transmit on the air interface.</summary>
         void process();
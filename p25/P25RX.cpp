@@ -58,7 +58,9 @@ const uint8_t NOAVEPTR = 99U;
 /// <summary>
 /// Initializes a new instance of the P25RX class.
 /// </summary>
-P25RX::P25RX() :
+/// <param name="modem">Modem channel the instance belongs to.</param>
+P25RX::P25RX(sdr::Modem* modem) :
+    ModemContext(modem),
     m_bitBuffer(),
     m_buffer(),
     m_bitPtr(0U),
@@ -120,9 +122,9 @@ void P25RX::reset()
 /// <param name="samples"></param>
 /// <param name="rssi"></param>
 /// <param name="length"></param>
-void P25RX::samples(const q15_t* samples, uint16_t* rssi, uint8_t length)
+void P25RX::samples(const q15_t* samples, uint16_t* rssi, uint16_t length)
 {
-    for (uint8_t i = 0U; i < length; i++) {
+    for (uint16_t i = 0U; i < length; i++) {
         q15_t sample = samples[i];
 
         m_rssiAccum += rssi[i];
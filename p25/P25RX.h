@@ -32,6 +32,7 @@
 #define __P25_RX_H__
 
 #include "Defines.h"
+#include "ModemContext.h"
 #include "p25/P25Defines.h"
 
 namespace p25
@@ -52,16 +53,16 @@ namespace p25
     //      Implements receiver logic for P25 mode operation.
     // ---------------------------------------------------------------------------
 
-    class DSP_FW_API P25RX {
+    class DSP_FW_API P25RX : public ModemContext {
     public:
         /// <summary>Initializes a new instance of the P25RX class.</summary>
-        P25RX();
+        P25RX(sdr::Modem* modem = NULL);
 
         /// <summary>Helper to reset data values to defaults.</summary>
         void reset();
 
         /// <summary>Sample P25 values from the air interface.</summary>
-        void samples(const q15_t* samples, uint16_t* rssi, uint8_t length);
+        void samples(const q15_t* samples, uint16_t* rssi, uint16_t length);
 
         /// <summary>Sets the P25 NAC.</summary>
         void setNAC(uint16_t nac);
@@ -45,7 +45,6 @@ static q15_t RC_0_2_FILTER[] = {
     0, 7482, 16311, 24651, 30607, 32767, 30607, 24651, 16311, 7482, 0, -4839, -6580, -5627,
     -3011, 0, 2315, 3310, 2936, 1613, 0, -1278, -1840, -1636, -897, 0
 }; // numTaps = 40, L = 5
-const uint16_t RC_0_2_FILTER_PHASE_LEN = 8U; // phaseLength = numTaps/L
 
 // Generated in MATLAB using the following commands, and then normalised for unity gain
 // shape2 = 'Inverse-sinc Lowpass';
@@ -56,7 +55,6 @@ static q15_t LOWPASS_FILTER[] = {
     8556, 18133, 18133, 8556, -2799, -7692, -4592, 1234, 3855, 2058, -911, -1912, -621,
     556, 1262, -682, -188, 124
 };
-const uint16_t LOWPASS_FILTER_LEN = 32U;
 
 #if defined(P25_ALTERNATE_SYM_LEVELS)
 const q15_t P25_LEVELA = 1500;
@@ -77,13 +75,13 @@ const q15_t P25_LEVELD = -1220;
 /// <summary>
 /// Initializes a new instance of the P25TX class.
 /// </summary>
-P25TX::P25TX() :
+/// <param name="modem">Modem channel the instance belongs to.</param>
+P25TX::P25TX(sdr::Modem* modem) :
+    ModemContext(modem),
     m_fifo(P25_TX_BUFFER_LEN),
     m_state(P25TXSTATE_NORMAL),
-    m_modFilter(),
-    m_lpFilter(),
-    m_modState(),
-    m_lpState(),
+    m_modFilter(RC_0_2_FILTER),
+    m_lpFilter(LOWPASS_FILTER),
     m_poBuffer(),
     m_poLen(0U),
     m_poPtr(0U),
@@ -93,17 +91,7 @@ P25TX::P25TX() :
     m_symLevel3Adj(0U),
     m_symLevel1Adj(0U)
 {
-    ::memset(m_modState, 0x00U, 16U * sizeof(q15_t));
-    ::memset(m_lpState, 0x00U, 60U * sizeof(q15_t));
-
-    m_modFilter.L = P25_RADIO_SYMBOL_LENGTH;
-    m_modFilter.phaseLength = RC_0_2_FILTER_PHASE_LEN;
-    m_modFilter.pCoeffs = RC_0_2_FILTER;
-    m_modFilter.pState = m_modState;
-
-    m_lpFilter.numTaps = LOWPASS_FILTER_LEN;
-    m_lpFilter.pState = m_lpState;
-    m_lpFilter.pCoeffs = LOWPASS_FILTER;
+    /* stub */
 }
 
 /// <summary>
@@ -117,10 +105,16 @@ void P25TX::process()
         uint16_t space = io.getSpace();
 
         while (space > (4U * P25_RADIO_SYMBOL_LENGTH)) {
-            writeSilence();
+            uint16_t count = (space - 1U) / (4U * P25_RADIO_SYMBOL_LENGTH);
+            if (count > TX_BYTE_BLOCK_MAX)
+                count = TX_BYTE_BLOCK_MAX;
+            if (count > m_tailCnt)
+                count = m_tailCnt;
 
-            space -= 4U * P25_RADIO_SYMBOL_LENGTH;
-            m_tailCnt--;
+            writeSilence(count);
+
+            space -= count * 4U * P25_RADIO_SYMBOL_LENGTH;
+            m_tailCnt -= count;
 
             if (m_tailCnt == 0U)
                 return;
@@ -157,11 +151,17 @@ void P25TX::process()
         uint16_t space = io.getSpace();
 
         while (space > (4U * P25_RADIO_SYMBOL_LENGTH)) {
-            uint8_t c = m_poBuffer[m_poPtr++];
+            // as many bytes as the Tx buffer has room for
+            uint16_t count = (space - 1U) / (4U * P25_RADIO_SYMBOL_LENGTH);
+            if (count > TX_BYTE_BLOCK_MAX)
+                count = TX_BYTE_BLOCK_MAX;
+            if (count > (m_poLen - m_poPtr))
+                count = m_poLen - m_poPtr;
 
-            writeByte(c);
+            writeBytes(m_poBuffer + m_poPtr, count);
+            m_poPtr += count;
 
-            space -= 4U * P25_RADIO_SYMBOL_LENGTH;
+            space -= count * 4U * P25_RADIO_SYMBOL_LENGTH;
             m_tailCnt = m_txHang;
 
             if (m_poPtr >= m_poLen) {
@@ -321,51 +321,57 @@ void P25TX::createCal()
 /// <summary>
 ///
 /// </summary>
-/// <param name="c"></param>
-void P25TX::writeByte(uint8_t c)
+/// <param name="data"></param>
+/// <param name="count"></param>
+void P25TX::writeBytes(const uint8_t* data, uint16_t count)
 {
-    q15_t inBuffer[4U];
-    q15_t intBuffer[P25_RADIO_SYMBOL_LENGTH * 4U];
-    q15_t outBuffer[P25_RADIO_SYMBOL_LENGTH * 4U];
+    q15_t inBuffer[TX_BYTE_BLOCK_MAX * 4U];
+    q15_t intBuffer[TX_BYTE_BLOCK_MAX * P25_RADIO_SYMBOL_LENGTH * 4U];
+    q15_t outBuffer[TX_BYTE_BLOCK_MAX * P25_RADIO_SYMBOL_LENGTH * 4U];
 
     const uint8_t MASK = 0xC0U;
 
-    for (uint8_t i = 0U; i < 4U; i++, c <<= 2) {
-        switch (c & MASK) {
-        case 0xC0U:
-            inBuffer[i] = (P25_LEVELA + m_symLevel3Adj); // +3
-            break;
-        case 0x80U:
-            inBuffer[i] = (P25_LEVELB + m_symLevel1Adj); // +1
-            break;
-        case 0x00U:
-            inBuffer[i] = (P25_LEVELC + -m_symLevel1Adj); // -1
-            break;
-        default: // 0x40U
-            inBuffer[i] = (P25_LEVELD + -m_symLevel3Adj); // -3
-            break;
+    for (uint16_t n = 0U; n < count; n++) {
+        uint8_t c = data[n];
+        for (uint8_t i = 0U; i < 4U; i++, c <<= 2) {
+            switch (c & MASK) {
+            case 0xC0U:
+                inBuffer[(n * 4U) + i] = (P25_LEVELA + m_symLevel3Adj); // +3
+                break;
+            case 0x80U:
+                inBuffer[(n * 4U) + i] = (P25_LEVELB + m_symLevel1Adj); // +1
+                break;
+            case 0x00U:
+                inBuffer[(n * 4U) + i] = (P25_LEVELC + -m_symLevel1Adj); // -1
+                break;
+            default: // 0x40U
+                inBuffer[(n * 4U) + i] = (P25_LEVELD + -m_symLevel3Adj); // -3
+                break;
+            }
         }
     }
 
-    ::arm_fir_interpolate_q15(&m_modFilter, inBuffer, intBuffer, 4U);
+    m_modFilter.process(inBuffer, intBuffer, count * 4U);
 
-    ::arm_fir_fast_q15(&m_lpFilter, intBuffer, outBuffer, P25_RADIO_SYMBOL_LENGTH * 4U);
+    m_lpFilter.process(intBuffer, outBuffer, count * P25_RADIO_SYMBOL_LENGTH * 4U);
 
-    io.write(STATE_P25, outBuffer, P25_RADIO_SYMBOL_LENGTH * 4U);
+    io.write(STATE_P25, outBuffer, count * P25_RADIO_SYMBOL_LENGTH * 4U);
 }
 
 /// <summary>
 ///
 /// </summary>
-void P25TX::writeSilence()
+/// <param name="count"></param>
+void P25TX::writeSilence(uint16_t count)
 {
-    q15_t inBuffer[4U] = { 0x00U, 0x00U, 0x00U, 0x00U };
-    q15_t intBuffer[P25_RADIO_SYMBOL_LENGTH * 4U];
-    q15_t outBuffer[P25_RADIO_SYMBOL_LENGTH * 4U];
-    
-    ::arm_fir_interpolate_q15(&m_modFilter, inBuffer, intBuffer, 4U);
-    
-    ::arm_fir_fast_q15(&m_lpFilter, intBuffer, outBuffer, P25_RADIO_SYMBOL_LENGTH * 4U);
-    
-    io.write(STATE_P25, outBuffer, P25_RADIO_SYMBOL_LENGTH * 4U);
+    q15_t inBuffer[TX_BYTE_BLOCK_MAX * 4U];
+    q15_t intBuffer[TX_BYTE_BLOCK_MAX * P25_RADIO_SYMBOL_LENGTH * 4U];
+    q15_t outBuffer[TX_BYTE_BLOCK_MAX * P25_RADIO_SYMBOL_LENGTH * 4U];
+    ::memset(inBuffer, 0x00U, count * 4U * sizeof(q15_t));
+
+    m_modFilter.process(inBuffer, intBuffer, count * 4U);
+
+    m_lpFilter.process(intBuffer, outBuffer, count * P25_RADIO_SYMBOL_LENGTH * 4U);
+
+    io.write(STATE_P25, outBuffer, count * P25_RADIO_SYMBOL_LENGTH * 4U);
 }
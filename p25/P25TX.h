@@ -32,7 +32,10 @@
 #define __P25_TX_H__
 
 #include "Defines.h"
+#include "ModemContext.h"
+#include "FirQ15.h"
 #include "SerialBuffer.h"
+#include "p25/P25Defines.h"
 
 namespace p25
 {
@@ -43,6 +46,9 @@ namespace p25
     #define P25_FIXED_DELAY 90      // 90 = 20ms
     #define P25_FIXED_TX_HANG 750   // 750 = 625ms
 
+    const uint16_t RC_0_2_FILTER_PHASE_LEN = 8U; // phaseLength = numTaps/L
+    const uint16_t LOWPASS_FILTER_LEN = 32U;
+
     enum P25TXSTATE {
         P25TXSTATE_NORMAL,
         P25TXSTATE_CAL
@@ -53,10 +59,10 @@ namespace p25
     //      Implements transmitter logic for P25 mode operation.
     // ---------------------------------------------------------------------------
 
-    class DSP_FW_API P25TX {
+    class DSP_FW_API P25TX : public ModemContext {
     public:
         /// <summary>Initializes a new instance of the P25TX class.</summary>
-        P25TX();
+        P25TX(sdr::Modem* modem = NULL);
 
         /// <summary>Process local buffer and transmit on the air interface.</summary>
         void process();
@@ -84,11 +90,8 @@ namespace p25
 
         P25TXSTATE m_state;
 
-        arm_fir_interpolate_instance_q15 m_modFilter;
-        arm_fir_instance_q15 m_lpFilter;
-
-        q15_t m_modState[16U];    // blockSize + phaseLength - 1, 4 + 9 - 1 plus some spare
-        q15_t m_lpState[60U];     // NoTaps + BlockSize - 1, 32 + 20 - 1 plus some spare
+        FirInterpolateQ15<P25_RADIO_SYMBOL_LENGTH, RC_0_2_FILTER_PHASE_LEN, TX_BYTE_BLOCK_MAX * 4U> m_modFilter;
+        FirQ15<LOWPASS_FILTER_LEN, TX_BYTE_BLOCK_MAX * P25_RADIO_SYMBOL_LENGTH * 4U> m_lpFilter;
 
         uint8_t m_poBuffer[1200U];
         uint16_t m_poLen;
@@ -107,9 +110,9 @@ namespace p25
         void createCal();
 
         /// <summary></summary>
-        void writeByte(uint8_t c);
+        void writeBytes(const uint8_t* data, uint16_t count);
         /// <summary></summary>
-        void writeSilence();
+        void writeSilence(uint16_t count);
     };
 } // namespace p25
 
@@ -0,0 +1,1802 @@
+/**
+* Digital Voice Modem - DSP Firmware
+* GPLv2 Open Source. Use is subject to license terms.
+* DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+*
+* @package DVM / DSP Firmware
+*
+*/
+/*
+*   Copyright (C) 2022 Bryan Biedenkapp N2PLL
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 2 of the License, or
+*   (at your option) any later version.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program; if not, write to the Free Software
+*   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*/
+#include "Globals.h"
+#include "FirQ15.h"
+#include "sdr/Benchmark.h"
+#include "sdr/BlackBox.h"
+#include "sdr/Channelizer.h"
+#include "sdr/DriftCompensator.h"
+#include "sdr/FMDiscriminator.h"
+#include "sdr/Resampler.h"
+#include "sdr/SampleFramePool.h"
+#include "sdr/ShmRing.h"
+#include "sdr/transport/DatagramTransport.h"
+#include "sdr/transport/FileTransport.h"
+#include "sdr/transport/LoopbackTransport.h"
+
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+
+#include <algorithm>
+#include <vector>
+
+using namespace sdr;
+using namespace sdr::transport;
+
+// ---------------------------------------------------------------------------
+//  Constants
+// ---------------------------------------------------------------------------
+
+const uint32_t RING_BENCH_SAMPLES = 20000000U;
+const uint16_t RING_BENCH_BLOCK = 64U;
+
+const uint32_t RX_BENCH_SAMPLES = 480000U;
+const uint16_t RX_BENCH_TAPS = 82U;
+
+const uint32_t FIR_BENCH_SAMPLES = 480000U;
+const uint16_t FIR_BENCH_BLOCK = 48U;
+const uint16_t FIR_BENCH_TAPS_MAX = 82U;
+
+const uint32_t INTERP_BENCH_SYMBOLS = 96000U;
+const uint16_t INTERP_BENCH_BLOCK = 96U;
+const uint8_t INTERP_BENCH_L_MAX = 10U;
+const uint16_t INTERP_BENCH_PHASE_MAX = 9U;
+
+const uint32_t FM_BENCH_SAMPLES = 240000U;
+
+const uint32_t RESAMPLE_BENCH_SECONDS = 2U;
+
+const uint32_t SHM_BENCH_WORDS = 50000000U;
+const uint32_t SHM_BENCH_BLOCK = 240U;
+
+const uint32_t DGRAM_BENCH_PACKETS = 200000U;
+const uint32_t DGRAM_BENCH_SAMPLES = 240U;
+const uint32_t DGRAM_BENCH_DROP = 97U;
+
+const uint32_t TRANSPORT_BENCH_FRAMES = 100000U;
+const uint32_t TRANSPORT_BENCH_FRAME = 720U;
+
+const uint32_t CHANNELIZER_BENCH_SECONDS = 2U;
+const uint32_t CHANNELIZER_BENCH_SPACING = 12500U;
+const uint32_t CHANNELIZER_BENCH_CHECK = 20000U;
+
+const uint32_t DRIFT_BENCH_SECONDS = 1800U;
+const uint32_t DRIFT_BENCH_BURST = 240U;
+const uint32_t DRIFT_BENCH_TARGET = 480U;
+const double DRIFT_BENCH_JITTER = 0.003;
+
+// ---------------------------------------------------------------------------
+//  Global Functions
+// ---------------------------------------------------------------------------
+
+typedef bool (*BenchmarkFn)();
+
+struct BenchmarkEntry {
+    const char* name;
+    const char* description;
+    BenchmarkFn fn;
+};
+
+/// <summary>
+/// Helper to get the current monotonic time in seconds.
+/// </summary>
+/// <returns></returns>
+static double now()
+{
+    timespec ts;
+    ::clock_gettime(CLOCK_MONOTONIC, &ts);
+    return double(ts.tv_sec) + (double(ts.tv_nsec) / 1e9);
+}
+
+struct RingBenchState {
+    SampleBuffer* samples;
+    RSSIBuffer* rssi;
+    uint32_t count;
+    uint32_t errors;
+};
+
+/// <summary>
+/// Producer side of the ring buffer benchmark; writes a known sequence.
+/// </summary>
+/// <param name="arg"></param>
+/// <returns></returns>
+static void* ringProducer(void* arg)
+{
+    RingBenchState* state = (RingBenchState*)arg;
+
+    for (uint32_t i = 0U; i < state->count; i++) {
+        while (!state->samples->put(uint16_t(i), uint8_t(i >> 16)))
+            ::sched_yield();
+        while (!state->rssi->put(uint16_t(~i)))
+            ::sched_yield();
+    }
+
+    return NULL;
+}
+
+/// <summary>
+/// Consumer side of the ring buffer benchmark; verifies the sequence arrives intact and in order.
+/// </summary>
+/// <param name="arg"></param>
+/// <returns></returns>
+static void* ringConsumer(void* arg)
+{
+    RingBenchState* state = (RingBenchState*)arg;
+
+    for (uint32_t i = 0U; i < state->count; i++) {
+        uint16_t sample, rssi;
+        uint8_t control;
+
+        while (!state->samples->get(sample, control))
+            ::sched_yield();
+        while (!state->rssi->get(rssi))
+            ::sched_yield();
+
+        if (sample != uint16_t(i) || control != uint8_t(i >> 16) || rssi != uint16_t(~i))
+            state->errors++;
+    }
+
+    return NULL;
+}
+
+/// <summary>
+/// Producer side of the block ring buffer benchmark; writes a known sequence in blocks.
+/// </summary>
+/// <param name="arg"></param>
+/// <returns></returns>
+static void* ringBlockProducer(void* arg)
+{
+    RingBenchState* state = (RingBenchState*)arg;
+
+    uint16_t samples[RING_BENCH_BLOCK], rssi[RING_BENCH_BLOCK];
+    uint8_t control[RING_BENCH_BLOCK];
+
+    uint32_t i = 0U;
+    while (i < state->count) {
+        for (uint16_t j = 0U; j < RING_BENCH_BLOCK; j++) {
+            samples[j] = uint16_t(i + j);
+            control[j] = uint8_t((i + j) >> 16);
+            rssi[j] = uint16_t(~(i + j));
+        }
+
+        uint16_t n = 0U;
+        while (n < RING_BENCH_BLOCK) {
+            uint16_t put = state->samples->putBlock(samples + n, control + n, RING_BENCH_BLOCK - n);
+            n += put;
+            if (put == 0U)
+                ::sched_yield();
+        }
+
+        n = 0U;
+        while (n < RING_BENCH_BLOCK) {
+            uint16_t put = state->rssi->putBlock(rssi + n, RING_BENCH_BLOCK - n);
+            n += put;
+            if (put == 0U)
+                ::sched_yield();
+        }
+
+        i += RING_BENCH_BLOCK;
+    }
+
+    return NULL;
+}
+
+/// <summary>
+/// Consumer side of the block ring buffer benchmark; verifies the sequence arrives intact and in order.
+/// </summary>
+/// <param name="arg"></param>
+/// <returns></returns>
+static void* ringBlockConsumer(void* arg)
+{
+    RingBenchState* state = (RingBenchState*)arg;
+
+    uint16_t samples[RING_BENCH_BLOCK], rssi[RING_BENCH_BLOCK];
+    uint8_t control[RING_BENCH_BLOCK];
+
+    uint32_t i = 0U, r = 0U;
+    while (i < state->count || r < state->count) {
+        uint16_t n = state->samples->getBlock(samples, control, RING_BENCH_BLOCK);
+        for (uint16_t j = 0U; j < n; j++, i++) {
+            if (samples[j] != uint16_t(i) || control[j] != uint8_t(i >> 16))
+                state->errors++;
+        }
+
+        uint16_t m = state->rssi->getBlock(rssi, RING_BENCH_BLOCK);
+        for (uint16_t j = 0U; j < m; j++, r++) {
+            if (rssi[j] != uint16_t(~r))
+                state->errors++;
+        }
+
+        if (n == 0U && m == 0U)
+            ::sched_yield();
+    }
+
+    return NULL;
+}
+
+/// <summary>
+/// Helper to run a ring buffer producer/consumer pair and report the results.
+/// </summary>
+/// <param name="name"></param>
+/// <param name="producerFn"></param>
+/// <param name="consumerFn"></param>
+/// <returns></returns>
+static bool runRing(const char* name, void* (*producerFn)(void*), void* (*consumerFn)(void*))
+{
+    SampleBuffer samples(RX_RINGBUFFER_SIZE);
+    RSSIBuffer rssi(RX_RINGBUFFER_SIZE);
+
+    RingBenchState state;
+    state.samples = &samples;
+    state.rssi = &rssi;
+    state.count = RING_BENCH_SAMPLES;
+    state.errors = 0U;
+
+    double start = now();
+
+    pthread_t producer, consumer;
+    ::pthread_create(&consumer, NULL, consumerFn, &state);
+    ::pthread_create(&producer, NULL, producerFn, &state);
+    ::pthread_join(producer, NULL);
+    ::pthread_join(consumer, NULL);
+
+    double elapsed = now() - start;
+
+    ::fprintf(stdout, "%s: %u samples in %.3fs, %.2f Msamples/s, errors = %u, remaining = %u\n",
+        name, state.count, elapsed, (double(state.count) / elapsed) / 1e6, state.errors, samples.getData());
+
+    return state.errors == 0U && samples.getData() == 0U && rssi.getData() == 0U;
+}
+
+/// <summary>
+/// Stress tests the Rx/Tx ring buffers with a concurrent producer and consumer and reports throughput.
+/// </summary>
+/// <returns></returns>
+static bool benchRing()
+{
+    return runRing("ring", ringProducer, ringConsumer);
+}
+
+/// <summary>
+/// Stress tests the Rx/Tx ring buffers using the block APIs and reports throughput.
+/// </summary>
+/// <returns></returns>
+static bool benchRingBlock()
+{
+    return runRing("ringblock", ringBlockProducer, ringBlockConsumer);
+}
+
+/// <summary>
+/// Helper to generate a deterministic pseudo-random 4-level signal riding on a DC offset.
+/// </summary>
+/// <param name="buffer"></param>
+/// <param name="length"></param>
+static void genSignal(q15_t* buffer, uint32_t length)
+{
+    const q15_t LEVELS[4U] = { -9000, -3000, 3000, 9000 };
+
+    uint32_t seed = 0x1234567U;
+    q15_t level = 0;
+    for (uint32_t i = 0U; i < length; i++) {
+        seed = (seed * 1103515245U) + 12345U;
+        if ((i % 5U) == 0U)
+            level = LEVELS[(seed >> 16) & 0x03U];
+
+        buffer[i] = q15_t(level + 1500 + int32_t((seed >> 20) & 0x3FFU) - 512);
+    }
+}
+
+/// <summary>
+/// Helper to run the Rx front end (DC blocker and a channel FIR) at the given block size.
+/// </summary>
+/// <param name="blockSize"></param>
+/// <param name="in"></param>
+/// <param name="out"></param>
+/// <param name="length"></param>
+static void runRxChain(uint16_t blockSize, q15_t* in, q15_t* out, uint32_t length)
+{
+    static q31_t DC_COEFFS[] = { 3367972, 0, 3367972, 0, 2140747704, 0 };
+    static q15_t TAPS[RX_BENCH_TAPS];
+    for (uint16_t i = 0U; i < RX_BENCH_TAPS; i++)
+        TAPS[i] = q15_t(((i * 7919U) % 4001U) - 2000);
+
+    q15_t firState[RX_BENCH_TAPS + RX_BLOCK_SIZE_MAX - 1U];
+    q31_t dcState[4U];
+    ::memset(dcState, 0x00U, sizeof(dcState));
+
+    arm_fir_instance_q15 fir;
+    ::arm_fir_init_q15(&fir, RX_BENCH_TAPS, TAPS, firState, RX_BLOCK_SIZE_MAX);
+
+    arm_biquad_casd_df1_inst_q31 dc;
+    dc.numStages = 1U;
+    dc.pState = dcState;
+    dc.pCoeffs = DC_COEFFS;
+    dc.postShift = 0;
+
+    for (uint32_t n = 0U; n < length; n += blockSize) {
+        q31_t q31Samples[RX_BLOCK_SIZE_MAX];
+        ::arm_q15_to_q31(in + n, q31Samples, blockSize);
+
+        q31_t dcValues[RX_BLOCK_SIZE_MAX];
+        ::arm_biquad_cascade_df1_q31(&dc, q31Samples, dcValues, blockSize);
+
+        q15_t dcSamples[RX_BLOCK_SIZE_MAX];
+        for (uint16_t j = 0U; j < blockSize; j += RX_BLOCK_SIZE) {
+            q31_t dcLevel = 0;
+            for (uint16_t i = j; i < (j + RX_BLOCK_SIZE); i++)
+                dcLevel += dcValues[i];
+            dcLevel /= RX_BLOCK_SIZE;
+
+            q15_t offset = q15_t(__SSAT((dcLevel >> 16), 16));
+            for (uint16_t i = j; i < (j + RX_BLOCK_SIZE); i++)
+                dcSamples[i] = in[n + i] - offset;
+        }
+
+        ::arm_fir_fast_q15(&fir, dcSamples, out + n, blockSize);
+    }
+}
+
+/// <summary>
+/// Verifies large Rx blocks are bit exact with the base block size and reports the per-sample cost.
+/// </summary>
+/// <returns></returns>
+static bool benchRxBlock()
+{
+    const uint16_t BLOCK_SIZES[] = { RX_BLOCK_SIZE, 48U, 240U, RX_BLOCK_SIZE_MAX };
+
+    q15_t* in = new q15_t[RX_BENCH_SAMPLES];
+    q15_t* ref = new q15_t[RX_BENCH_SAMPLES];
+    q15_t* out = new q15_t[RX_BENCH_SAMPLES];
+    genSignal(in, RX_BENCH_SAMPLES);
+
+    bool passed = true;
+    for (uint32_t b = 0U; b < (sizeof(BLOCK_SIZES) / sizeof(BLOCK_SIZES[0])); b++) {
+        double start = now();
+        runRxChain(BLOCK_SIZES[b], in, (b == 0U) ? ref : out, RX_BENCH_SAMPLES);
+        double elapsed = now() - start;
+
+        uint32_t mismatches = 0U;
+        if (b > 0U) {
+            for (uint32_t i = 0U; i < RX_BENCH_SAMPLES; i++) {
+                if (out[i] != ref[i])
+                    mismatches++;
+            }
+        }
+
+        ::fprintf(stdout, "rxblock: block = %u, %.1f ns/sample, mismatches = %u\n",
+            BLOCK_SIZES[b], (elapsed * 1e9) / double(RX_BENCH_SAMPLES), mismatches);
+        if (mismatches > 0U)
+            passed = false;
+    }
+
+    delete[] in;
+    delete[] ref;
+    delete[] out;
+    return passed;
+}
+
+/// <summary>
+/// Helper to run a FIR over the input, cycling through the given block sizes.
+/// </summary>
+/// <param name="taps"></param>
+/// <param name="numTaps"></param>
+/// <param name="blockSizes"></param>
+/// <param name="blockCount"></param>
+/// <param name="in"></param>
+/// <param name="out"></param>
+/// <param name="length"></param>
+/// <param name="fold">Flag indicating symmetric taps may be folded.</param>
+static void runFir(q15_t* taps, uint16_t numTaps, const uint16_t* blockSizes, uint32_t blockCount, q15_t* in, q15_t* out, uint32_t length,
+    bool fold = true)
+{
+    q15_t state[FIR_BENCH_TAPS_MAX + RX_BLOCK_SIZE_MAX - 1U];
+
+    arm_fir_instance_q15 fir;
+    ::arm_fir_init_q15(&fir, numTaps, taps, state, RX_BLOCK_SIZE_MAX);
+    if (!fold)
+        fir.foldLength = 0U;
+
+    uint32_t b = 0U;
+    for (uint32_t n = 0U; n < length; b++) {
+        uint32_t blockSize = std::min<uint32_t>(blockSizes[b % blockCount], length - n);
+        ::arm_fir_fast_q15(&fir, in + n, out + n, blockSize);
+        n += blockSize;
+    }
+}
+
+/// <summary>
+/// Verifies each FIR kernel the CPU supports is bit exact with the generic kernel and reports
+/// the per-sample cost at each of the Rx filter lengths.
+/// </summary>
+/// <returns></returns>
+static bool benchFir()
+{
+    const uint16_t FILTER_LENGTHS[] = { 6U, 10U, 32U, 42U, 82U };
+    // odd and short blocks exercise the output remainder and the state carried between calls
+    const uint16_t CHECK_BLOCKS[] = { FIR_BENCH_BLOCK, 1U, 7U, 2U, RX_BLOCK_SIZE_MAX, 33U, 240U, 3U };
+    const uint16_t BENCH_BLOCKS[] = { FIR_BENCH_BLOCK };
+
+    q15_t* in = new q15_t[FIR_BENCH_SAMPLES];
+    q15_t* ref = new q15_t[FIR_BENCH_SAMPLES];
+    q15_t* out = new q15_t[FIR_BENCH_SAMPLES];
+    genSignal(in, FIR_BENCH_SAMPLES);
+
+    // full scale samples and coefficients exercise the saturation and accumulator wrap
+    for (uint32_t i = 0U; i < FIR_BENCH_SAMPLES; i += 997U)
+        in[i] = ((i / 997U) & 1U) ? 32767 : -32768;
+
+    q15_t taps[FIR_BENCH_TAPS_MAX];
+    uint32_t seed = 0x7654321U;
+    for (uint16_t i = 0U; i < FIR_BENCH_TAPS_MAX; i++) {
+        seed = (seed * 1103515245U) + 12345U;
+        taps[i] = q15_t(seed >> 16);
+    }
+    taps[0U] = -32768;
+
+    ARM_FIR_KERNEL selected = ::arm_fir_get_kernel();
+    ::fprintf(stdout, "fir: selected kernel = %s\n", ::arm_fir_kernel_name(selected));
+
+    bool passed = true;
+    for (uint32_t f = 0U; f < (sizeof(FILTER_LENGTHS) / sizeof(FILTER_LENGTHS[0])); f++) {
+        uint16_t numTaps = FILTER_LENGTHS[f];
+
+        double generic = 0.0;
+        for (uint32_t k = 0U; k < ARM_FIR_KERNEL_COUNT; k++) {
+            ARM_FIR_KERNEL kernel = ARM_FIR_KERNEL(k);
+            if (!::arm_fir_set_kernel(kernel))
+                continue;
+
+            runFir(taps, numTaps, CHECK_BLOCKS, sizeof(CHECK_BLOCKS) / sizeof(CHECK_BLOCKS[0]),
+                in, (kernel == ARM_FIR_KERNEL_GENERIC) ? ref : out, FIR_BENCH_SAMPLES);
+
+            uint32_t mismatches = 0U;
+            if (kernel != ARM_FIR_KERNEL_GENERIC) {
+                for (uint32_t i = 0U; i < FIR_BENCH_SAMPLES; i++) {
+                    if (out[i] != ref[i])
+                        mismatches++;
+                }
+            }
+
+            double start = now();
+            runFir(taps, numTaps, BENCH_BLOCKS, 1U, in, out, FIR_BENCH_SAMPLES);
+            double elapsed = ((now() - start) * 1e9) / double(FIR_BENCH_SAMPLES);
+            if (kernel == ARM_FIR_KERNEL_GENERIC)
+                generic = elapsed;
+
+            ::fprintf(stdout, "fir: taps = %u, kernel = %s, %.2f ns/sample, %.1fx generic, mismatches = %u\n",
+                numTaps, ::arm_fir_kernel_name(kernel), elapsed, generic / elapsed, mismatches);
+            if (mismatches > 0U)
+                passed = false;
+        }
+    }
+
+    ::arm_fir_set_kernel(selected);
+
+    delete[] in;
+    delete[] ref;
+    delete[] out;
+    return passed;
+}
+
+/// <summary>
+/// Verifies the folded FIR is bit exact with the unfolded kernels at the shape of each symmetric
+/// filter in the tree and reports the per-sample cost of both.
+/// </summary>
+/// <returns></returns>
+static bool benchFold()
+{
+    struct FoldShape {
+        const char* name;
+        uint16_t numTaps;
+        uint16_t span;          // taps ahead of the zero padding
+    };
+
+    const FoldShape SHAPES[] = {
+        { "boxcar_5", 6U, 5U },
+        { "boxcar_10", 10U, 10U },
+        { "nxdn_sinc", 22U, 22U },
+        { "p25_lowpass", 32U, 32U },
+        { "nxdn_isinc", 32U, 32U },
+        { "rrc_0_2", 42U, 41U },
+        { "nxdn_0_2", 82U, 81U }
+    };
+    const uint16_t CHECK_BLOCKS[] = { FIR_BENCH_BLOCK, 1U, 7U, 2U, RX_BLOCK_SIZE_MAX, 33U, 240U, 3U };
+    const uint16_t BENCH_BLOCKS[] = { FIR_BENCH_BLOCK };
+
+    q15_t* in = new q15_t[FIR_BENCH_SAMPLES];
+    q15_t* ref = new q15_t[FIR_BENCH_SAMPLES];
+    q15_t* out = new q15_t[FIR_BENCH_SAMPLES];
+    genSignal(in, FIR_BENCH_SAMPLES);
+
+    // full scale samples make the mirrored sums overflow 16 bits
+    for (uint32_t i = 0U; i < FIR_BENCH_SAMPLES; i += 997U) {
+        in[i] = -32768;
+        in[i + 1U] = ((i / 997U) & 1U) ? 32767 : -32768;
+    }
+
+    ARM_FIR_KERNEL selected = ::arm_fir_get_kernel();
+
+    bool passed = true;
+    uint32_t seed = 0x3456789U;
+    for (uint32_t f = 0U; f < (sizeof(SHAPES) / sizeof(SHAPES[0])); f++) {
+        const FoldShape& shape = SHAPES[f];
+
+        q15_t taps[FIR_BENCH_TAPS_MAX];
+        ::memset(taps, 0x00U, sizeof(taps));
+        for (uint16_t i = 0U; i < ((shape.span + 1U) / 2U); i++) {
+            seed = (seed * 1103515245U) + 12345U;
+            taps[i] = taps[shape.span - 1U - i] = q15_t(seed >> 16);
+        }
+        taps[0U] = taps[shape.span - 1U] = -32768;
+
+        for (uint32_t k = 0U; k < ARM_FIR_KERNEL_COUNT; k++) {
+            ARM_FIR_KERNEL kernel = ARM_FIR_KERNEL(k);
+            if (!::arm_fir_set_kernel(kernel))
+                continue;
+
+            runFir(taps, shape.numTaps, CHECK_BLOCKS, sizeof(CHECK_BLOCKS) / sizeof(CHECK_BLOCKS[0]),
+                in, ref, FIR_BENCH_SAMPLES, false);
+            runFir(taps, shape.numTaps, CHECK_BLOCKS, sizeof(CHECK_BLOCKS) / sizeof(CHECK_BLOCKS[0]),
+                in, out, FIR_BENCH_SAMPLES, true);
+
+            uint32_t mismatches = 0U;
+            for (uint32_t i = 0U; i < FIR_BENCH_SAMPLES; i++) {
+                if (out[i] != ref[i])
+                    mismatches++;
+            }
+
+            double start = now();
+            runFir(taps, shape.numTaps, BENCH_BLOCKS, 1U, in, out, FIR_BENCH_SAMPLES, false);
+            double unfolded = ((now() - start) * 1e9) / double(FIR_BENCH_SAMPLES);
+
+            start = now();
+            runFir(taps, shape.numTaps, BENCH_BLOCKS, 1U, in, out, FIR_BENCH_SAMPLES, true);
+            double folded = ((now() - start) * 1e9) / double(FIR_BENCH_SAMPLES);
+
+            ::fprintf(stdout, "fold: %s (taps = %u), kernel = %s, %.2f ns/sample unfolded, %.2f ns/sample folded, %.2fx, mismatches = %u\n",
+                shape.name, shape.numTaps, ::arm_fir_kernel_name(kernel), unfolded, folded, unfolded / folded, mismatches);
+            if (mismatches > 0U)
+                passed = false;
+        }
+    }
+
+    ::arm_fir_set_kernel(selected);
+
+    delete[] in;
+    delete[] ref;
+    delete[] out;
+    return passed;
+}
+
+/// <summary>
+/// Helper to run a polyphase interpolator over the input, cycling through the given block sizes.
+/// </summary>
+/// <param name="taps"></param>
+/// <param name="L"></param>
+/// <param name="phaseLength"></param>
+/// <param name="blockSizes"></param>
+/// <param name="blockCount"></param>
+/// <param name="in"></param>
+/// <param name="out"></param>
+/// <param name="length"></param>
+static void runInterp(q15_t* taps, uint8_t L, uint16_t phaseLength, const uint16_t* blockSizes, uint32_t blockCount, q15_t* in, q15_t* out, uint32_t length)
+{
+    // the generic interpolator needs state room for the whole block
+    q15_t state[INTERP_BENCH_PHASE_MAX + RX_BLOCK_SIZE_MAX - 1U];
+
+    arm_fir_interpolate_instance_q15 interp;
+    ::arm_fir_interpolate_init_q15(&interp, L, L * phaseLength, taps, state, RX_BLOCK_SIZE_MAX);
+
+    uint32_t b = 0U;
+    for (uint32_t n = 0U; n < length; b++) {
+        uint32_t blockSize = std::min<uint32_t>(blockSizes[b % blockCount], length - n);
+        ::arm_fir_interpolate_q15(&interp, in + n, out + (n * L), blockSize);
+        n += blockSize;
+    }
+}
+
+/// <summary>
+/// Verifies each polyphase interpolator the CPU supports is bit exact with the generic one at the
+/// Tx modulator shapes and reports the per-output-sample cost.
+/// </summary>
+/// <returns></returns>
+static bool benchInterp()
+{
+    struct InterpShape {
+        const char* name;
+        uint8_t L;
+        uint16_t phaseLength;
+        q15_t scale;
+    };
+
+    // the P25, DMR and NXDN modulators, then a filter too hot for the 32-bit lanes
+    const InterpShape SHAPES[] = {
+        { "p25", 5U, 8U, 8000 },
+        { "dmr", 5U, 9U, 7000 },
+        { "nxdn", 10U, 9U, 7000 },
+        { "hot", 5U, 9U, 32767 }
+    };
+    const uint16_t CHECK_BLOCKS[] = { 4U, 1U, INTERP_BENCH_BLOCK, 7U, 2U, 3U, 480U };
+    const uint16_t BENCH_BLOCKS[] = { INTERP_BENCH_BLOCK };
+    const q15_t LEVELS[4U] = { -1220, -410, 410, 1220 };
+
+    q15_t* in = new q15_t[INTERP_BENCH_SYMBOLS];
+    q15_t* ref = new q15_t[INTERP_BENCH_SYMBOLS * INTERP_BENCH_L_MAX];
+    q15_t* out = new q15_t[INTERP_BENCH_SYMBOLS * INTERP_BENCH_L_MAX];
+
+    uint32_t seed = 0x2345678U;
+    for (uint32_t i = 0U; i < INTERP_BENCH_SYMBOLS; i++) {
+        seed = (seed * 1103515245U) + 12345U;
+        in[i] = LEVELS[(seed >> 16) & 0x03U];
+    }
+
+    // full scale symbols exercise the saturation
+    for (uint32_t i = 0U; i < INTERP_BENCH_SYMBOLS; i += 331U)
+        in[i] = ((i / 331U) & 1U) ? 32767 : -32768;
+
+    ARM_FIR_KERNEL selected = ::arm_fir_get_kernel();
+
+    bool passed = true;
+    for (uint32_t f = 0U; f < (sizeof(SHAPES) / sizeof(SHAPES[0])); f++) {
+        const InterpShape& shape = SHAPES[f];
+        uint32_t outLength = INTERP_BENCH_SYMBOLS * shape.L;
+
+        q15_t taps[INTERP_BENCH_L_MAX * INTERP_BENCH_PHASE_MAX];
+        for (uint16_t i = 0U; i < (shape.L * shape.phaseLength); i++) {
+            seed = (seed * 1103515245U) + 12345U;
+            taps[i] = q15_t(int32_t((seed >> 16) % (2U * uint32_t(shape.scale) + 1U)) - shape.scale);
+        }
+
+        double generic = 0.0;
+        for (uint32_t k = 0U; k < ARM_FIR_KERNEL_COUNT; k++) {
+            ARM_FIR_KERNEL kernel = ARM_FIR_KERNEL(k);
+            if (!::arm_fir_set_kernel(kernel))
+                continue;
+
+            runInterp(taps, shape.L, shape.phaseLength, CHECK_BLOCKS, sizeof(CHECK_BLOCKS) / sizeof(CHECK_BLOCKS[0]),
+                in, (kernel == ARM_FIR_KERNEL_GENERIC) ? ref : out, INTERP_BENCH_SYMBOLS);
+
+            uint32_t mismatches = 0U;
+            if (kernel != ARM_FIR_KERNEL_GENERIC) {
+                for (uint32_t i = 0U; i < outLength; i++) {
+                    if (out[i] != ref[i])
+                        mismatches++;
+                }
+            }
+
+            double start = now();
+            runInterp(taps, shape.L, shape.phaseLength, BENCH_BLOCKS, 1U, in, out, INTERP_BENCH_SYMBOLS);
+            double elapsed = ((now() - start) * 1e9) / double(outLength);
+            if (kernel == ARM_FIR_KERNEL_GENERIC)
+                generic = elapsed;
+
+            ::fprintf(stdout, "interp: %s (L = %u, phase = %u), kernel = %s, %.2f ns/sample, %.1fx generic, mismatches = %u\n",
+                shape.name, shape.L, shape.phaseLength, ::arm_fir_kernel_name(kernel), elapsed, generic / elapsed, mismatches);
+            if (mismatches > 0U)
+                passed = false;
+        }
+    }
+
+    ::arm_fir_set_kernel(selected);
+
+    delete[] in;
+    delete[] ref;
+    delete[] out;
+    return passed;
+}
+
+/// <summary>
+/// Helper to run a fixed length FIR template over the input, cycling through the given block sizes.
+/// </summary>
+/// <param name="taps"></param>
+/// <param name="blockSizes"></param>
+/// <param name="blockCount"></param>
+/// <param name="in"></param>
+/// <param name="out"></param>
+/// <param name="length"></param>
+template <uint16_t Taps>
+static void runFirQ15(q15_t* taps, const uint16_t* blockSizes, uint32_t blockCount, q15_t* in, q15_t* out, uint32_t length)
+{
+    FirQ15<Taps, RX_BLOCK_SIZE_MAX> fir(*reinterpret_cast<q15_t(*)[Taps]>(taps));
+
+    uint32_t b = 0U;
+    for (uint32_t n = 0U; n < length; b++) {
+        uint32_t blockSize = std::min<uint32_t>(blockSizes[b % blockCount], length - n);
+        fir.process(in + n, out + n, blockSize);
+        n += blockSize;
+    }
+}
+
+/// <summary>
+/// Helper to run a fixed length interpolator template over the input, cycling through the given block sizes.
+/// </summary>
+/// <param name="taps"></param>
+/// <param name="blockSizes"></param>
+/// <param name="blockCount"></param>
+/// <param name="in"></param>
+/// <param name="out"></param>
+/// <param name="length"></param>
+template <uint8_t L, uint16_t PhaseLength>
+static void runInterpQ15(q15_t* taps, const uint16_t* blockSizes, uint32_t blockCount, q15_t* in, q15_t* out, uint32_t length)
+{
+    // a block smaller than the largest checked one exercises the split into pieces
+    FirInterpolateQ15<L, PhaseLength, INTERP_BENCH_BLOCK> interp(*reinterpret_cast<q15_t(*)[L * PhaseLength]>(taps));
+
+    uint32_t b = 0U;
+    for (uint32_t n = 0U; n < length; b++) {
+        uint32_t blockSize = std::min<uint32_t>(blockSizes[b % blockCount], length - n);
+        interp.process(in + n, out + (n * L), blockSize);
+        n += blockSize;
+    }
+}
+
+/// <summary>
+/// Helper to check and time one FIR template shape against the runtime kernels.
+/// </summary>
+/// <param name="name"></param>
+/// <param name="taps"></param>
+/// <param name="in"></param>
+/// <param name="ref"></param>
+/// <param name="out"></param>
+/// <returns>True, if the template is bit exact with the runtime kernel.</returns>
+template <uint16_t Taps>
+static bool checkFirQ15(const char* name, q15_t* taps, q15_t* in, q15_t* ref, q15_t* out)
+{
+    const uint16_t CHECK_BLOCKS[] = { FIR_BENCH_BLOCK, 1U, 7U, 2U, RX_BLOCK_SIZE_MAX, 33U, 240U, 3U };
+    const uint16_t BENCH_BLOCKS[] = { FIR_BENCH_BLOCK };
+    const uint32_t CHECK_COUNT = sizeof(CHECK_BLOCKS) / sizeof(CHECK_BLOCKS[0]);
+
+    ARM_FIR_KERNEL selected = ::arm_fir_get_kernel();
+
+    bool passed = true;
+    for (uint32_t k = 0U; k < ARM_FIR_KERNEL_COUNT; k++) {
+        ARM_FIR_KERNEL kernel = ARM_FIR_KERNEL(k);
+        if ((kernel != ARM_FIR_KERNEL_GENERIC && kernel != selected) || !::arm_fir_set_kernel(kernel))
+            continue;
+
+        runFir(taps, Taps, CHECK_BLOCKS, CHECK_COUNT, in, ref, FIR_BENCH_SAMPLES, false);
+        runFirQ15<Taps>(taps, CHECK_BLOCKS, CHECK_COUNT, in, out, FIR_BENCH_SAMPLES);
+
+        uint32_t mismatches = 0U;
+        for (uint32_t i = 0U; i < FIR_BENCH_SAMPLES; i++) {
+            if (out[i] != ref[i])
+                mismatches++;
+        }
+
+        double start = now();
+        runFir(taps, Taps, BENCH_BLOCKS, 1U, in, out, FIR_BENCH_SAMPLES, false);
+        double runtime = ((now() - start) * 1e9) / double(FIR_BENCH_SAMPLES);
+
+        start = now();
+        runFirQ15<Taps>(taps, BENCH_BLOCKS, 1U, in, out, FIR_BENCH_SAMPLES);
+        double fixed = ((now() - start) * 1e9) / double(FIR_BENCH_SAMPLES);
+
+        ::fprintf(stdout, "firq15: %s (taps = %u), kernel = %s, %.2f ns/sample runtime, %.2f ns/sample template, %.2fx, mismatches = %u\n",
+            name, Taps, ::arm_fir_kernel_name(kernel), runtime, fixed, runtime / fixed, mismatches);
+        if (mismatches > 0U)
+            passed = false;
+    }
+
+    ::arm_fir_set_kernel(selected);
+    return passed;
+}
+
+/// <summary>
+/// Helper to check and time one interpolator template shape against the runtime kernels.
+/// </summary>
+/// <param name="name"></param>
+/// <param name="taps"></param>
+/// <param name="in"></param>
+/// <param name="ref"></param>
+/// <param name="out"></param>
+/// <returns>True, if the template is bit exact with the runtime kernel.</returns>
+template <uint8_t L, uint16_t PhaseLength>
+static bool checkInterpQ15(const char* name, q15_t* taps, q15_t* in, q15_t* ref, q15_t* out)
+{
+    const uint16_t CHECK_BLOCKS[] = { 4U, 1U, INTERP_BENCH_BLOCK, 7U, 2U, 3U, 480U };
+    const uint16_t BENCH_BLOCKS[] = { INTERP_BENCH_BLOCK };
+    const uint32_t CHECK_COUNT = sizeof(CHECK_BLOCKS) / sizeof(CHECK_BLOCKS[0]);
+    const uint32_t outLength = INTERP_BENCH_SYMBOLS * L;
+
+    ARM_FIR_KERNEL selected = ::arm_fir_get_kernel();
+
+    bool passed = true;
+    for (uint32_t k = 0U; k < ARM_FIR_KERNEL_COUNT; k++) {
+        ARM_FIR_KERNEL kernel = ARM_FIR_KERNEL(k);
+        if ((kernel != ARM_FIR_KERNEL_GENERIC && kernel != selected) || !::arm_fir_set_kernel(kernel))
+            continue;
+
+        runInterp(taps, L, PhaseLength, CHECK_BLOCKS, CHECK_COUNT, in, ref, INTERP_BENCH_SYMBOLS);
+        runInterpQ15<L, PhaseLength>(taps, CHECK_BLOCKS, CHECK_COUNT, in, out, INTERP_BENCH_SYMBOLS);
+
+        uint32_t mismatches = 0U;
+        for (uint32_t i = 0U; i < outLength; i++) {
+            if (out[i] != ref[i])
+                mismatches++;
+        }
+
+        double start = now();
+        runInterp(taps, L, PhaseLength, BENCH_BLOCKS, 1U, in, out, INTERP_BENCH_SYMBOLS);
+        double runtime = ((now() - start) * 1e9) / double(outLength);
+
+        start = now();
+        runInterpQ15<L, PhaseLength>(taps, BENCH_BLOCKS, 1U, in, out, INTERP_BENCH_SYMBOLS);
+        double fixed = ((now() - start) * 1e9) / double(outLength);
+
+        ::fprintf(stdout, "firq15: %s (L = %u, phase = %u), kernel = %s, %.2f ns/sample runtime, %.2f ns/sample template, %.2fx, mismatches = %u\n",
+            name, L, PhaseLength, ::arm_fir_kernel_name(kernel), runtime, fixed, runtime / fixed, mismatches);
+        if (mismatches > 0U)
+            passed = false;
+    }
+
+    ::arm_fir_set_kernel(selected);
+    return passed;
+}
+
+/// <summary>
+/// Verifies the fixed length FIR and interpolator templates are bit exact with the runtime kernels
+/// at each filter shape in the tree and reports the per-sample cost of both.
+/// </summary>
+/// <returns></returns>
+static bool benchFirQ15()
+{
+    q15_t* in = new q15_t[FIR_BENCH_SAMPLES];
+    q15_t* ref = new q15_t[FIR_BENCH_SAMPLES];
+    q15_t* out = new q15_t[FIR_BENCH_SAMPLES];
+    genSignal(in, FIR_BENCH_SAMPLES);
+
+    // full scale samples and coefficients exercise the saturation and accumulator wrap
+    for (uint32_t i = 0U; i < FIR_BENCH_SAMPLES; i += 997U)
+        in[i] = ((i / 997U) & 1U) ? 32767 : -32768;
+
+    q15_t taps[FIR_BENCH_TAPS_MAX];
+    uint32_t seed = 0x4567890U;
+    for (uint16_t i = 0U; i < FIR_BENCH_TAPS_MAX; i++) {
+        seed = (seed * 1103515245U) + 12345U;
+        taps[i] = q15_t(seed >> 16);
+    }
+    taps[0U] = -32768;
+
+    bool passed = true;
+    passed &= checkFirQ15<6U>("boxcar_5", taps, in, ref, out);
+    passed &= checkFirQ15<10U>("boxcar_10", taps, in, ref, out);
+    passed &= checkFirQ15<22U>("nxdn_sinc", taps, in, ref, out);
+    passed &= checkFirQ15<32U>("p25_lowpass", taps, in, ref, out);
+    passed &= checkFirQ15<42U>("rrc_0_2", taps, in, ref, out);
+    passed &= checkFirQ15<82U>("nxdn_0_2", taps, in, ref, out);
+
+    // modulator shaped taps, the interpolator takes 4-level symbols
+    const q15_t LEVELS[4U] = { -1220, -410, 410, 1220 };
+    for (uint32_t i = 0U; i < INTERP_BENCH_SYMBOLS; i++) {
+        seed = (seed * 1103515245U) + 12345U;
+        in[i] = LEVELS[(seed >> 16) & 0x03U];
+    }
+
+    q15_t interpTaps[INTERP_BENCH_L_MAX * INTERP_BENCH_PHASE_MAX];
+    for (uint16_t i = 0U; i < (INTERP_BENCH_L_MAX * INTERP_BENCH_PHASE_MAX); i++) {
+        seed = (seed * 1103515245U) + 12345U;
+        interpTaps[i] = q15_t(int32_t((seed >> 16) % 14001U) - 7000);
+    }
+
+    delete[] ref;
+    delete[] out;
+    ref = new q15_t[INTERP_BENCH_SYMBOLS * INTERP_BENCH_L_MAX];
+    out = new q15_t[INTERP_BENCH_SYMBOLS * INTERP_BENCH_L_MAX];
+
+    passed &= checkInterpQ15<5U, 8U>("p25", interpTaps, in, ref, out);
+    passed &= checkInterpQ15<5U, 9U>("dmr", interpTaps, in, ref, out);
+    passed &= checkInterpQ15<10U, 9U>("nxdn", interpTaps, in, ref, out);
+
+    delete[] in;
+    delete[] ref;
+    delete[] out;
+    return passed;
+}
+
+/// <summary>
+/// Helper to run a running sum boxcar filter over the input, cycling through the given block sizes.
+/// </summary>
+/// <param name="taps"></param>
+/// <param name="blockSizes"></param>
+/// <param name="blockCount"></param>
+/// <param name="in"></param>
+/// <param name="out"></param>
+/// <param name="length"></param>
+template <uint16_t Taps>
+static void runBoxcarQ15(q15_t* taps, const uint16_t* blockSizes, uint32_t blockCount, q15_t* in, q15_t* out, uint32_t length)
+{
+    BoxcarQ15<Taps, RX_BLOCK_SIZE_MAX> boxcar(*reinterpret_cast<q15_t(*)[Taps]>(taps));
+
+    uint32_t b = 0U;
+    for (uint32_t n = 0U; n < length; b++) {
+        uint32_t blockSize = std::min<uint32_t>(blockSizes[b % blockCount], length - n);
+        boxcar.processSum(in + n, out + n, blockSize);
+        n += blockSize;
+    }
+}
+
+/// <summary>
+/// Helper to check and time one boxcar shape against the runtime kernel and the FIR template.
+/// </summary>
+/// <param name="name"></param>
+/// <param name="taps"></param>
+/// <param name="in"></param>
+/// <param name="ref"></param>
+/// <param name="out"></param>
+/// <returns>True, if the boxcar is bit exact with the runtime kernels.</returns>
+template <uint16_t Taps>
+static bool checkBoxcarQ15(const char* name, q15_t* taps, q15_t* in, q15_t* ref, q15_t* out)
+{
+    const uint16_t CHECK_BLOCKS[] = { FIR_BENCH_BLOCK, 1U, 7U, 2U, RX_BLOCK_SIZE_MAX, 33U, 240U, 3U };
+    const uint16_t BENCH_BLOCKS[] = { RX_BLOCK_SIZE_MAX };
+    const uint32_t CHECK_COUNT = sizeof(CHECK_BLOCKS) / sizeof(CHECK_BLOCKS[0]);
+
+    ARM_FIR_KERNEL selected = ::arm_fir_get_kernel();
+
+    bool passed = true;
+    for (uint32_t k = 0U; k < ARM_FIR_KERNEL_COUNT; k++) {
+        ARM_FIR_KERNEL kernel = ARM_FIR_KERNEL(k);
+        if ((kernel != ARM_FIR_KERNEL_GENERIC && kernel != selected) || !::arm_fir_set_kernel(kernel))
+            continue;
+
+        runFir(taps, Taps, CHECK_BLOCKS, CHECK_COUNT, in, ref, FIR_BENCH_SAMPLES);
+        runBoxcarQ15<Taps>(taps, CHECK_BLOCKS, CHECK_COUNT, in, out, FIR_BENCH_SAMPLES);
+
+        uint32_t mismatches = 0U;
+        for (uint32_t i = 0U; i < FIR_BENCH_SAMPLES; i++) {
+            if (out[i] != ref[i])
+                mismatches++;
+        }
+
+        double start = now();
+        runFirQ15<Taps>(taps, BENCH_BLOCKS, 1U, in, out, FIR_BENCH_SAMPLES);
+        double fir = ((now() - start) * 1e9) / double(FIR_BENCH_SAMPLES);
+
+        start = now();
+        runBoxcarQ15<Taps>(taps, BENCH_BLOCKS, 1U, in, out, FIR_BENCH_SAMPLES);
+        double boxcar = ((now() - start) * 1e9) / double(FIR_BENCH_SAMPLES);
+
+        ::fprintf(stdout, "boxcar: %s (taps = %u), kernel = %s, %.2f ns/sample FIR, %.2f ns/sample boxcar, %.2fx, mismatches = %u\n",
+            name, Taps, ::arm_fir_kernel_name(kernel), fir, boxcar, fir / boxcar, mismatches);
+        if (mismatches > 0U)
+            passed = false;
+    }
+
+    ::arm_fir_set_kernel(selected);
+    return passed;
+}
+
+/// <summary>
+/// Verifies the running sum boxcar filters are bit exact with the FIR they replace at each boxcar
+/// shape in the tree and reports the per-sample cost of both.
+/// </summary>
+/// <returns></returns>
+static bool benchBoxcar()
+{
+    q15_t* in = new q15_t[FIR_BENCH_SAMPLES];
+    q15_t* ref = new q15_t[FIR_BENCH_SAMPLES];
+    q15_t* out = new q15_t[FIR_BENCH_SAMPLES];
+    genSignal(in, FIR_BENCH_SAMPLES);
+
+    // runs of full scale samples drive the output into saturation
+    for (uint32_t i = 0U; i < FIR_BENCH_SAMPLES; i += 997U) {
+        for (uint32_t j = i; j < std::min<uint32_t>(i + 12U, FIR_BENCH_SAMPLES); j++)
+            in[j] = ((i / 997U) & 1U) ? 32767 : -32768;
+    }
+
+    q15_t boxcar5Normal[6U] = { 12000, 12000, 12000, 12000, 12000, 0 };
+    q15_t boxcar5Narrow[6U] = { 9600, 9600, 9600, 9600, 9600, 0 };
+    q15_t boxcar10[10U] = { 6000, 6000, 6000, 6000, 6000, 6000, 6000, 6000, 6000, 6000 };
+    // a full scale negative gain wraps the product as it does the FIR accumulator
+    q15_t boxcarWrap[10U] = { -32768, -32768, -32768, -32768, -32768, -32768, -32768, -32768, 0, 0 };
+
+    bool passed = true;
+    passed &= checkBoxcarQ15<6U>("boxcar_5_normal", boxcar5Normal, in, ref, out);
+    passed &= checkBoxcarQ15<6U>("boxcar_5_narrow", boxcar5Narrow, in, ref, out);
+    passed &= checkBoxcarQ15<10U>("boxcar_10", boxcar10, in, ref, out);
+    passed &= checkBoxcarQ15<10U>("boxcar_wrap", boxcarWrap, in, ref, out);
+
+    delete[] in;
+    delete[] ref;
+    delete[] out;
+    return passed;
+}
+
+/// <summary>
+/// Demodulates a synthesized 4-level FM signal in both IQ formats and checks the recovered levels.
+/// </summary>
+/// <returns></returns>
+static bool benchFMDisc()
+{
+    const float DEVIATION = 3000.0F;
+    const float LEVELS[4U] = { -1800.0F, -600.0F, 600.0F, 1800.0F };
+
+    float* freq = new float[FM_BENCH_SAMPLES];
+    float* cf32 = new float[2U * FM_BENCH_SAMPLES];
+    int16_t* cs16 = new int16_t[2U * FM_BENCH_SAMPLES];
+    float* audio = new float[FM_BENCH_SAMPLES];
+
+    // 4800 baud symbols at 24 kHz, a noise free FM modulator
+    uint32_t seed = 0x1234567U;
+    double phase = 0.0;
+    for (uint32_t i = 0U; i < FM_BENCH_SAMPLES; i++) {
+        if ((i % 5U) == 0U)
+            seed = (seed * 1103515245U) + 12345U;
+        freq[i] = LEVELS[(seed >> 16) & 0x03U];
+
+        phase += (2.0 * M_PI * freq[i]) / 24000.0;
+        cf32[2U * i] = float(::cos(phase) * 0.1);
+        cf32[(2U * i) + 1U] = float(::sin(phase) * 0.1);
+        cs16[2U * i] = int16_t(::lrint(::cos(phase) * 16000.0));
+        cs16[(2U * i) + 1U] = int16_t(::lrint(::sin(phase) * 16000.0));
+    }
+
+    // expected RSSI of the 16000 count (-6.2 dBFS) cs16 and 0.1 (-20 dBFS) cf32 carriers
+    const double RSSI_DB[2U] = { 20.0 * ::log10(16000.0 / 32768.0), -20.0 };
+
+    bool passed = true;
+    for (uint32_t f = 0U; f < 2U; f++) {
+        FMDiscriminator disc(24000U, DEVIATION);
+        disc.setFormat((f == 0U) ? IQ_FORMAT_CS16 : IQ_FORMAT_CF32);
+
+        const uint8_t* data = (f == 0U) ? (const uint8_t*)cs16 : (const uint8_t*)cf32;
+        uint32_t length = FM_BENCH_SAMPLES * disc.getSampleSize();
+
+        double start = now();
+        uint32_t count = disc.process(data, length, audio);
+        double elapsed = now() - start;
+
+        // compare the symbol centers (past the channel filter delay) with the expected level
+        const uint32_t delay = FM_CHANNEL_FILTER_LEN / 2U;
+        double err = 0.0;
+        uint32_t n = 0U;
+        for (uint32_t i = 2U + delay; i < count; i += 5U) {
+            double expected = (freq[i - delay] / DEVIATION) * 2047.0;
+            err += ::fabs(double(audio[i]) - expected);
+            n++;
+        }
+        err /= double(n);
+
+        double rssiDb = (double(disc.getRSSI()) / FM_RSSI_COUNTS_PER_DB) + FM_RSSI_FLOOR_DB;
+
+        ::fprintf(stdout, "fmdisc: %s, %u samples, %.1f ns/sample, mean symbol error = %.1f counts, rssi = %u (%.2f dBFS, expected %.2f)\n",
+            (f == 0U) ? "cs16" : "cf32", count, (elapsed * 1e9) / double(count), err, disc.getRSSI(), rssiDb, RSSI_DB[f]);
+        if (count != FM_BENCH_SAMPLES || err > 100.0 || ::fabs(rssiDb - RSSI_DB[f]) > 0.5)
+            passed = false;
+    }
+
+    delete[] freq;
+    delete[] cf32;
+    delete[] cs16;
+    delete[] audio;
+    return passed;
+}
+
+/// <summary>
+/// Helper to resample a tone and return the RMS of the settled output.
+/// </summary>
+/// <param name="resampler"></param>
+/// <param name="inRate"></param>
+/// <param name="freq"></param>
+/// <param name="elapsed"></param>
+/// <param name="inCount"></param>
+/// <returns></returns>
+static double resampleTone(Resampler& resampler, uint32_t inRate, double freq, double& elapsed, uint32_t& inCount)
+{
+    inCount = inRate * RESAMPLE_BENCH_SECONDS;
+    float* in = new float[inCount];
+    float* out = new float[resampler.getMaxOutput(inCount)];
+    for (uint32_t i = 0U; i < inCount; i++)
+        in[i] = float(::sin((2.0 * M_PI * freq * double(i)) / double(inRate)));
+
+    resampler.reset();
+
+    double start = now();
+    uint32_t outCount = 0U;
+    for (uint32_t i = 0U; i < inCount; i += 480U) {
+        uint32_t n = (inCount - i) < 480U ? (inCount - i) : 480U;
+        outCount += resampler.process(in + i, n, out + outCount);
+    }
+    elapsed = now() - start;
+
+    // skip the first quarter while the filter settles
+    double sum = 0.0;
+    uint32_t first = outCount / 4U;
+    for (uint32_t i = first; i < outCount; i++)
+        sum += double(out[i]) * double(out[i]);
+
+    delete[] in;
+    delete[] out;
+    return ::sqrt(sum / double(outCount - first));
+}
+
+/// <summary>
+/// Checks the pass band gain and alias rejection of the SDR edge resamplers and reports their cost.
+/// </summary>
+/// <returns></returns>
+static bool benchResample()
+{
+    const uint32_t RATES[][2U] = {
+        { 48000U, 24000U }, { 96000U, 24000U }, { 192000U, 24000U }, { 44100U, 24000U },
+        { 24000U, 48000U }, { 24000U, 192000U }, { 24000U, 44100U }
+    };
+
+    bool passed = true;
+    for (uint32_t r = 0U; r < (sizeof(RATES) / sizeof(RATES[0])); r++) {
+        uint32_t inRate = RATES[r][0U], outRate = RATES[r][1U];
+
+        Resampler resampler;
+        if (!resampler.open(inRate, outRate))
+            return false;
+
+        double elapsed;
+        uint32_t inCount;
+        double pass = resampleTone(resampler, inRate, 1000.0, elapsed, inCount);
+        double passDb = 20.0 * ::log10(pass / ::sqrt(0.5));
+
+        // a tone above the output Nyquist rate must not alias into the channel
+        double stopDb = 0.0;
+        if (inRate > outRate) {
+            double stopElapsed;
+            uint32_t stopCount;
+            double stop = resampleTone(resampler, inRate, double(outRate) * 0.75, stopElapsed, stopCount);
+            stopDb = 20.0 * ::log10((stop + 1e-12) / ::sqrt(0.5));
+        }
+
+        ::fprintf(stdout, "resample: %u -> %u Hz, L/M = %u/%u, pass = %.2f dB, alias = %.1f dB, %.1f ns/input sample\n",
+            inRate, outRate, resampler.getInterpolation(), resampler.getDecimation(), passDb, stopDb, (elapsed * 1e9) / double(inCount));
+
+        if (::fabs(passDb) > 0.5 || (inRate > outRate && stopDb > -40.0))
+            passed = false;
+    }
+
+    return passed;
+}
+
+/// <summary>
+/// Producer side of the shared memory ring benchmark; writes a known sequence in front end sized blocks.
+/// </summary>
+/// <param name="arg"></param>
+/// <returns></returns>
+static void* shmProducer(void* arg)
+{
+    ShmRing* ring = (ShmRing*)arg;
+
+    uint16_t block[SHM_BENCH_BLOCK];
+    uint32_t i = 0U;
+    while (i < SHM_BENCH_WORDS) {
+        for (uint32_t j = 0U; j < SHM_BENCH_BLOCK; j++)
+            block[j] = uint16_t(i + j);
+
+        uint32_t n = 0U;
+        while (n < SHM_BENCH_BLOCK) {
+            n += ring->write(block + n, SHM_BENCH_BLOCK - n);
+            if (n < SHM_BENCH_BLOCK)
+                ring->waitSpace(100U);
+        }
+
+        i += SHM_BENCH_BLOCK;
+    }
+
+    return NULL;
+}
+
+/// <summary>
+/// Shared memory transport stress test and throughput.
+/// </summary>
+/// <returns></returns>
+static bool benchShm()
+{
+    char name[64U];
+    ::snprintf(name, sizeof(name), "/dvm-bench-%d", int(::getpid()));
+    ::shm_unlink(name);
+
+    // separate mappings of the same object, as the DSP and front end would have
+    ShmRing producer, consumer;
+    if (!producer.open(name, 24000U) || !consumer.open(name, 24000U)) {
+        ::shm_unlink(name);
+        return false;
+    }
+
+    double start = now();
+
+    pthread_t thread;
+    ::pthread_create(&thread, NULL, shmProducer, &producer);
+
+    uint32_t errors = 0U;
+    uint32_t total = 0U;
+    while (total < SHM_BENCH_WORDS) {
+        if (!consumer.waitData(100U))
+            continue;
+
+        ShmSpan spans[2U];
+        uint32_t n = consumer.beginRead(spans);
+        for (uint8_t s = 0U; s < 2U; s++) {
+            for (uint32_t j = 0U; j < spans[s].length; j++) {
+                if (spans[s].data[j] != uint16_t(total))
+                    errors++;
+                total++;
+            }
+        }
+
+        consumer.commitRead(n);
+    }
+
+    ::pthread_join(thread, NULL);
+    double elapsed = now() - start;
+
+    ::fprintf(stdout, "shm: %u words, %u errors, %.1f Mwords/s, consumer sleeps = %u, producer sleeps = %u\n",
+        total, errors, (double(total) / elapsed) / 1e6, consumer.getSleeps(), producer.getSleeps());
+
+    producer.close();
+    consumer.close();
+    ::shm_unlink(name);
+
+    return errors == 0U;
+}
+
+/// <summary>
+/// Sender side of the datagram benchmark; sends sequenced packets, skipping some to simulate loss.
+/// </summary>
+/// <param name="arg">Path of the receiving Unix socket.</param>
+/// <returns></returns>
+static void* dgramSender(void* arg)
+{
+    const char* path = (const char*)arg;
+
+    sockaddr_un addr;
+    ::memset(&addr, 0x00U, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    ::strncpy(addr.sun_path, path, sizeof(addr.sun_path) - 1U);
+
+    int fd = ::socket(AF_UNIX, SOCK_DGRAM, 0);
+    if (fd < 0 || ::connect(fd, (sockaddr*)&addr, sizeof(addr)) != 0) {
+        if (fd >= 0)
+            ::close(fd);
+        return NULL;
+    }
+
+    uint8_t packet[sizeof(DatagramHeader) + (DGRAM_BENCH_SAMPLES * sizeof(uint16_t))];
+    for (uint32_t i = 0U; i < DGRAM_BENCH_PACKETS; i++) {
+        if ((i % DGRAM_BENCH_DROP) == (DGRAM_BENCH_DROP - 1U))
+            continue;
+
+        DatagramHeader header;
+        header.sequence = i;
+        header.length = uint16_t(DGRAM_BENCH_SAMPLES * sizeof(uint16_t));
+        header.reserved = 0U;
+        ::memcpy(packet, &header, sizeof(header));
+
+        uint16_t* samples = (uint16_t*)(packet + sizeof(DatagramHeader));
+        for (uint32_t j = 0U; j < DGRAM_BENCH_SAMPLES; j++)
+            samples[j] = uint16_t(i);
+
+        ::send(fd, packet, sizeof(packet), 0);
+    }
+
+    // the last packet is never dropped, it tells the receiver the run is complete
+    ::close(fd);
+    return NULL;
+}
+
+/// <summary>
+/// Datagram transport batching, loss detection and cost.
+/// </summary>
+/// <returns></returns>
+static bool benchDgram()
+{
+    char path[64U];
+    ::snprintf(path, sizeof(path), "/tmp/dvm-bench-%d.sock", int(::getpid()));
+
+    DatagramTransport transport(std::string("unix://") + path, std::string(), NULL);
+    if (!transport.open())
+        return false;
+
+    double start = now();
+
+    pthread_t thread;
+    ::pthread_create(&thread, NULL, dgramSender, path);
+
+    uint32_t errors = 0U;
+    uint32_t filled = 0U;
+    uint32_t expected = 0U;
+    while (expected < DGRAM_BENCH_PACKETS) {
+        TransportBuffer buffers[TRANSPORT_MAX_BUFFERS];
+        uint32_t packets = transport.read(buffers);
+        if (packets == 0U)
+            break;
+
+        for (uint32_t i = 0U; i < packets; i++) {
+            uint32_t length = buffers[i].length, lost = buffers[i].lost;
+            const uint16_t* samples = (const uint16_t*)buffers[i].data;
+
+            filled += lost / (DGRAM_BENCH_SAMPLES * sizeof(uint16_t));
+            expected += lost / (DGRAM_BENCH_SAMPLES * sizeof(uint16_t));
+            if (length != DGRAM_BENCH_SAMPLES * sizeof(uint16_t) || samples[0U] != uint16_t(expected))
+                errors++;
+            expected++;
+        }
+    }
+
+    ::pthread_join(thread, NULL);
+    double elapsed = now() - start;
+
+    uint32_t dropped = DGRAM_BENCH_PACKETS / DGRAM_BENCH_DROP;
+    ::fprintf(stdout, "dgram: %llu packets in %u batches (mean %.1f per call), lost %u (filled %u, expected %u), %u errors, %.0f ns/packet\n",
+        (unsigned long long)transport.getPackets(), transport.getBatches(), double(transport.getPackets()) / double(transport.getBatches()),
+        transport.getLost(), filled, dropped, errors, (elapsed * 1e9) / double(transport.getPackets()));
+
+    transport.close();
+    return errors == 0U && filled == dropped && expected == DGRAM_BENCH_PACKETS;
+}
+
+/// <summary>
+/// Helper to fill a Tx frame with a known sequence of 12-bit samples, amplified like the Tx path.
+/// </summary>
+/// <param name="frame"></param>
+/// <param name="index">Frame number.</param>
+static void fillTransportFrame(short* frame, uint32_t index)
+{
+    for (uint32_t i = 0U; i < TRANSPORT_BENCH_FRAME; i++)
+        frame[i] = (short)uint16_t(((index + i) & 0x0FFFU) * 5U);
+}
+
+/// <summary>
+/// Loopback and file sample transport round trip and cost.
+/// </summary>
+/// <returns></returns>
+static bool benchTransport()
+{
+    SampleFramePool pool(16U, TRANSPORT_BENCH_FRAME);
+    TransportBuffer buffers[TRANSPORT_MAX_BUFFERS];
+
+    // loopback; every Tx frame must come back as the 12-bit samples it was made from
+    LoopbackTransport loopback(&pool);
+    loopback.open();
+
+    uint32_t loopErrors = 0U;
+    double start = now();
+    for (uint32_t f = 0U; f < TRANSPORT_BENCH_FRAMES; f++) {
+        short* frame = pool.acquire();
+        if (frame == NULL) {
+            loopErrors++;
+            break;
+        }
+
+        fillTransportFrame(frame, f);
+        if (!loopback.write(frame, TRANSPORT_BENCH_FRAME)) {
+            loopErrors++;
+            continue;
+        }
+
+        if (loopback.read(buffers) != 1U || buffers[0U].length != TRANSPORT_BENCH_FRAME * sizeof(short)) {
+            loopErrors++;
+            continue;
+        }
+
+        const uint16_t* samples = (const uint16_t*)buffers[0U].data;
+        for (uint32_t i = 0U; i < TRANSPORT_BENCH_FRAME; i++) {
+            if (samples[i] != uint16_t((f + i) & 0x0FFFU)) {
+                loopErrors++;
+                break;
+            }
+        }
+
+        loopback.release();
+    }
+    double loopElapsed = now() - start;
+    loopback.close();
+
+    ::fprintf(stdout, "transport: loopback %u frames, %u errors, %.0f ns/frame\n", TRANSPORT_BENCH_FRAMES, loopErrors,
+        (loopElapsed * 1e9) / double(TRANSPORT_BENCH_FRAMES));
+
+    // file; write a capture through the sink, then read it back through an unpaced source
+    char path[64U];
+    ::snprintf(path, sizeof(path), "file:///tmp/dvm-bench-%d.raw", int(::getpid()));
+
+    FileTransport sink(std::string(), path, 24000U, sizeof(short), &pool);
+    if (!sink.open())
+        return false;
+
+    uint32_t fileErrors = 0U;
+    start = now();
+    for (uint32_t f = 0U; f < TRANSPORT_BENCH_FRAMES; f++) {
+        short* frame = pool.acquire();
+        fillTransportFrame(frame, f);
+        if (!sink.write(frame, TRANSPORT_BENCH_FRAME))
+            fileErrors++;
+    }
+    sink.close();
+    double writeElapsed = now() - start;
+
+    FileTransport source(path, std::string(), 24000U, sizeof(short), &pool, false);
+    if (!source.open())
+        return false;
+
+    uint64_t bytes = 0U;
+    start = now();
+    while (true) {
+        uint32_t count = source.read(buffers);
+        if (count == 0U)
+            break;
+
+        // the source reads in 10 ms blocks, so frames are checked by absolute sample position
+        const short* samples = (const short*)buffers[0U].data;
+        uint32_t n = buffers[0U].length / sizeof(short);
+        for (uint32_t i = 0U; i < n; i++) {
+            uint64_t pos = (bytes / sizeof(short)) + i;
+            uint32_t f = uint32_t(pos / TRANSPORT_BENCH_FRAME);
+            uint32_t j = uint32_t(pos % TRANSPORT_BENCH_FRAME);
+            if (samples[i] != (short)uint16_t(((f + j) & 0x0FFFU) * 5U)) {
+                fileErrors++;
+                break;
+            }
+        }
+
+        bytes += buffers[0U].length;
+        source.release();
+    }
+    double readElapsed = now() - start;
+    source.close();
+    ::unlink(path + 7);
+
+    uint64_t expected = uint64_t(TRANSPORT_BENCH_FRAMES) * TRANSPORT_BENCH_FRAME * sizeof(short);
+    if (bytes != expected || !source.isEOF())
+        fileErrors++;
+
+    ::fprintf(stdout, "transport: file %llu bytes, %u errors, write %.1f MB/s, unpaced read %.1f MB/s (%.0fx real time)\n",
+        (unsigned long long)bytes, fileErrors, (double(expected) / writeElapsed) / 1e6, (double(bytes) / readElapsed) / 1e6,
+        (double(bytes) / (24000.0 * sizeof(short))) / readElapsed);
+
+    return loopErrors == 0U && fileErrors == 0U;
+}
+
+/// <summary>
+/// Helper to simulate a drifting, jittery source into the drift compensator.
+/// </summary>
+/// <param name="ppm">Clock offset of the simulated source.</param>
+/// <param name="settle">Seconds until the estimate stayed within 2 ppm of the offset.</param>
+/// <param name="fillMean">Mean fill over the last five minutes.</param>
+/// <param name="elapsed">Processing time in seconds.</param>
+/// <param name="inCount">Number of samples processed.</param>
+/// <returns>Final clock offset estimate.</returns>
+static float simulateDrift(double ppm, double& settle, float& fillMean, double& elapsed, uint64_t& inCount)
+{
+    const uint32_t rate = 24000U;
+    DriftCompensator drift(rate, DRIFT_BENCH_TARGET);
+
+    float in[DRIFT_BENCH_BURST];
+    float out[DRIFT_BENCH_BURST + (DRIFT_BENCH_BURST / 1000U) + 2U];
+
+    double srcRate = double(rate) * (1.0 + (ppm * 1e-6));
+    uint32_t seed = 12345U;
+    uint64_t delivered = 0U;
+    uint64_t bursts = 0U;
+    double lastUpdate = 0.0;
+    settle = -1.0;
+    inCount = 0U;
+
+    elapsed = 0.0;
+    while (true) {
+        // the source clock decides when a burst is complete, the transport adds jitter
+        double t = (double(bursts + 1U) * DRIFT_BENCH_BURST) / srcRate;
+        seed = (seed * 1103515245U) + 12345U;
+        double arrival = t + (DRIFT_BENCH_JITTER * (double((seed >> 8) & 0xFFFFU) / 65535.0));
+        if (t >= double(DRIFT_BENCH_SECONDS))
+            break;
+
+        for (uint32_t i = 0U; i < DRIFT_BENCH_BURST; i++)
+            in[i] = float(::sin((2.0 * M_PI * 1000.0 * double(inCount + i)) / srcRate));
+
+        double start = now();
+        uint32_t n = drift.process(in, DRIFT_BENCH_BURST, out);
+        elapsed += now() - start;
+
+        inCount += DRIFT_BENCH_BURST;
+        delivered += n;
+        bursts++;
+
+        int64_t fill = int64_t(DRIFT_BENCH_TARGET) + int64_t(delivered) - int64_t(arrival * double(rate));
+        drift.measure(int32_t(fill));
+
+        if (arrival - lastUpdate >= 1.0) {
+            drift.update(float(arrival - lastUpdate));
+            lastUpdate = arrival;
+
+            if (::fabs(double(drift.getPPM()) - ppm) > 2.0)
+                settle = -1.0;
+            else if (settle < 0.0)
+                settle = arrival;
+
+            if (arrival < double(DRIFT_BENCH_SECONDS - 300U))
+                drift.clearStats();
+        }
+    }
+
+    fillMean = drift.getFillMean();
+    return drift.getPPM();
+}
+
+/// <summary>
+/// Sample clock drift compensation convergence and cost.
+/// </summary>
+/// <returns></returns>
+static bool benchDrift()
+{
+    const double OFFSETS[] = { 100.0, -50.0, 20.0, 0.0, -250.0 };
+
+    bool passed = true;
+    for (uint32_t o = 0U; o < (sizeof(OFFSETS) / sizeof(OFFSETS[0])); o++) {
+        double settle, elapsed;
+        float fillMean;
+        uint64_t inCount;
+        float ppm = simulateDrift(OFFSETS[o], settle, fillMean, elapsed, inCount);
+
+        ::fprintf(stdout, "drift: source %+.0f ppm, estimate %+.2f ppm, settled in %.0f s, fill mean %.1f (target %u), %.1f ns/sample\n",
+            OFFSETS[o], ppm, settle, fillMean, DRIFT_BENCH_TARGET, (elapsed * 1e9) / double(inCount));
+
+        // within 2 ppm and 1 ms of the target latency once settled
+        if (settle < 0.0 || ::fabs(double(fillMean) - double(DRIFT_BENCH_TARGET)) > 24.0)
+            passed = false;
+    }
+
+    return passed;
+}
+
+/// <summary>
+/// Helper to channelize the given input, all bins, in wideband chunks.
+/// </summary>
+/// <param name="chan"></param>
+/// <param name="inI"></param>
+/// <param name="inQ"></param>
+/// <param name="count"></param>
+/// <param name="out">Interleaved complex output per bin.</param>
+/// <returns>Number of samples written to each bin.</returns>
+static uint32_t channelize(Channelizer& chan, const float* inI, const float* inQ, uint32_t count, std::vector<std::vector<float> >& out)
+{
+    const uint32_t CHUNK = 8192U;
+
+    std::vector<float*> ptr(chan.getBranches());
+    for (uint32_t b = 0U; b < chan.getBranches(); b++)
+        out[b].resize(2U * chan.getMaxOutput(count));
+
+    uint32_t written = 0U;
+    for (uint32_t i = 0U; i < count; i += CHUNK) {
+        for (uint32_t b = 0U; b < chan.getBranches(); b++)
+            ptr[b] = &out[b][2U * written];
+
+        uint32_t n = (count - i) < CHUNK ? (count - i) : CHUNK;
+        written += chan.process(inI + i, inQ + i, n, &ptr[0U]);
+    }
+
+    return written;
+}
+
+/// <summary>
+/// Polyphase channelizer exactness against a direct mix, filter and decimate, channel
+/// isolation and cost.
+/// </summary>
+/// <returns></returns>
+static bool benchChannelizer()
+{
+    const uint32_t BRANCHES[] = { 16U, 64U, 256U };
+
+    bool passed = true;
+    for (uint32_t m = 0U; m < (sizeof(BRANCHES) / sizeof(BRANCHES[0])); m++) {
+        const uint32_t branches = BRANCHES[m];
+        const uint32_t rate = branches * CHANNELIZER_BENCH_SPACING;
+        const uint32_t decim = branches / 2U;
+
+        std::vector<uint32_t> bins;
+        for (uint32_t b = 0U; b < branches; b++)
+            bins.push_back(b);
+
+        Channelizer chan;
+        if (!chan.open(branches, bins))
+            return false;
+
+        std::vector<std::vector<float> > out(branches);
+
+        // white noise against the direct form: y[n] = sum h[j] x[n - j] e^-j2pik(n - j)/M, at every decimation samples
+        uint32_t count = CHANNELIZER_BENCH_CHECK;
+        std::vector<float> inI(count), inQ(count);
+        uint32_t seed = 0x1234567U;
+        for (uint32_t i = 0U; i < count; i++) {
+            seed = (seed * 1103515245U) + 12345U;
+            inI[i] = float(int32_t(seed >> 16) - 32768) / 32768.0F;
+            seed = (seed * 1103515245U) + 12345U;
+            inQ[i] = float(int32_t(seed >> 16) - 32768) / 32768.0F;
+        }
+
+        uint32_t written = channelize(chan, &inI[0U], &inQ[0U], count, out);
+
+        const std::vector<float>& taps = chan.getTaps();
+        const uint32_t length = uint32_t(taps.size());
+        double maxErr = 0.0, maxRef = 0.0;
+        const uint32_t CHECK_BINS[] = { 0U, 1U, branches / 2U - 1U, branches / 2U, branches - 1U };
+        for (uint32_t c = 0U; c < (sizeof(CHECK_BINS) / sizeof(CHECK_BINS[0])); c++) {
+            uint32_t k = CHECK_BINS[c];
+            for (uint32_t o = 0U; o < written; o += 7U) {
+                uint32_t n = (o * decim) + decim - 1U;
+                double re = 0.0, im = 0.0;
+                for (uint32_t j = 0U; j < length && j <= n; j++) {
+                    double h = taps[length - 1U - j];
+                    double a = (-2.0 * M_PI * double((uint64_t(k) * (n - j)) % branches)) / double(branches);
+                    double xr = inI[n - j], xi = inQ[n - j];
+                    re += h * ((xr * ::cos(a)) - (xi * ::sin(a)));
+                    im += h * ((xr * ::sin(a)) + (xi * ::cos(a)));
+                }
+
+                double er = re - out[k][2U * o], ei = im - out[k][(2U * o) + 1U];
+                maxErr = std::max(maxErr, ::sqrt((er * er) + (ei * ei)));
+                maxRef = std::max(maxRef, ::sqrt((re * re) + (im * im)));
+            }
+        }
+
+        // a tone 2 kHz above the center of one channel; it must appear there only, the
+        // neighbouring channel centers are 0.84 and 1.16 spacings away, in the stop band
+        const uint32_t toneBin = 3U;
+        const double toneFreq = (double(toneBin) * double(CHANNELIZER_BENCH_SPACING)) + 2000.0;
+        count = rate * CHANNELIZER_BENCH_SECONDS;
+        inI.resize(count);
+        inQ.resize(count);
+        for (uint32_t i = 0U; i < count; i++) {
+            double phase = (2.0 * M_PI * ::fmod(toneFreq * double(i), double(rate))) / double(rate);
+            inI[i] = float(::cos(phase) * 0.5);
+            inQ[i] = float(::sin(phase) * 0.5);
+        }
+
+        chan.reset();
+        double start = now();
+        written = channelize(chan, &inI[0U], &inQ[0U], count, out);
+        double elapsed = now() - start;
+
+        // skip the first quarter while the filter settles
+        double toneDb = 0.0, leakDb = -400.0;
+        for (uint32_t b = 0U; b < branches; b++) {
+            double sum = 0.0;
+            uint32_t first = written / 4U;
+            for (uint32_t i = first; i < written; i++)
+                sum += (double(out[b][2U * i]) * double(out[b][2U * i])) + (double(out[b][(2U * i) + 1U]) * double(out[b][(2U * i) + 1U]));
+            double db = 10.0 * ::log10((sum / double(written - first)) / 0.25 + 1e-30);
+
+            if (b == toneBin)
+                toneDb = db;
+            else
+                leakDb = std::max(leakDb, db);
+        }
+
+        double ns = (elapsed * 1e9) / double(count);
+        double load = (ns * double(rate)) / 1e9;
+        ::fprintf(stdout, "channelizer: %u channels at %u Hz, max error = %.2e (of %.2f), tone = %+.3f dB, worst leakage = %.1f dB, %.2f ns/sample, %.1f%% of a core, %.0f channels/core\n",
+            branches, rate, maxErr, maxRef, toneDb, leakDb, ns, load * 100.0, double(branches) / load);
+
+        if (written != (count / decim) || maxErr > (maxRef * 1e-4) || ::fabs(toneDb) > 0.1 || leakDb > -60.0)
+            passed = false;
+    }
+
+    return passed;
+}
+
+/// <summary>
+/// Records Rx blocks into the black box recorder and reports the cost of the hot path.
+/// </summary>
+/// <returns></returns>
+static bool benchBlackBox()
+{
+    const uint16_t BLOCK_SIZES[] = { RX_BLOCK_SIZE, 48U, 240U, RX_BLOCK_SIZE_MAX };
+
+    uint16_t samples[RX_BLOCK_SIZE_MAX];
+    uint16_t rssi[RX_BLOCK_SIZE_MAX];
+    uint8_t control[RX_BLOCK_SIZE_MAX];
+    for (uint32_t i = 0U; i < RX_BLOCK_SIZE_MAX; i++) {
+        samples[i] = uint16_t(2048U + (i % 512U));
+        rssi[i] = uint16_t(i);
+        control[i] = 0U;
+    }
+
+    // no trigger is raised, so nothing is snapshot to the path
+    BlackBox blackBox;
+    if (!blackBox.open("/tmp/dvm-bench-blackbox", BLACKBOX_TIME_DEFAULT, SAMPLE_RATE, 0U)) {
+        ::fprintf(stdout, "blackbox: failed to open\n");
+        return false;
+    }
+
+    for (uint32_t b = 0U; b < (sizeof(BLOCK_SIZES) / sizeof(BLOCK_SIZES[0])); b++) {
+        uint32_t blocks = RX_BENCH_SAMPLES / BLOCK_SIZES[b];
+
+        double start = now();
+        for (uint32_t i = 0U; i < blocks; i++)
+            blackBox.record(samples, rssi, control, BLOCK_SIZES[b]);
+        double elapsed = now() - start;
+
+        ::fprintf(stdout, "blackbox: block = %u, %.1f ns/block, %.2f ns/sample\n",
+            BLOCK_SIZES[b], (elapsed * 1e9) / double(blocks), (elapsed * 1e9) / double(blocks * BLOCK_SIZES[b]));
+    }
+
+    blackBox.close();
+    return true;
+}
+
+const BenchmarkEntry BENCHMARKS[] = {
+    { "ring", "SPSC sample/RSSI ring buffer stress test and throughput", benchRing },
+    { "ringblock", "SPSC sample/RSSI ring buffer block API stress test and throughput", benchRingBlock },
+    { "fmdisc", "IQ channel filter and FM discriminator accuracy and cost", benchFMDisc },
+    { "resample", "SDR edge resampler pass band, alias rejection and cost", benchResample },
+    { "shm", "shared memory sample transport stress test and throughput", benchShm },
+    { "dgram", "datagram sample transport batching, loss detection and cost", benchDgram },
+    { "transport", "loopback and file sample transport round trip and cost", benchTransport },
+    { "drift", "sample clock drift compensation convergence, latency and cost", benchDrift },
+    { "rxblock", "Rx front end bit exactness and cost across block sizes", benchRxBlock },
+    { "fir", "SIMD FIR kernel bit exactness and cost across filter lengths", benchFir },
+    { "fold", "folded symmetric FIR bit exactness and cost per filter", benchFold },
+    { "interp", "SIMD polyphase Tx interpolator bit exactness and cost", benchInterp },
+    { "firq15", "fixed length FIR and interpolator template bit exactness and cost", benchFirQ15 },
+    { "boxcar", "running sum boxcar filter bit exactness and cost", benchBoxcar },
+    { "channelizer", "wideband polyphase channelizer exactness, isolation and channels per core", benchChannelizer },
+    { "blackbox", "black box recorder cost per Rx block", benchBlackBox },
+};
+const uint32_t BENCHMARK_COUNT = sizeof(BENCHMARKS) / sizeof(BENCHMARKS[0]);
+
+/// <summary>
+/// Runs the named benchmark (or all benchmarks if the name is empty) and reports to stdout.
+/// </summary>
+/// <param name="name">Name of the benchmark to run.</param>
+/// <returns>Process exit code.</returns>
+int sdr::runBenchmark(const std::string& name)
+{
+    bool found = false;
+    bool passed = true;
+    for (uint32_t i = 0U; i < BENCHMARK_COUNT; i++) {
+        if (!name.empty() && name != BENCHMARKS[i].name)
+            continue;
+
+        found = true;
+        ::fprintf(stdout, "running %s, %s\n", BENCHMARKS[i].name, BENCHMARKS[i].description);
+        if (!BENCHMARKS[i].fn()) {
+            ::fprintf(stdout, "%s: FAILED\n", BENCHMARKS[i].name);
+            passed = false;
+        }
+    }
+
+    if (!found) {
+        ::fprintf(stderr, "unknown benchmark `%s', available:", name.c_str());
+        for (uint32_t i = 0U; i < BENCHMARK_COUNT; i++)
+            ::fprintf(stderr, " %s", BENCHMARKS[i].name);
+        ::fprintf(stderr, "\n");
+        return EXIT_FAILURE;
+    }
+
+    return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
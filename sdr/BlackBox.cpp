@@ -0,0 +1,375 @@
+/**
+* Digital Voice Modem - DSP Firmware
+* GPLv2 Open Source. Use is subject to license terms.
+* DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+*
+* @package DVM / DSP Firmware
+*
+*/
+/*
+*   Copyright (C) 2022 Bryan Biedenkapp N2PLL
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 2 of the License, or
+*   (at your option) any later version.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program; if not, write to the Free Software
+*   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*/
+#include "sdr/BlackBox.h"
+#include "sdr/SigMFRecorder.h"
+#include "sdr/ThreadPolicy.h"
+#include "sdr/Log.h"
+
+#include <sys/mman.h>
+#include <time.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+
+using namespace sdr;
+
+// ---------------------------------------------------------------------------
+//  Constants
+// ---------------------------------------------------------------------------
+
+// the ring holds a second more than a snapshot, room the DSP keeps recording into
+// while a snapshot is written out
+const uint32_t BLACKBOX_HEADROOM = 1U;
+
+// how often the snapshot thread looks for a trigger, in milliseconds
+const uint32_t BLACKBOX_POLL = 100U;
+
+// samples interleaved and written to the snapshot at once
+const uint32_t BLACKBOX_CHUNK = 2400U;
+
+// the pending trigger holds the reason in its top byte and the sample it happened at below
+const uint32_t BLACKBOX_REASON_SHIFT = 56U;
+const uint64_t BLACKBOX_AT_MASK = (1ULL << BLACKBOX_REASON_SHIFT) - 1ULL;
+
+const int64_t NSEC_PER_SEC = 1000000000LL;
+
+static const char* BLACKBOX_NAMES[] = { "none", "p25-lost", "dmr-lost", "nxdn-lost", "rx-overflow", "request" };
+static const char* BLACKBOX_DESCRIPTIONS[] = { "no trigger", "P25 sync lost", "DMR sync lost", "NXDN sync lost",
+    "Rx ring buffer overflow", "snapshot requested" };
+
+// ---------------------------------------------------------------------------
+//  Macros
+// ---------------------------------------------------------------------------
+
+#define LOAD_ACQUIRE(v)         __atomic_load_n(&(v), __ATOMIC_ACQUIRE)
+#define LOAD_RELAXED(v)         __atomic_load_n(&(v), __ATOMIC_RELAXED)
+#define STORE_RELEASE(v, x)     __atomic_store_n(&(v), (x), __ATOMIC_RELEASE)
+
+// ---------------------------------------------------------------------------
+//  Globals Variables
+// ---------------------------------------------------------------------------
+
+uint32_t BlackBox::m_request = 0U;
+
+// ---------------------------------------------------------------------------
+//  Public Class Members
+// ---------------------------------------------------------------------------
+
+/// <summary>
+/// Initializes a new instance of the BlackBox class.
+/// </summary>
+BlackBox::BlackBox() :
+    m_base(),
+    m_sampleRate(0U),
+    m_channel(0U),
+    m_map(NULL),
+    m_mapLength(0U),
+    m_samples(NULL),
+    m_rssi(NULL),
+    m_control(NULL),
+    m_length(0U),
+    m_window(0U),
+    m_pos(0U),
+    m_written(0U),
+    m_trigger(0U),
+    m_holdoff(0U),
+    m_requestSeen(0U),
+    m_snapshots(0U),
+    m_suppressed(0U),
+    m_buffer(),
+    m_thread(),
+    m_running(false)
+{
+    /* stub */
+}
+
+/// <summary>
+/// Finalizes a instance of the BlackBox class.
+/// </summary>
+BlackBox::~BlackBox()
+{
+    close();
+}
+
+/// <summary>
+/// Maps the ring and starts the snapshot thread.
+/// </summary>
+/// <remarks>The ring is prefaulted, so recording into it never faults a page in.</remarks>
+/// <param name="base">Path the snapshots are named from, as base-time-trigger.sigmf-data/meta.</param>
+/// <param name="seconds">Length of the Rx history kept and snapshot, in seconds.</param>
+/// <param name="sampleRate">Sample rate of the DSP ring buffers.</param>
+/// <param name="channel">Modem channel number, for the snapshot descriptions.</param>
+/// <returns>True, if the ring was mapped, otherwise false.</returns>
+bool BlackBox::open(const std::string& base, uint32_t seconds, uint32_t sampleRate, uint32_t channel)
+{
+    close();
+
+    m_base = base;
+    m_sampleRate = sampleRate;
+    m_channel = channel;
+    m_window = seconds * sampleRate;
+    m_length = (seconds + BLACKBOX_HEADROOM) * sampleRate;
+
+    size_t length = size_t(m_length) * ((2U * sizeof(uint16_t)) + sizeof(uint8_t));
+    size_t page = size_t(::sysconf(_SC_PAGESIZE));
+    length = ((length + page - 1U) / page) * page;
+
+    void* map = ::mmap(NULL, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_POPULATE, -1, 0);
+    if (map == MAP_FAILED) {
+        ::LogError(LOG_DSP, "BlackBox::open(), failed to map %u bytes, err = %d", (uint32_t)length, errno);
+        return false;
+    }
+
+    m_map = (uint8_t*)map;
+    m_mapLength = length;
+    m_samples = (uint16_t*)m_map;
+    m_rssi = m_samples + m_length;
+    m_control = (uint8_t*)(m_rssi + m_length);
+
+    m_pos = 0U;
+    m_written = 0U;
+    m_trigger = 0U;
+    m_holdoff = 0U;
+    m_requestSeen = LOAD_RELAXED(m_request);
+    m_snapshots = 0U;
+    m_suppressed = 0U;
+    m_buffer.resize(BLACKBOX_CHUNK * CAPTURE_RX_CHANNELS);
+
+    // the snapshots are written with the default policy, out of the way of the real-time threads
+    char name[32U];
+    ::snprintf(name, sizeof(name), "Ch%u BlackBox", channel);
+
+    m_running = true;
+    if (!ThreadPolicy().create(&m_thread, threadHelper, this, name)) {
+        m_running = false;
+        ::munmap(m_map, m_mapLength);
+        m_map = NULL;
+        return false;
+    }
+
+    ::LogMessage(LOG_DSP, "Black box keeping the last %u seconds of Rx samples, snapshots to %s-*.sigmf-data", seconds, base.c_str());
+    return true;
+}
+
+/// <summary>
+/// Records a block of Rx samples as the DSP read them; called by the DSP thread only.
+/// </summary>
+/// <param name="samples">ADC samples.</param>
+/// <param name="rssi">RSSI of each sample.</param>
+/// <param name="control">Control mark of each sample.</param>
+/// <param name="length">Number of samples.</param>
+void BlackBox::record(const uint16_t* samples, const uint16_t* rssi, const uint8_t* control, uint16_t length)
+{
+    if (m_map == NULL)
+        return;
+
+    uint32_t first = m_length - m_pos;
+    if (first > length)
+        first = length;
+
+    ::memcpy(m_samples + m_pos, samples, first * sizeof(uint16_t));
+    ::memcpy(m_rssi + m_pos, rssi, first * sizeof(uint16_t));
+    ::memcpy(m_control + m_pos, control, first * sizeof(uint8_t));
+
+    // a block that runs off the end of the ring carries on at its start
+    if (first < length) {
+        uint32_t rest = length - first;
+        ::memcpy(m_samples, samples + first, rest * sizeof(uint16_t));
+        ::memcpy(m_rssi, rssi + first, rest * sizeof(uint16_t));
+        ::memcpy(m_control, control + first, rest * sizeof(uint8_t));
+    }
+
+    m_pos += length;
+    if (m_pos >= m_length)
+        m_pos -= m_length;
+
+    STORE_RELEASE(m_written, m_written + length);
+}
+
+/// <summary>
+/// Asks for a snapshot of the ring; may be called from any thread.
+/// </summary>
+/// <remarks>While a trigger is pending further triggers are ignored.</remarks>
+/// <param name="reason">Event that triggered the snapshot.</param>
+void BlackBox::trigger(BLACKBOX_TRIGGER reason)
+{
+    if (m_map == NULL)
+        return;
+
+    uint64_t value = (uint64_t(reason) << BLACKBOX_REASON_SHIFT) | (LOAD_RELAXED(m_written) & BLACKBOX_AT_MASK);
+    uint64_t expected = 0U;
+    __atomic_compare_exchange_n(&m_trigger, &expected, value, false, __ATOMIC_RELEASE, __ATOMIC_RELAXED);
+}
+
+/// <summary>
+/// Asks every black box recorder for a snapshot; safe to call from a signal handler.
+/// </summary>
+void BlackBox::request()
+{
+    __atomic_add_fetch(&m_request, 1U, __ATOMIC_RELAXED);
+}
+
+/// <summary>
+/// Stops the snapshot thread and unmaps the ring.
+/// </summary>
+/// <remarks>The DSP thread must no longer be recording.</remarks>
+void BlackBox::close()
+{
+    if (m_map == NULL)
+        return;
+
+    m_running = false;
+    ::pthread_join(m_thread, NULL);
+
+    ::munmap(m_map, m_mapLength);
+    m_map = NULL;
+
+    ::LogMessage(LOG_DSP, "Black box closed, snapshots = %u", m_snapshots);
+}
+
+// ---------------------------------------------------------------------------
+//  Private Class Members
+// ---------------------------------------------------------------------------
+
+/// <summary>
+/// Helper to write the last seconds of the ring to a SigMF recording.
+/// </summary>
+/// <remarks>The snapshot ends at the newest sample recorded, so it also holds what followed
+/// the trigger until the snapshot thread saw it.</remarks>
+/// <param name="reason">Event that triggered the snapshot.</param>
+/// <param name="at">Sample the trigger happened at.</param>
+void BlackBox::snapshot(BLACKBOX_TRIGGER reason, uint64_t at)
+{
+    uint64_t end = LOAD_ACQUIRE(m_written);
+    uint64_t start = (end > m_window) ? (end - m_window) : 0U;
+    if (end == start)
+        return;
+
+    timespec now;
+    ::clock_gettime(CLOCK_REALTIME, &now);
+    tm utc;
+    ::gmtime_r(&now.tv_sec, &utc);
+
+    char stamp[32U];
+    ::strftime(stamp, sizeof(stamp), "%Y%m%d-%H%M%S", &utc);
+    std::string base = m_base + "-" + stamp + "-" + BLACKBOX_NAMES[reason];
+    std::string dataPath = base + ".sigmf-data";
+
+    FILE* fp = ::fopen(dataPath.c_str(), "wb");
+    if (fp == NULL) {
+        ::LogError(LOG_DSP, "BlackBox, failed to create %s, err = %d", dataPath.c_str(), errno);
+        return;
+    }
+
+    uint32_t pos = uint32_t(start % m_length);
+    for (uint64_t done = start; done < end; ) {
+        uint32_t n = (end - done > BLACKBOX_CHUNK) ? BLACKBOX_CHUNK : uint32_t(end - done);
+        for (uint32_t i = 0U; i < n; i++) {
+            m_buffer[(3U * i)] = m_samples[pos];
+            m_buffer[(3U * i) + 1U] = m_rssi[pos];
+            m_buffer[(3U * i) + 2U] = m_control[pos];
+
+            if (++pos >= m_length)
+                pos = 0U;
+        }
+
+        if (::fwrite(&m_buffer[0U], sizeof(uint16_t) * CAPTURE_RX_CHANNELS, n, fp) != n)
+            ::LogError(LOG_DSP, "BlackBox, failed to write %s, err = %d", dataPath.c_str(), errno);
+        done += n;
+    }
+
+    ::fclose(fp);
+
+    // the DSP kept recording while the ring was copied; it must not have come round to
+    // the start of the snapshot
+    bool overtaken = (LOAD_ACQUIRE(m_written) - start) > m_length;
+
+    std::vector<std::pair<uint64_t, std::string> > annotations;
+    if (at >= start && at <= end)
+        annotations.push_back(std::make_pair(at - start, std::string(BLACKBOX_DESCRIPTIONS[reason])));
+    if (overtaken)
+        annotations.push_back(std::make_pair(0U, std::string("the start of the snapshot was overwritten while it was written")));
+
+    // the first sample of the snapshot was read this long before now
+    int64_t ago = int64_t(((end - start) * uint64_t(NSEC_PER_SEC)) / m_sampleRate);
+    int64_t first = (int64_t(now.tv_sec) * NSEC_PER_SEC) + now.tv_nsec - ago;
+    timespec ts;
+    ts.tv_sec = time_t(first / NSEC_PER_SEC);
+    ts.tv_nsec = long(first % NSEC_PER_SEC);
+
+    char description[128U];
+    ::snprintf(description, sizeof(description), "DVM DSP channel %u Rx black box; interleaved ADC sample, RSSI and control mark", m_channel);
+    SigMFRecorder::writeMeta(base + ".sigmf-meta", m_sampleRate, CAPTURE_RX_CHANNELS, description, SigMFRecorder::getDateTime(ts), annotations);
+
+    // further triggers are held off until the ring has been refilled since this snapshot
+    m_holdoff = end + m_window;
+    m_snapshots++;
+
+    ::LogMessage(LOG_DSP, "Black box snapshot %s, %s, %.1f seconds of Rx samples%s, triggers suppressed = %u", dataPath.c_str(),
+        BLACKBOX_DESCRIPTIONS[reason], double(end - start) / double(m_sampleRate), overtaken ? ", start overwritten" : "", m_suppressed);
+    m_suppressed = 0U;
+}
+
+/// <summary>
+///
+/// </summary>
+/// <param name="arg"></param>
+/// <returns></returns>
+void* BlackBox::threadHelper(void* arg)
+{
+    BlackBox* p = (BlackBox*)arg;
+
+    while (p->m_running) {
+        timespec ts;
+        ts.tv_sec = 0;
+        ts.tv_nsec = long(BLACKBOX_POLL) * 1000000L;
+        ::clock_nanosleep(CLOCK_MONOTONIC, 0, &ts, NULL);
+
+        // a requested snapshot is taken regardless of the holdoff
+        uint32_t request = LOAD_RELAXED(m_request);
+        if (request != p->m_requestSeen) {
+            p->m_requestSeen = request;
+            p->snapshot(BLACKBOX_REQUEST, LOAD_ACQUIRE(p->m_written));
+            continue;
+        }
+
+        uint64_t trigger = __atomic_exchange_n(&p->m_trigger, 0U, __ATOMIC_ACQUIRE);
+        if (trigger == 0U)
+            continue;
+
+        BLACKBOX_TRIGGER reason = BLACKBOX_TRIGGER(trigger >> BLACKBOX_REASON_SHIFT);
+        uint64_t at = trigger & BLACKBOX_AT_MASK;
+        if (at < p->m_holdoff) {
+            p->m_suppressed++;
+            continue;
+        }
+
+        p->snapshot(reason, at);
+    }
+
+    return NULL;
+}
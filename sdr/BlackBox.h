@@ -0,0 +1,126 @@
+/**
+* Digital Voice Modem - DSP Firmware
+* GPLv2 Open Source. Use is subject to license terms.
+* DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+*
+* @package DVM / DSP Firmware
+*
+*/
+/*
+*   Copyright (C) 2022 Bryan Biedenkapp N2PLL
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 2 of the License, or
+*   (at your option) any later version.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program; if not, write to the Free Software
+*   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*/
+#if !defined(__BLACK_BOX_H__)
+#define __BLACK_BOX_H__
+
+#include "Defines.h"
+
+#include <pthread.h>
+
+#include <string>
+#include <vector>
+
+namespace sdr
+{
+    // ---------------------------------------------------------------------------
+    //  Constants
+    // ---------------------------------------------------------------------------
+
+    // default and largest length of the Rx history kept, in seconds
+    const uint32_t BLACKBOX_TIME_DEFAULT = 10U;
+    const uint32_t BLACKBOX_TIME_MAX = 600U;
+
+    /// <summary>
+    /// Events that snapshot the black box recorder.
+    /// </summary>
+    enum BLACKBOX_TRIGGER {
+        BLACKBOX_NONE = 0U,
+
+        BLACKBOX_P25_LOST,
+        BLACKBOX_DMR_LOST,
+        BLACKBOX_NXDN_LOST,
+        BLACKBOX_RX_OVERFLOW,
+        BLACKBOX_REQUEST
+    };
+
+    // ---------------------------------------------------------------------------
+    //  Class Declaration
+    //      Implements an always-on recorder of the last seconds of Rx samples,
+    //      RSSI and control marks the DSP read, held in a memory mapped ring.
+    //      A trigger makes a background thread snapshot the ring to a SigMF
+    //      recording; recording and triggering never make a system call.
+    // ---------------------------------------------------------------------------
+
+    class DSP_FW_API BlackBox {
+    public:
+        /// <summary>Initializes a new instance of the BlackBox class.</summary>
+        BlackBox();
+        /// <summary>Finalizes a instance of the BlackBox class.</summary>
+        ~BlackBox();
+
+        /// <summary>Maps the ring and starts the snapshot thread.</summary>
+        bool open(const std::string& base, uint32_t seconds, uint32_t sampleRate, uint32_t channel);
+        /// <summary>Flag indicating whether the recorder is open.</summary>
+        bool isOpen() const { return m_map != NULL; }
+
+        /// <summary>Records a block of Rx samples as the DSP read them; called by the DSP thread only.</summary>
+        void record(const uint16_t* samples, const uint16_t* rssi, const uint8_t* control, uint16_t length);
+        /// <summary>Asks for a snapshot of the ring; may be called from any thread.</summary>
+        void trigger(BLACKBOX_TRIGGER reason);
+
+        /// <summary>Asks every black box recorder for a snapshot; safe to call from a signal handler.</summary>
+        static void request();
+
+        /// <summary>Stops the snapshot thread and unmaps the ring.</summary>
+        void close();
+
+    private:
+        std::string m_base;
+        uint32_t m_sampleRate;
+        uint32_t m_channel;
+
+        uint8_t* m_map;
+        size_t m_mapLength;
+        uint16_t* m_samples;
+        uint16_t* m_rssi;
+        uint8_t* m_control;
+        uint32_t m_length;                  // ring length in samples
+        uint32_t m_window;                  // samples in a snapshot
+
+        uint32_t m_pos;                     // written by the DSP thread only
+        uint64_t m_written;
+        uint64_t m_trigger;                 // pending reason (top byte) and the sample it happened at
+
+        uint64_t m_holdoff;                 // written by the snapshot thread only
+        uint32_t m_requestSeen;
+        uint32_t m_snapshots;
+        uint32_t m_suppressed;
+        std::vector<uint16_t> m_buffer;
+
+        pthread_t m_thread;
+        volatile bool m_running;
+
+        static uint32_t m_request;
+
+        /// <summary>Helper to write the last seconds of the ring to a SigMF recording.</summary>
+        void snapshot(BLACKBOX_TRIGGER reason, uint64_t at);
+
+        /// <summary></summary>
+        static void* threadHelper(void* arg);
+    };
+} // namespace sdr
+
+#endif // __BLACK_BOX_H__
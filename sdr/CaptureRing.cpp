@@ -0,0 +1,153 @@
+/**
+* Digital Voice Modem - DSP Firmware
+* GPLv2 Open Source. Use is subject to license terms.
+* DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+*
+* @package DVM / DSP Firmware
+*
+*/
+/*
+*   Copyright (C) 2022 Bryan Biedenkapp N2PLL
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 2 of the License, or
+*   (at your option) any later version.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program; if not, write to the Free Software
+*   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*/
+#include "sdr/CaptureRing.h"
+
+#include <cstring>
+
+using namespace sdr;
+
+// ---------------------------------------------------------------------------
+//  Macros
+// ---------------------------------------------------------------------------
+
+#define LOAD_ACQUIRE(v)         __atomic_load_n(&(v), __ATOMIC_ACQUIRE)
+#define LOAD_RELAXED(v)         __atomic_load_n(&(v), __ATOMIC_RELAXED)
+#define STORE_RELEASE(v, x)     __atomic_store_n(&(v), (x), __ATOMIC_RELEASE)
+
+// ---------------------------------------------------------------------------
+//  Public Class Members
+// ---------------------------------------------------------------------------
+
+/// <summary>
+/// Initializes a new instance of the CaptureRing class.
+/// </summary>
+/// <param name="length">Length of the ring in words, a power of two.</param>
+CaptureRing::CaptureRing(uint32_t length) :
+    m_length(length),
+    m_mask(length - 1U),
+    m_data(NULL),
+    m_head(0U),
+    m_tail(0U)
+{
+    m_data = new uint16_t[length];
+}
+
+/// <summary>
+/// Finalizes a instance of the CaptureRing class.
+/// </summary>
+CaptureRing::~CaptureRing()
+{
+    delete[] m_data;
+}
+
+/// <summary>
+/// Gets the number of words queued in the ring.
+/// </summary>
+/// <returns></returns>
+uint32_t CaptureRing::getData() const
+{
+    return LOAD_ACQUIRE(m_head) - LOAD_RELAXED(m_tail);
+}
+
+/// <summary>
+/// Gets the number of words free in the ring.
+/// </summary>
+/// <returns></returns>
+uint32_t CaptureRing::getSpace() const
+{
+    return m_length - (LOAD_RELAXED(m_head) - LOAD_ACQUIRE(m_tail));
+}
+
+/// <summary>
+/// Copies a record made of two parts into the ring, if it fits whole.
+/// </summary>
+/// <remarks>The consumer sees the record only once all of it is in the ring.</remarks>
+/// <param name="header"></param>
+/// <param name="headerLength">Length of the header in words.</param>
+/// <param name="data"></param>
+/// <param name="length">Length of the data in words.</param>
+/// <returns>True, if the record was queued, otherwise false.</returns>
+bool CaptureRing::write(const uint16_t* header, uint32_t headerLength, const uint16_t* data, uint32_t length)
+{
+    if ((headerLength + length) > getSpace())
+        return false;
+
+    uint32_t head = LOAD_RELAXED(m_head);
+    copyIn(head, header, headerLength);
+    copyIn(head + headerLength, data, length);
+
+    STORE_RELEASE(m_head, head + headerLength + length);
+    return true;
+}
+
+/// <summary>
+/// Copies words out of the ring; the caller checks they are queued.
+/// </summary>
+/// <param name="data"></param>
+/// <param name="length">Length in words.</param>
+void CaptureRing::read(uint16_t* data, uint32_t length)
+{
+    uint32_t tail = LOAD_RELAXED(m_tail);
+    uint32_t pos = tail & m_mask;
+    uint32_t first = m_length - pos;
+    if (first > length)
+        first = length;
+
+    ::memcpy(data, m_data + pos, first * sizeof(uint16_t));
+    ::memcpy(data + first, m_data, (length - first) * sizeof(uint16_t));
+
+    STORE_RELEASE(m_tail, tail + length);
+}
+
+/// <summary>
+/// Discards everything queued; only while neither side is running.
+/// </summary>
+void CaptureRing::reset()
+{
+    STORE_RELEASE(m_head, 0U);
+    STORE_RELEASE(m_tail, 0U);
+}
+
+// ---------------------------------------------------------------------------
+//  Private Class Members
+// ---------------------------------------------------------------------------
+
+/// <summary>
+/// Helper to copy words into the ring at the given free running index.
+/// </summary>
+/// <param name="index"></param>
+/// <param name="data"></param>
+/// <param name="length">Length in words.</param>
+void CaptureRing::copyIn(uint32_t index, const uint16_t* data, uint32_t length)
+{
+    uint32_t pos = index & m_mask;
+    uint32_t first = m_length - pos;
+    if (first > length)
+        first = length;
+
+    ::memcpy(m_data + pos, data, first * sizeof(uint16_t));
+    ::memcpy(m_data, data + first, (length - first) * sizeof(uint16_t));
+}
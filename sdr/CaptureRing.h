@@ -0,0 +1,83 @@
+/**
+* Digital Voice Modem - DSP Firmware
+* GPLv2 Open Source. Use is subject to license terms.
+* DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+*
+* @package DVM / DSP Firmware
+*
+*/
+/*
+*   Copyright (C) 2022 Bryan Biedenkapp N2PLL
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 2 of the License, or
+*   (at your option) any later version.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program; if not, write to the Free Software
+*   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*/
+#if !defined(__CAPTURE_RING_H__)
+#define __CAPTURE_RING_H__
+
+#include "Defines.h"
+
+namespace sdr
+{
+    // ---------------------------------------------------------------------------
+    //  Class Declaration
+    //      Implements a single-producer/single-consumer ring of 16-bit words
+    //      handing records from a DSP thread to a background writer. Records
+    //      are committed whole and the producer never waits; a record that
+    //      does not fit is refused.
+    // ---------------------------------------------------------------------------
+
+    class DSP_FW_API CaptureRing {
+    public:
+        /// <summary>Initializes a new instance of the CaptureRing class.</summary>
+        CaptureRing(uint32_t length);
+        /// <summary>Finalizes a instance of the CaptureRing class.</summary>
+        ~CaptureRing();
+
+        /// <summary>Gets the number of words queued in the ring.</summary>
+        uint32_t getData() const;
+        /// <summary>Gets the number of words free in the ring.</summary>
+        uint32_t getSpace() const;
+
+        /// <summary>Copies a record made of two parts into the ring, if it fits whole.</summary>
+        bool write(const uint16_t* header, uint32_t headerLength, const uint16_t* data, uint32_t length);
+        /// <summary>Copies words out of the ring; the caller checks they are queued.</summary>
+        void read(uint16_t* data, uint32_t length);
+
+        /// <summary>Discards everything queued; only while neither side is running.</summary>
+        void reset();
+
+    private:
+        uint32_t m_length;
+        uint32_t m_mask;
+        uint16_t* m_data;
+
+        CACHE_LINE_PAD(m_pad0);
+
+        // written only by the producer
+        uint32_t m_head;
+
+        CACHE_LINE_PAD(m_pad1);
+
+        // written only by the consumer
+        uint32_t m_tail;
+
+        CACHE_LINE_PAD(m_pad2);
+
+        /// <summary>Helper to copy words into the ring at the given free running index.</summary>
+        void copyIn(uint32_t index, const uint16_t* data, uint32_t length);
+    };
+} // namespace sdr
+
+#endif // __CAPTURE_RING_H__
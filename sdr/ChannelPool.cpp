@@ -0,0 +1,250 @@
+/**
+* Digital Voice Modem - DSP Firmware
+* GPLv2 Open Source. Use is subject to license terms.
+* DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+*
+* @package DVM / DSP Firmware
+*
+*/
+/*
+*   Copyright (C) 2022 Bryan Biedenkapp N2PLL
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 2 of the License, or
+*   (at your option) any later version.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program; if not, write to the Free Software
+*   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*/
+#include "Globals.h"
+#include "sdr/ChannelPool.h"
+#include "sdr/Log.h"
+#include "sdr/Modem.h"
+
+#include <sys/epoll.h>
+#include <unistd.h>
+#include <cerrno>
+#include <string>
+
+using namespace sdr;
+
+// ---------------------------------------------------------------------------
+//  Macros
+// ---------------------------------------------------------------------------
+
+#define LOAD_ACQUIRE(v)         __atomic_load_n(&(v), __ATOMIC_ACQUIRE)
+#define STORE_RELEASE(v, x)     __atomic_store_n(&(v), (x), __ATOMIC_RELEASE)
+
+// ---------------------------------------------------------------------------
+//  Public Class Members
+// ---------------------------------------------------------------------------
+
+/// <summary>
+/// Initializes a new instance of the ChannelPool class.
+/// </summary>
+ChannelPool::ChannelPool() :
+    m_epollFd(-1),
+    m_channels(),
+    m_killed(NULL),
+    m_stop(false),
+    m_nextWorker(0U),
+    m_policy(NULL)
+{
+    /* stub */
+}
+
+/// <summary>
+/// Finalizes a instance of the ChannelPool class.
+/// </summary>
+ChannelPool::~ChannelPool()
+{
+    close();
+}
+
+/// <summary>
+/// Opens the channel pool.
+/// </summary>
+/// <returns>True, if the channel pool was opened, otherwise false.</returns>
+bool ChannelPool::open()
+{
+    m_epollFd = ::epoll_create1(EPOLL_CLOEXEC);
+    if (m_epollFd < 0) {
+        ::LogError(LOG_DSP, "Cannot create the channel pool epoll instance, errno = %d", errno);
+        return false;
+    }
+
+    return true;
+}
+
+/// <summary>
+/// Adds a modem channel to the pool.
+/// </summary>
+/// <param name="modem">Modem channel with an open event loop.</param>
+/// <returns>True, if the channel was added, otherwise false.</returns>
+bool ChannelPool::add(Modem* modem)
+{
+    if (m_epollFd < 0 || modem == NULL)
+        return false;
+
+    Channel* channel = new Channel();
+    channel->modem = modem;
+    ::clock_gettime(CLOCK_MONOTONIC, &channel->armed);
+
+    if (!arm(channel, EPOLL_CTL_ADD)) {
+        delete channel;
+        return false;
+    }
+
+    m_channels.push_back(channel);
+    return true;
+}
+
+/// <summary>
+/// Runs the main loop of the channels on the given number of workers until the kill flag is set.
+/// </summary>
+/// <remarks>The calling thread is the first worker; the others are created with the given policy.</remarks>
+/// <param name="workers">Number of worker threads.</param>
+/// <param name="policy">Scheduling policy of the workers.</param>
+/// <param name="killed">Flag set by the signal handler.</param>
+void ChannelPool::run(uint32_t workers, const ThreadPolicy& policy, const bool* killed)
+{
+    m_killed = killed;
+    m_policy = &policy;
+    m_nextWorker = 1U;
+    STORE_RELEASE(m_stop, false);
+
+    // a previous run may have stopped with channels still checked out
+    for (std::vector<Channel*>::iterator it = m_channels.begin(); it != m_channels.end(); ++it)
+        arm(*it, EPOLL_CTL_MOD);
+
+    if (workers < 1U)
+        workers = 1U;
+
+    std::vector<pthread_t> threads;
+    for (uint32_t i = 1U; i < workers; i++) {
+        pthread_t thread;
+        if (policy.create(&thread, workerHelper, this, "Worker"))
+            threads.push_back(thread);
+    }
+
+    work(0U);
+
+    for (std::vector<pthread_t>::iterator it = threads.begin(); it != threads.end(); ++it)
+        ::pthread_join(*it, NULL);
+}
+
+/// <summary>
+/// Closes the channel pool.
+/// </summary>
+void ChannelPool::close()
+{
+    for (std::vector<Channel*>::iterator it = m_channels.begin(); it != m_channels.end(); ++it)
+        delete *it;
+    m_channels.clear();
+
+    if (m_epollFd >= 0) {
+        ::close(m_epollFd);
+        m_epollFd = -1;
+    }
+}
+
+// ---------------------------------------------------------------------------
+//  Private Class Members
+// ---------------------------------------------------------------------------
+
+/// <summary>
+/// Helper to hand a channel back to the pool so its next event wakes a worker.
+/// </summary>
+/// <param name="channel"></param>
+/// <param name="op">EPOLL_CTL_ADD for a new channel, otherwise EPOLL_CTL_MOD.</param>
+/// <returns>True, if the channel was armed, otherwise false.</returns>
+bool ChannelPool::arm(Channel* channel, int op)
+{
+    // one shot, so only one worker at a time runs a channel
+    epoll_event ev;
+    ev.events = EPOLLIN | EPOLLONESHOT;
+    ev.data.ptr = channel;
+    if (::epoll_ctl(m_epollFd, op, channel->modem->m_eventLoop.getFd(), &ev) < 0) {
+        ::LogError(LOG_DSP, "Cannot arm channel %u, errno = %d", channel->modem->getId(), errno);
+        return false;
+    }
+
+    return true;
+}
+
+/// <summary>
+/// Helper to run the main loop of a channel that has work.
+/// </summary>
+/// <param name="channel"></param>
+/// <param name="idleSince">When the channel and the worker were both last idle.</param>
+void ChannelPool::service(Channel* channel, const timespec& idleSince)
+{
+    Modem* modem = channel->modem;
+
+    modem->m_eventLoop.wait(0, &idleSince);
+
+    // drain every complete Rx block before handing the channel back
+    do {
+        modem->m_firmware.loop();
+    } while (modem->m_io.hasRXBlock() && !LOAD_ACQUIRE(*m_killed));
+
+    WakeupLatency& latency = modem->m_eventLoop.getLatency();
+    if (latency.isDue(WAKEUP_LATENCY_INTERVAL))
+        latency.logStats(modem->getName("Main").c_str());
+
+    ::clock_gettime(CLOCK_MONOTONIC, &channel->armed);
+    arm(channel, EPOLL_CTL_MOD);
+}
+
+/// <summary>
+/// Runs a worker until the pool is stopped.
+/// </summary>
+/// <param name="worker">Worker number; worker 0 watches the kill flag and stops the pool.</param>
+void ChannelPool::work(uint32_t worker)
+{
+    while (!LOAD_ACQUIRE(m_stop)) {
+        if (worker == 0U && LOAD_ACQUIRE(*m_killed)) {
+            STORE_RELEASE(m_stop, true);
+            break;
+        }
+
+        timespec idle;
+        ::clock_gettime(CLOCK_MONOTONIC, &idle);
+
+        epoll_event ev;
+        int n = ::epoll_wait(m_epollFd, &ev, 1, CHANNEL_POOL_WAIT);
+        if (n <= 0)
+            continue;
+
+        // the housekeeping tick only counts as a wakeup if it came due while both the
+        // worker and the channel were idle
+        Channel* channel = (Channel*)ev.data.ptr;
+        timespec armed = channel->armed;
+        if (armed.tv_sec > idle.tv_sec || (armed.tv_sec == idle.tv_sec && armed.tv_nsec > idle.tv_nsec))
+            idle = armed;
+
+        service(channel, idle);
+    }
+}
+
+/// <summary></summary>
+/// <param name="arg"></param>
+/// <returns></returns>
+void* ChannelPool::workerHelper(void* arg)
+{
+    ChannelPool* p = (ChannelPool*)arg;
+    uint32_t worker = __atomic_fetch_add(&p->m_nextWorker, 1U, __ATOMIC_RELAXED);
+
+    std::string name = "Worker " + std::to_string(worker);
+    p->m_policy->apply(name.c_str());
+
+    p->work(worker);
+    return NULL;
+}
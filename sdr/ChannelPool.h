@@ -0,0 +1,99 @@
+/**
+* Digital Voice Modem - DSP Firmware
+* GPLv2 Open Source. Use is subject to license terms.
+* DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+*
+* @package DVM / DSP Firmware
+*
+*/
+/*
+*   Copyright (C) 2022 Bryan Biedenkapp N2PLL
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 2 of the License, or
+*   (at your option) any later version.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program; if not, write to the Free Software
+*   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*/
+#if !defined(__CHANNEL_POOL_H__)
+#define __CHANNEL_POOL_H__
+
+#include "Defines.h"
+#include "sdr/ThreadPolicy.h"
+
+#include <pthread.h>
+#include <time.h>
+
+#include <vector>
+
+namespace sdr
+{
+    // ---------------------------------------------------------------------------
+    //  Constants
+    // ---------------------------------------------------------------------------
+
+    // how long an idle worker waits before checking for shutdown, in milliseconds
+    const int CHANNEL_POOL_WAIT = 100;
+
+    class Modem;
+
+    // ---------------------------------------------------------------------------
+    //  Class Declaration
+    //      Implements a pool of worker threads running the main loop of the modem
+    //      channels; a channel is serviced by one worker at a time, whichever is
+    //      free when its event loop has work.
+    // ---------------------------------------------------------------------------
+
+    class DSP_FW_API ChannelPool {
+    public:
+        /// <summary>Initializes a new instance of the ChannelPool class.</summary>
+        ChannelPool();
+        /// <summary>Finalizes a instance of the ChannelPool class.</summary>
+        ~ChannelPool();
+
+        /// <summary>Opens the channel pool.</summary>
+        bool open();
+        /// <summary>Adds a modem channel to the pool.</summary>
+        bool add(Modem* modem);
+
+        /// <summary>Runs the main loop of the channels on the given number of workers until the kill flag is set.</summary>
+        void run(uint32_t workers, const ThreadPolicy& policy, const bool* killed);
+
+        /// <summary>Closes the channel pool.</summary>
+        void close();
+
+    private:
+        struct Channel {
+            Modem* modem;
+            timespec armed;                 // when the channel was last handed back to the pool
+        };
+
+        int m_epollFd;
+        std::vector<Channel*> m_channels;
+
+        const bool* m_killed;
+        bool m_stop;
+        uint32_t m_nextWorker;
+        const ThreadPolicy* m_policy;
+
+        /// <summary>Helper to hand a channel back to the pool so its next event wakes a worker.</summary>
+        bool arm(Channel* channel, int op);
+        /// <summary>Helper to run the main loop of a channel that has work.</summary>
+        void service(Channel* channel, const timespec& idleSince);
+        /// <summary>Runs a worker until the pool is stopped.</summary>
+        void work(uint32_t worker);
+
+        /// <summary></summary>
+        static void* workerHelper(void* arg);
+    };
+} // namespace sdr
+
+#endif // __CHANNEL_POOL_H__
@@ -0,0 +1,304 @@
+/**
+* Digital Voice Modem - DSP Firmware
+* GPLv2 Open Source. Use is subject to license terms.
+* DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+*
+* @package DVM / DSP Firmware
+*
+*/
+/*
+*   Copyright (C) 2022 Bryan Biedenkapp N2PLL
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 2 of the License, or
+*   (at your option) any later version.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program; if not, write to the Free Software
+*   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*/
+#include "sdr/Channelizer.h"
+
+#include <cmath>
+#include <algorithm>
+#include <cstring>
+
+using namespace sdr;
+
+// ---------------------------------------------------------------------------
+//  Public Class Members
+// ---------------------------------------------------------------------------
+
+/// <summary>
+/// Initializes a new instance of the Channelizer class.
+/// </summary>
+Channelizer::Channelizer() :
+    m_branches(0U),
+    m_decimation(0U),
+    m_length(0U),
+    m_taps(),
+    m_histI(),
+    m_histQ(),
+    m_foldI(),
+    m_foldQ(),
+    m_fftRe(),
+    m_fftIm(),
+    m_bitRev(),
+    m_stageRe(),
+    m_stageIm(),
+    m_rotRe(),
+    m_rotIm(),
+    m_bins(),
+    m_phase(0U),
+    m_time(0U)
+{
+    /* stub */
+}
+
+/// <summary>
+/// Opens the filter bank with the given number of branches and output bins.
+/// </summary>
+/// <param name="branches">Number of branches (FFT size), a power of 2; the channel spacing is the input rate over this.</param>
+/// <param name="bins">FFT bins to output, one per channel; bin k is centered at +k times the spacing.</param>
+/// <returns>True, if the filter bank was opened, otherwise false.</returns>
+bool Channelizer::open(uint32_t branches, const std::vector<uint32_t>& bins)
+{
+    if (branches < CHANNELIZER_BRANCHES_MIN || branches > CHANNELIZER_BRANCHES_MAX || (branches & (branches - 1U)) != 0U)
+        return false;
+    if (bins.empty())
+        return false;
+    for (size_t i = 0U; i < bins.size(); i++) {
+        if (bins[i] >= branches)
+            return false;
+    }
+
+    m_branches = branches;
+    m_decimation = branches / 2U;
+    m_length = branches * CHANNELIZER_TAPS_PER_BRANCH;
+    m_bins = bins;
+
+    // Blackman windowed sinc prototype, normalized for unity gain at DC
+    std::vector<float> proto(m_length);
+    const double fc = double(CHANNELIZER_CUTOFF) / double(branches);
+    const double mid = double(m_length - 1U) / 2.0;
+
+    double sum = 0.0;
+    for (uint32_t i = 0U; i < m_length; i++) {
+        double n = double(i) - mid;
+        double sinc = (n == 0.0) ? (2.0 * fc) : (::sin(2.0 * M_PI * fc * n) / (M_PI * n));
+        double x = (2.0 * M_PI * double(i)) / double(m_length - 1U);
+        double window = 0.42 - (0.5 * ::cos(x)) + (0.08 * ::cos(2.0 * x));
+        proto[i] = float(sinc * window);
+        sum += sinc * window;
+    }
+
+    // time reverse the taps, so the oldest history sample meets the last tap
+    m_taps.resize(m_length);
+    for (uint32_t i = 0U; i < m_length; i++)
+        m_taps[i] = float(double(proto[m_length - 1U - i]) / sum);
+
+    m_histI.assign(m_length - 1U + CHANNELIZER_BLOCK_SIZE, 0.0F);
+    m_histQ.assign(m_length - 1U + CHANNELIZER_BLOCK_SIZE, 0.0F);
+
+    m_foldI.assign(branches, 0.0F);
+    m_foldQ.assign(branches, 0.0F);
+    m_fftRe.assign(branches, 0.0F);
+    m_fftIm.assign(branches, 0.0F);
+
+    uint32_t bits = 0U;
+    while ((1U << bits) < branches)
+        bits++;
+
+    m_bitRev.resize(branches);
+    for (uint32_t i = 0U; i < branches; i++) {
+        uint32_t r = 0U;
+        for (uint32_t b = 0U; b < bits; b++) {
+            if ((i & (1U << b)) != 0U)
+                r |= 1U << (bits - 1U - b);
+        }
+        m_bitRev[i] = r;
+    }
+
+    // the twiddles of the stage combining halves of length h live at [h - 1, 2h - 1)
+    m_stageRe.resize(branches - 1U);
+    m_stageIm.resize(branches - 1U);
+    for (uint32_t h = 1U; h < branches; h <<= 1) {
+        for (uint32_t j = 0U; j < h; j++) {
+            m_stageRe[h - 1U + j] = float(::cos(-M_PI * double(j) / double(h)));
+            m_stageIm[h - 1U + j] = float(::sin(-M_PI * double(j) / double(h)));
+        }
+    }
+
+    m_rotRe.resize(branches);
+    m_rotIm.resize(branches);
+    for (uint32_t i = 0U; i < branches; i++) {
+        m_rotRe[i] = float(::cos(-2.0 * M_PI * double(i) / double(branches)));
+        m_rotIm[i] = float(::sin(-2.0 * M_PI * double(i) / double(branches)));
+    }
+
+    reset();
+    return true;
+}
+
+/// <summary>
+/// Resets the filter history.
+/// </summary>
+void Channelizer::reset()
+{
+    std::fill(m_histI.begin(), m_histI.end(), 0.0F);
+    std::fill(m_histQ.begin(), m_histQ.end(), 0.0F);
+
+    m_phase = m_decimation - 1U;
+    m_time = 0U;
+}
+
+/// <summary>
+/// Channelizes deinterleaved complex samples into interleaved complex samples per channel.
+/// </summary>
+/// <param name="inI">In-phase input samples.</param>
+/// <param name="inQ">Quadrature input samples.</param>
+/// <param name="count">Number of input samples.</param>
+/// <param name="out">Interleaved complex output per channel, each must hold getMaxOutput(count) samples.</param>
+/// <returns>Number of samples written to each channel.</returns>
+uint32_t Channelizer::process(const float* inI, const float* inQ, uint32_t count, float* const* out)
+{
+    if (m_branches == 0U)
+        return 0U;
+
+    const uint32_t hist = m_length - 1U;
+    uint32_t written = 0U;
+    uint32_t done = 0U;
+    while (done < count) {
+        uint32_t n = count - done;
+        if (n > CHANNELIZER_BLOCK_SIZE)
+            n = CHANNELIZER_BLOCK_SIZE;
+
+        ::memcpy(&m_histI[hist], inI + done, n * sizeof(float));
+        ::memcpy(&m_histQ[hist], inQ + done, n * sizeof(float));
+
+        // every decimation samples the window ending at the newest sample produces one output per channel
+        uint32_t pos = m_phase;
+        while (pos < n) {
+            output(pos, (m_time + pos + 1U) & (m_branches - 1U), out, written);
+            written++;
+            pos += m_decimation;
+        }
+
+        m_phase = pos - n;
+        m_time = (m_time + n) & (m_branches - 1U);
+
+        // keep the newest samples as history for the next block
+        ::memmove(&m_histI[0U], &m_histI[n], hist * sizeof(float));
+        ::memmove(&m_histQ[0U], &m_histQ[n], hist * sizeof(float));
+
+        done += n;
+    }
+
+    return written;
+}
+
+/// <summary>
+/// Helper to get the bin a frequency offset falls in.
+/// </summary>
+/// <param name="offset">Channel offset from the wideband center (in Hz), a multiple of the spacing.</param>
+/// <param name="spacing">Channel spacing (in Hz).</param>
+/// <param name="branches">Number of filter bank branches.</param>
+/// <returns></returns>
+uint32_t Channelizer::getBin(int32_t offset, uint32_t spacing, uint32_t branches)
+{
+    int32_t bin = offset / int32_t(spacing);
+    if (bin < 0)
+        bin += int32_t(branches);
+
+    return uint32_t(bin);
+}
+
+// ---------------------------------------------------------------------------
+//  Private Class Members
+// ---------------------------------------------------------------------------
+
+/// <summary>
+/// Helper to compute one output sample of every channel from the window starting at the given history index.
+/// </summary>
+/// <param name="base">History index of the oldest sample in the window.</param>
+/// <param name="time">Index after the newest sample in the window, modulo the branches.</param>
+/// <param name="out">Interleaved complex output per channel.</param>
+/// <param name="index">Output sample index.</param>
+void Channelizer::output(uint32_t base, uint32_t time, float* const* out, uint32_t index)
+{
+    const uint32_t m = m_branches;
+    const float* taps = &m_taps[0U];
+    const float* histI = &m_histI[base];
+    const float* histQ = &m_histQ[base];
+    float* foldI = &m_foldI[0U];
+    float* foldQ = &m_foldQ[0U];
+
+    // weight the window and fold it onto the branches; the inner loops are contiguous and vectorize
+    for (uint32_t r = 0U; r < m; r++) {
+        foldI[r] = taps[r] * histI[r];
+        foldQ[r] = taps[r] * histQ[r];
+    }
+
+    for (uint32_t p = 1U; p < CHANNELIZER_TAPS_PER_BRANCH; p++) {
+        const float* t = taps + (p * m);
+        const float* i = histI + (p * m);
+        const float* q = histQ + (p * m);
+        for (uint32_t r = 0U; r < m; r++) {
+            foldI[r] += t[r] * i[r];
+            foldQ[r] += t[r] * q[r];
+        }
+    }
+
+    for (uint32_t r = 0U; r < m; r++) {
+        m_fftRe[m_bitRev[r]] = foldI[r];
+        m_fftIm[m_bitRev[r]] = foldQ[r];
+    }
+
+    fft();
+
+    // undo the phase of the window position, mixing each bin down to baseband
+    for (size_t c = 0U; c < m_bins.size(); c++) {
+        uint32_t k = m_bins[c];
+        uint32_t rot = (k * time) & (m - 1U);
+
+        float re = m_fftRe[k];
+        float im = m_fftIm[k];
+        out[c][2U * index] = (re * m_rotRe[rot]) - (im * m_rotIm[rot]);
+        out[c][(2U * index) + 1U] = (re * m_rotIm[rot]) + (im * m_rotRe[rot]);
+    }
+}
+
+/// <summary>
+/// Helper to run the in place FFT over the bit reversed fold.
+/// </summary>
+void Channelizer::fft()
+{
+    const uint32_t m = m_branches;
+    float* re = &m_fftRe[0U];
+    float* im = &m_fftIm[0U];
+
+    for (uint32_t h = 1U; h < m; h <<= 1) {
+        const float* wRe = &m_stageRe[h - 1U];
+        const float* wIm = &m_stageIm[h - 1U];
+        for (uint32_t s = 0U; s < m; s += 2U * h) {
+            float* aRe = re + s;
+            float* aIm = im + s;
+            float* bRe = re + s + h;
+            float* bIm = im + s + h;
+            for (uint32_t j = 0U; j < h; j++) {
+                float tRe = (wRe[j] * bRe[j]) - (wIm[j] * bIm[j]);
+                float tIm = (wRe[j] * bIm[j]) + (wIm[j] * bRe[j]);
+                bRe[j] = aRe[j] - tRe;
+                bIm[j] = aIm[j] - tIm;
+                aRe[j] += tRe;
+                aIm[j] += tIm;
+            }
+        }
+    }
+}
@@ -0,0 +1,113 @@
+/**
+* Digital Voice Modem - DSP Firmware
+* GPLv2 Open Source. Use is subject to license terms.
+* DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+*
+* @package DVM / DSP Firmware
+*
+*/
+/*
+*   Copyright (C) 2022 Bryan Biedenkapp N2PLL
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 2 of the License, or
+*   (at your option) any later version.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program; if not, write to the Free Software
+*   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*/
+#if !defined(__CHANNELIZER_H__)
+#define __CHANNELIZER_H__
+
+#include "Defines.h"
+
+#include <vector>
+
+namespace sdr
+{
+    // ---------------------------------------------------------------------------
+    //  Constants
+    // ---------------------------------------------------------------------------
+
+    const uint32_t CHANNELIZER_BRANCHES_MIN = 4U;
+    const uint32_t CHANNELIZER_BRANCHES_MAX = 1024U;
+    const uint32_t CHANNELIZER_TAPS_PER_BRANCH = 24U;
+    const uint32_t CHANNELIZER_BLOCK_SIZE = 4096U;
+
+    // one sided cutoff of the prototype low pass, in channel spacings; the channels
+    // come out at twice the spacing, so the transition band does not alias
+    const float CHANNELIZER_CUTOFF = 0.55F;
+
+    // ---------------------------------------------------------------------------
+    //  Class Declaration
+    //      Implements a 2x oversampled polyphase filter bank channelizer; splits
+    //      complex baseband at M times the channel spacing into channels at twice
+    //      the spacing, one FFT per M/2 input samples.
+    // ---------------------------------------------------------------------------
+
+    class DSP_FW_API Channelizer {
+    public:
+        /// <summary>Initializes a new instance of the Channelizer class.</summary>
+        Channelizer();
+
+        /// <summary>Opens the filter bank with the given number of branches and output bins.</summary>
+        bool open(uint32_t branches, const std::vector<uint32_t>& bins);
+        /// <summary>Resets the filter history.</summary>
+        void reset();
+
+        /// <summary>Gets the number of filter bank branches (FFT size).</summary>
+        uint32_t getBranches() const { return m_branches; }
+        /// <summary>Gets the decimation from the input to the channel rate.</summary>
+        uint32_t getDecimation() const { return m_decimation; }
+        /// <summary>Gets the number of output channels.</summary>
+        uint32_t getChannels() const { return uint32_t(m_bins.size()); }
+        /// <summary>Gets the largest number of samples per channel the given number of input samples produces.</summary>
+        uint32_t getMaxOutput(uint32_t samples) const { return (samples / m_decimation) + 1U; }
+        /// <summary>Gets the prototype low pass filter, time reversed.</summary>
+        const std::vector<float>& getTaps() const { return m_taps; }
+
+        /// <summary>Channelizes deinterleaved complex samples into interleaved complex samples per channel.</summary>
+        uint32_t process(const float* inI, const float* inQ, uint32_t count, float* const* out);
+
+        /// <summary>Helper to get the bin a frequency offset falls in.</summary>
+        static uint32_t getBin(int32_t offset, uint32_t spacing, uint32_t branches);
+
+    private:
+        uint32_t m_branches;
+        uint32_t m_decimation;
+        uint32_t m_length;
+
+        std::vector<float> m_taps;          // time reversed prototype, lined up with the history
+        std::vector<float> m_histI;
+        std::vector<float> m_histQ;
+
+        std::vector<float> m_foldI;
+        std::vector<float> m_foldQ;
+        std::vector<float> m_fftRe;
+        std::vector<float> m_fftIm;
+        std::vector<uint32_t> m_bitRev;
+        std::vector<float> m_stageRe;       // per stage FFT twiddles, stored contiguously
+        std::vector<float> m_stageIm;
+        std::vector<float> m_rotRe;         // e^-j2pik/M, the output phase correction
+        std::vector<float> m_rotIm;
+
+        std::vector<uint32_t> m_bins;
+
+        uint32_t m_phase;
+        uint32_t m_time;
+
+        /// <summary>Helper to compute one output sample of every channel from the window starting at the given history index.</summary>
+        void output(uint32_t base, uint32_t time, float* const* out, uint32_t index);
+        /// <summary>Helper to run the in place FFT over the bit reversed fold.</summary>
+        void fft();
+    };
+} // namespace sdr
+
+#endif // __CHANNELIZER_H__
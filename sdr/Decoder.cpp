@@ -0,0 +1,277 @@
+/**
+* Digital Voice Modem - DSP Firmware
+* GPLv2 Open Source. Use is subject to license terms.
+* DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+*
+* @package DVM / DSP Firmware
+*
+*/
+/*
+*   Copyright (C) 2022 Bryan Biedenkapp N2PLL
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 2 of the License, or
+*   (at your option) any later version.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program; if not, write to the Free Software
+*   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*/
+#include "Globals.h"
+#include "sdr/Decoder.h"
+#include "sdr/SigMFReplay.h"
+#include "sdr/transport/FileTransport.h"
+
+#include <time.h>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+
+using namespace sdr;
+using namespace sdr::transport;
+
+// ---------------------------------------------------------------------------
+//  Constants
+// ---------------------------------------------------------------------------
+
+// size of the output file buffer; frames are small and written one at a time
+const size_t DECODE_OUTPUT_BUFFER = 65536U;
+
+// ---------------------------------------------------------------------------
+//  Global Functions
+// ---------------------------------------------------------------------------
+
+/// <summary>
+/// Helper to check whether a recording is a SigMF capture.
+/// </summary>
+/// <param name="path"></param>
+/// <returns></returns>
+static bool isSigMF(const std::string& path)
+{
+    return path.find(".sigmf-") != std::string::npos;
+}
+
+/// <summary>
+/// Decodes a recording on the calling thread as fast as the DSP runs and writes the frames to the output.
+/// </summary>
+/// <remarks>A SigMF capture made by --capture is fed straight into the Rx ring buffers; any other
+/// recording is read in the Rx format of the channel options, as a file:// Rx endpoint would be.</remarks>
+/// <param name="config">Channel options giving the Rx format of the recording.</param>
+/// <param name="input">Path of the recording.</param>
+/// <param name="output">Path of the file the frames are written to, or empty or "-" for stdout.</param>
+/// <param name="killed">Flag set when the decode should stop early.</param>
+/// <returns>Process exit code.</returns>
+int sdr::runDecoder(const ChannelConfig& config, const std::string& input, const std::string& output, const bool* killed)
+{
+    ChannelConfig decode = config;
+    decode.zmqTx = std::string();
+    decode.shmName = std::string();
+    decode.capturePath = std::string();
+    decode.blackBoxPath = std::string();
+
+    // there is no live clock to drift against
+    decode.driftComp = false;
+
+    // the log only goes to its file, so a recording that cannot be read is reported here too
+    if (isSigMF(input)) {
+        decode.zmqRx = std::string();
+        decode.replayPath = input;
+        decode.replayFast = true;
+
+        SigMFReplay replay;
+        if (!replay.open(input, SAMPLE_RATE, false)) {
+            ::fprintf(stderr, "unable to replay the recording %s, see the log\n", input.c_str());
+            return EXIT_FAILURE;
+        }
+    }
+    else {
+        decode.zmqRx = FileTransport::isFile(input) ? input : "file://" + input;
+        decode.replayPath = std::string();
+
+        FILE* fp = ::fopen(decode.zmqRx.substr(7U).c_str(), "rb");
+        if (fp == NULL) {
+            ::fprintf(stderr, "unable to open the recording %s, err = %d\n", input.c_str(), errno);
+            return EXIT_FAILURE;
+        }
+        ::fclose(fp);
+    }
+
+    Decoder decoder(output);
+    if (!decoder.open()) {
+        ::fprintf(stderr, "unable to create the output %s, err = %d\n", output.c_str(), errno);
+        return EXIT_FAILURE;
+    }
+
+    ::LogInfoEx(LOG_DSP, "DSP is decoding %s", input.c_str());
+
+    // all receivers run from idle, as they would before the host selects a mode; the
+    // simplex DMR receiver is used as there is no transmitter for the duplex one to follow
+    Modem* modem = new Modem(1U, decode);
+    modem->m_decoder = &decoder;
+
+    modem->m_duplex = false;
+    modem->m_io.start();
+
+    timespec start;
+    ::clock_gettime(CLOCK_MONOTONIC, &start);
+
+    uint64_t samples = 0U;
+    while (!*killed) {
+        uint32_t n = modem->m_io.decodeRx();
+        if (n == 0U)
+            break;
+
+        samples += n;
+        while (modem->m_io.hasRXBlock())
+            modem->m_io.process();
+    }
+
+    timespec end;
+    ::clock_gettime(CLOCK_MONOTONIC, &end);
+    double seconds = double(end.tv_sec - start.tv_sec) + (double(end.tv_nsec - start.tv_nsec) / 1e9);
+
+    modem->close();
+    delete modem;
+
+    decoder.report(input, samples, seconds);
+    decoder.close();
+    return EXIT_SUCCESS;
+}
+
+// ---------------------------------------------------------------------------
+//  Public Class Members
+// ---------------------------------------------------------------------------
+
+/// <summary>
+/// Initializes a new instance of the Decoder class.
+/// </summary>
+/// <param name="output">Path of the file the frames are written to, or empty or "-" for stdout.</param>
+Decoder::Decoder(const std::string& output) :
+    m_output(output),
+    m_file(NULL),
+    m_dmrFrames(0U),
+    m_dmrLost(0U),
+    m_p25Frames(0U),
+    m_p25Lost(0U),
+    m_nxdnFrames(0U),
+    m_nxdnLost(0U),
+    m_bytes(0U)
+{
+    /* stub */
+}
+
+/// <summary>
+/// Finalizes a instance of the Decoder class.
+/// </summary>
+Decoder::~Decoder()
+{
+    close();
+}
+
+/// <summary>
+/// Opens the output file, or stdout if the path is empty or "-".
+/// </summary>
+/// <returns>True, if the output was opened, otherwise false.</returns>
+bool Decoder::open()
+{
+    close();
+
+    if (m_output.empty() || m_output == "-")
+        m_file = stdout;
+    else {
+        m_file = ::fopen(m_output.c_str(), "wb");
+        if (m_file == NULL) {
+            ::LogError(LOG_DSP, "Decoder::open(), failed to create %s, err = %d", m_output.c_str(), errno);
+            return false;
+        }
+    }
+
+    ::setvbuf(m_file, NULL, _IOFBF, DECODE_OUTPUT_BUFFER);
+    return true;
+}
+
+/// <summary>
+/// Writes a frame the modem would have written to the host.
+/// </summary>
+/// <remarks>Frames are written exactly as they would go over the PTY, so the output can be
+/// parsed by anything that reads the modem protocol.</remarks>
+/// <param name="data">Frame, starting with the frame start byte.</param>
+/// <param name="length">Length of the frame in bytes.</param>
+void Decoder::write(const uint8_t* data, uint32_t length)
+{
+    if (m_file == NULL || length < 3U)
+        return;
+
+    switch (data[2U]) {
+    case CMD_DMR_DATA1:
+    case CMD_DMR_DATA2:
+        m_dmrFrames++;
+        break;
+    case CMD_DMR_LOST1:
+    case CMD_DMR_LOST2:
+        m_dmrLost++;
+        break;
+    case CMD_P25_DATA:
+        m_p25Frames++;
+        break;
+    case CMD_P25_LOST:
+        m_p25Lost++;
+        break;
+    case CMD_NXDN_DATA:
+        m_nxdnFrames++;
+        break;
+    case CMD_NXDN_LOST:
+        m_nxdnLost++;
+        break;
+    default:
+        break;
+    }
+
+    m_bytes += ::fwrite(data, 1U, length, m_file);
+}
+
+/// <summary>
+/// Writes the decode statistics to the log and stderr.
+/// </summary>
+/// <param name="input">Path of the recording.</param>
+/// <param name="samples">Number of 24 kHz samples decoded.</param>
+/// <param name="seconds">Time (in seconds) the decode took.</param>
+void Decoder::report(const std::string& input, uint64_t samples, double seconds) const
+{
+    double air = double(samples) / double(SAMPLE_RATE);
+    double elapsed = (seconds > 0.0) ? seconds : 1e-9;
+    uint32_t frames = m_dmrFrames + m_p25Frames + m_nxdnFrames;
+
+    char line1[256U], line2[256U];
+    ::snprintf(line1, sizeof(line1), "Decoded %s, %llu samples (%.1f s) in %.3f s, %.0f samples/s, %.1fx real time",
+        input.c_str(), (unsigned long long)samples, air, seconds, double(samples) / elapsed, air / elapsed);
+    ::snprintf(line2, sizeof(line2), "Decoded frames, DMR = %u (lost %u), P25 = %u (lost %u), NXDN = %u (lost %u), %.1f frames/s, %llu bytes written",
+        m_dmrFrames, m_dmrLost, m_p25Frames, m_p25Lost, m_nxdnFrames, m_nxdnLost, double(frames) / elapsed, (unsigned long long)m_bytes);
+
+    ::LogMessage(LOG_DSP, "%s", line1);
+    ::LogMessage(LOG_DSP, "%s", line2);
+
+    // the frames may be going to stdout
+    ::fprintf(stderr, "%s\n%s\n", line1, line2);
+}
+
+/// <summary>
+/// Closes the output file.
+/// </summary>
+void Decoder::close()
+{
+    if (m_file == NULL)
+        return;
+
+    if (m_file == stdout)
+        ::fflush(m_file);
+    else
+        ::fclose(m_file);
+    m_file = NULL;
+}
@@ -0,0 +1,83 @@
+/**
+* Digital Voice Modem - DSP Firmware
+* GPLv2 Open Source. Use is subject to license terms.
+* DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+*
+* @package DVM / DSP Firmware
+*
+*/
+/*
+*   Copyright (C) 2022 Bryan Biedenkapp N2PLL
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 2 of the License, or
+*   (at your option) any later version.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program; if not, write to the Free Software
+*   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*/
+#if !defined(__DECODER_H__)
+#define __DECODER_H__
+
+#include "Defines.h"
+#include "sdr/Modem.h"
+
+#include <cstdio>
+#include <string>
+
+namespace sdr
+{
+    // ---------------------------------------------------------------------------
+    //  Class Declaration
+    //      Implements the sink of an offline decode; the frames the modem would
+    //      have written to the host are written to a file, and counted.
+    // ---------------------------------------------------------------------------
+
+    class DSP_FW_API Decoder {
+    public:
+        /// <summary>Initializes a new instance of the Decoder class.</summary>
+        Decoder(const std::string& output);
+        /// <summary>Finalizes a instance of the Decoder class.</summary>
+        ~Decoder();
+
+        /// <summary>Opens the output file, or stdout if the path is empty or "-".</summary>
+        bool open();
+
+        /// <summary>Writes a frame the modem would have written to the host.</summary>
+        void write(const uint8_t* data, uint32_t length);
+
+        /// <summary>Writes the decode statistics to the log and stderr.</summary>
+        void report(const std::string& input, uint64_t samples, double seconds) const;
+
+        /// <summary>Closes the output file.</summary>
+        void close();
+
+    private:
+        std::string m_output;
+        FILE* m_file;
+
+        uint32_t m_dmrFrames;
+        uint32_t m_dmrLost;
+        uint32_t m_p25Frames;
+        uint32_t m_p25Lost;
+        uint32_t m_nxdnFrames;
+        uint32_t m_nxdnLost;
+        uint64_t m_bytes;
+    };
+
+    // ---------------------------------------------------------------------------
+    //  Global Functions
+    // ---------------------------------------------------------------------------
+
+    /// <summary>Decodes a recording on the calling thread as fast as the DSP runs and writes the frames to the output.</summary>
+    extern DSP_FW_API int runDecoder(const ChannelConfig& config, const std::string& input, const std::string& output, const bool* killed);
+} // namespace sdr
+
+#endif // __DECODER_H__
@@ -0,0 +1,228 @@
+/**
+* Digital Voice Modem - DSP Firmware
+* GPLv2 Open Source. Use is subject to license terms.
+* DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+*
+* @package DVM / DSP Firmware
+*
+*/
+/*
+*   Copyright (C) 2022 Bryan Biedenkapp N2PLL
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 2 of the License, or
+*   (at your option) any later version.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program; if not, write to the Free Software
+*   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*/
+#include "sdr/DriftCompensator.h"
+
+using namespace sdr;
+
+// ---------------------------------------------------------------------------
+//  Constants
+// ---------------------------------------------------------------------------
+
+// loop gains, with the fill error in seconds of audio; a critically damped loop
+// with a natural frequency of 0.02 rad/s, slow enough to average out transport
+// jitter and settling within a few minutes
+const float LOOP_KP = 0.04F;
+const float LOOP_KI = 0.0004F;
+
+const float LOOP_MAX = DRIFT_MAX_PPM * 1e-6F;
+
+// ---------------------------------------------------------------------------
+//  Public Class Members
+// ---------------------------------------------------------------------------
+
+/// <summary>
+/// Initializes a new instance of the DriftCompensator class.
+/// </summary>
+/// <param name="sampleRate">Nominal sample rate of the buffer.</param>
+/// <param name="target">Fill level (in samples) to hold the buffer at.</param>
+DriftCompensator::DriftCompensator(uint32_t sampleRate, uint32_t target) :
+    m_sampleRate(sampleRate),
+    m_target(target),
+    m_integ(0.0F),
+    m_ppm(0.0F),
+    m_correction(0.0F),
+    m_step(1.0),
+    m_mu(0.0),
+    m_hist(),
+    m_sum(0),
+    m_count(0U),
+    m_fillSum(0),
+    m_fillCount(0U),
+    m_fillMin(0),
+    m_fillMax(0),
+    m_updates(0U),
+    m_slips(0U)
+{
+    reset();
+}
+
+/// <summary>
+/// Sets the nominal sample rate of the buffer.
+/// </summary>
+/// <param name="sampleRate"></param>
+void DriftCompensator::setSampleRate(uint32_t sampleRate)
+{
+    m_sampleRate = sampleRate;
+}
+
+/// <summary>
+/// Sets the fill level (in samples) the control loop holds the buffer at.
+/// </summary>
+/// <param name="target"></param>
+void DriftCompensator::setTarget(uint32_t target)
+{
+    m_target = target;
+}
+
+/// <summary>
+/// Resets the control loop and resampler state.
+/// </summary>
+void DriftCompensator::reset()
+{
+    m_integ = 0.0F;
+    m_ppm = 0.0F;
+    m_correction = 0.0F;
+
+    m_step = 1.0;
+    m_mu = 0.0;
+    for (uint32_t i = 0U; i < 4U; i++)
+        m_hist[i] = 0.0F;
+
+    m_sum = 0;
+    m_count = 0U;
+
+    clearStats();
+}
+
+/// <summary>
+/// Records an observation of the buffer fill level.
+/// </summary>
+/// <param name="fill">Fill level in samples.</param>
+void DriftCompensator::measure(int32_t fill)
+{
+    m_sum += fill;
+    m_count++;
+
+    if (m_fillCount == 0U || fill < m_fillMin)
+        m_fillMin = fill;
+    if (m_fillCount == 0U || fill > m_fillMax)
+        m_fillMax = fill;
+    m_fillSum += fill;
+    m_fillCount++;
+}
+
+/// <summary>
+/// Runs the control loop over the observations since the last update.
+/// </summary>
+/// <param name="interval">Time (in seconds) since the last update.</param>
+/// <returns>True, if the loop was updated, otherwise false.</returns>
+bool DriftCompensator::update(float interval)
+{
+    if (m_count == 0U)
+        return false;
+
+    // the mean fill over the interval smooths the sawtooth of bursty transports
+    float mean = float(m_sum) / float(m_count);
+    float error = (mean - float(m_target)) / float(m_sampleRate);
+    m_sum = 0;
+    m_count = 0U;
+
+    // a buffer running full means the source clock is fast; consume more input
+    // per output sample
+    m_integ += LOOP_KI * error * interval;
+    m_integ = (m_integ > LOOP_MAX) ? LOOP_MAX : m_integ;
+    m_integ = (m_integ < -LOOP_MAX) ? -LOOP_MAX : m_integ;
+
+    float correction = (LOOP_KP * error) + m_integ;
+    correction = (correction > LOOP_MAX) ? LOOP_MAX : correction;
+    correction = (correction < -LOOP_MAX) ? -LOOP_MAX : correction;
+
+    m_ppm = m_integ * 1e6F;
+    m_correction = correction * 1e6F;
+    m_step = 1.0 + double(correction);
+
+    m_updates++;
+    return true;
+}
+
+/// <summary>
+/// Gets the mean fill level (in samples) since the statistics were cleared.
+/// </summary>
+/// <returns></returns>
+float DriftCompensator::getFillMean() const
+{
+    if (m_fillCount == 0U)
+        return 0.0F;
+
+    return float(m_fillSum) / float(m_fillCount);
+}
+
+/// <summary>
+/// Clears the fill level statistics.
+/// </summary>
+void DriftCompensator::clearStats()
+{
+    m_fillSum = 0;
+    m_fillCount = 0U;
+    m_fillMin = 0;
+    m_fillMax = 0;
+    m_updates = 0U;
+    m_slips = 0U;
+}
+
+/// <summary>
+/// Resamples a block of samples by the current correction; returns the number of output samples written.
+/// </summary>
+/// <remarks>Outputs are interpolated between the middle two of the last four inputs, which
+/// delays the stream by two samples.</remarks>
+/// <param name="in">Input samples.</param>
+/// <param name="inCount">Number of input samples.</param>
+/// <param name="out">Output samples, must hold getMaxOutput(inCount) samples.</param>
+/// <returns></returns>
+uint32_t DriftCompensator::process(const float* in, uint32_t inCount, float* out)
+{
+    uint32_t outCount = 0U;
+
+    float h0 = m_hist[0U], h1 = m_hist[1U], h2 = m_hist[2U], h3 = m_hist[3U];
+    double mu = m_mu;
+    for (uint32_t n = 0U; n < inCount; n++) {
+        h0 = h1;
+        h1 = h2;
+        h2 = h3;
+        h3 = in[n];
+
+        // cubic Lagrange interpolator in Farrow form
+        float c1 = h2 - (h0 / 3.0F) - (h1 / 2.0F) - (h3 / 6.0F);
+        float c2 = ((h0 + h2) / 2.0F) - h1;
+        float c3 = ((h3 - h0) / 6.0F) + ((h1 - h2) / 2.0F);
+
+        while (mu < 1.0) {
+            float x = float(mu);
+            out[outCount++] = (((c3 * x) + c2) * x + c1) * x + h1;
+            mu += m_step;
+        }
+
+        mu -= 1.0;
+    }
+
+    m_hist[0U] = h0;
+    m_hist[1U] = h1;
+    m_hist[2U] = h2;
+    m_hist[3U] = h3;
+    m_mu = mu;
+
+    return outCount;
+}
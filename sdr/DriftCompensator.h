@@ -0,0 +1,117 @@
+/**
+* Digital Voice Modem - DSP Firmware
+* GPLv2 Open Source. Use is subject to license terms.
+* DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+*
+* @package DVM / DSP Firmware
+*
+*/
+/*
+*   Copyright (C) 2022 Bryan Biedenkapp N2PLL
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 2 of the License, or
+*   (at your option) any later version.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program; if not, write to the Free Software
+*   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*/
+#if !defined(__DRIFT_COMPENSATOR_H__)
+#define __DRIFT_COMPENSATOR_H__
+
+#include "Defines.h"
+
+namespace sdr
+{
+    // ---------------------------------------------------------------------------
+    //  Constants
+    // ---------------------------------------------------------------------------
+
+    // largest clock offset the control loop will correct, in parts per million
+    const float DRIFT_MAX_PPM = 500.0F;
+
+    // ---------------------------------------------------------------------------
+    //  Class Declaration
+    //      Implements sample clock drift compensation; a PI control loop holds
+    //      the fill level of an elastic buffer at a target latency by steering
+    //      a fractional (cubic Lagrange) resampler by a few parts per million.
+    // ---------------------------------------------------------------------------
+
+    class DSP_FW_API DriftCompensator {
+    public:
+        /// <summary>Initializes a new instance of the DriftCompensator class.</summary>
+        DriftCompensator(uint32_t sampleRate, uint32_t target);
+
+        /// <summary>Sets the nominal sample rate of the buffer.</summary>
+        void setSampleRate(uint32_t sampleRate);
+        /// <summary>Gets the nominal sample rate of the buffer.</summary>
+        uint32_t getSampleRate() const { return m_sampleRate; }
+        /// <summary>Sets the fill level (in samples) the control loop holds the buffer at.</summary>
+        void setTarget(uint32_t target);
+        /// <summary>Gets the fill level (in samples) the control loop holds the buffer at.</summary>
+        uint32_t getTarget() const { return m_target; }
+
+        /// <summary>Resets the control loop and resampler state.</summary>
+        void reset();
+
+        /// <summary>Records an observation of the buffer fill level.</summary>
+        void measure(int32_t fill);
+        /// <summary>Runs the control loop over the observations since the last update.</summary>
+        bool update(float interval);
+        /// <summary>Records a buffer slip, after which the fill level was re-established.</summary>
+        void slip() { m_slips++; }
+
+        /// <summary>Gets the estimated clock offset of the source, in parts per million.</summary>
+        float getPPM() const { return m_ppm; }
+        /// <summary>Gets the correction currently applied by the resampler, in parts per million.</summary>
+        float getCorrection() const { return m_correction; }
+        /// <summary>Gets the mean fill level (in samples) since the statistics were cleared.</summary>
+        float getFillMean() const;
+        /// <summary>Gets the lowest fill level (in samples) since the statistics were cleared.</summary>
+        int32_t getFillMin() const { return m_fillMin; }
+        /// <summary>Gets the highest fill level (in samples) since the statistics were cleared.</summary>
+        int32_t getFillMax() const { return m_fillMax; }
+        /// <summary>Gets the number of control loop updates since the statistics were cleared.</summary>
+        uint32_t getUpdates() const { return m_updates; }
+        /// <summary>Gets the number of buffer slips since the statistics were cleared.</summary>
+        uint32_t getSlips() const { return m_slips; }
+        /// <summary>Clears the fill level statistics.</summary>
+        void clearStats();
+
+        /// <summary>Gets the largest number of outputs produced from the given number of inputs.</summary>
+        uint32_t getMaxOutput(uint32_t inCount) const { return inCount + (inCount / 1000U) + 2U; }
+        /// <summary>Resamples a block of samples by the current correction; returns the number of output samples written.</summary>
+        uint32_t process(const float* in, uint32_t inCount, float* out);
+
+    private:
+        uint32_t m_sampleRate;
+        uint32_t m_target;
+
+        float m_integ;
+        float m_ppm;
+        float m_correction;
+
+        double m_step;
+        double m_mu;
+        float m_hist[4U];
+
+        int64_t m_sum;
+        uint32_t m_count;
+
+        int64_t m_fillSum;
+        uint32_t m_fillCount;
+        int32_t m_fillMin;
+        int32_t m_fillMax;
+        uint32_t m_updates;
+        uint32_t m_slips;
+    };
+} // namespace sdr
+
+#endif // __DRIFT_COMPENSATOR_H__
@@ -0,0 +1,248 @@
+/**
+* Digital Voice Modem - DSP Firmware
+* GPLv2 Open Source. Use is subject to license terms.
+* DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+*
+* @package DVM / DSP Firmware
+*
+*/
+/*
+*   Copyright (C) 2022 Bryan Biedenkapp N2PLL
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 2 of the License, or
+*   (at your option) any later version.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program; if not, write to the Free Software
+*   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*/
+#include "sdr/EventLoop.h"
+#include "sdr/Log.h"
+
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+#include <cerrno>
+
+using namespace sdr;
+
+// ---------------------------------------------------------------------------
+//  Constants
+// ---------------------------------------------------------------------------
+
+const int MAX_EVENTS = 8;
+
+const int64_t NSEC_PER_SEC = 1000000000LL;
+
+// ---------------------------------------------------------------------------
+//  Public Class Members
+// ---------------------------------------------------------------------------
+
+/// <summary>
+/// Initializes a new instance of the EventLoop class.
+/// </summary>
+EventLoop::EventLoop() :
+    m_epollFd(-1),
+    m_eventFd(-1),
+    m_timerFd(-1),
+    m_tickEpoch(),
+    m_tickNs(0),
+    m_ticks(0U),
+    m_latency()
+{
+    /* stub */
+}
+
+/// <summary>
+/// Finalizes a instance of the EventLoop class.
+/// </summary>
+EventLoop::~EventLoop()
+{
+    close();
+}
+
+/// <summary>
+/// Opens the event loop with the given housekeeping tick interval.
+/// </summary>
+/// <param name="tickUs">Housekeeping tick interval in microseconds.</param>
+/// <returns>True, if the event loop was opened, otherwise false.</returns>
+bool EventLoop::open(uint32_t tickUs)
+{
+    m_epollFd = ::epoll_create1(EPOLL_CLOEXEC);
+    if (m_epollFd < 0) {
+        ::LogError(LOG_DSP, "Cannot create the epoll instance, errno = %d", errno);
+        return false;
+    }
+
+    m_eventFd = ::eventfd(0U, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (m_eventFd < 0) {
+        ::LogError(LOG_DSP, "Cannot create the event fd, errno = %d", errno);
+        close();
+        return false;
+    }
+
+    m_timerFd = ::timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    if (m_timerFd < 0) {
+        ::LogError(LOG_DSP, "Cannot create the timer fd, errno = %d", errno);
+        close();
+        return false;
+    }
+
+    // the tick runs on absolute time so the wakeup latency of every expiry is known
+    ::clock_gettime(CLOCK_MONOTONIC, &m_tickEpoch);
+    m_tickEpoch.tv_sec += tickUs / 1000000U;
+    m_tickEpoch.tv_nsec += (tickUs % 1000000U) * 1000U;
+    if (m_tickEpoch.tv_nsec >= NSEC_PER_SEC) {
+        m_tickEpoch.tv_sec++;
+        m_tickEpoch.tv_nsec -= NSEC_PER_SEC;
+    }
+
+    m_tickNs = int64_t(tickUs) * 1000;
+    m_ticks = 0U;
+    m_latency.clear();
+
+    itimerspec spec;
+    spec.it_interval.tv_sec = tickUs / 1000000U;
+    spec.it_interval.tv_nsec = (tickUs % 1000000U) * 1000U;
+    spec.it_value = m_tickEpoch;
+    if (::timerfd_settime(m_timerFd, TFD_TIMER_ABSTIME, &spec, NULL) < 0) {
+        ::LogError(LOG_DSP, "Cannot arm the timer fd, errno = %d", errno);
+        close();
+        return false;
+    }
+
+    if (!add(m_eventFd) || !add(m_timerFd)) {
+        close();
+        return false;
+    }
+
+    return true;
+}
+
+/// <summary>
+/// Adds a file descriptor to watch for readability.
+/// </summary>
+/// <param name="fd">File descriptor.</param>
+/// <returns>True, if the file descriptor was added, otherwise false.</returns>
+bool EventLoop::add(int fd)
+{
+    if (m_epollFd < 0 || fd < 0)
+        return false;
+
+    epoll_event ev;
+    ev.events = EPOLLIN;
+    ev.data.fd = fd;
+    if (::epoll_ctl(m_epollFd, EPOLL_CTL_ADD, fd, &ev) < 0 && errno != EEXIST) {
+        ::LogError(LOG_DSP, "Cannot watch fd %d, errno = %d", fd, errno);
+        return false;
+    }
+
+    return true;
+}
+
+/// <summary>
+/// Removes a watched file descriptor.
+/// </summary>
+/// <param name="fd">File descriptor.</param>
+void EventLoop::remove(int fd)
+{
+    if (m_epollFd < 0 || fd < 0)
+        return;
+
+    ::epoll_ctl(m_epollFd, EPOLL_CTL_DEL, fd, NULL);
+}
+
+/// <summary>
+/// Wakes the event loop; safe to call from any thread.
+/// </summary>
+void EventLoop::notify()
+{
+    if (m_eventFd < 0)
+        return;
+
+    uint64_t one = 1U;
+    ssize_t ret = ::write(m_eventFd, &one, sizeof(one));
+    (void)ret;
+}
+
+/// <summary>
+/// Blocks until there is work to do or the timeout (in milliseconds) expires.
+/// </summary>
+/// <param name="timeout">Timeout in milliseconds, or -1 to wait indefinitely.</param>
+/// <param name="idleSince">When the caller went idle waiting on this loop through its
+/// file descriptor, if it did; otherwise the loop is idle from this call on.</param>
+/// <returns>Number of ready file descriptors, or -1 on error or signal.</returns>
+int EventLoop::wait(int timeout, const timespec* idleSince)
+{
+    if (m_epollFd < 0)
+        return -1;
+
+    timespec start;
+    if (idleSince != NULL)
+        start = *idleSince;
+    else
+        ::clock_gettime(CLOCK_MONOTONIC, &start);
+
+    epoll_event events[MAX_EVENTS];
+    int n = ::epoll_wait(m_epollFd, events, MAX_EVENTS, timeout);
+
+    // the event and timer counters are level triggered, drain them so the
+    // next wait blocks until they are signalled again
+    for (int i = 0; i < n; i++) {
+        if (events[i].data.fd == m_eventFd || events[i].data.fd == m_timerFd) {
+            uint64_t count = 0U;
+            ssize_t ret = ::read(events[i].data.fd, &count, sizeof(count));
+            if (ret != ssize_t(sizeof(count)) || events[i].data.fd != m_timerFd)
+                continue;
+
+            // the first expiry not yet seen is when the loop was due to wake; it only
+            // counts as a wakeup if the loop was already asleep by then
+            int64_t due = int64_t(m_ticks) * m_tickNs;
+            m_ticks += count;
+
+            int64_t slept = (int64_t(start.tv_sec - m_tickEpoch.tv_sec) * NSEC_PER_SEC) + (start.tv_nsec - m_tickEpoch.tv_nsec);
+            if (n == 1 && slept <= due) {
+                timespec deadline = m_tickEpoch;
+                deadline.tv_sec += time_t(due / NSEC_PER_SEC);
+                deadline.tv_nsec += long(due % NSEC_PER_SEC);
+                if (deadline.tv_nsec >= NSEC_PER_SEC) {
+                    deadline.tv_sec++;
+                    deadline.tv_nsec -= NSEC_PER_SEC;
+                }
+
+                m_latency.record(deadline);
+            }
+        }
+    }
+
+    return n;
+}
+
+/// <summary>
+/// Closes the event loop.
+/// </summary>
+void EventLoop::close()
+{
+    if (m_timerFd >= 0) {
+        ::close(m_timerFd);
+        m_timerFd = -1;
+    }
+
+    if (m_eventFd >= 0) {
+        ::close(m_eventFd);
+        m_eventFd = -1;
+    }
+
+    if (m_epollFd >= 0) {
+        ::close(m_epollFd);
+        m_epollFd = -1;
+    }
+}
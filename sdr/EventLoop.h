@@ -0,0 +1,83 @@
+/**
+* Digital Voice Modem - DSP Firmware
+* GPLv2 Open Source. Use is subject to license terms.
+* DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+*
+* @package DVM / DSP Firmware
+*
+*/
+/*
+*   Copyright (C) 2022 Bryan Biedenkapp N2PLL
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 2 of the License, or
+*   (at your option) any later version.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program; if not, write to the Free Software
+*   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*/
+#if !defined(__EVENT_LOOP_H__)
+#define __EVENT_LOOP_H__
+
+#include "Defines.h"
+#include "sdr/WakeupLatency.h"
+
+#include <time.h>
+
+namespace sdr
+{
+    // ---------------------------------------------------------------------------
+    //  Class Declaration
+    //      Implements the epoll based event loop that wakes the native main loop
+    //      when there is serial data, when the sample threads signal work, or on
+    //      the periodic housekeeping tick.
+    // ---------------------------------------------------------------------------
+
+    class DSP_FW_API EventLoop {
+    public:
+        /// <summary>Initializes a new instance of the EventLoop class.</summary>
+        EventLoop();
+        /// <summary>Finalizes a instance of the EventLoop class.</summary>
+        ~EventLoop();
+
+        /// <summary>Opens the event loop with the given housekeeping tick interval.</summary>
+        bool open(uint32_t tickUs);
+        /// <summary>Adds a file descriptor to watch for readability.</summary>
+        bool add(int fd);
+        /// <summary>Removes a watched file descriptor.</summary>
+        void remove(int fd);
+
+        /// <summary>Wakes the event loop; safe to call from any thread.</summary>
+        void notify();
+
+        /// <summary>Blocks until there is work to do or the timeout (in milliseconds) expires.</summary>
+        int wait(int timeout = -1, const timespec* idleSince = NULL);
+
+        /// <summary>Closes the event loop.</summary>
+        void close();
+
+        /// <summary>Gets the epoll file descriptor, readable whenever there is work to do.</summary>
+        int getFd() const { return m_epollFd; }
+        /// <summary>Gets the wakeup latency of the housekeeping tick.</summary>
+        WakeupLatency& getLatency() { return m_latency; }
+
+    private:
+        int m_epollFd;
+        int m_eventFd;
+        int m_timerFd;
+
+        timespec m_tickEpoch;
+        int64_t m_tickNs;
+        uint64_t m_ticks;
+        WakeupLatency m_latency;
+    };
+} // namespace sdr
+
+#endif // __EVENT_LOOP_H__
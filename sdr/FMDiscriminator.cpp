@@ -0,0 +1,299 @@
+/**
+* Digital Voice Modem - DSP Firmware
+* GPLv2 Open Source. Use is subject to license terms.
+* DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+*
+* @package DVM / DSP Firmware
+*
+*/
+/*
+*   Copyright (C) 2022 Bryan Biedenkapp N2PLL
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 2 of the License, or
+*   (at your option) any later version.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program; if not, write to the Free Software
+*   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*/
+#include "sdr/FMDiscriminator.h"
+
+#include <cmath>
+
+using namespace sdr;
+
+// ---------------------------------------------------------------------------
+//  Constants
+// ---------------------------------------------------------------------------
+
+// one sided bandwidth of the channel filter, a 12.5 kHz channel
+const float CHANNEL_CUTOFF_HZ = 6250.0F;
+
+// ---------------------------------------------------------------------------
+//  Public Class Members
+// ---------------------------------------------------------------------------
+
+/// <summary>
+/// Initializes a new instance of the FMDiscriminator class.
+/// </summary>
+/// <param name="sampleRate">Sample rate of the IQ stream.</param>
+/// <param name="deviation">Peak deviation (in Hz) mapped to full scale audio.</param>
+FMDiscriminator::FMDiscriminator(uint32_t sampleRate, float deviation) :
+    m_format(IQ_FORMAT_NONE),
+    m_deviation(deviation),
+    m_gain(0.0F),
+    m_taps(),
+    m_stateI(),
+    m_stateQ(),
+    m_lastI(0.0F),
+    m_lastQ(0.0F),
+    m_powerSum(0.0F),
+    m_powerCount(0U)
+{
+    setSampleRate(sampleRate);
+}
+
+/// <summary>
+/// Sets the IQ sample rate, redesigning the channel filter.
+/// </summary>
+/// <param name="sampleRate">Sample rate of the IQ stream.</param>
+void FMDiscriminator::setSampleRate(uint32_t sampleRate)
+{
+    // the discriminator output is the phase step per sample in radians
+    m_gain = FM_AUDIO_FULL_SCALE / ((2.0F * float(M_PI) * m_deviation) / float(sampleRate));
+
+    // Hamming windowed sinc low pass, normalized for unity gain at DC
+    const float fc = CHANNEL_CUTOFF_HZ / float(sampleRate);
+    const int mid = int(FM_CHANNEL_FILTER_LEN / 2U);
+
+    float sum = 0.0F;
+    for (int i = 0; i < int(FM_CHANNEL_FILTER_LEN); i++) {
+        int n = i - mid;
+        float sinc = (n == 0) ? (2.0F * fc) : (::sinf(2.0F * float(M_PI) * fc * float(n)) / (float(M_PI) * float(n)));
+        float window = 0.54F - (0.46F * ::cosf((2.0F * float(M_PI) * float(i)) / float(FM_CHANNEL_FILTER_LEN - 1U)));
+        m_taps[i] = sinc * window;
+        sum += m_taps[i];
+    }
+
+    for (uint32_t i = 0U; i < FM_CHANNEL_FILTER_LEN; i++)
+        m_taps[i] /= sum;
+
+    reset();
+}
+
+/// <summary>
+/// Sets the IQ payload format.
+/// </summary>
+/// <param name="format"></param>
+void FMDiscriminator::setFormat(IQ_FORMAT format)
+{
+    m_format = format;
+    reset();
+}
+
+/// <summary>
+/// Gets the size (in bytes) of one complex sample.
+/// </summary>
+/// <returns></returns>
+uint32_t FMDiscriminator::getSampleSize() const
+{
+    switch (m_format) {
+    case IQ_FORMAT_CS16:
+        return 2U * sizeof(int16_t);
+    case IQ_FORMAT_CF32:
+        return 2U * sizeof(float);
+    default:
+        return sizeof(int16_t);
+    }
+}
+
+/// <summary>
+/// Resets the filter and discriminator state.
+/// </summary>
+void FMDiscriminator::reset()
+{
+    ::memset(m_stateI, 0x00U, sizeof(m_stateI));
+    ::memset(m_stateQ, 0x00U, sizeof(m_stateQ));
+
+    m_lastI = 0.0F;
+    m_lastQ = 0.0F;
+}
+
+/// <summary>
+/// Demodulates a buffer of IQ samples into audio samples.
+/// </summary>
+/// <param name="data">Interleaved IQ payload.</param>
+/// <param name="length">Length of the payload in bytes; a trailing partial sample is ignored.</param>
+/// <param name="audio">Audio output (+/- FM_AUDIO_FULL_SCALE), must hold length / getSampleSize() samples.</param>
+/// <returns>Number of audio samples written.</returns>
+uint32_t FMDiscriminator::process(const uint8_t* data, uint32_t length, float* audio)
+{
+    if (m_format == IQ_FORMAT_NONE)
+        return 0U;
+
+    uint32_t count = length / getSampleSize();
+    m_powerSum = 0.0F;
+    m_powerCount = 0U;
+
+    const uint32_t hist = FM_CHANNEL_FILTER_LEN - 1U;
+    uint32_t done = 0U;
+    while (done < count) {
+        uint32_t n = count - done;
+        if (n > FM_DISC_BLOCK_SIZE)
+            n = FM_DISC_BLOCK_SIZE;
+
+        // deinterleave into the filter state after the history of the previous block
+        float* inI = m_stateI + hist;
+        float* inQ = m_stateQ + hist;
+        if (m_format == IQ_FORMAT_CS16) {
+            int16_t iq[2U * FM_DISC_BLOCK_SIZE];
+            ::memcpy(iq, data + (done * 2U * sizeof(int16_t)), n * 2U * sizeof(int16_t));
+            for (uint32_t i = 0U; i < n; i++) {
+                inI[i] = float(iq[2U * i]);
+                inQ[i] = float(iq[(2U * i) + 1U]);
+            }
+        }
+        else {
+            float iq[2U * FM_DISC_BLOCK_SIZE];
+            ::memcpy(iq, data + (done * 2U * sizeof(float)), n * 2U * sizeof(float));
+            for (uint32_t i = 0U; i < n; i++) {
+                inI[i] = iq[2U * i];
+                inQ[i] = iq[(2U * i) + 1U];
+            }
+        }
+
+        demodulate(n, audio + done);
+
+        // keep the newest samples as history for the next block
+        ::memmove(m_stateI, m_stateI + n, hist * sizeof(float));
+        ::memmove(m_stateQ, m_stateQ + n, hist * sizeof(float));
+
+        done += n;
+    }
+
+    return count;
+}
+
+/// <summary>
+/// Gets the mean in-channel power (relative to full scale) of the last processed buffer.
+/// </summary>
+/// <returns></returns>
+float FMDiscriminator::getPower() const
+{
+    if (m_powerCount == 0U)
+        return 0.0F;
+
+    // full scale is a sine at the largest integer amplitude, or +/-1.0 for float
+    float fullScale = (m_format == IQ_FORMAT_CS16) ? (32768.0F * 32768.0F) : 1.0F;
+    return (m_powerSum / float(m_powerCount)) / fullScale;
+}
+
+/// <summary>
+/// Gets the RSSI of the last processed buffer, in 12-bit log detector counts.
+/// </summary>
+/// <remarks>The host RSSI mapping table turns these counts into dBm, the same as for
+/// the analog RSSI detector of a hotspot.</remarks>
+/// <returns></returns>
+uint16_t FMDiscriminator::getRSSI() const
+{
+    float power = getPower();
+    if (power <= 0.0F)
+        return 0U;
+
+    float counts = ((10.0F * ::log10f(power)) - FM_RSSI_FLOOR_DB) * FM_RSSI_COUNTS_PER_DB;
+    if (counts <= 0.0F)
+        return 0U;
+    if (counts >= float(FM_RSSI_MAX))
+        return FM_RSSI_MAX;
+
+    return uint16_t(::lrintf(counts));
+}
+
+/// <summary>
+/// Helper to parse an IQ payload format name.
+/// </summary>
+/// <param name="name"></param>
+/// <param name="format"></param>
+/// <returns>True, if the name was recognized, otherwise false.</returns>
+bool FMDiscriminator::parseFormat(const char* name, IQ_FORMAT& format)
+{
+    if (::strcmp(name, "cs16") == 0)
+        format = IQ_FORMAT_CS16;
+    else if (::strcmp(name, "cf32") == 0)
+        format = IQ_FORMAT_CF32;
+    else if (::strcmp(name, "audio") == 0)
+        format = IQ_FORMAT_NONE;
+    else
+        return false;
+
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+//  Private Class Members
+// ---------------------------------------------------------------------------
+
+/// <summary>
+/// Helper to filter and demodulate one block of deinterleaved IQ held in the state buffers.
+/// </summary>
+/// <remarks>Each pass is a straight loop over plain arrays so the compiler can vectorize it;
+/// the discriminator uses the cross product of consecutive samples normalized by the
+/// signal power, which approximates the phase step without an atan2.</remarks>
+/// <param name="count"></param>
+/// <param name="audio"></param>
+void FMDiscriminator::demodulate(uint32_t count, float* audio)
+{
+    float fI[FM_DISC_BLOCK_SIZE + 1U];
+    float fQ[FM_DISC_BLOCK_SIZE + 1U];
+
+    // channel filter; fI[0]/fQ[0] carry the last filtered sample of the previous block
+    fI[0U] = m_lastI;
+    fQ[0U] = m_lastQ;
+    for (uint32_t n = 0U; n < count; n++) {
+        float accI = 0.0F, accQ = 0.0F;
+        for (uint32_t k = 0U; k < FM_CHANNEL_FILTER_LEN; k++) {
+            accI += m_taps[k] * m_stateI[n + k];
+            accQ += m_taps[k] * m_stateQ[n + k];
+        }
+
+        fI[n + 1U] = accI;
+        fQ[n + 1U] = accQ;
+    }
+
+    m_lastI = fI[count];
+    m_lastQ = fQ[count];
+
+    // in-channel power for the RSSI; split sums keep the additions independent
+    float p[4U] = { 0.0F, 0.0F, 0.0F, 0.0F };
+    uint32_t n4 = count & ~3U;
+    for (uint32_t n = 0U; n < n4; n += 4U) {
+        for (uint32_t j = 0U; j < 4U; j++)
+            p[j] += (fI[n + j + 1U] * fI[n + j + 1U]) + (fQ[n + j + 1U] * fQ[n + j + 1U]);
+    }
+    for (uint32_t n = n4; n < count; n++)
+        p[0U] += (fI[n + 1U] * fI[n + 1U]) + (fQ[n + 1U] * fQ[n + 1U]);
+
+    m_powerSum += (p[0U] + p[1U]) + (p[2U] + p[3U]);
+    m_powerCount += count;
+
+    // quadrature discriminator
+    for (uint32_t n = 0U; n < count; n++) {
+        float i1 = fI[n + 1U], q1 = fQ[n + 1U];
+        float i0 = fI[n], q0 = fQ[n];
+
+        float cross = (i0 * q1) - (q0 * i1);
+        float power = (i1 * i1) + (q1 * q1) + 1e-12F;
+        float v = (cross / power) * m_gain;
+
+        v = (v > FM_AUDIO_FULL_SCALE) ? FM_AUDIO_FULL_SCALE : v;
+        v = (v < -FM_AUDIO_FULL_SCALE) ? -FM_AUDIO_FULL_SCALE : v;
+        audio[n] = v;
+    }
+}
@@ -0,0 +1,113 @@
+/**
+* Digital Voice Modem - DSP Firmware
+* GPLv2 Open Source. Use is subject to license terms.
+* DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+*
+* @package DVM / DSP Firmware
+*
+*/
+/*
+*   Copyright (C) 2022 Bryan Biedenkapp N2PLL
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 2 of the License, or
+*   (at your option) any later version.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program; if not, write to the Free Software
+*   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*/
+#if !defined(__FM_DISCRIMINATOR_H__)
+#define __FM_DISCRIMINATOR_H__
+
+#include "Defines.h"
+
+namespace sdr
+{
+    // ---------------------------------------------------------------------------
+    //  Constants
+    // ---------------------------------------------------------------------------
+
+    /// <summary>
+    /// Sample transport payload formats.
+    /// </summary>
+    enum IQ_FORMAT {
+        IQ_FORMAT_NONE,                         // real FM demodulated audio (int16)
+        IQ_FORMAT_CS16,                         // complex baseband, interleaved int16 I/Q
+        IQ_FORMAT_CF32                          // complex baseband, interleaved float32 I/Q
+    };
+
+    const uint32_t FM_DISC_BLOCK_SIZE = 256U;
+    const uint32_t FM_CHANNEL_FILTER_LEN = 31U;
+
+    // audio counts either side of zero at the configured deviation, matching the
+    // 12-bit converter range the air interface processing is levelled for
+    const float FM_AUDIO_FULL_SCALE = 2047.0F;
+
+    // RSSI is reported like a 12-bit log detector, 32 counts per dB from -128 dBFS
+    const float FM_RSSI_FLOOR_DB = -128.0F;
+    const float FM_RSSI_COUNTS_PER_DB = 32.0F;
+    const uint16_t FM_RSSI_MAX = 4095U;
+
+    // ---------------------------------------------------------------------------
+    //  Class Declaration
+    //      Implements the complex baseband channel filter and quadrature FM
+    //      discriminator that turns IQ from the sample transport into the real
+    //      audio samples the air interface processing expects.
+    // ---------------------------------------------------------------------------
+
+    class DSP_FW_API FMDiscriminator {
+    public:
+        /// <summary>Initializes a new instance of the FMDiscriminator class.</summary>
+        FMDiscriminator(uint32_t sampleRate, float deviation);
+
+        /// <summary>Sets the IQ sample rate, redesigning the channel filter.</summary>
+        void setSampleRate(uint32_t sampleRate);
+        /// <summary>Sets the IQ payload format.</summary>
+        void setFormat(IQ_FORMAT format);
+        /// <summary>Gets the IQ payload format.</summary>
+        IQ_FORMAT getFormat() const { return m_format; }
+        /// <summary>Gets the size (in bytes) of one complex sample.</summary>
+        uint32_t getSampleSize() const;
+
+        /// <summary>Resets the filter and discriminator state.</summary>
+        void reset();
+
+        /// <summary>Demodulates a buffer of IQ samples into audio samples.</summary>
+        uint32_t process(const uint8_t* data, uint32_t length, float* audio);
+
+        /// <summary>Gets the mean in-channel power (relative to full scale) of the last processed buffer.</summary>
+        float getPower() const;
+        /// <summary>Gets the RSSI of the last processed buffer, in 12-bit log detector counts.</summary>
+        uint16_t getRSSI() const;
+
+        /// <summary>Helper to parse an IQ payload format name.</summary>
+        static bool parseFormat(const char* name, IQ_FORMAT& format);
+
+    private:
+        IQ_FORMAT m_format;
+        float m_deviation;
+        float m_gain;
+
+        float m_taps[FM_CHANNEL_FILTER_LEN];
+        float m_stateI[FM_CHANNEL_FILTER_LEN - 1U + FM_DISC_BLOCK_SIZE];
+        float m_stateQ[FM_CHANNEL_FILTER_LEN - 1U + FM_DISC_BLOCK_SIZE];
+
+        float m_lastI;
+        float m_lastQ;
+
+        float m_powerSum;
+        uint32_t m_powerCount;
+
+        /// <summary>Helper to filter and demodulate one block of deinterleaved IQ held in the state buffers.</summary>
+        void demodulate(uint32_t count, float* audio);
+    };
+} // namespace sdr
+
+#endif // __FM_DISCRIMINATOR_H__
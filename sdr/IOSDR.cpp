@@ -34,15 +34,19 @@
 #include "Globals.h"
 #include "IO.h"
 #include "sdr/Log.h"
+#include "sdr/Modem.h"
+#include "sdr/transport/DatagramTransport.h"
+#include "sdr/transport/FileTransport.h"
+#include "sdr/transport/LoopbackTransport.h"
+#include "sdr/transport/ShmTransport.h"
+#include "sdr/transport/ZmqTransport.h"
 
 #include <unistd.h>
 #include <pthread.h>
 #include <stdio.h>
 #include <stdlib.h>
-
-#include <vector>
-
-#include <zmq.hpp>
+#include <cmath>
+#include <time.h>
 
 // ---------------------------------------------------------------------------
 //  Constants
@@ -50,24 +54,41 @@
 
 const uint16_t DC_OFFSET = 2048U;
 
-// ---------------------------------------------------------------------------
-//  Globals Variables
-// ---------------------------------------------------------------------------
+// number of samples converted per pass when the SDR runs at a different rate
+const uint32_t RX_CONVERT_CHUNK = 256U;
+const uint32_t TX_CONVERT_CHUNK = 120U;
+
+// RSSI reported when the Rx payload carries no signal strength
+const uint16_t RX_RSSI_NONE = 3U;
+
+// interval between sample transport statistics, in milliseconds
+const uint32_t TRANSPORT_STATS_INTERVAL = 60000U;
+
+// the Rx thread wakes when the transport delivers samples, so its wakeup latency is how much
+// later than the sample clock predicts a payload is read; the prediction follows the earliest
+// arrival of each window, and a longer silence than the gap restarts it
+const uint32_t RX_ARRIVAL_WINDOW = 1000U;
+const uint32_t RX_ARRIVAL_GAP = 500U;
 
-static pthread_t m_threadTx;
-static pthread_mutex_t m_txLock;
-static pthread_t m_threadRx;
-static pthread_mutex_t m_rxLock;
+// largest run of silence handed to the Rx path at once when filling lost samples, in bytes
+const uint32_t RX_FILL_LENGTH = 1440U;
 
-zmq::context_t m_zmqContextTx;
-zmq::socket_t m_zmqSocketTx;
-static std::vector<short> m_audioBufTx = std::vector<short>();
+// samples fed from a replayed recording at once, 10ms; and how long a replay as fast as
+// possible waits for the main loop to make room for them, in microseconds
+const uint16_t REPLAY_BLOCK = 240U;
+const uint32_t REPLAY_WAIT = 1000U;
 
-zmq::context_t m_zmqContextRx;
-zmq::socket_t m_zmqSocketRx;
-static std::vector<short> m_audioBufRx = std::vector<short>();
+// Rx drift compensation loop timing, in milliseconds
+const uint32_t DRIFT_UPDATE_INTERVAL = 1000U;
+const uint32_t DRIFT_LOG_INTERVAL = 60000U;
+const uint32_t DRIFT_SLIP_LIMIT = 500U;      // fill error that re-establishes the buffer
 
-static bool m_cosInt = false;
+// ---------------------------------------------------------------------------
+//  Macros
+// ---------------------------------------------------------------------------
+
+#define LOAD_ACQUIRE(v)         __atomic_load_n(&(v), __ATOMIC_ACQUIRE)
+#define STORE_RELEASE(v, x)     __atomic_store_n(&(v), (x), __ATOMIC_RELEASE)
 
 // ---------------------------------------------------------------------------
 //  Public Class Members
@@ -78,37 +99,57 @@ static bool m_cosInt = false;
 /// </summary>
 void IO::interrupt()
 {
-    uint16_t sample = DC_OFFSET;
-    uint8_t control = MARK_NONE;
+    bool consumed = false;
 
     ::pthread_mutex_lock(&m_txLock);
-    while(m_txBuffer.get(sample, control))
+    while (true)
     {
-        sample *= 5; // amplify by 12dB	
-
-        if (m_audioBufTx.size() >= 720)
-        {
-            zmq::message_t reply = zmq::message_t(720 * sizeof(short));
-            ::memcpy(reply.data(), (unsigned char*)m_audioBufTx.data(), 720 * sizeof(short));
-
-            try
-            {
-                m_zmqSocketTx.send(reply, zmq::send_flags::dontwait);
+        if (m_txFrame == NULL) {
+            m_txFrame = m_txFramePool.acquire();
+            m_txFramePtr = 0U;
+
+            // all frames are still in flight; leave the samples in the Tx ring buffer
+            // until the transport returns a frame to the pool
+            if (m_txFrame == NULL) {
+                uint32_t exhausted = m_txFramePool.getExhaustedCount();
+                if (m_txFrameExhausted == 0U)
+                    ::LogWarning(LOG_DSP, "IO::interrupt(), Tx frame pool exhausted, exhaustCnt = %u", exhausted);
+                m_txFrameExhausted = exhausted;
+                break;
             }
-            catch(const zmq::error_t& zmqE) { /* stub */ }
-
-            usleep(9600 * 3);
-            
-            m_audioBufTx.erase(m_audioBufTx.begin(), m_audioBufTx.begin() + 720);
-            m_audioBufTx.push_back((short)sample);
         }
+
+        uint32_t n = 0U;
+        if (m_txResampler.isActive())
+            n = fillTxFrameResampled();
         else
-            m_audioBufTx.push_back((short)sample);
+            n = fillTxFrame();
+
+        if (n == 0U)
+            break;
+
+        consumed = true;
+
+        if (m_txFramePtr >= m_txFrameLength)
+            sendTxFrame();
     }
     ::pthread_mutex_unlock(&m_txLock);
-   
-    sample = 2048U;
-    m_watchdog++;
+
+    // space was freed in the Tx ring buffer, wake the main loop to refill it
+    if (consumed)
+        m_modem->m_eventLoop.notify();
+
+    // the MCU interrupt runs once per sample; the Tx thread runs as often as it is
+    // woken, so the watchdog advances by the elapsed time in 24 kHz samples instead
+    timespec now;
+    ::clock_gettime(CLOCK_MONOTONIC, &now);
+
+    uint64_t elapsed = uint64_t((int64_t(now.tv_sec - m_watchdogTime.tv_sec) * 1000000000LL) + (now.tv_nsec - m_watchdogTime.tv_nsec));
+    m_watchdogTime = now;
+
+    m_watchdogFrac += elapsed * SAMPLE_RATE;
+    m_watchdog += uint32_t(m_watchdogFrac / 1000000000ULL);
+    m_watchdogFrac %= 1000000000ULL;
 }
 
 /// <summary>
@@ -120,6 +161,467 @@ uint8_t IO::getCPU() const
     return CPU_TYPE_NATIVE_SDR;
 }
 
+/// <summary>
+/// Flag indicating the RX ring buffer holds at least one block of samples.
+/// </summary>
+/// <returns></returns>
+bool IO::hasRXBlock() const
+{
+    return m_rxBuffer.getData() >= m_modem->m_config.rxBlockSize;
+}
+
+/// <summary>
+/// Closes the sample transport.
+/// </summary>
+void IO::closeTransport()
+{
+    if (m_transport != NULL) {
+        m_transport->close();
+        delete m_transport;
+        m_transport = NULL;
+    }
+}
+
+/// <summary>
+/// Feeds the next samples of an offline decode into the Rx ring buffers.
+/// </summary>
+/// <remarks>The caller processes the Rx ring buffer down to less than a block between calls,
+/// which leaves room for a whole block of the recording.</remarks>
+/// <returns>Number of samples fed, zero once the whole recording has been read.</returns>
+uint32_t IO::decodeRx()
+{
+    uint16_t before = m_rxBuffer.getData();
+
+    if (m_replay.isOpen()) {
+        uint16_t samples[REPLAY_BLOCK];
+        uint16_t rssi[REPLAY_BLOCK];
+        uint8_t control[REPLAY_BLOCK];
+        uint32_t n = m_replay.read(samples, rssi, control, REPLAY_BLOCK);
+        if (n == 0U)
+            return 0U;
+
+        uint16_t put = m_rxBuffer.putBlock(samples, control, uint16_t(n));
+        m_rssiBuffer.putBlock(rssi, put);
+    }
+    else {
+        sdr::transport::TransportBuffer buffers[sdr::transport::TRANSPORT_MAX_BUFFERS];
+        uint32_t count = m_transport->read(buffers);
+        if (count == 0U)
+            return 0U;
+
+        for (uint32_t i = 0U; i < count; i++)
+            deliverRx(buffers[i].data, buffers[i].length);
+        m_transport->release();
+    }
+
+    return uint32_t(m_rxBuffer.getData() - before);
+}
+
+/// <summary>
+/// Completes the sample capture; the main loop must be stopped.
+/// </summary>
+/// <remarks>A replay is left open, the Rx thread never stops reading it.</remarks>
+void IO::closeCapture()
+{
+    m_recorder.close();
+}
+
+// ---------------------------------------------------------------------------
+//  Private Class Members
+// ---------------------------------------------------------------------------
+
+/// <summary>
+/// Helper to copy queued Tx samples into the current frame.
+/// </summary>
+/// <returns>Number of samples taken from the Tx ring buffer.</returns>
+uint32_t IO::fillTxFrame()
+{
+    SampleSpan spans[2U];
+    if (m_txBuffer.beginGet(spans) == 0U)
+        return 0U;
+
+    // copy as much of the queued samples as fits in the current frame
+    uint16_t room = uint16_t(m_txFrameLength - m_txFramePtr);
+    uint16_t n = 0U;
+    for (uint8_t s = 0U; s < 2U && n < room; s++) {
+        uint16_t count = spans[s].length;
+        if (count > (room - n))
+            count = room - n;
+
+        const uint16_t* in = spans[s].samples;
+        short* out = m_txFrame + m_txFramePtr;
+        for (uint16_t i = 0U; i < count; i++)
+            out[i] = (short)uint16_t(in[i] * 5U); // amplify by 12dB
+
+        m_txFramePtr += count;
+        n += count;
+    }
+
+    m_txBuffer.commitGet(n);
+    return n;
+}
+
+/// <summary>
+/// Helper to resample queued Tx samples into the current frame.
+/// </summary>
+/// <returns>Number of samples taken from the Tx ring buffer or moved into the frame.</returns>
+uint32_t IO::fillTxFrameResampled()
+{
+    // refill the pending output from the Tx ring buffer once it has been drained
+    if (m_txPendingPtr >= m_txPendingLen) {
+        uint16_t samples[TX_CONVERT_CHUNK];
+        uint8_t control[TX_CONVERT_CHUNK];
+        uint16_t n = m_txBuffer.getBlock(samples, control, TX_CONVERT_CHUNK);
+        if (n == 0U)
+            return 0U;
+
+        float in[TX_CONVERT_CHUNK];
+        for (uint16_t i = 0U; i < n; i++)
+            in[i] = float((short)uint16_t(samples[i] * 5U)); // amplify by 12dB
+
+        uint32_t count = m_txResampler.process(in, n, &m_txResampled[0U]);
+        for (uint32_t i = 0U; i < count; i++) {
+            float v = m_txResampled[i];
+            v = (v > 32767.0F) ? 32767.0F : v;
+            v = (v < -32768.0F) ? -32768.0F : v;
+            m_txPending[i] = short(::lrintf(v));
+        }
+
+        m_txPendingPtr = 0U;
+        m_txPendingLen = count;
+        return n;
+    }
+
+    uint32_t count = m_txPendingLen - m_txPendingPtr;
+    if (count > (m_txFrameLength - m_txFramePtr))
+        count = m_txFrameLength - m_txFramePtr;
+
+    ::memcpy(m_txFrame + m_txFramePtr, &m_txPending[m_txPendingPtr], count * sizeof(short));
+    m_txFramePtr += count;
+    m_txPendingPtr += count;
+    return count;
+}
+
+/// <summary>
+/// Helper to deliver a received payload into the Rx ring buffer.
+/// </summary>
+/// <param name="data">Payload from the sample transport.</param>
+/// <param name="length">Length of the payload in bytes.</param>
+void IO::deliverRx(const uint8_t* data, uint32_t length)
+{
+    const sdr::ChannelConfig& config = m_modem->m_config;
+    uint8_t control = MARK_NONE;
+
+    // the Rx ring buffers are single-producer/single-consumer and need no lock
+    if (m_fmDisc.getFormat() != sdr::IQ_FORMAT_NONE || config.rxRSSI || m_rxResampler.isActive() || config.driftComp) {
+        convertRx(data, length);
+
+        if (m_rxBuffer.getData() >= config.rxBlockSize)
+            m_modem->m_eventLoop.notify();
+        return;
+    }
+
+    uint32_t sampleSize = sizeof(short);
+    uint32_t samples = length / sampleSize;
+    SampleSpan spans[2U];
+    uint16_t space = m_rxBuffer.beginPut(spans);
+    uint16_t put = (samples > space) ? space : uint16_t(samples);
+    if (samples > space) {
+        m_rxBuffer.setOverflow();
+        m_modem->m_blackBox.trigger(sdr::BLACKBOX_RX_OVERFLOW);
+    }
+
+    uint16_t n = 0U;
+    for (uint8_t s = 0U; s < 2U && n < put; s++) {
+        uint16_t count = spans[s].length;
+        if (count > (put - n))
+            count = put - n;
+
+        ::memcpy(spans[s].samples, data + (n * sizeof(short)), count * sizeof(short));
+        ::memset(spans[s].control, control, count);
+        n += count;
+    }
+
+    m_rxBuffer.commitPut(put);
+    m_rssiBuffer.putFill(RX_RSSI_NONE, put);
+
+    if (m_rxBuffer.getData() >= config.rxBlockSize)
+        m_modem->m_eventLoop.notify();
+}
+
+/// <summary>
+/// Helper to convert a received payload to 24 kHz samples in the Rx ring buffer.
+/// </summary>
+/// <param name="data">Payload from the sample transport.</param>
+/// <param name="length">Length of the payload in bytes.</param>
+/// <returns>Number of samples written to the Rx ring buffer.</returns>
+uint32_t IO::convertRx(const uint8_t* data, uint32_t length)
+{
+    const sdr::ChannelConfig& config = m_modem->m_config;
+    bool iq = m_fmDisc.getFormat() != sdr::IQ_FORMAT_NONE;
+    uint32_t sampleSize = m_rxSampleSize;
+    uint32_t samples = length / sampleSize;
+
+    // demodulated audio from the discriminator is centered on zero, like the 12-bit
+    // converters it is levelled for it is moved up to the DC offset
+    int32_t offset = iq ? int32_t(DC_OFFSET) : 0;
+
+    uint32_t written = 0U;
+    for (uint32_t done = 0U; done < samples; ) {
+        uint32_t n = samples - done;
+        if (n > RX_CONVERT_CHUNK)
+            n = RX_CONVERT_CHUNK;
+
+        // the RSSI is decimated to one value per chunk and expanded over the samples
+        // the chunk produces
+        float audio[RX_CONVERT_CHUNK];
+        uint16_t rssi = RX_RSSI_NONE;
+        if (iq) {
+            m_fmDisc.process(data + (done * sampleSize), n * sampleSize, audio);
+            rssi = m_fmDisc.getRSSI();
+        }
+        else if (config.rxRSSI) {
+            short raw[2U * RX_CONVERT_CHUNK];
+            ::memcpy(raw, data + (done * sampleSize), n * sampleSize);
+
+            uint32_t sum = 0U;
+            for (uint32_t i = 0U; i < n; i++) {
+                audio[i] = float(raw[2U * i]);
+                sum += uint16_t(raw[(2U * i) + 1U]);
+            }
+
+            rssi = uint16_t(sum / n);
+        }
+        else {
+            short raw[RX_CONVERT_CHUNK];
+            ::memcpy(raw, data + (done * sizeof(short)), n * sizeof(short));
+            for (uint32_t i = 0U; i < n; i++)
+                audio[i] = float(raw[i]);
+        }
+
+        uint32_t count = m_rxResampler.process(audio, n, &m_rxResampled[0U]);
+
+        const float* resampled = &m_rxResampled[0U];
+        if (config.driftComp) {
+            count = m_rxDrift.process(resampled, count, &m_rxDrifted[0U]);
+            resampled = &m_rxDrifted[0U];
+        }
+
+        uint16_t out[RX_CONVERT_CHUNK * 4U];
+        uint32_t pos = 0U;
+        while (pos < count) {
+            uint32_t m = count - pos;
+            if (m > (RX_CONVERT_CHUNK * 4U))
+                m = RX_CONVERT_CHUNK * 4U;
+
+            for (uint32_t i = 0U; i < m; i++) {
+                float v = resampled[pos + i];
+                v = (v > 32767.0F) ? 32767.0F : v;
+                v = (v < -32768.0F) ? -32768.0F : v;
+                out[i] = uint16_t(offset + int32_t(::lrintf(v)));
+            }
+
+            uint16_t put = m_rxBuffer.putBlock(out, NULL, uint16_t(m));
+            m_rssiBuffer.putFill(rssi, put);
+            if (put < m)
+                m_modem->m_blackBox.trigger(sdr::BLACKBOX_RX_OVERFLOW);
+            written += put;
+            pos += m;
+        }
+
+        if (config.driftComp)
+            trackRxDrift(count);
+
+        done += n;
+    }
+
+    return written;
+}
+
+/// <summary>
+/// Helper to create the sample transport selected by the channel options.
+/// </summary>
+/// <remarks>--offset selects a channel of the wideband front end and -s selects shared
+/// memory; otherwise the scheme of the -r and -t endpoints selects the transport, and
+/// anything not recognized is left to ZeroMQ.</remarks>
+/// <returns>Sample transport, or NULL if the endpoints do not select one.</returns>
+sdr::transport::ISampleTransport* IO::createTransport()
+{
+    using namespace sdr::transport;
+    const sdr::ChannelConfig& config = m_modem->m_config;
+
+    if (config.channelized)
+        return g_wideband.createTransport(config.offset, &m_txFramePool);
+
+    // an offline decode reads its recording as fast as the DSP processes it, and has no Tx
+    if (g_decode)
+        return new FileTransport(config.zmqRx, std::string(), config.rxSampleRate, m_rxSampleSize, NULL, false);
+
+    if (!config.shmName.empty())
+        return new ShmTransport(config.shmName, config.rxSampleRate, config.txSampleRate, m_rxSampleSize, &m_txFramePool);
+
+    if (LoopbackTransport::isLoopback(config.zmqRx) || LoopbackTransport::isLoopback(config.zmqTx)) {
+        // Tx frames go straight back into the Rx path, so both sides must carry the same samples
+        if (config.rxIQFormat != sdr::IQ_FORMAT_NONE || config.rxRSSI || config.rxSampleRate != config.txSampleRate) {
+            ::LogError(LOG_DSP, "Loopback requires audio Rx samples at the Tx sample rate");
+            return NULL;
+        }
+
+        return new LoopbackTransport(&m_txFramePool);
+    }
+
+    bool rxFile = FileTransport::isFile(config.zmqRx);
+    bool txFile = FileTransport::isFile(config.zmqTx);
+    bool rxDgram = DatagramTransport::isDatagram(config.zmqRx);
+    bool txDgram = DatagramTransport::isDatagram(config.zmqTx);
+    if (rxFile || txFile || rxDgram || txDgram) {
+        if (rxFile && txFile)
+            return new FileTransport(config.zmqRx, config.zmqTx, config.rxSampleRate, m_rxSampleSize, &m_txFramePool);
+        if (rxDgram && txDgram)
+            return new DatagramTransport(config.zmqRx, config.zmqTx, &m_txFramePool);
+
+        ::LogError(LOG_DSP, "The Rx and Tx endpoints must use the same transport, rx = %s, tx = %s", config.zmqRx.c_str(), config.zmqTx.c_str());
+        return NULL;
+    }
+
+    return new ZmqTransport(config.zmqRx, config.zmqTx, &m_txFramePool);
+}
+
+/// <summary>
+/// Helper to hand the completed Tx frame to the sample transport on its deadline.
+/// </summary>
+void IO::sendTxFrame()
+{
+    // SDRs derive the Rx and Tx sample clocks from one reference, so the Tx sink
+    // drifts by the offset the Rx loop has measured
+    int32_t ppb = LOAD_ACQUIRE(m_driftPPB);
+    if (ppb != m_txPacerPPB) {
+        m_txPacer.setPPM(float(ppb) / 1000.0F);
+        m_txPacerPPB = ppb;
+    }
+
+    // the transport takes the frame over and returns it to the pool once sent
+    short* frame = m_txFrame;
+    m_txFrame = NULL;
+    m_txFramePtr = 0U;
+    m_txFrameExhausted = 0U;
+
+    // hold the frame until its deadline on the sample clock
+    m_txPacer.wait();
+
+    if (!m_transport->write(frame, m_txFrameLength))
+        m_txPacer.overrun();
+
+    m_txPacer.advance(m_txFrameLength);
+}
+
+/// <summary>
+/// Helper to run the Rx drift compensation loop after samples were delivered.
+/// </summary>
+/// <remarks>The DSP consumes Rx samples as soon as a block is available, so the Rx ring
+/// buffer fill does not show the clock offset; instead the loop runs on the fill of an
+/// elastic buffer drained at exactly 24 kHz on CLOCK_MONOTONIC, the clock the Tx pacer
+/// schedules on.</remarks>
+/// <param name="samples">Number of samples delivered.</param>
+void IO::trackRxDrift(uint32_t samples)
+{
+    timespec now;
+    ::clock_gettime(CLOCK_MONOTONIC, &now);
+
+    if (!m_rxDriftAnchored) {
+        m_rxDriftEpoch = now;
+        m_rxDriftSamples = 0U;
+        m_rxDriftUpdate = 0;
+        m_rxDriftLog = 0;
+        m_rxDriftAnchored = true;
+    }
+
+    int64_t elapsed = (int64_t(now.tv_sec - m_rxDriftEpoch.tv_sec) * 1000000000LL) + (now.tv_nsec - m_rxDriftEpoch.tv_nsec);
+    m_rxDriftSamples += samples;
+
+    int64_t drained = int64_t((double(elapsed) * double(SAMPLE_RATE)) / 1e9);
+    int64_t fill = int64_t(m_rxDrift.getTarget()) + int64_t(m_rxDriftSamples) - drained;
+
+    // the transport stalled or burst far beyond any clock offset; start over from the target
+    int64_t slip = (int64_t(DRIFT_SLIP_LIMIT) * SAMPLE_RATE) / 1000;
+    if (fill - int64_t(m_rxDrift.getTarget()) > slip || int64_t(m_rxDrift.getTarget()) - fill > slip) {
+        ::LogWarning(LOG_DSP, "Rx drift, buffer slipped, fill = %d, target = %u", int32_t(fill), m_rxDrift.getTarget());
+        m_rxDrift.slip();
+        m_rxDriftEpoch = now;
+        m_rxDriftSamples = 0U;
+        m_rxDriftUpdate = 0;
+        m_rxDriftLog = 0;
+        return;
+    }
+
+    m_rxDrift.measure(int32_t(fill));
+
+    if ((elapsed - m_rxDriftUpdate) >= (int64_t(DRIFT_UPDATE_INTERVAL) * 1000000LL)) {
+        m_rxDrift.update(float(elapsed - m_rxDriftUpdate) / 1e9F);
+        m_rxDriftUpdate = elapsed;
+
+        STORE_RELEASE(m_driftPPB, int32_t(::lrintf(m_rxDrift.getPPM() * 1000.0F)));
+    }
+
+    if ((elapsed - m_rxDriftLog) >= (int64_t(DRIFT_LOG_INTERVAL) * 1000000LL)) {
+        ::LogMessage(LOG_DSP, "Rx drift, ppm = %.2f, correction = %.2f, fill mean = %.1f, min = %d, max = %d, target = %u, slips = %u",
+            m_rxDrift.getPPM(), m_rxDrift.getCorrection(), m_rxDrift.getFillMean(), m_rxDrift.getFillMin(), m_rxDrift.getFillMax(),
+            m_rxDrift.getTarget(), m_rxDrift.getSlips());
+        m_rxDrift.clearStats();
+        m_rxDriftLog = elapsed;
+    }
+}
+
+/// <summary>
+/// Helper to record how late the Rx thread woke for the samples the transport delivered.
+/// </summary>
+/// <remarks>A payload cannot arrive before its last sample was taken, so the earliest arrival
+/// against the transport sample clock is the thread waking on time; anything later is the
+/// scheduling, transport and network latency the thread saw.</remarks>
+/// <param name="now">CLOCK_MONOTONIC time the transport read returned.</param>
+/// <param name="samples">Number of transport samples delivered, including lost samples.</param>
+void IO::trackRxArrival(const timespec& now, uint32_t samples)
+{
+    const uint32_t rate = m_modem->m_config.rxSampleRate;
+
+    if (m_rxArrivalAnchored) {
+        int64_t elapsed = (int64_t(now.tv_sec - m_rxArrivalEpoch.tv_sec) * 1000000000LL) + (now.tv_nsec - m_rxArrivalEpoch.tv_nsec);
+
+        m_rxArrivalFrac += uint64_t(samples) * 1000000000ULL;
+        m_rxArrivalExpected += int64_t(m_rxArrivalFrac / rate);
+        m_rxArrivalFrac %= rate;
+
+        int64_t late = elapsed - m_rxArrivalExpected;
+        if (late <= (int64_t(RX_ARRIVAL_GAP) * 1000000LL)) {
+            // earlier than predicted, the prediction was late
+            if (late < 0) {
+                m_rxArrivalExpected += late;
+                late = 0;
+            }
+
+            m_rxWakeup.record(late);
+            if (late < m_rxArrivalMin)
+                m_rxArrivalMin = late;
+
+            // the SDR and host clocks drift apart; follow the earliest arrival of each window
+            if ((elapsed - m_rxArrivalWindow) >= (int64_t(RX_ARRIVAL_WINDOW) * 1000000LL)) {
+                m_rxArrivalExpected += m_rxArrivalMin;
+                m_rxArrivalMin = INT64_MAX;
+                m_rxArrivalWindow = elapsed;
+            }
+            return;
+        }
+    }
+
+    // the first payload, or the stream stopped and restarted, anchors the sample clock
+    m_rxArrivalEpoch = now;
+    m_rxArrivalExpected = 0;
+    m_rxArrivalFrac = 0U;
+    m_rxArrivalMin = INT64_MAX;
+    m_rxArrivalWindow = 0;
+    m_rxArrivalAnchored = true;
+}
+
 /// <summary>
 /// Gets the unique identifier for the air interface.
 /// </summary>
@@ -146,42 +648,80 @@ void IO::initInt()
 /// </summary>
 void IO::startInt()
 {
-    ::LogMessage(LOG_DSP, "Host connected, starting IO operations...");
+    const sdr::ChannelConfig& config = m_modem->m_config;
+    ::LogMessage(LOG_DSP, "Host connected, starting IO operations for channel %u...", m_modem->getId());
+
+    m_txFramePool.release(m_txFrame);
+    m_txFrame = NULL;
+    m_txFramePtr = 0U;
+
+    // the frame length and lead are kept in time, so they scale with the SDR rate
+    m_txFrameLength = uint32_t((uint64_t(TX_FRAME_LENGTH) * config.txSampleRate) / SAMPLE_RATE);
+    uint32_t lead = uint32_t((uint64_t(config.txLead) * config.txSampleRate) / SAMPLE_RATE);
+
+    m_txPacer.setSampleRate(config.txSampleRate);
+    m_txPacer.setLead(lead);
+    ::LogMessage(LOG_DSP, "Tx pacing with a lead of %u samples at %u Hz", lead, config.txSampleRate);
+
+    m_fmDisc.setSampleRate(config.rxSampleRate);
+    m_fmDisc.setFormat(config.rxIQFormat);
 
-    m_zmqSocketTx.close();
-    if (m_zmqSocketRx.connected()) {
-        m_zmqSocketRx.close();
+    // audio can carry an RSSI word after every sample, IQ carries its own power
+    m_rxSampleSize = m_fmDisc.getSampleSize();
+    if (config.rxIQFormat == sdr::IQ_FORMAT_NONE && config.rxRSSI)
+        m_rxSampleSize = 2U * sizeof(short);
+
+    // the transport is created once the Rx sample format is known
+    closeTransport();
+
+    m_transport = createTransport();
+    if (m_transport == NULL || !m_transport->open()) {
+        ::LogError(LOG_DSP, "IO::startInt(), failed to open the sample transport");
+        ::LogFinalise();
+        exit(-1);
     }
 
-    m_zmqContextTx = zmq::context_t(1);
-    m_zmqSocketTx = zmq::socket_t(m_zmqContextTx, ZMQ_PUSH);
+    ::clock_gettime(CLOCK_MONOTONIC, &m_transportStats);
 
-    m_zmqContextRx = zmq::context_t(1);
-    m_zmqSocketRx = zmq::socket_t(m_zmqContextRx, ZMQ_PULL);
+    // recordings hold the 24 kHz samples the DSP itself exchanges with the ring buffers
+    if (!config.capturePath.empty() && !m_recorder.open(config.capturePath, SAMPLE_RATE, m_modem->getId())) {
+        ::LogError(LOG_DSP, "IO::startInt(), failed to start the sample capture");
+        ::LogFinalise();
+        exit(-1);
+    }
 
-    try
-    {
-        ::LogMessage(LOG_DSP, "Binding Tx socket to %s", m_zmqTx.c_str());
-        m_zmqSocketTx.bind(m_zmqTx);
+    if (!config.blackBoxPath.empty() && !m_modem->m_blackBox.open(config.blackBoxPath, config.blackBoxTime, SAMPLE_RATE, m_modem->getId())) {
+        ::LogError(LOG_DSP, "IO::startInt(), failed to start the black box");
+        ::LogFinalise();
+        exit(-1);
     }
-    catch(const zmq::error_t& zmqE) { ::LogError(LOG_DSP, "IO::startInt(), Tx Socket: %s", zmqE.what()); }
-    catch(const std::exception& e) { ::LogError(LOG_DSP, "IO::startInt(), Tx Socket: %s", e.what()); }
 
-    try
-    {
-        ::LogMessage(LOG_DSP, "Connecting Rx socket to %s", m_zmqRx.c_str());
-        m_zmqSocketRx.connect(m_zmqRx);
-        if (m_zmqSocketRx.connected()) {
-            ::LogMessage(LOG_DSP, "IO::startInt(), connected to remote ZMQ listener", m_zmqRx.c_str());
-        } else {
-            ::LogWarning(LOG_DSP, "IO::startInt(), failed to remote ZMQ listener, will continue to retry to connect", m_zmqRx.c_str());
-        }
+    if (!config.replayPath.empty() && !m_replay.open(config.replayPath, SAMPLE_RATE, !config.replayFast)) {
+        ::LogError(LOG_DSP, "IO::startInt(), failed to open the replay");
+        ::LogFinalise();
+        exit(-1);
     }
-    catch(const zmq::error_t& zmqE) { ::LogError(LOG_DSP, "IO::startInt(), Rx Socket: %s", zmqE.what()); }
-    catch(const std::exception& e) { ::LogError(LOG_DSP, "IO::startInt(), Rx Socket: %s", e.what()); }
 
-    m_audioBufTx = std::vector<short>();
-    m_audioBufRx = std::vector<short>();
+    m_rxResampler.open(config.rxSampleRate, SAMPLE_RATE);
+    m_rxResampled.resize(m_rxResampler.getMaxOutput(RX_CONVERT_CHUNK));
+
+    m_txResampler.open(SAMPLE_RATE, config.txSampleRate);
+    m_txResampled.resize(m_txResampler.getMaxOutput(TX_CONVERT_CHUNK));
+    m_txPending.resize(m_txResampled.size());
+    m_txPendingPtr = m_txPendingLen = 0U;
+
+    m_rxDrift.setTarget((config.driftTarget * SAMPLE_RATE) / 1000U);
+    m_rxDrift.reset();
+    m_rxDrifted.resize(m_rxDrift.getMaxOutput(m_rxResampled.size()));
+    m_rxDriftAnchored = false;
+    m_driftPPB = m_txPacerPPB = 0;
+    m_txPacer.setPPM(0.0F);
+    if (config.driftComp)
+        ::LogMessage(LOG_DSP, "Rx drift compensation enabled, target latency %u ms", config.driftTarget);
+    if (config.rxIQFormat != sdr::IQ_FORMAT_NONE)
+        ::LogMessage(LOG_DSP, "Rx input is complex baseband (%s), demodulating in the DSP", config.rxIQFormat == sdr::IQ_FORMAT_CS16 ? "cs16" : "cf32");
+    else if (config.rxRSSI)
+        ::LogMessage(LOG_DSP, "Rx input is audio with interleaved RSSI");
 
     if (::pthread_mutex_init(&m_txLock, NULL) != 0) {
         ::LogError(LOG_DSP, "Tx thread lock failed?");
@@ -189,14 +729,12 @@ void IO::startInt()
         exit(-1);
     }
 
-    if (::pthread_mutex_init(&m_rxLock, NULL) != 0) {
-        ::LogError(LOG_DSP, "Rx thread lock failed?");
-        ::LogFinalise();
-        exit(-2);
-    }
+    // an offline decode drives the Rx path from the calling thread
+    if (g_decode)
+        return;
 
-    ::pthread_create(&m_threadTx, NULL, txThreadHelper, this);
-    ::pthread_create(&m_threadRx, NULL, rxThreadHelper, this);
+    config.txPolicy.create(&m_threadTx, txThreadHelper, this, m_modem->getName("Tx").c_str());
+    config.rxPolicy.create(&m_threadRx, rxThreadHelper, this, m_modem->getName("Rx").c_str());
 }
 
 /// <summary></summary>
@@ -262,11 +800,22 @@ void* IO::txThreadHelper(void* arg)
 {
     IO* p = (IO*)arg;
 
+    std::string name = p->m_modem->getName("Tx");
+    p->m_modem->m_config.txPolicy.apply(name.c_str());
+
+    sdr::WakeupLatency& wakeup = p->m_txPacer.getWakeup();
+    wakeup.clear();
+
+    ::clock_gettime(CLOCK_MONOTONIC, &p->m_watchdogTime);
+
     while (true)
     {
         if (p->m_txBuffer.getData() < 1)
-            usleep(20);
+            p->m_txPacer.idle(p->m_tx);
         p->interrupt();
+
+        if (wakeup.isDue(sdr::WAKEUP_LATENCY_INTERVAL))
+            wakeup.logStats(name.c_str());
     }
 
     return NULL;
@@ -275,47 +824,87 @@ void* IO::txThreadHelper(void* arg)
 /// <summary></summary>
 void IO::interruptRx()
 {
-    uint16_t sample = DC_OFFSET;
-    uint8_t control = MARK_NONE;
-    
-    zmq::message_t msg;
-    zmq::recv_result_t recv;
-    try
-    {
-        recv = m_zmqSocketRx.recv(msg, zmq::recv_flags::none);
-    }
-    catch(const zmq::error_t& zmqE) 
-    {
-        if (zmqE.num() == ENOTSOCK || zmqE.num() == ENOTCONN ||
-            zmqE.num() == ECONNABORTED || zmqE.num() == ECONNRESET ||
-            zmqE.num() == ENETDOWN || zmqE.num() == ENETUNREACH || zmqE.num() == ENETRESET) {
-            try
-            {
-                m_zmqSocketRx.connect(m_zmqRx);
+    sdr::transport::TransportBuffer buffers[sdr::transport::TRANSPORT_MAX_BUFFERS];
+    uint32_t count = m_transport->read(buffers);
+
+    timespec now;
+    ::clock_gettime(CLOCK_MONOTONIC, &now);
+
+    uint32_t arrived = 0U;
+    for (uint32_t i = 0U; i < count; i++)
+        arrived += buffers[i].lost + buffers[i].length;
+    if (arrived > 0U)
+        trackRxArrival(now, arrived / m_rxSampleSize);
+
+    for (uint32_t i = 0U; i < count; i++) {
+        // fill lost samples with silence to keep the air interface timing; silence
+        // is the DC offset for audio (with no signal strength) and zero for IQ
+        uint32_t lost = buffers[i].lost;
+        if (lost > 0U) {
+            short fill[RX_FILL_LENGTH / sizeof(short)];
+            short value = (m_fmDisc.getFormat() == sdr::IQ_FORMAT_NONE) ? short(DC_OFFSET) : 0;
+            for (uint32_t j = 0U; j < (RX_FILL_LENGTH / sizeof(short)); j++)
+                fill[j] = (m_modem->m_config.rxRSSI && (j & 1U) != 0U) ? 0 : value;
+
+            while (lost > 0U) {
+                uint32_t n = (lost > RX_FILL_LENGTH) ? RX_FILL_LENGTH : lost;
+                deliverRx((const uint8_t*)fill, n);
+                lost -= n;
             }
-            catch(const zmq::error_t& zmqE) { /* stub */}
-            return;
-        } else {
-            ::LogError(LOG_DSP, "IO::interruptRx(): %s (%u)", zmqE.what(), zmqE.num()); 
         }
+
+        deliverRx(buffers[i].data, buffers[i].length);
     }
 
-    int size = msg.size();
-    if (size < 1)
-        return;
+    m_transport->release();
 
-    ::pthread_mutex_lock(&m_rxLock);
-    uint16_t space = m_rxBuffer.getSpace();
+    if ((uint32_t(now.tv_sec - m_transportStats.tv_sec) * 1000U) >= TRANSPORT_STATS_INTERVAL) {
+        m_transport->logStats();
+        m_transportStats = now;
+    }
 
-    for (int i = 0; i < size; i += 2)
-    {
-        short sample = 0;
-        ::memcpy(&sample, (unsigned char*)msg.data() + i, sizeof(short));
+    if (m_rxWakeup.isDue(sdr::WAKEUP_LATENCY_INTERVAL))
+        m_rxWakeup.logStats(m_modem->getName("Rx").c_str());
+}
+
+/// <summary>
+/// Helper to feed the next replayed samples into the Rx ring buffers.
+/// </summary>
+/// <remarks>Replayed samples bypass the transport and the Rx conversion, so the DSP sees
+/// exactly the samples, RSSI and control marks that were captured.</remarks>
+void IO::replayRx()
+{
+    if (m_replay.isEOF()) {
+        timespec ts;
+        ts.tv_sec = 0;
+        ts.tv_nsec = long(sdr::transport::TRANSPORT_READ_TIMEOUT) * 1000000L;
+        ::clock_nanosleep(CLOCK_MONOTONIC, 0, &ts, NULL);
+        return;
+    }
 
-        m_rxBuffer.put((uint16_t)sample, control);
-        m_rssiBuffer.put(3U);
+    // as fast as possible is as fast as the main loop empties the Rx ring buffer
+    if (!m_replay.isPaced() && m_rxBuffer.getSpace() < REPLAY_BLOCK) {
+        timespec ts;
+        ts.tv_sec = 0;
+        ts.tv_nsec = long(REPLAY_WAIT) * 1000L;
+        ::clock_nanosleep(CLOCK_MONOTONIC, 0, &ts, NULL);
+        return;
     }
-    ::pthread_mutex_unlock(&m_rxLock);        
+
+    uint16_t samples[REPLAY_BLOCK];
+    uint16_t rssi[REPLAY_BLOCK];
+    uint8_t control[REPLAY_BLOCK];
+    uint32_t n = m_replay.read(samples, rssi, control, REPLAY_BLOCK);
+    if (n == 0U)
+        return;
+
+    uint16_t put = m_rxBuffer.putBlock(samples, control, uint16_t(n));
+    m_rssiBuffer.putBlock(rssi, put);
+    if (put < n)
+        m_modem->m_blackBox.trigger(sdr::BLACKBOX_RX_OVERFLOW);
+
+    if (m_rxBuffer.getData() >= m_modem->m_config.rxBlockSize)
+        m_modem->m_eventLoop.notify();
 }
 
 /// <summary></summary>
@@ -324,9 +913,18 @@ void IO::interruptRx()
 void* IO::rxThreadHelper(void* arg)
 {
     IO* p = (IO*)arg;
+    p->m_modem->m_config.rxPolicy.apply(p->m_modem->getName("Rx").c_str());
+
+    p->m_rxArrivalAnchored = false;
+    p->m_rxWakeup.clear();
 
     while (true)
-        p->interruptRx();
+    {
+        if (p->m_replay.isOpen())
+            p->replayRx();
+        else
+            p->interruptRx();
+    }
 
     return NULL;
 }
@@ -0,0 +1,172 @@
+/**
+* Digital Voice Modem - DSP Firmware
+* GPLv2 Open Source. Use is subject to license terms.
+* DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+*
+* @package DVM / DSP Firmware
+*
+*/
+/*
+*   Copyright (C) 2022 Bryan Biedenkapp N2PLL
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 2 of the License, or
+*   (at your option) any later version.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program; if not, write to the Free Software
+*   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*/
+#include "Globals.h"
+#include "sdr/Modem.h"
+
+using namespace sdr;
+
+// ---------------------------------------------------------------------------
+//  Public Class Members
+// ---------------------------------------------------------------------------
+
+/// <summary>
+/// Initializes a new instance of the ChannelConfig struct.
+/// </summary>
+ChannelConfig::ChannelConfig() :
+    ptyPort(),
+    zmqRx("ipc:///tmp/dvm-rx.ipc"),
+    zmqTx("ipc:///tmp/dvm-tx.ipc"),
+    shmName(),
+    txLead(1440U),
+    rxBlockSize(48U),
+    rxIQFormat(IQ_FORMAT_NONE),
+    rxRSSI(false),
+    rxSampleRate(SAMPLE_RATE),
+    txSampleRate(SAMPLE_RATE),
+    driftComp(false),
+    driftTarget(20U),
+    channelized(false),
+    offset(0),
+    capturePath(),
+    replayPath(),
+    replayFast(false),
+    blackBoxPath(),
+    blackBoxTime(BLACKBOX_TIME_DEFAULT),
+    rxPolicy(),
+    txPolicy()
+{
+    /* stub */
+}
+
+/// <summary>
+/// Initializes a new instance of the ModemContext class.
+/// </summary>
+/// <param name="modem">Modem channel the names are bound to.</param>
+ModemContext::ModemContext(sdr::Modem* modem) :
+    m_modem(modem),
+    m_modemState(modem->m_modemState),
+    m_dmrEnable(modem->m_dmrEnable),
+    m_p25Enable(modem->m_p25Enable),
+    m_nxdnEnable(modem->m_nxdnEnable),
+    m_dcBlockerEnable(modem->m_dcBlockerEnable),
+    m_cosLockoutEnable(modem->m_cosLockoutEnable),
+    m_duplex(modem->m_duplex),
+    m_tx(modem->m_tx),
+    m_dcd(modem->m_dcd),
+    serial(modem->m_serial),
+    io(modem->m_io),
+    dmrIdleRX(modem->m_dmrIdleRX),
+    dmrRX(modem->m_dmrRX),
+    dmrTX(modem->m_dmrTX),
+    dmrDMORX(modem->m_dmrDMORX),
+    dmrDMOTX(modem->m_dmrDMOTX),
+    p25RX(modem->m_p25RX),
+    p25TX(modem->m_p25TX),
+    nxdnRX(modem->m_nxdnRX),
+    nxdnTX(modem->m_nxdnTX),
+    calDMR(modem->m_calDMR),
+    calP25(modem->m_calP25),
+    calNXDN(modem->m_calNXDN),
+    calRSSI(modem->m_calRSSI),
+    cwIdTX(modem->m_cwIdTX),
+    stats(modem->m_stats)
+{
+    /* stub */
+}
+
+/// <summary>
+/// Initializes a new instance of the Modem class.
+/// </summary>
+/// <param name="id">Channel number.</param>
+/// <param name="config">Channel options.</param>
+Modem::Modem(uint32_t id, const ChannelConfig& config) :
+    m_config(config),
+    m_dmrIdleRX(this),
+    m_dmrRX(this),
+    m_dmrTX(this),
+    m_dmrDMORX(this),
+    m_dmrDMOTX(this),
+    m_p25RX(this),
+    m_p25TX(this),
+    m_nxdnRX(this),
+    m_nxdnTX(this),
+    m_calDMR(this),
+    m_calP25(this),
+    m_calNXDN(this),
+    m_calRSSI(this),
+    m_cwIdTX(this),
+    m_stats(),
+    m_serial(this),
+    m_io(this),
+    m_blackBox(),
+    m_eventLoop(),
+    m_serialPort(NULL),
+    m_readBuffer(0x00U),
+    m_decoder(NULL),
+    m_firmware(this),
+    m_id(id)
+{
+    /* stub */
+}
+
+/// <summary>
+/// Gets the name of one of the channel threads, for the log.
+/// </summary>
+/// <param name="thread">Name of the thread within the channel.</param>
+/// <returns></returns>
+std::string Modem::getName(const char* thread) const
+{
+    return "Ch" + std::to_string(m_id) + " " + std::string(thread);
+}
+
+/// <summary>
+/// Opens the channel event loop with the given housekeeping tick interval.
+/// </summary>
+/// <param name="tickUs">Housekeeping tick interval in microseconds.</param>
+/// <returns>True, if the event loop was opened, otherwise false.</returns>
+bool Modem::open(uint32_t tickUs)
+{
+    return m_eventLoop.open(tickUs);
+}
+
+/// <summary>
+/// Closes the PTY, the sample transport, the sample capture, the black box and the event loop.
+/// </summary>
+void Modem::close()
+{
+    if (m_serialPort != NULL) {
+        m_eventLoop.remove(m_serialPort->getFd());
+        m_serialPort->close();
+        delete m_serialPort;
+        m_serialPort = NULL;
+    }
+
+    // the capture is completed first, the process exits right after the transport closes
+    m_io.closeCapture();
+    m_blackBox.close();
+    m_io.closeTransport();
+    m_eventLoop.close();
+}
@@ -0,0 +1,176 @@
+/**
+* Digital Voice Modem - DSP Firmware
+* GPLv2 Open Source. Use is subject to license terms.
+* DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+*
+* @package DVM / DSP Firmware
+*
+*/
+/*
+*   Copyright (C) 2022 Bryan Biedenkapp N2PLL
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 2 of the License, or
+*   (at your option) any later version.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program; if not, write to the Free Software
+*   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*/
+#if !defined(__MODEM_H__)
+#define __MODEM_H__
+
+#include "Defines.h"
+#include "Globals.h"
+#include "Firmware.h"
+#include "sdr/BlackBox.h"
+#include "sdr/EventLoop.h"
+#include "sdr/FMDiscriminator.h"
+#include "sdr/ThreadPolicy.h"
+#include "sdr/port/PseudoPTYPort.h"
+
+#include <string>
+
+namespace sdr
+{
+    class Decoder;
+
+    // ---------------------------------------------------------------------------
+    //  Constants
+    // ---------------------------------------------------------------------------
+
+    const uint32_t MODEM_CHANNELS_MAX = 32U;
+
+    // ---------------------------------------------------------------------------
+    //  Structure Declaration
+    //      Options of one modem channel, as given on the command line.
+    // ---------------------------------------------------------------------------
+
+    struct ChannelConfig {
+        /// <summary>Initializes a new instance of the ChannelConfig struct.</summary>
+        ChannelConfig();
+
+        std::string ptyPort;
+        std::string zmqRx;
+        std::string zmqTx;
+        std::string shmName;
+
+        uint32_t txLead;                    // Tx samples queued ahead of the SDR
+        uint16_t rxBlockSize;               // Rx samples processed per pass
+        IQ_FORMAT rxIQFormat;
+        bool rxRSSI;
+        uint32_t rxSampleRate;
+        uint32_t txSampleRate;
+        bool driftComp;
+        uint32_t driftTarget;               // ms
+        bool channelized;                   // Rx comes from the wideband front end
+        int32_t offset;                     // Hz from the wideband center
+        std::string capturePath;            // SigMF recordings are named from this
+        std::string replayPath;
+        bool replayFast;
+        std::string blackBoxPath;           // black box snapshots are named from this
+        uint32_t blackBoxTime;              // seconds
+
+        ThreadPolicy rxPolicy;
+        ThreadPolicy txPolicy;
+    };
+
+    // ---------------------------------------------------------------------------
+    //  Class Declaration
+    //      Implements one modem channel; the state and protocol objects the MCU
+    //      builds keep as globals, its PTY and its event loop. The protocol
+    //      objects reach each other through a ModemContext bound to the channel.
+    // ---------------------------------------------------------------------------
+
+    class DSP_FW_API Modem {
+    public:
+        /// <summary>Initializes a new instance of the Modem class.</summary>
+        Modem(uint32_t id, const ChannelConfig& config);
+
+        /// <summary>Gets the channel number.</summary>
+        uint32_t getId() const { return m_id; }
+        /// <summary>Gets the name of one of the channel threads, for the log.</summary>
+        std::string getName(const char* thread) const;
+
+        /// <summary>Opens the channel event loop with the given housekeeping tick interval.</summary>
+        bool open(uint32_t tickUs);
+        /// <summary>Closes the PTY, the sample transport, the sample capture, the black box and the event loop.</summary>
+        void close();
+
+        /** Channel options */
+        ChannelConfig m_config;
+
+        /** Modem state */
+        DVM_STATE m_modemState = STATE_IDLE;
+
+        bool m_dmrEnable = true;
+        bool m_p25Enable = true;
+        bool m_nxdnEnable = true;
+
+        bool m_dcBlockerEnable = true;
+        bool m_cosLockoutEnable = false;
+
+        bool m_duplex = true;
+
+        bool m_tx = false;
+        bool m_dcd = false;
+
+        /** DMR BS */
+        dmr::DMRIdleRX m_dmrIdleRX;
+        dmr::DMRRX m_dmrRX;
+        dmr::DMRTX m_dmrTX;
+
+        /** DMR MS-DMO */
+        dmr::DMRDMORX m_dmrDMORX;
+        dmr::DMRDMOTX m_dmrDMOTX;
+
+        /** P25 */
+        p25::P25RX m_p25RX;
+        p25::P25TX m_p25TX;
+
+        /** NXDN */
+        nxdn::NXDNRX m_nxdnRX;
+        nxdn::NXDNTX m_nxdnTX;
+
+        /** Calibration */
+        dmr::CalDMR m_calDMR;
+        p25::CalP25 m_calP25;
+        nxdn::CalNXDN m_calNXDN;
+        CalRSSI m_calRSSI;
+
+        /** CW */
+        CWIdTX m_cwIdTX;
+
+        /** Stage timing counters */
+        StageStats m_stats;
+
+        /** RS232 and Air Interface I/O */
+        SerialPort m_serial;
+        IO m_io;
+
+        /** Black box recorder of the last seconds of Rx samples */
+        BlackBox m_blackBox;
+
+        /** Native PTY and the event loop waking the channel on PTY data, sample thread work or the housekeeping tick */
+        EventLoop m_eventLoop;
+        port::PseudoPTYPort* m_serialPort;
+        uint8_t m_readBuffer;
+
+        /** Offline decode sink the host frames go to instead of the PTY */
+        Decoder* m_decoder;
+
+        /** Firmware setup and main loop run against this channel */
+        Firmware m_firmware;
+
+    private:
+        uint32_t m_id;
+    };
+} // namespace sdr
+
+#endif // __MODEM_H__
@@ -0,0 +1,248 @@
+/**
+* Digital Voice Modem - DSP Firmware
+* GPLv2 Open Source. Use is subject to license terms.
+* DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+*
+* @package DVM / DSP Firmware
+*
+*/
+/*
+*   Copyright (C) 2022 Bryan Biedenkapp N2PLL
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 2 of the License, or
+*   (at your option) any later version.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program; if not, write to the Free Software
+*   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*/
+#include "sdr/Resampler.h"
+#include "sdr/Log.h"
+
+#include <cmath>
+
+using namespace sdr;
+
+// ---------------------------------------------------------------------------
+//  Constants
+// ---------------------------------------------------------------------------
+
+// taps per polyphase branch, relative to the larger of the two factors
+const uint32_t TAPS_PER_FACTOR = 16U;
+
+// pass band edge as a fraction of the lower of the two Nyquist rates
+const double CUTOFF_RATIO = 0.9;
+
+// ---------------------------------------------------------------------------
+//  Global Functions
+// ---------------------------------------------------------------------------
+
+/// <summary>
+/// Helper to calculate the greatest common divisor.
+/// </summary>
+/// <param name="a"></param>
+/// <param name="b"></param>
+/// <returns></returns>
+static uint32_t gcd(uint32_t a, uint32_t b)
+{
+    while (b != 0U) {
+        uint32_t t = a % b;
+        a = b;
+        b = t;
+    }
+
+    return a;
+}
+
+// ---------------------------------------------------------------------------
+//  Public Class Members
+// ---------------------------------------------------------------------------
+
+/// <summary>
+/// Initializes a new instance of the Resampler class.
+/// </summary>
+Resampler::Resampler() :
+    m_interp(1U),
+    m_decim(1U),
+    m_phaseLength(0U),
+    m_coeffs(NULL),
+    m_state(NULL),
+    m_time(0U)
+{
+    /* stub */
+}
+
+/// <summary>
+/// Finalizes a instance of the Resampler class.
+/// </summary>
+Resampler::~Resampler()
+{
+    release();
+}
+
+/// <summary>
+/// Configures the resampler for the given input and output rates.
+/// </summary>
+/// <param name="inRate">Input sample rate.</param>
+/// <param name="outRate">Output sample rate.</param>
+/// <returns>True, if the resampler was configured, otherwise false.</returns>
+bool Resampler::open(uint32_t inRate, uint32_t outRate)
+{
+    release();
+
+    if (inRate == 0U || outRate == 0U)
+        return false;
+
+    uint32_t div = gcd(inRate, outRate);
+    m_interp = outRate / div;
+    m_decim = inRate / div;
+
+    if (m_interp == m_decim)
+        return true;
+
+    if (m_interp > RESAMPLER_MAX_PHASES) {
+        ::LogError(LOG_DSP, "Cannot resample %u Hz to %u Hz, %u polyphase branches exceeds %u", inRate, outRate, m_interp, RESAMPLER_MAX_PHASES);
+        m_interp = m_decim = 1U;
+        return false;
+    }
+
+    // the prototype filter runs at inRate * L and must cut off below the lower Nyquist rate
+    uint32_t factor = (m_interp > m_decim) ? m_interp : m_decim;
+    m_phaseLength = (TAPS_PER_FACTOR * factor + m_interp - 1U) / m_interp;
+    if (m_phaseLength < 4U)
+        m_phaseLength = 4U;
+
+    uint32_t length = m_phaseLength * m_interp;
+    double fc = (0.5 * CUTOFF_RATIO) / double(factor);    // normalized to the prototype rate
+    double mid = double(length - 1U) / 2.0;
+
+    // windowed sinc prototype with a Blackman window, scaled by L to keep unity gain
+    double* proto = new double[length];
+    double sum = 0.0;
+    for (uint32_t i = 0U; i < length; i++) {
+        double n = double(i) - mid;
+        double sinc = (n == 0.0) ? (2.0 * fc) : (::sin(2.0 * M_PI * fc * n) / (M_PI * n));
+        double window = 0.42 - (0.5 * ::cos((2.0 * M_PI * double(i)) / double(length - 1U))) + (0.08 * ::cos((4.0 * M_PI * double(i)) / double(length - 1U)));
+        proto[i] = sinc * window;
+        sum += proto[i];
+    }
+
+    // split into branches, each stored oldest-to-newest so the dot product walks
+    // the input history forwards
+    m_coeffs = new float[length];
+    for (uint32_t p = 0U; p < m_interp; p++) {
+        for (uint32_t k = 0U; k < m_phaseLength; k++)
+            m_coeffs[(p * m_phaseLength) + (m_phaseLength - 1U - k)] = float((proto[p + (k * m_interp)] * double(m_interp)) / sum);
+    }
+
+    delete[] proto;
+
+    m_state = new float[m_phaseLength - 1U + RESAMPLER_BLOCK_SIZE];
+    reset();
+
+    ::LogMessage(LOG_DSP, "Resampling %u Hz to %u Hz, L = %u, M = %u, %u taps per branch", inRate, outRate, m_interp, m_decim, m_phaseLength);
+    return true;
+}
+
+/// <summary>
+/// Gets the largest number of outputs produced from the given number of inputs.
+/// </summary>
+/// <param name="inCount"></param>
+/// <returns></returns>
+uint32_t Resampler::getMaxOutput(uint32_t inCount) const
+{
+    return ((inCount * m_interp) / m_decim) + 1U;
+}
+
+/// <summary>
+/// Resets the filter history.
+/// </summary>
+void Resampler::reset()
+{
+    if (m_state != NULL)
+        ::memset(m_state, 0x00U, (m_phaseLength - 1U + RESAMPLER_BLOCK_SIZE) * sizeof(float));
+    m_time = 0U;
+}
+
+/// <summary>
+/// Converts a block of samples; returns the number of output samples written.
+/// </summary>
+/// <param name="in">Input samples.</param>
+/// <param name="inCount">Number of input samples.</param>
+/// <param name="out">Output samples, must hold getMaxOutput(inCount) samples.</param>
+/// <returns></returns>
+uint32_t Resampler::process(const float* in, uint32_t inCount, float* out)
+{
+    if (!isActive()) {
+        ::memcpy(out, in, inCount * sizeof(float));
+        return inCount;
+    }
+
+    const uint32_t hist = m_phaseLength - 1U;
+    uint32_t outCount = 0U;
+
+    uint32_t done = 0U;
+    while (done < inCount) {
+        uint32_t n = inCount - done;
+        if (n > RESAMPLER_BLOCK_SIZE)
+            n = RESAMPLER_BLOCK_SIZE;
+
+        ::memcpy(m_state + hist, in + done, n * sizeof(float));
+
+        // m_time is the position of the next output, in 1/L input sample steps,
+        // relative to the first new input sample of this block
+        uint32_t limit = n * m_interp;
+        while (m_time < limit) {
+            uint32_t index = m_time / m_interp;
+            uint32_t phase = m_time % m_interp;
+
+            const float* x = m_state + index;
+            const float* h = m_coeffs + (phase * m_phaseLength);
+
+            float acc = 0.0F;
+            for (uint32_t k = 0U; k < m_phaseLength; k++)
+                acc += h[k] * x[k];
+
+            out[outCount++] = acc;
+            m_time += m_decim;
+        }
+
+        m_time -= limit;
+
+        ::memmove(m_state, m_state + n, hist * sizeof(float));
+        done += n;
+    }
+
+    return outCount;
+}
+
+// ---------------------------------------------------------------------------
+//  Private Class Members
+// ---------------------------------------------------------------------------
+
+/// <summary>
+/// Helper to release the filter storage.
+/// </summary>
+void Resampler::release()
+{
+    if (m_coeffs != NULL) {
+        delete[] m_coeffs;
+        m_coeffs = NULL;
+    }
+
+    if (m_state != NULL) {
+        delete[] m_state;
+        m_state = NULL;
+    }
+
+    m_interp = m_decim = 1U;
+    m_phaseLength = 0U;
+    m_time = 0U;
+}
@@ -0,0 +1,87 @@
+/**
+* Digital Voice Modem - DSP Firmware
+* GPLv2 Open Source. Use is subject to license terms.
+* DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+*
+* @package DVM / DSP Firmware
+*
+*/
+/*
+*   Copyright (C) 2022 Bryan Biedenkapp N2PLL
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 2 of the License, or
+*   (at your option) any later version.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program; if not, write to the Free Software
+*   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*/
+#if !defined(__RESAMPLER_H__)
+#define __RESAMPLER_H__
+
+#include "Defines.h"
+
+namespace sdr
+{
+    // ---------------------------------------------------------------------------
+    //  Constants
+    // ---------------------------------------------------------------------------
+
+    const uint32_t RESAMPLER_MAX_PHASES = 1024U;
+    const uint32_t RESAMPLER_BLOCK_SIZE = 256U;
+
+    // ---------------------------------------------------------------------------
+    //  Class Declaration
+    //      Implements a polyphase rational (L/M) sample rate converter. Each
+    //      output is one contiguous dot product of a polyphase branch against
+    //      the input history, laid out so the compiler can vectorize it.
+    // ---------------------------------------------------------------------------
+
+    class DSP_FW_API Resampler {
+    public:
+        /// <summary>Initializes a new instance of the Resampler class.</summary>
+        Resampler();
+        /// <summary>Finalizes a instance of the Resampler class.</summary>
+        ~Resampler();
+
+        /// <summary>Configures the resampler for the given input and output rates.</summary>
+        bool open(uint32_t inRate, uint32_t outRate);
+
+        /// <summary>Flag indicating whether the rates differ and samples need converting.</summary>
+        bool isActive() const { return m_interp != m_decim; }
+        /// <summary>Gets the interpolation factor.</summary>
+        uint32_t getInterpolation() const { return m_interp; }
+        /// <summary>Gets the decimation factor.</summary>
+        uint32_t getDecimation() const { return m_decim; }
+        /// <summary>Gets the largest number of outputs produced from the given number of inputs.</summary>
+        uint32_t getMaxOutput(uint32_t inCount) const;
+
+        /// <summary>Resets the filter history.</summary>
+        void reset();
+
+        /// <summary>Converts a block of samples; returns the number of output samples written.</summary>
+        uint32_t process(const float* in, uint32_t inCount, float* out);
+
+    private:
+        uint32_t m_interp;
+        uint32_t m_decim;
+        uint32_t m_phaseLength;
+
+        float* m_coeffs;
+        float* m_state;
+
+        uint32_t m_time;
+
+        /// <summary>Helper to release the filter storage.</summary>
+        void release();
+    };
+} // namespace sdr
+
+#endif // __RESAMPLER_H__
@@ -0,0 +1,118 @@
+/**
+* Digital Voice Modem - DSP Firmware
+* GPLv2 Open Source. Use is subject to license terms.
+* DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+*
+* @package DVM / DSP Firmware
+*
+*/
+/*
+*   Copyright (C) 2022 Bryan Biedenkapp N2PLL
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 2 of the License, or
+*   (at your option) any later version.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program; if not, write to the Free Software
+*   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*/
+#include "sdr/SampleFramePool.h"
+
+#include <cassert>
+
+using namespace sdr;
+
+// ---------------------------------------------------------------------------
+//  Public Class Members
+// ---------------------------------------------------------------------------
+
+/// <summary>
+/// Initializes a new instance of the SampleFramePool class.
+/// </summary>
+/// <param name="frameCount">Number of frames in the pool.</param>
+/// <param name="frameLength">Number of samples in each frame.</param>
+SampleFramePool::SampleFramePool(uint32_t frameCount, uint32_t frameLength) :
+    m_frameCount(frameCount),
+    m_frameLength(frameLength),
+    m_frames(NULL),
+    m_inUse(NULL),
+    m_next(0U),
+    m_exhausted(0U)
+{
+    assert(frameCount > 0U);
+    assert(frameLength > 0U);
+
+    m_frames = new short[frameCount * frameLength];
+    m_inUse = new std::atomic<bool>[frameCount];
+    for (uint32_t i = 0U; i < frameCount; i++)
+        m_inUse[i].store(false, std::memory_order_relaxed);
+}
+
+/// <summary>
+/// Finalizes a instance of the SampleFramePool class.
+/// </summary>
+SampleFramePool::~SampleFramePool()
+{
+    delete[] m_frames;
+    delete[] m_inUse;
+}
+
+/// <summary>
+/// Acquires a free frame from the pool.
+/// </summary>
+/// <remarks>This must only be called from a single thread; frames may be released from any thread.</remarks>
+/// <returns>Pointer to a frame of <see cref="getFrameLength"/> samples, or NULL if all frames are in flight.</returns>
+short* SampleFramePool::acquire()
+{
+    // frames are generally returned in the order they were handed out, so
+    // the next frame in sequence is almost always the free one
+    for (uint32_t n = 0U; n < m_frameCount; n++) {
+        uint32_t idx = m_next;
+
+        m_next++;
+        if (m_next >= m_frameCount)
+            m_next = 0U;
+
+        if (!m_inUse[idx].load(std::memory_order_acquire)) {
+            m_inUse[idx].store(true, std::memory_order_relaxed);
+            return m_frames + (idx * m_frameLength);
+        }
+    }
+
+    m_exhausted.fetch_add(1U, std::memory_order_relaxed);
+    return NULL;
+}
+
+/// <summary>
+/// Returns a frame to the pool.
+/// </summary>
+/// <param name="frame">Frame previously returned by <see cref="acquire"/>.</param>
+void SampleFramePool::release(short* frame)
+{
+    if (frame == NULL)
+        return;
+
+    uint32_t idx = uint32_t(frame - m_frames) / m_frameLength;
+    assert(idx < m_frameCount);
+
+    m_inUse[idx].store(false, std::memory_order_release);
+}
+
+/// <summary>
+/// Transport free callback; returns the frame pointed to by data to the pool passed by hint.
+/// </summary>
+/// <param name="data">Frame data.</param>
+/// <param name="hint">Owning <see cref="SampleFramePool"/>.</param>
+void SampleFramePool::freeFrame(void* data, void* hint)
+{
+    SampleFramePool* pool = (SampleFramePool*)hint;
+    if (pool != NULL)
+        pool->release((short*)data);
+}
@@ -0,0 +1,75 @@
+/**
+* Digital Voice Modem - DSP Firmware
+* GPLv2 Open Source. Use is subject to license terms.
+* DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+*
+* @package DVM / DSP Firmware
+*
+*/
+/*
+*   Copyright (C) 2022 Bryan Biedenkapp N2PLL
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 2 of the License, or
+*   (at your option) any later version.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program; if not, write to the Free Software
+*   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*/
+#if !defined(__SAMPLE_FRAME_POOL_H__)
+#define __SAMPLE_FRAME_POOL_H__
+
+#include "Defines.h"
+
+#include <atomic>
+
+namespace sdr
+{
+    // ---------------------------------------------------------------------------
+    //  Class Declaration
+    //      Implements a preallocated pool of fixed-size sample frames. Frames are
+    //      filled in place and handed to the transport without copying; the
+    //      transport returns them to the pool through the release callback.
+    // ---------------------------------------------------------------------------
+
+    class DSP_FW_API SampleFramePool {
+    public:
+        /// <summary>Initializes a new instance of the SampleFramePool class.</summary>
+        SampleFramePool(uint32_t frameCount, uint32_t frameLength);
+        /// <summary>Finalizes a instance of the SampleFramePool class.</summary>
+        ~SampleFramePool();
+
+        /// <summary>Acquires a free frame from the pool.</summary>
+        short* acquire();
+        /// <summary>Returns a frame to the pool.</summary>
+        void release(short* frame);
+
+        /// <summary>Gets the number of samples in a frame.</summary>
+        uint32_t getFrameLength() const { return m_frameLength; }
+        /// <summary>Gets the number of times a frame was requested with no free frames available.</summary>
+        uint32_t getExhaustedCount() const { return m_exhausted.load(std::memory_order_relaxed); }
+
+        /// <summary>Transport free callback; returns the frame pointed to by data to the pool passed by hint.</summary>
+        static void freeFrame(void* data, void* hint);
+
+    private:
+        uint32_t m_frameCount;
+        uint32_t m_frameLength;
+
+        short* m_frames;
+        std::atomic<bool>* m_inUse;
+
+        uint32_t m_next;
+
+        std::atomic<uint32_t> m_exhausted;
+    };
+} // namespace sdr
+
+#endif // __SAMPLE_FRAME_POOL_H__
@@ -33,18 +33,13 @@
 #include "Globals.h"
 #include "SerialPort.h"
 
+#include "sdr/Decoder.h"
 #include "sdr/port/UARTPort.h"
 #include "sdr/port/PseudoPTYPort.h"
 
+using namespace sdr;
 using namespace sdr::port;
 
-// ---------------------------------------------------------------------------
-//  Globals Variables
-// ---------------------------------------------------------------------------
-
-PseudoPTYPort* m_serialPort = nullptr;
-static uint8_t m_readBuffer = 0x00U;
-
 // ---------------------------------------------------------------------------
 //  Private Class Members
 // ---------------------------------------------------------------------------
@@ -78,13 +73,19 @@ uint8_t SerialPort::flashWrite(const uint8_t* data, uint8_t length)
 /// <param name="speed"></param>
 void SerialPort::beginInt(uint8_t n, int speed)
 {
-    ::LogMessage(LOG_DSP, "Starting PTY serial...");
+    // each modem channel has its own PTY
+    Modem* modem = m_modem;
+    ::LogMessage(LOG_DSP, "Starting PTY serial for channel %u...", modem->getId());
 
     switch (n) {
     case 1U:
-        m_readBuffer = 0x00U;
-        m_serialPort = new PseudoPTYPort(m_ptyPort, SERIAL_115200, false);
-        m_serialPort->open();
+        modem->m_readBuffer = 0x00U;
+        modem->m_serialPort = new PseudoPTYPort(modem->m_config.ptyPort, SERIAL_115200, false);
+        if (!modem->m_serialPort->open()) {
+            // the channel is left without a PTY, which stops the startup
+            delete modem->m_serialPort;
+            modem->m_serialPort = NULL;
+        }
         break;
     default:
         break;
@@ -100,7 +101,10 @@ int SerialPort::availableInt(uint8_t n)
 {
     switch (n) {
     case 1U:
-        return m_serialPort->read(&m_readBuffer, (uint8_t)(1 * sizeof(uint8_t)));
+    {
+        Modem* modem = m_modem;
+        return modem->m_serialPort->read(&modem->m_readBuffer, (uint8_t)(1 * sizeof(uint8_t)));
+    }
     default:
         return 0;
     }
@@ -130,7 +134,7 @@ uint8_t SerialPort::readInt(uint8_t n)
 {
     switch (n) {
     case 1U:
-        return m_readBuffer;  
+        return m_modem->m_readBuffer;
     default:
         return 0U;
     }
@@ -147,8 +151,33 @@ void SerialPort::writeInt(uint8_t n, const uint8_t* data, uint16_t length, bool
 {
     switch (n) {
     case 1U:
-        m_serialPort->write(data, length);
+    {
+        Modem* modem = m_modem;
+
+        // a receiver losing sync snapshots the black box
+        if (length >= 3U) {
+            switch (data[2U]) {
+            case CMD_P25_LOST:
+                modem->m_blackBox.trigger(BLACKBOX_P25_LOST);
+                break;
+            case CMD_DMR_LOST1:
+            case CMD_DMR_LOST2:
+                modem->m_blackBox.trigger(BLACKBOX_DMR_LOST);
+                break;
+            case CMD_NXDN_LOST:
+                modem->m_blackBox.trigger(BLACKBOX_NXDN_LOST);
+                break;
+            default:
+                break;
+            }
+        }
+
+        if (modem->m_decoder != NULL)
+            modem->m_decoder->write(data, length);
+        else
+            modem->m_serialPort->write(data, length);
         break;
+    }
     default:
         break;
     }
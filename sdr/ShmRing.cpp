@@ -0,0 +1,301 @@
+/**
+* Digital Voice Modem - DSP Firmware
+* GPLv2 Open Source. Use is subject to license terms.
+* DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+*
+* @package DVM / DSP Firmware
+*
+*/
+/*
+*   Copyright (C) 2022 Bryan Biedenkapp N2PLL
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 2 of the License, or
+*   (at your option) any later version.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program; if not, write to the Free Software
+*   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*/
+#include "sdr/ShmRing.h"
+#include "sdr/Log.h"
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <time.h>
+#include <cerrno>
+
+using namespace sdr;
+
+// ---------------------------------------------------------------------------
+//  Macros
+// ---------------------------------------------------------------------------
+
+#define LOAD_ACQUIRE(v)         __atomic_load_n(&(v), __ATOMIC_ACQUIRE)
+#define LOAD_RELAXED(v)         __atomic_load_n(&(v), __ATOMIC_RELAXED)
+#define STORE_RELEASE(v, x)     __atomic_store_n(&(v), (x), __ATOMIC_RELEASE)
+
+// ---------------------------------------------------------------------------
+//  Global Functions
+// ---------------------------------------------------------------------------
+
+/// <summary>
+/// Helper to sleep on a futex word shared between processes.
+/// </summary>
+/// <param name="addr"></param>
+/// <param name="expected">Value the word must still hold for the caller to sleep.</param>
+/// <param name="timeout">Timeout in milliseconds.</param>
+static void futexWait(uint32_t* addr, uint32_t expected, uint32_t timeout)
+{
+    timespec ts;
+    ts.tv_sec = time_t(timeout / 1000U);
+    ts.tv_nsec = long(timeout % 1000U) * 1000000L;
+    ::syscall(SYS_futex, addr, FUTEX_WAIT, expected, &ts, NULL, 0);
+}
+
+/// <summary>
+/// Helper to wake the waiter on a futex word shared between processes.
+/// </summary>
+/// <param name="addr"></param>
+static void futexWake(uint32_t* addr)
+{
+    ::syscall(SYS_futex, addr, FUTEX_WAKE, 1, NULL, NULL, 0);
+}
+
+// ---------------------------------------------------------------------------
+//  Public Class Members
+// ---------------------------------------------------------------------------
+
+/// <summary>
+/// Initializes a new instance of the ShmRing class.
+/// </summary>
+ShmRing::ShmRing() :
+    m_name(),
+    m_header(NULL),
+    m_data(NULL),
+    m_size(0U),
+    m_mask(SHM_RING_LENGTH - 1U),
+    m_sleeps(0U)
+{
+    /* stub */
+}
+
+/// <summary>
+/// Finalizes a instance of the ShmRing class.
+/// </summary>
+ShmRing::~ShmRing()
+{
+    close();
+}
+
+/// <summary>
+/// Creates (or attaches to) the named shared memory ring.
+/// </summary>
+/// <remarks>A ring that already exists with a valid header is attached to as is, so
+/// the DSP can be restarted while the front end keeps running.</remarks>
+/// <param name="name">Name of the POSIX shared memory object (e.g. "/dvm-rx").</param>
+/// <param name="sampleRate">Sample rate of the stream, recorded in the header.</param>
+/// <returns>True, if the ring was mapped, otherwise false.</returns>
+bool ShmRing::open(const std::string& name, uint32_t sampleRate)
+{
+    if (isOpen()) {
+        if (name == m_name)
+            return true;
+        close();
+    }
+
+    int fd = ::shm_open(name.c_str(), O_RDWR | O_CREAT, 0660);
+    if (fd < 0) {
+        ::LogError(LOG_DSP, "ShmRing::open(), failed to open %s, err = %d", name.c_str(), errno);
+        return false;
+    }
+
+    m_size = sizeof(ShmRingHeader) + (SHM_RING_LENGTH * sizeof(uint16_t));
+
+    struct stat st;
+    bool created = (::fstat(fd, &st) == 0) && (size_t(st.st_size) < m_size);
+    if (created && ::ftruncate(fd, off_t(m_size)) != 0) {
+        ::LogError(LOG_DSP, "ShmRing::open(), failed to size %s, err = %d", name.c_str(), errno);
+        ::close(fd);
+        return false;
+    }
+
+    void* map = ::mmap(NULL, m_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (map == MAP_FAILED) {
+        ::LogError(LOG_DSP, "ShmRing::open(), failed to map %s, err = %d", name.c_str(), errno);
+        return false;
+    }
+
+    m_header = (ShmRingHeader*)map;
+    m_data = (uint16_t*)((uint8_t*)map + sizeof(ShmRingHeader));
+    m_name = name;
+
+    if (created || m_header->magic != SHM_RING_MAGIC || m_header->version != SHM_RING_VERSION || m_header->length != SHM_RING_LENGTH) {
+        ::memset(m_header, 0x00U, sizeof(ShmRingHeader));
+        m_header->version = SHM_RING_VERSION;
+        m_header->length = SHM_RING_LENGTH;
+        m_header->sampleRate = sampleRate;
+
+        // the magic is published last, front ends wait for it before using the ring
+        STORE_RELEASE(m_header->magic, SHM_RING_MAGIC);
+    }
+    else {
+        m_header->sampleRate = sampleRate;
+    }
+
+    ::LogMessage(LOG_DSP, "Mapped shared memory ring %s, %u words", name.c_str(), SHM_RING_LENGTH);
+    return true;
+}
+
+/// <summary>
+/// Unmaps the shared memory ring.
+/// </summary>
+void ShmRing::close()
+{
+    if (m_header != NULL) {
+        ::munmap(m_header, m_size);
+        m_header = NULL;
+        m_data = NULL;
+    }
+}
+
+/// <summary>
+/// Gets the number of words queued in the ring.
+/// </summary>
+/// <returns></returns>
+uint32_t ShmRing::getData() const
+{
+    return LOAD_ACQUIRE(m_header->head) - LOAD_ACQUIRE(m_header->tail);
+}
+
+/// <summary>
+/// Gets the number of words free in the ring.
+/// </summary>
+/// <returns></returns>
+uint32_t ShmRing::getSpace() const
+{
+    return SHM_RING_LENGTH - getData();
+}
+
+/// <summary>
+/// Copies words into the ring and wakes the consumer; returns the number of words written.
+/// </summary>
+/// <param name="data"></param>
+/// <param name="length"></param>
+/// <returns></returns>
+uint32_t ShmRing::write(const uint16_t* data, uint32_t length)
+{
+    uint32_t head = LOAD_RELAXED(m_header->head);
+    uint32_t space = SHM_RING_LENGTH - (head - LOAD_ACQUIRE(m_header->tail));
+    if (length > space)
+        length = space;
+
+    uint32_t pos = head & m_mask;
+    uint32_t first = SHM_RING_LENGTH - pos;
+    if (first > length)
+        first = length;
+
+    ::memcpy(m_data + pos, data, first * sizeof(uint16_t));
+    ::memcpy(m_data, data + first, (length - first) * sizeof(uint16_t));
+
+    // the head store and the waiter check are ordered against the consumer's
+    // waiter store and head check, so a wakeup is never missed
+    __atomic_store_n(&m_header->head, head + length, __ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&m_header->headWaiters, __ATOMIC_SEQ_CST) != 0U)
+        futexWake(&m_header->head);
+
+    return length;
+}
+
+/// <summary>
+/// Gets the queued words as up to two contiguous spans without consuming them.
+/// </summary>
+/// <param name="spans"></param>
+/// <returns>Total number of words in the spans.</returns>
+uint32_t ShmRing::beginRead(ShmSpan spans[2U]) const
+{
+    uint32_t tail = LOAD_RELAXED(m_header->tail);
+    uint32_t data = LOAD_ACQUIRE(m_header->head) - tail;
+
+    uint32_t pos = tail & m_mask;
+    uint32_t first = SHM_RING_LENGTH - pos;
+    if (first > data)
+        first = data;
+
+    spans[0U].data = m_data + pos;
+    spans[0U].length = first;
+    spans[1U].data = m_data;
+    spans[1U].length = data - first;
+
+    return data;
+}
+
+/// <summary>
+/// Consumes words previously returned by beginRead.
+/// </summary>
+/// <param name="count"></param>
+void ShmRing::commitRead(uint32_t count)
+{
+    __atomic_store_n(&m_header->tail, LOAD_RELAXED(m_header->tail) + count, __ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&m_header->tailWaiters, __ATOMIC_SEQ_CST) != 0U)
+        futexWake(&m_header->tail);
+}
+
+/// <summary>
+/// Blocks until the ring holds data or the timeout expires.
+/// </summary>
+/// <param name="timeout">Timeout in milliseconds.</param>
+/// <returns>True, if the ring holds data, otherwise false.</returns>
+bool ShmRing::waitData(uint32_t timeout)
+{
+    uint32_t tail = LOAD_RELAXED(m_header->tail);
+    uint32_t head = LOAD_ACQUIRE(m_header->head);
+    if (head != tail)
+        return true;
+
+    __atomic_store_n(&m_header->headWaiters, 1U, __ATOMIC_SEQ_CST);
+    head = __atomic_load_n(&m_header->head, __ATOMIC_SEQ_CST);
+    if (head == tail) {
+        m_sleeps++;
+        futexWait(&m_header->head, head, timeout);
+        head = LOAD_ACQUIRE(m_header->head);
+    }
+    __atomic_store_n(&m_header->headWaiters, 0U, __ATOMIC_RELAXED);
+
+    return head != tail;
+}
+
+/// <summary>
+/// Blocks until the ring has space or the timeout expires.
+/// </summary>
+/// <param name="timeout">Timeout in milliseconds.</param>
+/// <returns>True, if the ring has space, otherwise false.</returns>
+bool ShmRing::waitSpace(uint32_t timeout)
+{
+    uint32_t head = LOAD_RELAXED(m_header->head);
+    uint32_t tail = LOAD_ACQUIRE(m_header->tail);
+    if ((head - tail) < SHM_RING_LENGTH)
+        return true;
+
+    __atomic_store_n(&m_header->tailWaiters, 1U, __ATOMIC_SEQ_CST);
+    tail = __atomic_load_n(&m_header->tail, __ATOMIC_SEQ_CST);
+    if ((head - tail) >= SHM_RING_LENGTH) {
+        m_sleeps++;
+        futexWait(&m_header->tail, tail, timeout);
+        tail = LOAD_ACQUIRE(m_header->tail);
+    }
+    __atomic_store_n(&m_header->tailWaiters, 0U, __ATOMIC_RELAXED);
+
+    return (head - tail) < SHM_RING_LENGTH;
+}
@@ -0,0 +1,129 @@
+/**
+* Digital Voice Modem - DSP Firmware
+* GPLv2 Open Source. Use is subject to license terms.
+* DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+*
+* @package DVM / DSP Firmware
+*
+*/
+/*
+*   Copyright (C) 2022 Bryan Biedenkapp N2PLL
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 2 of the License, or
+*   (at your option) any later version.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program; if not, write to the Free Software
+*   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*/
+#if !defined(__SHM_RING_H__)
+#define __SHM_RING_H__
+
+#include "Defines.h"
+
+#include <string>
+
+namespace sdr
+{
+    // ---------------------------------------------------------------------------
+    //  Constants
+    // ---------------------------------------------------------------------------
+
+    const uint32_t SHM_RING_MAGIC = 0x534D5644U;   // "DVMS"
+    const uint32_t SHM_RING_VERSION = 1U;
+
+    // 16-bit words per ring; 512 KiB, over 5 seconds of 24 kHz audio
+    const uint32_t SHM_RING_LENGTH = 262144U;
+
+    // ---------------------------------------------------------------------------
+    //  Structure Declaration
+    //      Header at the start of the shared memory object, shared with the SDR
+    //      front end. The producer and consumer indices are free running 32-bit
+    //      word counts, each on its own cache line, and double as futex words.
+    // ---------------------------------------------------------------------------
+
+    struct ShmRingHeader {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t length;                        // ring length in 16-bit words, a power of two
+        uint32_t sampleRate;                    // informational, sample rate of the stream
+        uint8_t m_pad0[CACHE_LINE_SIZE - (4U * sizeof(uint32_t))];
+
+        uint32_t head;                          // written by the producer only
+        uint32_t headWaiters;                   // non-zero while the consumer sleeps on head
+        uint8_t m_pad1[CACHE_LINE_SIZE - (2U * sizeof(uint32_t))];
+
+        uint32_t tail;                          // written by the consumer only
+        uint32_t tailWaiters;                   // non-zero while the producer sleeps on tail
+        uint8_t m_pad2[CACHE_LINE_SIZE - (2U * sizeof(uint32_t))];
+    };
+
+    /// <summary>
+    /// Contiguous run of words in the shared memory ring.
+    /// </summary>
+    struct ShmSpan {
+        const uint16_t* data;
+        uint32_t length;
+    };
+
+    // ---------------------------------------------------------------------------
+    //  Class Declaration
+    //      Implements a single-producer/single-consumer ring of 16-bit words in
+    //      POSIX shared memory. Neither side makes a system call while the ring
+    //      has data (or space); a sleeping side is woken with a futex.
+    // ---------------------------------------------------------------------------
+
+    class DSP_FW_API ShmRing {
+    public:
+        /// <summary>Initializes a new instance of the ShmRing class.</summary>
+        ShmRing();
+        /// <summary>Finalizes a instance of the ShmRing class.</summary>
+        ~ShmRing();
+
+        /// <summary>Creates (or attaches to) the named shared memory ring.</summary>
+        bool open(const std::string& name, uint32_t sampleRate);
+        /// <summary>Unmaps the shared memory ring.</summary>
+        void close();
+        /// <summary>Flag indicating whether the ring is mapped.</summary>
+        bool isOpen() const { return m_header != NULL; }
+
+        /// <summary>Gets the number of words queued in the ring.</summary>
+        uint32_t getData() const;
+        /// <summary>Gets the number of words free in the ring.</summary>
+        uint32_t getSpace() const;
+
+        /// <summary>Copies words into the ring and wakes the consumer; returns the number of words written.</summary>
+        uint32_t write(const uint16_t* data, uint32_t length);
+
+        /// <summary>Gets the queued words as up to two contiguous spans without consuming them.</summary>
+        uint32_t beginRead(ShmSpan spans[2U]) const;
+        /// <summary>Consumes words previously returned by beginRead.</summary>
+        void commitRead(uint32_t count);
+        /// <summary>Blocks until the ring holds data or the timeout expires.</summary>
+        bool waitData(uint32_t timeout);
+
+        /// <summary>Blocks until the ring has space or the timeout expires.</summary>
+        bool waitSpace(uint32_t timeout);
+
+        /// <summary>Gets the number of times this side slept waiting on the other.</summary>
+        uint32_t getSleeps() const { return m_sleeps; }
+
+    private:
+        std::string m_name;
+        ShmRingHeader* m_header;
+        uint16_t* m_data;
+        size_t m_size;
+        uint32_t m_mask;
+
+        uint32_t m_sleeps;
+    };
+} // namespace sdr
+
+#endif // __SHM_RING_H__
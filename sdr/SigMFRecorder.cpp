@@ -0,0 +1,419 @@
+/**
+* Digital Voice Modem - DSP Firmware
+* GPLv2 Open Source. Use is subject to license terms.
+* DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+*
+* @package DVM / DSP Firmware
+*
+*/
+/*
+*   Copyright (C) 2022 Bryan Biedenkapp N2PLL
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 2 of the License, or
+*   (at your option) any later version.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program; if not, write to the Free Software
+*   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*/
+#include "sdr/SigMFRecorder.h"
+#include "sdr/ThreadPolicy.h"
+#include "sdr/Log.h"
+
+#include <time.h>
+#include <cerrno>
+#include <cstring>
+
+using namespace sdr;
+
+// ---------------------------------------------------------------------------
+//  Constants
+// ---------------------------------------------------------------------------
+
+// how long the writer sleeps when both rings are empty, in milliseconds
+const uint32_t CAPTURE_WRITER_SLEEP = 20U;
+
+// ---------------------------------------------------------------------------
+//  Public Class Members
+// ---------------------------------------------------------------------------
+
+/// <summary>
+/// Initializes a new instance of the SigMFRecorder class.
+/// </summary>
+SigMFRecorder::SigMFRecorder() :
+    m_rx(),
+    m_tx(),
+    m_sampleRate(0U),
+    m_buffer(CAPTURE_RECORD_MAX * CAPTURE_RX_CHANNELS),
+    m_thread(),
+    m_running(false),
+    m_open(false)
+{
+    m_rx.file = m_tx.file = NULL;
+    m_rx.ring = m_tx.ring = NULL;
+}
+
+/// <summary>
+/// Finalizes a instance of the SigMFRecorder class.
+/// </summary>
+SigMFRecorder::~SigMFRecorder()
+{
+    close();
+
+    delete m_rx.ring;
+    delete m_tx.ring;
+}
+
+/// <summary>
+/// Creates the Rx and Tx recordings and starts the writer.
+/// </summary>
+/// <param name="base">Path the recordings are named from, as base-rx.sigmf-data/meta and base-tx.sigmf-data/meta.</param>
+/// <param name="sampleRate">Sample rate of the DSP ring buffers.</param>
+/// <param name="channel">Modem channel number, for the recording descriptions.</param>
+/// <returns>True, if the recordings were created, otherwise false.</returns>
+bool SigMFRecorder::open(const std::string& base, uint32_t sampleRate, uint32_t channel)
+{
+    close();
+
+    m_sampleRate = sampleRate;
+
+    char description[128U];
+    ::snprintf(description, sizeof(description), "DVM DSP channel %u Rx; interleaved ADC sample, RSSI and control mark", channel);
+    if (!openStream(m_rx, base + "-rx", description, CAPTURE_RX_CHANNELS))
+        return false;
+
+    ::snprintf(description, sizeof(description), "DVM DSP channel %u Tx; interleaved DAC sample and control mark", channel);
+    if (!openStream(m_tx, base + "-tx", description, CAPTURE_TX_CHANNELS)) {
+        closeStream(m_rx);
+        return false;
+    }
+
+    // the writer runs with the default policy, out of the way of the real-time threads
+    char name[32U];
+    ::snprintf(name, sizeof(name), "Ch%u Capture", channel);
+
+    m_running = true;
+    if (!ThreadPolicy().create(&m_thread, threadHelper, this, name)) {
+        m_running = false;
+        closeStream(m_rx);
+        closeStream(m_tx);
+        return false;
+    }
+
+    m_open = true;
+    ::LogMessage(LOG_DSP, "Capturing Rx and Tx samples to %s-rx.sigmf-data and %s-tx.sigmf-data", base.c_str(), base.c_str());
+    return true;
+}
+
+/// <summary>
+/// Records a block of Rx samples as the DSP read them.
+/// </summary>
+/// <param name="samples">ADC samples.</param>
+/// <param name="rssi">RSSI of each sample.</param>
+/// <param name="control">Control mark of each sample.</param>
+/// <param name="length">Number of samples.</param>
+void SigMFRecorder::recordRx(const uint16_t* samples, const uint16_t* rssi, const uint8_t* control, uint16_t length)
+{
+    if (!m_open)
+        return;
+
+    uint16_t data[CAPTURE_RECORD_MAX * CAPTURE_RX_CHANNELS];
+    for (uint16_t done = 0U; done < length; ) {
+        uint16_t n = length - done;
+        if (n > CAPTURE_RECORD_MAX)
+            n = CAPTURE_RECORD_MAX;
+
+        for (uint16_t i = 0U; i < n; i++) {
+            data[(3U * i)] = samples[done + i];
+            data[(3U * i) + 1U] = rssi[done + i];
+            data[(3U * i) + 2U] = control[done + i];
+        }
+
+        record(m_rx, data, n);
+        done += n;
+    }
+}
+
+/// <summary>
+/// Records a block of Tx samples as the DSP wrote them.
+/// </summary>
+/// <param name="samples">DAC samples.</param>
+/// <param name="control">Control mark of each sample.</param>
+/// <param name="length">Number of samples.</param>
+void SigMFRecorder::recordTx(const uint16_t* samples, const uint8_t* control, uint16_t length)
+{
+    if (!m_open)
+        return;
+
+    uint16_t data[CAPTURE_RECORD_MAX * CAPTURE_TX_CHANNELS];
+    for (uint16_t done = 0U; done < length; ) {
+        uint16_t n = length - done;
+        if (n > CAPTURE_RECORD_MAX)
+            n = CAPTURE_RECORD_MAX;
+
+        for (uint16_t i = 0U; i < n; i++) {
+            data[(2U * i)] = samples[done + i];
+            data[(2U * i) + 1U] = control[done + i];
+        }
+
+        record(m_tx, data, n);
+        done += n;
+    }
+}
+
+/// <summary>
+/// Stops the writer, writes out everything queued and completes the recordings.
+/// </summary>
+/// <remarks>The DSP thread must no longer be recording.</remarks>
+void SigMFRecorder::close()
+{
+    if (!m_open)
+        return;
+
+    m_open = false;
+    m_running = false;
+    ::pthread_join(m_thread, NULL);
+
+    drain(m_rx);
+    drain(m_tx);
+
+    ::LogMessage(LOG_DSP, "Capture complete, Rx samples = %llu (dropped %llu), Tx samples = %llu (dropped %llu)",
+        (unsigned long long)m_rx.samples, (unsigned long long)m_rx.dropped, (unsigned long long)m_tx.samples, (unsigned long long)m_tx.dropped);
+
+    closeStream(m_rx);
+    closeStream(m_tx);
+}
+
+/// <summary>
+/// Writes the SigMF metadata of a recording of interleaved 16-bit channels.
+/// </summary>
+/// <param name="path">Path of the .sigmf-meta file.</param>
+/// <param name="sampleRate">Sample rate of the recording.</param>
+/// <param name="channels">Number of interleaved channels.</param>
+/// <param name="description"></param>
+/// <param name="datetime">Wall clock time of the first sample, as from getDateTime().</param>
+/// <param name="annotations">Sample index and comment of each annotation.</param>
+/// <returns>True, if the metadata was written, otherwise false.</returns>
+bool SigMFRecorder::writeMeta(const std::string& path, uint32_t sampleRate, uint32_t channels, const std::string& description,
+    const std::string& datetime, const std::vector<std::pair<uint64_t, std::string> >& annotations)
+{
+    FILE* fp = ::fopen(path.c_str(), "w");
+    if (fp == NULL) {
+        ::LogError(LOG_DSP, "SigMFRecorder, failed to create %s, err = %d", path.c_str(), errno);
+        return false;
+    }
+
+    ::fprintf(fp, "{\n"
+        "    \"global\": {\n"
+        "        \"core:datatype\": \"ru16_le\",\n"
+        "        \"core:sample_rate\": %u,\n"
+        "        \"core:num_channels\": %u,\n"
+        "        \"core:version\": \"1.0.0\",\n"
+        "        \"core:recorder\": \"" __EXE_NAME__ "\",\n"
+        "        \"core:description\": \"%s\"\n"
+        "    },\n"
+        "    \"captures\": [\n"
+        "        {\n"
+        "            \"core:sample_start\": 0,\n"
+        "            \"core:datetime\": \"%s\"\n"
+        "        }\n"
+        "    ],\n"
+        "    \"annotations\": [",
+        sampleRate, channels, description.c_str(), datetime.c_str());
+
+    for (size_t i = 0U; i < annotations.size(); i++) {
+        ::fprintf(fp, "%s\n        {\n"
+            "            \"core:sample_start\": %llu,\n"
+            "            \"core:comment\": \"%s\"\n"
+            "        }", (i == 0U) ? "" : ",", (unsigned long long)annotations[i].first, annotations[i].second.c_str());
+    }
+
+    ::fprintf(fp, "%s]\n}\n", annotations.empty() ? "" : "\n    ");
+
+    bool ret = (::fclose(fp) == 0);
+    if (!ret)
+        ::LogError(LOG_DSP, "SigMFRecorder, failed to write %s, err = %d", path.c_str(), errno);
+
+    return ret;
+}
+
+/// <summary>
+/// Helper to format a wall clock time as a SigMF datetime.
+/// </summary>
+/// <param name="ts">CLOCK_REALTIME time.</param>
+/// <returns>ISO 8601 UTC time, to the millisecond.</returns>
+std::string SigMFRecorder::getDateTime(const timespec& ts)
+{
+    tm utc;
+    ::gmtime_r(&ts.tv_sec, &utc);
+
+    char datetime[40U];
+    size_t n = ::strftime(datetime, sizeof(datetime), "%Y-%m-%dT%H:%M:%S", &utc);
+    ::snprintf(datetime + n, sizeof(datetime) - n, ".%03ldZ", ts.tv_nsec / 1000000L);
+    return std::string(datetime);
+}
+
+// ---------------------------------------------------------------------------
+//  Private Class Members
+// ---------------------------------------------------------------------------
+
+/// <summary>
+/// Helper to create the files of one recording.
+/// </summary>
+/// <param name="stream"></param>
+/// <param name="base">Path of the recording without the SigMF extension.</param>
+/// <param name="description"></param>
+/// <param name="channels">Number of interleaved channels.</param>
+/// <returns></returns>
+bool SigMFRecorder::openStream(Stream& stream, const std::string& base, const char* description, uint32_t channels)
+{
+    stream.dataPath = base + ".sigmf-data";
+    stream.metaPath = base + ".sigmf-meta";
+    stream.description = description;
+    stream.channels = channels;
+    stream.pendingDropped = 0U;
+    stream.samples = 0U;
+    stream.dropped = 0U;
+    stream.gaps.clear();
+
+    timespec now;
+    ::clock_gettime(CLOCK_REALTIME, &now);
+    stream.datetime = getDateTime(now);
+
+    if (stream.ring == NULL)
+        stream.ring = new CaptureRing(CAPTURE_RING_LENGTH);
+    stream.ring->reset();
+
+    stream.file = ::fopen(stream.dataPath.c_str(), "wb");
+    if (stream.file == NULL) {
+        ::LogError(LOG_DSP, "SigMFRecorder::open(), failed to create %s, err = %d", stream.dataPath.c_str(), errno);
+        return false;
+    }
+
+    // the metadata is complete from the start, so a recording cut short still opens
+    if (!writeMeta(stream)) {
+        ::fclose(stream.file);
+        stream.file = NULL;
+        return false;
+    }
+
+    return true;
+}
+
+/// <summary>
+/// Helper to hand one record to the writer, or count it as dropped.
+/// </summary>
+/// <param name="stream"></param>
+/// <param name="data">Interleaved samples.</param>
+/// <param name="length">Number of samples.</param>
+void SigMFRecorder::record(Stream& stream, const uint16_t* data, uint16_t length)
+{
+    uint16_t header[CAPTURE_RECORD_HEADER];
+    header[0U] = length;
+    header[1U] = uint16_t(stream.pendingDropped & 0xFFFFU);
+    header[2U] = uint16_t(stream.pendingDropped >> 16);
+
+    if (stream.ring->write(header, CAPTURE_RECORD_HEADER, data, length * stream.channels))
+        stream.pendingDropped = 0U;
+    else
+        stream.pendingDropped += length;
+}
+
+/// <summary>
+/// Helper to write everything queued for one recording to its data file.
+/// </summary>
+/// <param name="stream"></param>
+/// <returns>True, if any records were written, otherwise false.</returns>
+bool SigMFRecorder::drain(Stream& stream)
+{
+    bool written = false;
+    while (stream.ring->getData() >= CAPTURE_RECORD_HEADER) {
+        uint16_t header[CAPTURE_RECORD_HEADER];
+        stream.ring->read(header, CAPTURE_RECORD_HEADER);
+
+        // records are committed whole, so the samples follow their header
+        uint32_t length = header[0U];
+        stream.ring->read(&m_buffer[0U], length * stream.channels);
+
+        uint32_t dropped = uint32_t(header[1U]) | (uint32_t(header[2U]) << 16);
+        if (dropped > 0U) {
+            stream.gaps.push_back(std::make_pair(stream.samples, dropped));
+            stream.dropped += dropped;
+        }
+
+        if (::fwrite(&m_buffer[0U], sizeof(uint16_t) * stream.channels, length, stream.file) != length)
+            ::LogError(LOG_DSP, "SigMFRecorder, failed to write %s, err = %d", stream.dataPath.c_str(), errno);
+
+        stream.samples += length;
+        written = true;
+    }
+
+    if (written)
+        ::fflush(stream.file);
+
+    return written;
+}
+
+/// <summary>
+/// Helper to write the SigMF metadata of one recording.
+/// </summary>
+/// <remarks>Samples the recorder dropped are left out of the data file and noted as annotations.</remarks>
+/// <param name="stream"></param>
+/// <returns></returns>
+bool SigMFRecorder::writeMeta(const Stream& stream)
+{
+    std::vector<std::pair<uint64_t, std::string> > annotations;
+    for (size_t i = 0U; i < stream.gaps.size(); i++) {
+        char comment[64U];
+        ::snprintf(comment, sizeof(comment), "%u samples dropped by the recorder", stream.gaps[i].second);
+        annotations.push_back(std::make_pair(stream.gaps[i].first, std::string(comment)));
+    }
+
+    return writeMeta(stream.metaPath, m_sampleRate, stream.channels, stream.description, stream.datetime, annotations);
+}
+
+/// <summary>
+/// Helper to close the files of one recording.
+/// </summary>
+/// <param name="stream"></param>
+void SigMFRecorder::closeStream(Stream& stream)
+{
+    if (stream.file == NULL)
+        return;
+
+    ::fclose(stream.file);
+    stream.file = NULL;
+
+    writeMeta(stream);
+}
+
+/// <summary>
+///
+/// </summary>
+/// <param name="arg"></param>
+/// <returns></returns>
+void* SigMFRecorder::threadHelper(void* arg)
+{
+    SigMFRecorder* p = (SigMFRecorder*)arg;
+
+    while (p->m_running) {
+        bool rx = p->drain(p->m_rx);
+        bool tx = p->drain(p->m_tx);
+        if (rx || tx)
+            continue;
+
+        timespec ts;
+        ts.tv_sec = 0;
+        ts.tv_nsec = long(CAPTURE_WRITER_SLEEP) * 1000000L;
+        ::clock_nanosleep(CLOCK_MONOTONIC, 0, &ts, NULL);
+    }
+
+    return NULL;
+}
@@ -0,0 +1,137 @@
+/**
+* Digital Voice Modem - DSP Firmware
+* GPLv2 Open Source. Use is subject to license terms.
+* DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+*
+* @package DVM / DSP Firmware
+*
+*/
+/*
+*   Copyright (C) 2022 Bryan Biedenkapp N2PLL
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 2 of the License, or
+*   (at your option) any later version.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program; if not, write to the Free Software
+*   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*/
+#if !defined(__SIGMF_RECORDER_H__)
+#define __SIGMF_RECORDER_H__
+
+#include "Defines.h"
+#include "sdr/CaptureRing.h"
+
+#include <pthread.h>
+#include <time.h>
+
+#include <cstdio>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace sdr
+{
+    // ---------------------------------------------------------------------------
+    //  Constants
+    // ---------------------------------------------------------------------------
+
+    // words per capture stream ring; 2 MiB, over 14 seconds of Rx samples, RSSI and marks
+    const uint32_t CAPTURE_RING_LENGTH = 1048576U;
+
+    // most samples in one capture record
+    const uint32_t CAPTURE_RECORD_MAX = 480U;
+
+    // words ahead of each record: sample count, then the samples dropped before it (low, high)
+    const uint32_t CAPTURE_RECORD_HEADER = 3U;
+
+    // interleaved channels of the Rx (sample, RSSI, control mark) and Tx (sample, control mark) recordings
+    const uint32_t CAPTURE_RX_CHANNELS = 3U;
+    const uint32_t CAPTURE_TX_CHANNELS = 2U;
+
+    // ---------------------------------------------------------------------------
+    //  Class Declaration
+    //      Implements a recorder of the samples the DSP exchanges with its ring
+    //      buffers, as SigMF recordings. The DSP thread hands records to a
+    //      background writer through lock-free rings and never waits on it.
+    // ---------------------------------------------------------------------------
+
+    class DSP_FW_API SigMFRecorder {
+    public:
+        /// <summary>Initializes a new instance of the SigMFRecorder class.</summary>
+        SigMFRecorder();
+        /// <summary>Finalizes a instance of the SigMFRecorder class.</summary>
+        ~SigMFRecorder();
+
+        /// <summary>Creates the Rx and Tx recordings and starts the writer.</summary>
+        bool open(const std::string& base, uint32_t sampleRate, uint32_t channel);
+        /// <summary>Flag indicating whether the recorder is open.</summary>
+        bool isOpen() const { return m_open; }
+
+        /// <summary>Records a block of Rx samples as the DSP read them.</summary>
+        void recordRx(const uint16_t* samples, const uint16_t* rssi, const uint8_t* control, uint16_t length);
+        /// <summary>Records a block of Tx samples as the DSP wrote them.</summary>
+        void recordTx(const uint16_t* samples, const uint8_t* control, uint16_t length);
+
+        /// <summary>Stops the writer, writes out everything queued and completes the recordings.</summary>
+        void close();
+
+        /// <summary>Writes the SigMF metadata of a recording of interleaved 16-bit channels.</summary>
+        static bool writeMeta(const std::string& path, uint32_t sampleRate, uint32_t channels, const std::string& description,
+            const std::string& datetime, const std::vector<std::pair<uint64_t, std::string> >& annotations);
+        /// <summary>Helper to format a wall clock time as a SigMF datetime.</summary>
+        static std::string getDateTime(const timespec& ts);
+
+    private:
+        /// <summary>
+        /// One SigMF recording, fed by its own ring.
+        /// </summary>
+        struct Stream {
+            std::string dataPath;
+            std::string metaPath;
+            std::string description;
+            std::string datetime;
+            uint32_t channels;
+            FILE* file;
+            CaptureRing* ring;
+
+            uint32_t pendingDropped;                        // written by the DSP thread only
+
+            uint64_t samples;                               // written by the writer only
+            uint64_t dropped;
+            std::vector<std::pair<uint64_t, uint32_t> > gaps;
+        };
+
+        Stream m_rx;
+        Stream m_tx;
+        uint32_t m_sampleRate;
+        std::vector<uint16_t> m_buffer;
+
+        pthread_t m_thread;
+        volatile bool m_running;
+        bool m_open;
+
+        /// <summary>Helper to create the files of one recording.</summary>
+        bool openStream(Stream& stream, const std::string& base, const char* description, uint32_t channels);
+        /// <summary>Helper to hand one record to the writer, or count it as dropped.</summary>
+        void record(Stream& stream, const uint16_t* data, uint16_t length);
+        /// <summary>Helper to write everything queued for one recording to its data file.</summary>
+        bool drain(Stream& stream);
+        /// <summary>Helper to write the SigMF metadata of one recording.</summary>
+        bool writeMeta(const Stream& stream);
+        /// <summary>Helper to close the files of one recording.</summary>
+        void closeStream(Stream& stream);
+
+        /// <summary></summary>
+        static void* threadHelper(void* arg);
+    };
+} // namespace sdr
+
+#endif // __SIGMF_RECORDER_H__
@@ -0,0 +1,261 @@
+/**
+* Digital Voice Modem - DSP Firmware
+* GPLv2 Open Source. Use is subject to license terms.
+* DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+*
+* @package DVM / DSP Firmware
+*
+*/
+/*
+*   Copyright (C) 2022 Bryan Biedenkapp N2PLL
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 2 of the License, or
+*   (at your option) any later version.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program; if not, write to the Free Software
+*   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*/
+#include "sdr/SigMFReplay.h"
+#include "sdr/Log.h"
+
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+
+using namespace sdr;
+
+// ---------------------------------------------------------------------------
+//  Constants
+// ---------------------------------------------------------------------------
+
+const int64_t NSEC_PER_SEC = 1000000000LL;
+
+// ---------------------------------------------------------------------------
+//  Public Class Members
+// ---------------------------------------------------------------------------
+
+/// <summary>
+/// Initializes a new instance of the SigMFReplay class.
+/// </summary>
+SigMFReplay::SigMFReplay() :
+    m_path(),
+    m_file(NULL),
+    m_sampleRate(0U),
+    m_paced(true),
+    m_eof(false),
+    m_anchored(false),
+    m_epoch(),
+    m_samples(0U)
+{
+    /* stub */
+}
+
+/// <summary>
+/// Finalizes a instance of the SigMFReplay class.
+/// </summary>
+SigMFReplay::~SigMFReplay()
+{
+    close();
+}
+
+/// <summary>
+/// Opens an Rx recording, checking it matches the DSP sample rate.
+/// </summary>
+/// <param name="path">Path of the recording, with or without the .sigmf-meta or .sigmf-data extension.</param>
+/// <param name="sampleRate">Sample rate of the DSP ring buffers.</param>
+/// <param name="paced">Replay at the recorded sample rate, rather than as fast as samples are read.</param>
+/// <returns>True, if the recording was opened, otherwise false.</returns>
+bool SigMFReplay::open(const std::string& path, uint32_t sampleRate, bool paced)
+{
+    close();
+
+    std::string base = path;
+    const char* EXTENSIONS[] = { ".sigmf-meta", ".sigmf-data", "." };
+    for (uint32_t i = 0U; i < 3U; i++) {
+        size_t len = ::strlen(EXTENSIONS[i]);
+        if (base.size() > len && base.compare(base.size() - len, len, EXTENSIONS[i]) == 0) {
+            base.erase(base.size() - len);
+            break;
+        }
+    }
+
+    std::string metaPath = base + ".sigmf-meta";
+    FILE* fp = ::fopen(metaPath.c_str(), "r");
+    if (fp == NULL) {
+        ::LogError(LOG_DSP, "SigMFReplay::open(), failed to open %s, err = %d", metaPath.c_str(), errno);
+        return false;
+    }
+
+    std::string json;
+    char buffer[1024U];
+    size_t n;
+    while ((n = ::fread(buffer, 1U, sizeof(buffer), fp)) > 0U)
+        json.append(buffer, n);
+    ::fclose(fp);
+
+    // only the layout the recorder writes for Rx can go back into the Rx ring buffers
+    std::string datatype;
+    double rate = 0.0, channels = 1.0;
+    if (!getString(json, "core:datatype", datatype) || !getNumber(json, "core:sample_rate", rate))
+        ::LogError(LOG_DSP, "SigMFReplay::open(), %s has no datatype or sample rate", metaPath.c_str());
+    else {
+        getNumber(json, "core:num_channels", channels);
+        if (datatype != "ru16_le" || uint32_t(channels) != CAPTURE_RX_CHANNELS)
+            ::LogError(LOG_DSP, "SigMFReplay::open(), %s is %s with %u channels, not an Rx capture", metaPath.c_str(), datatype.c_str(), uint32_t(channels));
+        else if (uint32_t(rate) != sampleRate)
+            ::LogError(LOG_DSP, "SigMFReplay::open(), %s is sampled at %u Hz, not %u Hz", metaPath.c_str(), uint32_t(rate), sampleRate);
+        else
+            m_path = base + ".sigmf-data";
+    }
+
+    if (m_path.empty())
+        return false;
+
+    m_file = ::fopen(m_path.c_str(), "rb");
+    if (m_file == NULL) {
+        ::LogError(LOG_DSP, "SigMFReplay::open(), failed to open %s, err = %d", m_path.c_str(), errno);
+        m_path.clear();
+        return false;
+    }
+
+    m_sampleRate = sampleRate;
+    m_paced = paced;
+    m_eof = false;
+    m_anchored = false;
+    m_samples = 0U;
+
+    ::LogMessage(LOG_DSP, "Replaying Rx samples from %s, %s", m_path.c_str(), paced ? "at real time" : "as fast as possible");
+    return true;
+}
+
+/// <summary>
+/// Reads samples, their RSSI and control marks; paced replay waits until they are due.
+/// </summary>
+/// <param name="samples"></param>
+/// <param name="rssi"></param>
+/// <param name="control"></param>
+/// <param name="length">Most samples to read, up to CAPTURE_RECORD_MAX.</param>
+/// <returns>Number of samples read.</returns>
+uint32_t SigMFReplay::read(uint16_t* samples, uint16_t* rssi, uint8_t* control, uint32_t length)
+{
+    if (m_file == NULL || m_eof)
+        return 0U;
+
+    if (length > CAPTURE_RECORD_MAX)
+        length = CAPTURE_RECORD_MAX;
+
+    uint16_t data[CAPTURE_RECORD_MAX * CAPTURE_RX_CHANNELS];
+    size_t n = ::fread(data, sizeof(uint16_t) * CAPTURE_RX_CHANNELS, length, m_file);
+    if (n == 0U) {
+        ::LogMessage(LOG_DSP, "End of replay %s, %llu samples read", m_path.c_str(), (unsigned long long)m_samples);
+        m_eof = true;
+        return 0U;
+    }
+
+    if (m_paced) {
+        if (!m_anchored) {
+            ::clock_gettime(CLOCK_MONOTONIC, &m_epoch);
+            m_anchored = true;
+        }
+
+        // samples are due once the samples before them would have been received
+        int64_t due = (int64_t(m_samples) * NSEC_PER_SEC) / int64_t(m_sampleRate);
+        timespec ts = m_epoch;
+        ts.tv_sec += time_t(due / NSEC_PER_SEC);
+        ts.tv_nsec += long(due % NSEC_PER_SEC);
+        if (ts.tv_nsec >= NSEC_PER_SEC) {
+            ts.tv_sec++;
+            ts.tv_nsec -= NSEC_PER_SEC;
+        }
+
+        while (::clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) == EINTR)
+            ;
+    }
+
+    for (size_t i = 0U; i < n; i++) {
+        samples[i] = data[(3U * i)];
+        rssi[i] = data[(3U * i) + 1U];
+        control[i] = uint8_t(data[(3U * i) + 2U]);
+    }
+
+    m_samples += n;
+    return uint32_t(n);
+}
+
+/// <summary>
+/// Closes the recording.
+/// </summary>
+void SigMFReplay::close()
+{
+    if (m_file != NULL) {
+        ::fclose(m_file);
+        m_file = NULL;
+    }
+
+    m_path.clear();
+}
+
+// ---------------------------------------------------------------------------
+//  Private Class Members
+// ---------------------------------------------------------------------------
+
+/// <summary>
+/// Helper to find the string value of a key in the SigMF metadata.
+/// </summary>
+/// <remarks>This is not a JSON parser; it finds the first occurrence of the key, which
+/// is enough for the flat global object the recorder writes.</remarks>
+/// <param name="json"></param>
+/// <param name="key"></param>
+/// <param name="value"></param>
+/// <returns></returns>
+bool SigMFReplay::getString(const std::string& json, const char* key, std::string& value)
+{
+    size_t pos = json.find("\"" + std::string(key) + "\"");
+    if (pos == std::string::npos)
+        return false;
+
+    pos = json.find(':', pos + ::strlen(key) + 2U);
+    if (pos == std::string::npos)
+        return false;
+
+    size_t start = json.find('"', pos);
+    if (start == std::string::npos)
+        return false;
+
+    size_t end = json.find('"', start + 1U);
+    if (end == std::string::npos)
+        return false;
+
+    value = json.substr(start + 1U, end - start - 1U);
+    return true;
+}
+
+/// <summary>
+/// Helper to find the numeric value of a key in the SigMF metadata.
+/// </summary>
+/// <param name="json"></param>
+/// <param name="key"></param>
+/// <param name="value"></param>
+/// <returns></returns>
+bool SigMFReplay::getNumber(const std::string& json, const char* key, double& value)
+{
+    size_t pos = json.find("\"" + std::string(key) + "\"");
+    if (pos == std::string::npos)
+        return false;
+
+    pos = json.find(':', pos + ::strlen(key) + 2U);
+    if (pos == std::string::npos)
+        return false;
+
+    char* end = NULL;
+    value = ::strtod(json.c_str() + pos + 1U, &end);
+    return (end != json.c_str() + pos + 1U);
+}
@@ -0,0 +1,85 @@
+/**
+* Digital Voice Modem - DSP Firmware
+* GPLv2 Open Source. Use is subject to license terms.
+* DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+*
+* @package DVM / DSP Firmware
+*
+*/
+/*
+*   Copyright (C) 2022 Bryan Biedenkapp N2PLL
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 2 of the License, or
+*   (at your option) any later version.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program; if not, write to the Free Software
+*   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*/
+#if !defined(__SIGMF_REPLAY_H__)
+#define __SIGMF_REPLAY_H__
+
+#include "Defines.h"
+#include "sdr/SigMFRecorder.h"
+
+#include <time.h>
+
+#include <cstdio>
+#include <string>
+
+namespace sdr
+{
+    // ---------------------------------------------------------------------------
+    //  Class Declaration
+    //      Implements a reader of the Rx recordings made by the SigMF recorder,
+    //      at real time or as fast as the caller asks for samples.
+    // ---------------------------------------------------------------------------
+
+    class DSP_FW_API SigMFReplay {
+    public:
+        /// <summary>Initializes a new instance of the SigMFReplay class.</summary>
+        SigMFReplay();
+        /// <summary>Finalizes a instance of the SigMFReplay class.</summary>
+        ~SigMFReplay();
+
+        /// <summary>Opens an Rx recording, checking it matches the DSP sample rate.</summary>
+        bool open(const std::string& path, uint32_t sampleRate, bool paced);
+        /// <summary>Flag indicating whether a recording is open.</summary>
+        bool isOpen() const { return m_file != NULL; }
+        /// <summary>Flag indicating whether paced replay is enabled.</summary>
+        bool isPaced() const { return m_paced; }
+        /// <summary>Flag indicating the whole recording has been read.</summary>
+        bool isEOF() const { return m_eof; }
+
+        /// <summary>Reads samples, their RSSI and control marks; paced replay waits until they are due.</summary>
+        uint32_t read(uint16_t* samples, uint16_t* rssi, uint8_t* control, uint32_t length);
+
+        /// <summary>Closes the recording.</summary>
+        void close();
+
+    private:
+        std::string m_path;
+        FILE* m_file;
+        uint32_t m_sampleRate;
+        bool m_paced;
+        bool m_eof;
+
+        bool m_anchored;
+        timespec m_epoch;
+        uint64_t m_samples;
+
+        /// <summary>Helper to find the string value of a key in the SigMF metadata.</summary>
+        static bool getString(const std::string& json, const char* key, std::string& value);
+        /// <summary>Helper to find the numeric value of a key in the SigMF metadata.</summary>
+        static bool getNumber(const std::string& json, const char* key, double& value);
+    };
+} // namespace sdr
+
+#endif // __SIGMF_REPLAY_H__
@@ -0,0 +1,219 @@
+/**
+* Digital Voice Modem - DSP Firmware
+* GPLv2 Open Source. Use is subject to license terms.
+* DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+*
+* @package DVM / DSP Firmware
+*
+*/
+/*
+*   Copyright (C) 2022 Bryan Biedenkapp N2PLL
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 2 of the License, or
+*   (at your option) any later version.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program; if not, write to the Free Software
+*   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*/
+#include "sdr/ThreadPolicy.h"
+#include "sdr/Log.h"
+
+#include <sys/mman.h>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+
+using namespace sdr;
+
+// ---------------------------------------------------------------------------
+//  Globals Variables
+// ---------------------------------------------------------------------------
+
+bool ThreadPolicy::m_locked = false;
+
+// CPUs the process was started on; threads without their own CPU list run on these
+// rather than inheriting the list of the main loop
+static cpu_set_t m_processCPUs;
+static bool m_processCPUsValid = (::sched_getaffinity(0, sizeof(m_processCPUs), &m_processCPUs) == 0);
+
+// ---------------------------------------------------------------------------
+//  Public Class Members
+// ---------------------------------------------------------------------------
+
+/// <summary>
+/// Initializes a new instance of the ThreadPolicy class.
+/// </summary>
+ThreadPolicy::ThreadPolicy() :
+    m_priority(0),
+    m_cpus(),
+    m_hasCPUs(false),
+    m_cpuList()
+{
+    CPU_ZERO(&m_cpus);
+}
+
+/// <summary>
+/// Sets the CPUs the thread may run on from a list (e.g. "0,2-3").
+/// </summary>
+/// <param name="cpus">Comma separated list of CPUs and CPU ranges.</param>
+/// <returns>True, if the list was valid, otherwise false.</returns>
+bool ThreadPolicy::setCPUs(const std::string& cpus)
+{
+    cpu_set_t set;
+    CPU_ZERO(&set);
+
+    const char* p = cpus.c_str();
+    while (*p != '\0') {
+        char* end = NULL;
+        long first = ::strtol(p, &end, 10);
+        if (end == p || first < 0 || first >= CPU_SETSIZE)
+            return false;
+
+        long last = first;
+        p = end;
+        if (*p == '-') {
+            p++;
+            last = ::strtol(p, &end, 10);
+            if (end == p || last < first || last >= CPU_SETSIZE)
+                return false;
+            p = end;
+        }
+
+        for (long cpu = first; cpu <= last; cpu++)
+            CPU_SET(cpu, &set);
+
+        if (*p == ',')
+            p++;
+        else if (*p != '\0')
+            return false;
+    }
+
+    if (CPU_COUNT(&set) == 0)
+        return false;
+
+    m_cpus = set;
+    m_hasCPUs = true;
+    m_cpuList = cpus;
+    return true;
+}
+
+/// <summary>
+/// Creates a thread with this policy; the thread applies the rest itself with apply().
+/// </summary>
+/// <remarks>The thread is created on SCHED_OTHER and raises itself with apply(), so a
+/// refused priority does not stop the thread being created. If the attributes are
+/// refused (e.g. a CPU that is not online) the thread is created with the defaults.</remarks>
+/// <param name="thread"></param>
+/// <param name="fn">Thread entry point.</param>
+/// <param name="arg">Argument passed to the entry point.</param>
+/// <param name="name">Name of the thread, for the log.</param>
+/// <returns>True, if the thread was created, otherwise false.</returns>
+bool ThreadPolicy::create(pthread_t* thread, void* (*fn)(void*), void* arg, const char* name) const
+{
+    pthread_attr_t attr;
+    ::pthread_attr_init(&attr);
+    ::pthread_attr_setstacksize(&attr, THREAD_STACK_SIZE);
+
+    sched_param param;
+    ::memset(&param, 0x00U, sizeof(param));
+    ::pthread_attr_setinheritsched(&attr, PTHREAD_EXPLICIT_SCHED);
+    ::pthread_attr_setschedpolicy(&attr, SCHED_OTHER);
+    ::pthread_attr_setschedparam(&attr, &param);
+
+    if (m_hasCPUs)
+        ::pthread_attr_setaffinity_np(&attr, sizeof(m_cpus), &m_cpus);
+    else if (m_processCPUsValid)
+        ::pthread_attr_setaffinity_np(&attr, sizeof(m_processCPUs), &m_processCPUs);
+
+    int err = ::pthread_create(thread, &attr, fn, arg);
+    ::pthread_attr_destroy(&attr);
+    if (err == 0)
+        return true;
+
+    ::LogWarning(LOG_DSP, "%s thread, cannot create with CPUs %s, err = %d, using the defaults", name, m_hasCPUs ? m_cpuList.c_str() : "any", err);
+    err = ::pthread_create(thread, NULL, fn, arg);
+    if (err != 0) {
+        ::LogError(LOG_DSP, "%s thread, cannot create, err = %d", name, err);
+        return false;
+    }
+
+    return true;
+}
+
+/// <summary>
+/// Applies this policy to the calling thread.
+/// </summary>
+/// <param name="name">Name of the thread, for the log.</param>
+/// <returns>True, if the whole policy was applied, otherwise false.</returns>
+bool ThreadPolicy::apply(const char* name) const
+{
+    bool ret = true;
+
+    if (m_priority > 0) {
+        sched_param param;
+        ::memset(&param, 0x00U, sizeof(param));
+        param.sched_priority = m_priority;
+
+        int err = ::pthread_setschedparam(::pthread_self(), SCHED_FIFO, &param);
+        if (err != 0) {
+            ::LogWarning(LOG_DSP, "%s thread, cannot set SCHED_FIFO priority %d, err = %d", name, m_priority, err);
+            ret = false;
+        }
+    }
+
+    if (m_hasCPUs) {
+        int err = ::pthread_setaffinity_np(::pthread_self(), sizeof(m_cpus), &m_cpus);
+        if (err != 0) {
+            ::LogWarning(LOG_DSP, "%s thread, cannot set CPU affinity %s, err = %d", name, m_cpuList.c_str(), err);
+            ret = false;
+        }
+    }
+
+    if (m_locked)
+        prefaultStack();
+
+    if (m_priority > 0 || m_hasCPUs) {
+        ::LogMessage(LOG_DSP, "%s thread, policy = %s, priority = %d, cpus = %s", name, (m_priority > 0) ? "SCHED_FIFO" : "SCHED_OTHER",
+            m_priority, m_hasCPUs ? m_cpuList.c_str() : "any");
+    }
+
+    return ret;
+}
+
+/// <summary>
+/// Locks the current and future memory of the process.
+/// </summary>
+/// <returns>True, if the memory was locked, otherwise false.</returns>
+bool ThreadPolicy::lockMemory()
+{
+    if (::mlockall(MCL_CURRENT | MCL_FUTURE) != 0) {
+        ::LogWarning(LOG_DSP, "Cannot lock the process memory, err = %d", errno);
+        return false;
+    }
+
+    m_locked = true;
+    prefaultStack();
+
+    ::LogMessage(LOG_DSP, "Process memory locked");
+    return true;
+}
+
+/// <summary>
+/// Touches the stack of the calling thread so it is resident before it is needed.
+/// </summary>
+void ThreadPolicy::prefaultStack()
+{
+    volatile uint8_t stack[THREAD_STACK_PREFAULT];
+    for (uint32_t i = 0U; i < THREAD_STACK_PREFAULT; i += 4096U)
+        stack[i] = 0U;
+
+    (void)stack[0U];
+}
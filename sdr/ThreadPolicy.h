@@ -0,0 +1,90 @@
+/**
+* Digital Voice Modem - DSP Firmware
+* GPLv2 Open Source. Use is subject to license terms.
+* DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+*
+* @package DVM / DSP Firmware
+*
+*/
+/*
+*   Copyright (C) 2022 Bryan Biedenkapp N2PLL
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 2 of the License, or
+*   (at your option) any later version.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program; if not, write to the Free Software
+*   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*/
+#if !defined(__THREAD_POLICY_H__)
+#define __THREAD_POLICY_H__
+
+#include "Defines.h"
+
+#include <pthread.h>
+#include <sched.h>
+
+#include <string>
+
+namespace sdr
+{
+    // ---------------------------------------------------------------------------
+    //  Constants
+    // ---------------------------------------------------------------------------
+
+    // stack size of the sample threads; kept small since locked memory includes
+    // the whole stack mapping
+    const uint32_t THREAD_STACK_SIZE = 512U * 1024U;
+    // stack touched up front when memory is locked, so the real-time paths never fault
+    const uint32_t THREAD_STACK_PREFAULT = 256U * 1024U;
+
+    // ---------------------------------------------------------------------------
+    //  Class Declaration
+    //      Implements the scheduling policy and CPU affinity of a native
+    //      thread, and locking the process memory.
+    // ---------------------------------------------------------------------------
+
+    class DSP_FW_API ThreadPolicy {
+    public:
+        /// <summary>Initializes a new instance of the ThreadPolicy class.</summary>
+        ThreadPolicy();
+
+        /// <summary>Sets the SCHED_FIFO priority of the thread; 0 leaves it on SCHED_OTHER.</summary>
+        void setPriority(int priority) { m_priority = priority; }
+        /// <summary>Gets the SCHED_FIFO priority of the thread.</summary>
+        int getPriority() const { return m_priority; }
+        /// <summary>Sets the CPUs the thread may run on from a list (e.g. "0,2-3").</summary>
+        bool setCPUs(const std::string& cpus);
+        /// <summary>Gets the list of CPUs the thread may run on.</summary>
+        const std::string& getCPUs() const { return m_cpuList; }
+
+        /// <summary>Creates a thread with this policy; the thread applies the rest itself with apply().</summary>
+        bool create(pthread_t* thread, void* (*fn)(void*), void* arg, const char* name) const;
+        /// <summary>Applies this policy to the calling thread.</summary>
+        bool apply(const char* name) const;
+
+        /// <summary>Locks the current and future memory of the process.</summary>
+        static bool lockMemory();
+        /// <summary>Flag indicating the process memory is locked.</summary>
+        static bool isMemoryLocked() { return m_locked; }
+        /// <summary>Touches the stack of the calling thread so it is resident before it is needed.</summary>
+        static void prefaultStack();
+
+    private:
+        int m_priority;
+        cpu_set_t m_cpus;
+        bool m_hasCPUs;
+        std::string m_cpuList;
+
+        static bool m_locked;
+    };
+} // namespace sdr
+
+#endif // __THREAD_POLICY_H__
@@ -0,0 +1,263 @@
+/**
+* Digital Voice Modem - DSP Firmware
+* GPLv2 Open Source. Use is subject to license terms.
+* DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+*
+* @package DVM / DSP Firmware
+*
+*/
+/*
+*   Copyright (C) 2022 Bryan Biedenkapp N2PLL
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 2 of the License, or
+*   (at your option) any later version.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program; if not, write to the Free Software
+*   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*/
+#include "sdr/TxPacer.h"
+#include "sdr/Log.h"
+
+#include <cstdio>
+#include <cerrno>
+
+using namespace sdr;
+
+// ---------------------------------------------------------------------------
+//  Constants
+// ---------------------------------------------------------------------------
+
+const int64_t NSEC_PER_SEC = 1000000000LL;
+
+// upper bounds of the lateness histogram buckets, in microseconds; the last bucket is open
+const uint32_t LATE_BOUNDS[TX_PACER_LATE_BUCKETS] = { 50U, 100U, 250U, 500U, 1000U, 2000U, 5000U, 10000U, 0xFFFFFFFFU };
+
+// how long to back off while the Tx ring buffer is empty, in nanoseconds
+const int64_t IDLE_WAIT_NS = 500000LL;
+
+// ---------------------------------------------------------------------------
+//  Public Class Members
+// ---------------------------------------------------------------------------
+
+/// <summary>
+/// Initializes a new instance of the TxPacer class.
+/// </summary>
+/// <param name="sampleRate">Sample rate of the sink.</param>
+/// <param name="lead">Number of samples to keep queued ahead of the sink.</param>
+TxPacer::TxPacer(uint32_t sampleRate, uint32_t lead) :
+    m_sampleRate(sampleRate),
+    m_lead(lead),
+    m_ppm(0.0F),
+    m_rate(double(sampleRate)),
+    m_anchored(false),
+    m_streaming(false),
+    m_epoch(),
+    m_samples(0U),
+    m_baseSamples(0U),
+    m_baseNs(0),
+    m_frames(0U),
+    m_underruns(0U),
+    m_overruns(0U),
+    m_late(),
+    m_maxLate(0U),
+    m_wakeup()
+{
+    for (uint32_t i = 0U; i < TX_PACER_LATE_BUCKETS; i++)
+        m_late[i] = 0U;
+}
+
+/// <summary>
+/// Sets the sample rate of the sink.
+/// </summary>
+/// <param name="sampleRate">Sample rate of the sink.</param>
+void TxPacer::setSampleRate(uint32_t sampleRate)
+{
+    m_sampleRate = sampleRate;
+    m_rate = double(sampleRate) * (1.0 + (double(m_ppm) * 1e-6));
+    m_anchored = false;
+}
+
+/// <summary>
+/// Sets the number of samples to keep queued ahead of the sink.
+/// </summary>
+/// <param name="lead">Number of samples.</param>
+void TxPacer::setLead(uint32_t lead)
+{
+    m_lead = lead;
+}
+
+/// <summary>
+/// Sets the clock offset (in parts per million) of the sink.
+/// </summary>
+/// <remarks>The sample clock is rebased at the current sample, so deadlines already met
+/// do not move when the rate changes.</remarks>
+/// <param name="ppm">Clock offset; positive when the sink runs fast.</param>
+void TxPacer::setPPM(float ppm)
+{
+    if (m_anchored) {
+        m_baseNs = playout(m_samples);
+        m_baseSamples = m_samples;
+    }
+
+    m_ppm = ppm;
+    m_rate = double(m_sampleRate) * (1.0 + (double(ppm) * 1e-6));
+}
+
+/// <summary>
+/// Blocks until the deadline of the next frame.
+/// </summary>
+void TxPacer::wait()
+{
+    timespec now;
+    ::clock_gettime(CLOCK_MONOTONIC, &now);
+
+    if (!m_anchored)
+        anchor(now);
+
+    int64_t elapsed = (int64_t(now.tv_sec - m_epoch.tv_sec) * NSEC_PER_SEC) + (now.tv_nsec - m_epoch.tv_nsec);
+
+    // the sink has played out everything we have sent it; restart the sample clock
+    int64_t drained = playout(m_samples);
+    if (elapsed > drained) {
+        if (m_streaming && m_samples > 0U)
+            m_underruns++;
+
+        anchor(now);
+        elapsed = 0;
+    }
+
+    int64_t due = deadline(m_samples);
+    if (elapsed < due) {
+        timespec ts = m_epoch;
+        ts.tv_sec += time_t(due / NSEC_PER_SEC);
+        ts.tv_nsec += long(due % NSEC_PER_SEC);
+        if (ts.tv_nsec >= NSEC_PER_SEC) {
+            ts.tv_sec++;
+            ts.tv_nsec -= NSEC_PER_SEC;
+        }
+
+        while (::clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) == EINTR)
+            ;
+
+        m_wakeup.record(ts);
+        ::clock_gettime(CLOCK_MONOTONIC, &now);
+        elapsed = (int64_t(now.tv_sec - m_epoch.tv_sec) * NSEC_PER_SEC) + (now.tv_nsec - m_epoch.tv_nsec);
+    }
+
+    // frames inside the initial lead are sent immediately and are not paced
+    if (due >= 0) {
+        int64_t late = (elapsed - due) / 1000;
+        if (late < 0)
+            late = 0;
+
+        uint32_t lateUs = (late > 0xFFFFFFFFLL) ? 0xFFFFFFFFU : uint32_t(late);
+        for (uint32_t i = 0U; i < TX_PACER_LATE_BUCKETS; i++) {
+            if (lateUs < LATE_BOUNDS[i] || i == (TX_PACER_LATE_BUCKETS - 1U)) {
+                m_late[i]++;
+                break;
+            }
+        }
+
+        if (lateUs > m_maxLate)
+            m_maxLate = lateUs;
+    }
+
+    m_streaming = true;
+}
+
+/// <summary>
+/// Advances the sample clock after a frame has been emitted.
+/// </summary>
+/// <param name="samples">Number of samples emitted.</param>
+void TxPacer::advance(uint32_t samples)
+{
+    m_samples += samples;
+    m_frames++;
+}
+
+/// <summary>
+/// Blocks briefly while there is no data to transmit.
+/// </summary>
+/// <param name="active">Flag indicating whether the transmitter is still keyed.</param>
+void TxPacer::idle(bool active)
+{
+    if (!active && m_streaming) {
+        m_streaming = false;
+        logStats();
+    }
+
+    m_wakeup.probe(uint32_t(IDLE_WAIT_NS / 1000));
+}
+
+/// <summary>
+/// Gets the upper bound (in microseconds) of the given lateness histogram bucket.
+/// </summary>
+/// <param name="bucket">Histogram bucket.</param>
+/// <returns></returns>
+uint32_t TxPacer::getLateBound(uint32_t bucket)
+{
+    return (bucket < TX_PACER_LATE_BUCKETS) ? LATE_BOUNDS[bucket] : 0U;
+}
+
+/// <summary>
+/// Writes the pacer statistics to the log.
+/// </summary>
+void TxPacer::logStats() const
+{
+    char hist[256U];
+    int len = 0;
+    for (uint32_t i = 0U; i < TX_PACER_LATE_BUCKETS && len < (int)sizeof(hist); i++) {
+        if (i == (TX_PACER_LATE_BUCKETS - 1U))
+            len += ::snprintf(hist + len, sizeof(hist) - len, ">=%uus: %u", LATE_BOUNDS[i - 1U], m_late[i]);
+        else
+            len += ::snprintf(hist + len, sizeof(hist) - len, "<%uus: %u, ", LATE_BOUNDS[i], m_late[i]);
+    }
+
+    ::LogMessage(LOG_DSP, "Tx pacer, frames = %u, underruns = %u, overruns = %u, lead = %u, maxLate = %uus, ppm = %.2f", m_frames, m_underruns, m_overruns, m_lead, m_maxLate, m_ppm);
+    ::LogMessage(LOG_DSP, "Tx pacer lateness, %s", hist);
+}
+
+// ---------------------------------------------------------------------------
+//  Private Class Members
+// ---------------------------------------------------------------------------
+
+/// <summary>
+/// Helper to anchor the sample clock to the current time.
+/// </summary>
+/// <param name="now"></param>
+void TxPacer::anchor(const timespec& now)
+{
+    m_epoch = now;
+    m_samples = 0U;
+    m_baseSamples = 0U;
+    m_baseNs = 0;
+    m_anchored = true;
+}
+
+/// <summary>
+/// Helper to calculate the time (in nanoseconds from the epoch) the sink plays out the given sample.
+/// </summary>
+/// <param name="samples"></param>
+/// <returns></returns>
+int64_t TxPacer::playout(uint64_t samples) const
+{
+    return m_baseNs + int64_t((double(int64_t(samples - m_baseSamples)) * double(NSEC_PER_SEC)) / m_rate);
+}
+
+/// <summary>
+/// Helper to calculate the deadline (in nanoseconds from the epoch) of the given sample.
+/// </summary>
+/// <param name="samples"></param>
+/// <returns></returns>
+int64_t TxPacer::deadline(uint64_t samples) const
+{
+    return playout(samples) - int64_t((double(m_lead) * double(NSEC_PER_SEC)) / m_rate);
+}
@@ -0,0 +1,121 @@
+/**
+* Digital Voice Modem - DSP Firmware
+* GPLv2 Open Source. Use is subject to license terms.
+* DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+*
+* @package DVM / DSP Firmware
+*
+*/
+/*
+*   Copyright (C) 2022 Bryan Biedenkapp N2PLL
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 2 of the License, or
+*   (at your option) any later version.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program; if not, write to the Free Software
+*   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*/
+#if !defined(__TX_PACER_H__)
+#define __TX_PACER_H__
+
+#include "Defines.h"
+#include "sdr/WakeupLatency.h"
+
+#include <time.h>
+
+namespace sdr
+{
+    // ---------------------------------------------------------------------------
+    //  Constants
+    // ---------------------------------------------------------------------------
+
+    const uint32_t TX_PACER_LATE_BUCKETS = 9U;
+
+    // ---------------------------------------------------------------------------
+    //  Class Declaration
+    //      Implements a transmit pacer that schedules frame emission on absolute
+    //      CLOCK_MONOTONIC deadlines derived from the number of samples sent,
+    //      keeping a fixed lead of samples ahead of the SDR sink.
+    // ---------------------------------------------------------------------------
+
+    class DSP_FW_API TxPacer {
+    public:
+        /// <summary>Initializes a new instance of the TxPacer class.</summary>
+        TxPacer(uint32_t sampleRate, uint32_t lead);
+
+        /// <summary>Sets the sample rate of the sink.</summary>
+        void setSampleRate(uint32_t sampleRate);
+        /// <summary>Sets the number of samples to keep queued ahead of the sink.</summary>
+        void setLead(uint32_t lead);
+        /// <summary>Gets the number of samples to keep queued ahead of the sink.</summary>
+        uint32_t getLead() const { return m_lead; }
+        /// <summary>Sets the clock offset (in parts per million) of the sink.</summary>
+        void setPPM(float ppm);
+        /// <summary>Gets the clock offset (in parts per million) of the sink.</summary>
+        float getPPM() const { return m_ppm; }
+
+        /// <summary>Blocks until the deadline of the next frame.</summary>
+        void wait();
+        /// <summary>Advances the sample clock after a frame has been emitted.</summary>
+        void advance(uint32_t samples);
+        /// <summary>Blocks briefly while there is no data to transmit.</summary>
+        void idle(bool active);
+
+        /// <summary>Records a frame the sink refused to accept.</summary>
+        void overrun() { m_overruns++; }
+
+        /// <summary>Gets the number of times the sink ran dry during a transmission.</summary>
+        uint32_t getUnderruns() const { return m_underruns; }
+        /// <summary>Gets the number of frames the sink refused to accept.</summary>
+        uint32_t getOverruns() const { return m_overruns; }
+        /// <summary>Gets the count of frames in the given lateness histogram bucket.</summary>
+        uint32_t getLateCount(uint32_t bucket) const { return (bucket < TX_PACER_LATE_BUCKETS) ? m_late[bucket] : 0U; }
+        /// <summary>Gets the upper bound (in microseconds) of the given lateness histogram bucket.</summary>
+        static uint32_t getLateBound(uint32_t bucket);
+        /// <summary>Gets the largest observed lateness (in microseconds).</summary>
+        uint32_t getMaxLate() const { return m_maxLate; }
+        /// <summary>Gets the wakeup latency of the pacer sleeps.</summary>
+        WakeupLatency& getWakeup() { return m_wakeup; }
+
+        /// <summary>Writes the pacer statistics to the log.</summary>
+        void logStats() const;
+
+    private:
+        uint32_t m_sampleRate;
+        uint32_t m_lead;
+        float m_ppm;
+        double m_rate;
+
+        bool m_anchored;
+        bool m_streaming;
+        timespec m_epoch;
+        uint64_t m_samples;
+        uint64_t m_baseSamples;
+        int64_t m_baseNs;
+
+        uint32_t m_frames;
+        uint32_t m_underruns;
+        uint32_t m_overruns;
+        uint32_t m_late[TX_PACER_LATE_BUCKETS];
+        uint32_t m_maxLate;
+
+        WakeupLatency m_wakeup;
+
+        /// <summary>Helper to anchor the sample clock to the current time.</summary>
+        void anchor(const timespec& now);
+        /// <summary>Helper to calculate the time (in nanoseconds from the epoch) the sink plays out the given sample.</summary>
+        int64_t playout(uint64_t samples) const;
+        /// <summary>Helper to calculate the deadline (in nanoseconds from the epoch) of the given sample.</summary>
+        int64_t deadline(uint64_t samples) const;
+    };
+} // namespace sdr
+
+#endif // __TX_PACER_H__
@@ -0,0 +1,163 @@
+/**
+* Digital Voice Modem - DSP Firmware
+* GPLv2 Open Source. Use is subject to license terms.
+* DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+*
+* @package DVM / DSP Firmware
+*
+*/
+/*
+*   Copyright (C) 2022 Bryan Biedenkapp N2PLL
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 2 of the License, or
+*   (at your option) any later version.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program; if not, write to the Free Software
+*   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*/
+#include "sdr/WakeupLatency.h"
+#include "sdr/Log.h"
+
+#include <cstdio>
+#include <cerrno>
+
+using namespace sdr;
+
+// ---------------------------------------------------------------------------
+//  Constants
+// ---------------------------------------------------------------------------
+
+const int64_t NSEC_PER_SEC = 1000000000LL;
+
+// upper bounds of the latency histogram buckets, in microseconds; the last bucket is open
+const uint32_t LATENCY_BOUNDS[WAKEUP_LATENCY_BUCKETS] = { 10U, 25U, 50U, 100U, 250U, 500U, 1000U, 0xFFFFFFFFU };
+
+// ---------------------------------------------------------------------------
+//  Public Class Members
+// ---------------------------------------------------------------------------
+
+/// <summary>
+/// Initializes a new instance of the WakeupLatency class.
+/// </summary>
+WakeupLatency::WakeupLatency() :
+    m_count(0U),
+    m_sum(0U),
+    m_max(0U),
+    m_hist(),
+    m_start()
+{
+    clear();
+}
+
+/// <summary>
+/// Records a wakeup the given number of nanoseconds after its deadline.
+/// </summary>
+/// <param name="lateNs"></param>
+void WakeupLatency::record(int64_t lateNs)
+{
+    int64_t late = lateNs / 1000;
+    if (late < 0)
+        late = 0;
+
+    uint32_t lateUs = (late > 0xFFFFFFFFLL) ? 0xFFFFFFFFU : uint32_t(late);
+    for (uint32_t i = 0U; i < WAKEUP_LATENCY_BUCKETS; i++) {
+        if (lateUs < LATENCY_BOUNDS[i] || i == (WAKEUP_LATENCY_BUCKETS - 1U)) {
+            m_hist[i]++;
+            break;
+        }
+    }
+
+    m_count++;
+    m_sum += lateUs;
+    if (lateUs > m_max)
+        m_max = lateUs;
+}
+
+/// <summary>
+/// Records a wakeup that is happening now for the given deadline.
+/// </summary>
+/// <param name="deadline">CLOCK_MONOTONIC time the thread was due to wake.</param>
+void WakeupLatency::record(const timespec& deadline)
+{
+    timespec now;
+    ::clock_gettime(CLOCK_MONOTONIC, &now);
+    record((int64_t(now.tv_sec - deadline.tv_sec) * NSEC_PER_SEC) + (now.tv_nsec - deadline.tv_nsec));
+}
+
+/// <summary>
+/// Sleeps for the given number of microseconds and records how late the wakeup was.
+/// </summary>
+/// <param name="us"></param>
+void WakeupLatency::probe(uint32_t us)
+{
+    timespec ts;
+    ::clock_gettime(CLOCK_MONOTONIC, &ts);
+    ts.tv_sec += time_t(us / 1000000U);
+    ts.tv_nsec += long(us % 1000000U) * 1000L;
+    if (ts.tv_nsec >= NSEC_PER_SEC) {
+        ts.tv_sec++;
+        ts.tv_nsec -= NSEC_PER_SEC;
+    }
+
+    while (::clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) == EINTR)
+        ;
+
+    record(ts);
+}
+
+/// <summary>
+/// Flag indicating the statistics interval (in milliseconds) has elapsed.
+/// </summary>
+/// <param name="intervalMs"></param>
+/// <returns></returns>
+bool WakeupLatency::isDue(uint32_t intervalMs) const
+{
+    timespec now;
+    ::clock_gettime(CLOCK_MONOTONIC, &now);
+
+    int64_t elapsed = (int64_t(now.tv_sec - m_start.tv_sec) * 1000) + ((now.tv_nsec - m_start.tv_nsec) / 1000000);
+    return elapsed >= int64_t(intervalMs);
+}
+
+/// <summary>
+/// Writes the latency statistics to the log and clears them.
+/// </summary>
+/// <param name="name">Name of the thread.</param>
+void WakeupLatency::logStats(const char* name)
+{
+    char hist[256U];
+    int len = 0;
+    for (uint32_t i = 0U; i < WAKEUP_LATENCY_BUCKETS && len < (int)sizeof(hist); i++) {
+        if (i == (WAKEUP_LATENCY_BUCKETS - 1U))
+            len += ::snprintf(hist + len, sizeof(hist) - len, ">=%uus: %u", LATENCY_BOUNDS[i - 1U], m_hist[i]);
+        else
+            len += ::snprintf(hist + len, sizeof(hist) - len, "<%uus: %u, ", LATENCY_BOUNDS[i], m_hist[i]);
+    }
+
+    float mean = (m_count > 0U) ? float(m_sum) / float(m_count) : 0.0F;
+    ::LogMessage(LOG_DSP, "%s thread wakeup latency, wakeups = %u, mean = %.1fus, max = %uus, %s", name, m_count, mean, m_max, hist);
+
+    clear();
+}
+
+/// <summary>
+/// Clears the latency statistics.
+/// </summary>
+void WakeupLatency::clear()
+{
+    m_count = 0U;
+    m_sum = 0U;
+    m_max = 0U;
+    for (uint32_t i = 0U; i < WAKEUP_LATENCY_BUCKETS; i++)
+        m_hist[i] = 0U;
+
+    ::clock_gettime(CLOCK_MONOTONIC, &m_start);
+}
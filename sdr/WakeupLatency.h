@@ -0,0 +1,86 @@
+/**
+* Digital Voice Modem - DSP Firmware
+* GPLv2 Open Source. Use is subject to license terms.
+* DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+*
+* @package DVM / DSP Firmware
+*
+*/
+/*
+*   Copyright (C) 2022 Bryan Biedenkapp N2PLL
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 2 of the License, or
+*   (at your option) any later version.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program; if not, write to the Free Software
+*   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*/
+#if !defined(__WAKEUP_LATENCY_H__)
+#define __WAKEUP_LATENCY_H__
+
+#include "Defines.h"
+
+#include <time.h>
+
+namespace sdr
+{
+    // ---------------------------------------------------------------------------
+    //  Constants
+    // ---------------------------------------------------------------------------
+
+    const uint32_t WAKEUP_LATENCY_BUCKETS = 8U;
+
+    // interval between thread wakeup latency statistics, in milliseconds
+    const uint32_t WAKEUP_LATENCY_INTERVAL = 60000U;
+
+    // ---------------------------------------------------------------------------
+    //  Class Declaration
+    //      Implements a histogram of how late a thread woke up after a timed
+    //      sleep or the data it waits on was due; owned and updated by a
+    //      single thread.
+    // ---------------------------------------------------------------------------
+
+    class DSP_FW_API WakeupLatency {
+    public:
+        /// <summary>Initializes a new instance of the WakeupLatency class.</summary>
+        WakeupLatency();
+
+        /// <summary>Records a wakeup the given number of nanoseconds after its deadline.</summary>
+        void record(int64_t lateNs);
+        /// <summary>Records a wakeup that is happening now for the given deadline.</summary>
+        void record(const timespec& deadline);
+        /// <summary>Sleeps for the given number of microseconds and records how late the wakeup was.</summary>
+        void probe(uint32_t us);
+
+        /// <summary>Gets the number of wakeups recorded.</summary>
+        uint32_t getCount() const { return m_count; }
+        /// <summary>Gets the largest observed latency (in microseconds).</summary>
+        uint32_t getMax() const { return m_max; }
+
+        /// <summary>Flag indicating the statistics interval (in milliseconds) has elapsed.</summary>
+        bool isDue(uint32_t intervalMs) const;
+
+        /// <summary>Writes the latency statistics to the log and clears them.</summary>
+        void logStats(const char* name);
+        /// <summary>Clears the latency statistics.</summary>
+        void clear();
+
+    private:
+        uint32_t m_count;
+        uint64_t m_sum;
+        uint32_t m_max;
+        uint32_t m_hist[WAKEUP_LATENCY_BUCKETS];
+
+        timespec m_start;
+    };
+} // namespace sdr
+
+#endif // __WAKEUP_LATENCY_H__
@@ -0,0 +1,323 @@
+/**
+* Digital Voice Modem - DSP Firmware
+* GPLv2 Open Source. Use is subject to license terms.
+* DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+*
+* @package DVM / DSP Firmware
+*
+*/
+/*
+*   Copyright (C) 2022 Bryan Biedenkapp N2PLL
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 2 of the License, or
+*   (at your option) any later version.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program; if not, write to the Free Software
+*   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*/
+#include "sdr/WidebandFrontEnd.h"
+#include "sdr/transport/DatagramTransport.h"
+#include "sdr/transport/FileTransport.h"
+#include "sdr/transport/ZmqTransport.h"
+#include "sdr/Log.h"
+
+#include <cstdlib>
+#include <cstring>
+
+using namespace sdr;
+using namespace sdr::transport;
+
+// ---------------------------------------------------------------------------
+//  Constants
+// ---------------------------------------------------------------------------
+
+// interval between front end statistics in the log, in milliseconds
+const uint32_t WIDEBAND_STATS_INTERVAL = 60000U;
+
+// ---------------------------------------------------------------------------
+//  Public Class Members
+// ---------------------------------------------------------------------------
+
+/// <summary>
+/// Initializes a new instance of the WidebandFrontEnd class.
+/// </summary>
+WidebandFrontEnd::WidebandFrontEnd() :
+    m_endpoint(),
+    m_format(IQ_FORMAT_CS16),
+    m_sampleRate(WIDEBAND_SAMPLE_RATE_DEFAULT),
+    m_spacing(WIDEBAND_SPACING_DEFAULT),
+    m_policy(),
+    m_offsets(),
+    m_queues(),
+    m_transport(NULL),
+    m_channelizer(),
+    m_inI(),
+    m_inQ(),
+    m_out(),
+    m_outPtr(),
+    m_thread(),
+    m_started(false),
+    m_running(false),
+    m_stats(),
+    m_statsSamples(0U),
+    m_statsNs(0U),
+    m_statsLost(0U)
+{
+    /* stub */
+}
+
+/// <summary>
+/// Finalizes a instance of the WidebandFrontEnd class.
+/// </summary>
+WidebandFrontEnd::~WidebandFrontEnd()
+{
+    close();
+
+    // the queues are left to the process exit, the channel Rx threads never stop reading them
+}
+
+/// <summary>
+/// Checks whether a channel offset can be channelized.
+/// </summary>
+/// <param name="offset">Channel offset from the wideband center (in Hz).</param>
+/// <returns>True, if the offset is a whole number of channels inside the wideband stream, otherwise false.</returns>
+bool WidebandFrontEnd::checkOffset(int32_t offset) const
+{
+    if ((offset % int32_t(m_spacing)) != 0)
+        return false;
+
+    return (::abs(offset) < int32_t(m_sampleRate / 2U));
+}
+
+/// <summary>
+/// Opens the wideband transport and filter bank for the given channel offsets.
+/// </summary>
+/// <param name="offsets">Offset (in Hz) of each channel from the wideband center.</param>
+/// <returns>True, if the front end was opened, otherwise false.</returns>
+bool WidebandFrontEnd::open(const std::vector<int32_t>& offsets)
+{
+    if (m_spacing == 0U || (m_sampleRate % m_spacing) != 0U) {
+        ::LogError(LOG_DSP, "The wideband sample rate must be a whole number of channels, rate = %u, spacing = %u", m_sampleRate, m_spacing);
+        return false;
+    }
+
+    uint32_t branches = m_sampleRate / m_spacing;
+    std::vector<uint32_t> bins;
+    for (size_t i = 0U; i < offsets.size(); i++)
+        bins.push_back(Channelizer::getBin(offsets[i], m_spacing, branches));
+
+    if (!m_channelizer.open(branches, bins)) {
+        ::LogError(LOG_DSP, "The wideband stream must hold a power of 2 channels, %u to %u, rate = %u, spacing = %u", CHANNELIZER_BRANCHES_MIN, CHANNELIZER_BRANCHES_MAX,
+            m_sampleRate, m_spacing);
+        return false;
+    }
+
+    m_offsets = offsets;
+    for (size_t i = 0U; i < offsets.size(); i++)
+        m_queues.push_back(new ChannelQueue());
+
+    m_inI.resize(WIDEBAND_CHUNK);
+    m_inQ.resize(WIDEBAND_CHUNK);
+    m_out.resize(offsets.size());
+    m_outPtr.resize(offsets.size());
+    for (size_t i = 0U; i < offsets.size(); i++) {
+        m_out[i].resize(2U * m_channelizer.getMaxOutput(WIDEBAND_CHUNK));
+        m_outPtr[i] = &m_out[i][0U];
+    }
+
+    // the front end only receives, so the wideband transports never touch a Tx frame pool
+    uint32_t sampleSize = (m_format == IQ_FORMAT_CS16) ? (2U * sizeof(int16_t)) : (2U * sizeof(float));
+    if (FileTransport::isFile(m_endpoint))
+        m_transport = new FileTransport(m_endpoint, std::string(), m_sampleRate, sampleSize, NULL);
+    else if (DatagramTransport::isDatagram(m_endpoint))
+        m_transport = new DatagramTransport(m_endpoint, std::string(), NULL);
+    else
+        m_transport = new ZmqTransport(m_endpoint, std::string(), NULL);
+
+    if (!m_transport->open()) {
+        ::LogError(LOG_DSP, "WidebandFrontEnd::open(), failed to open the wideband transport %s", m_endpoint.c_str());
+        delete m_transport;
+        m_transport = NULL;
+        return false;
+    }
+
+    ::LogMessage(LOG_DSP, "Wideband front end, %u Hz (%s), %u channels of %u Hz at %u Hz", m_sampleRate, (m_format == IQ_FORMAT_CS16) ? "cs16" : "cf32",
+        (uint32_t)offsets.size(), m_spacing, getChannelRate());
+    return true;
+}
+
+/// <summary>
+/// Starts the front end thread.
+/// </summary>
+/// <returns></returns>
+bool WidebandFrontEnd::start()
+{
+    if (m_transport == NULL)
+        return false;
+
+    m_running = true;
+    if (!m_policy.create(&m_thread, threadHelper, this, "Wideband")) {
+        m_running = false;
+        return false;
+    }
+
+    m_started = true;
+    return true;
+}
+
+/// <summary>
+/// Creates the receive only transport of the channel at the given offset.
+/// </summary>
+/// <param name="offset">Channel offset from the wideband center (in Hz).</param>
+/// <param name="pool">Pool the channel's Tx frames are returned to.</param>
+/// <returns>Sample transport, or NULL if the offset is not channelized.</returns>
+ISampleTransport* WidebandFrontEnd::createTransport(int32_t offset, SampleFramePool* pool)
+{
+    for (size_t i = 0U; i < m_offsets.size(); i++) {
+        if (m_offsets[i] == offset)
+            return new ChannelizedTransport(m_queues[i], offset, pool);
+    }
+
+    ::LogError(LOG_DSP, "No wideband channel at %+d Hz", offset);
+    return NULL;
+}
+
+/// <summary>
+/// Stops the front end thread and closes the wideband transport.
+/// </summary>
+void WidebandFrontEnd::close()
+{
+    if (m_started) {
+        m_running = false;
+        ::pthread_join(m_thread, NULL);
+        m_started = false;
+    }
+
+    if (m_transport != NULL) {
+        m_transport->close();
+        delete m_transport;
+        m_transport = NULL;
+    }
+
+    for (size_t i = 0U; i < m_queues.size(); i++)
+        m_queues[i]->close();
+}
+
+// ---------------------------------------------------------------------------
+//  Private Class Members
+// ---------------------------------------------------------------------------
+
+/// <summary>
+/// Helper to channelize received wideband samples.
+/// </summary>
+/// <param name="data">Interleaved IQ payload.</param>
+/// <param name="length">Length of the payload in bytes; a trailing partial sample is ignored.</param>
+void WidebandFrontEnd::process(const uint8_t* data, uint32_t length)
+{
+    uint32_t sampleSize = (m_format == IQ_FORMAT_CS16) ? (2U * sizeof(int16_t)) : (2U * sizeof(float));
+    uint32_t count = length / sampleSize;
+
+    uint32_t done = 0U;
+    while (done < count) {
+        uint32_t n = count - done;
+        if (n > WIDEBAND_CHUNK)
+            n = WIDEBAND_CHUNK;
+
+        // deinterleave into full scale +/-1.0, which the channel demodulators expect of cf32
+        float* inI = &m_inI[0U];
+        float* inQ = &m_inQ[0U];
+        if (m_format == IQ_FORMAT_CS16) {
+            const int16_t* iq = (const int16_t*)(data + (done * sampleSize));
+            for (uint32_t i = 0U; i < n; i++) {
+                inI[i] = float(iq[2U * i]) * (1.0F / 32768.0F);
+                inQ[i] = float(iq[(2U * i) + 1U]) * (1.0F / 32768.0F);
+            }
+        }
+        else {
+            const float* iq = (const float*)(data + (done * sampleSize));
+            for (uint32_t i = 0U; i < n; i++) {
+                inI[i] = iq[2U * i];
+                inQ[i] = iq[(2U * i) + 1U];
+            }
+        }
+
+        uint32_t outputs = m_channelizer.process(inI, inQ, n, &m_outPtr[0U]);
+        for (size_t c = 0U; c < m_queues.size(); c++)
+            m_queues[c]->push(m_outPtr[c], outputs);
+
+        done += n;
+    }
+}
+
+/// <summary>
+/// Helper to write the front end statistics to the log.
+/// </summary>
+/// <param name="now"></param>
+void WidebandFrontEnd::logStats(const timespec& now)
+{
+    // load is the time spent channelizing against the time the samples span
+    float nsPerSample = (m_statsSamples > 0U) ? (float(m_statsNs) / float(m_statsSamples)) : 0.0F;
+    float load = (nsPerSample * float(m_sampleRate)) / 1.0e7F;
+
+    ::LogMessage(LOG_DSP, "Wideband front end, samples = %llu, %.1f ns/sample, load = %.1f%%, lost = %u", (unsigned long long)m_statsSamples,
+        nsPerSample, load, m_statsLost);
+    m_transport->logStats();
+
+    m_stats = now;
+    m_statsSamples = m_statsNs = 0U;
+    m_statsLost = 0U;
+}
+
+/// <summary>
+///
+/// </summary>
+/// <param name="arg"></param>
+/// <returns></returns>
+void* WidebandFrontEnd::threadHelper(void* arg)
+{
+    WidebandFrontEnd* p = (WidebandFrontEnd*)arg;
+    p->m_policy.apply("Wideband");
+
+    uint32_t sampleSize = (p->m_format == IQ_FORMAT_CS16) ? (2U * sizeof(int16_t)) : (2U * sizeof(float));
+    ::clock_gettime(CLOCK_MONOTONIC, &p->m_stats);
+
+    TransportBuffer buffers[TRANSPORT_MAX_BUFFERS];
+    while (p->m_running) {
+        uint32_t count = p->m_transport->read(buffers);
+
+        timespec start;
+        ::clock_gettime(CLOCK_MONOTONIC, &start);
+
+        for (uint32_t i = 0U; i < count; i++) {
+            // wideband samples lost upstream are lost on every channel
+            if (buffers[i].lost > 0U) {
+                uint32_t lost = (buffers[i].lost / sampleSize) / p->m_channelizer.getDecimation();
+                for (size_t c = 0U; c < p->m_queues.size(); c++)
+                    p->m_queues[c]->lose(lost);
+                p->m_statsLost += buffers[i].lost / sampleSize;
+            }
+
+            p->process(buffers[i].data, buffers[i].length);
+            p->m_statsSamples += buffers[i].length / sampleSize;
+        }
+
+        p->m_transport->release();
+
+        timespec now;
+        ::clock_gettime(CLOCK_MONOTONIC, &now);
+        p->m_statsNs += uint64_t((int64_t(now.tv_sec - start.tv_sec) * 1000000000LL) + (now.tv_nsec - start.tv_nsec));
+
+        if ((uint32_t(now.tv_sec - p->m_stats.tv_sec) * 1000U) >= WIDEBAND_STATS_INTERVAL)
+            p->logStats(now);
+    }
+
+    return NULL;
+}
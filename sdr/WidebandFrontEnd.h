@@ -0,0 +1,136 @@
+/**
+* Digital Voice Modem - DSP Firmware
+* GPLv2 Open Source. Use is subject to license terms.
+* DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+*
+* @package DVM / DSP Firmware
+*
+*/
+/*
+*   Copyright (C) 2022 Bryan Biedenkapp N2PLL
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 2 of the License, or
+*   (at your option) any later version.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program; if not, write to the Free Software
+*   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*/
+#if !defined(__WIDEBAND_FRONT_END_H__)
+#define __WIDEBAND_FRONT_END_H__
+
+#include "Defines.h"
+#include "sdr/Channelizer.h"
+#include "sdr/FMDiscriminator.h"
+#include "sdr/SampleFramePool.h"
+#include "sdr/ThreadPolicy.h"
+#include "sdr/transport/ChannelizedTransport.h"
+
+#include <pthread.h>
+#include <time.h>
+
+#include <string>
+#include <vector>
+
+namespace sdr
+{
+    // ---------------------------------------------------------------------------
+    //  Constants
+    // ---------------------------------------------------------------------------
+
+    const uint32_t WIDEBAND_SAMPLE_RATE_MAX = 20000000U;
+    const uint32_t WIDEBAND_SAMPLE_RATE_DEFAULT = 200000U;
+    const uint32_t WIDEBAND_SPACING_DEFAULT = 12500U;
+
+    // wideband samples converted and channelized per pass
+    const uint32_t WIDEBAND_CHUNK = 8192U;
+
+    // ---------------------------------------------------------------------------
+    //  Class Declaration
+    //      Implements the wideband front end; receives one complex baseband
+    //      stream, channelizes it and hands each channel to its modem through a
+    //      channelized transport.
+    // ---------------------------------------------------------------------------
+
+    class DSP_FW_API WidebandFrontEnd {
+    public:
+        /// <summary>Initializes a new instance of the WidebandFrontEnd class.</summary>
+        WidebandFrontEnd();
+        /// <summary>Finalizes a instance of the WidebandFrontEnd class.</summary>
+        ~WidebandFrontEnd();
+
+        /// <summary>Sets the endpoint the wideband samples are received from.</summary>
+        void setEndpoint(const std::string& endpoint) { m_endpoint = endpoint; }
+        /// <summary>Gets the endpoint the wideband samples are received from.</summary>
+        const std::string& getEndpoint() const { return m_endpoint; }
+        /// <summary>Sets the wideband IQ format.</summary>
+        void setFormat(IQ_FORMAT format) { m_format = format; }
+        /// <summary>Sets the wideband sample rate.</summary>
+        void setSampleRate(uint32_t sampleRate) { m_sampleRate = sampleRate; }
+        /// <summary>Sets the channel spacing.</summary>
+        void setSpacing(uint32_t spacing) { m_spacing = spacing; }
+        /// <summary>Gets the thread policy of the front end.</summary>
+        ThreadPolicy& getPolicy() { return m_policy; }
+
+        /// <summary>Flag indicating whether a wideband endpoint is set.</summary>
+        bool isEnabled() const { return !m_endpoint.empty(); }
+        /// <summary>Gets the sample rate of the channels.</summary>
+        uint32_t getChannelRate() const { return (2U * m_spacing); }
+        /// <summary>Checks whether a channel offset can be channelized.</summary>
+        bool checkOffset(int32_t offset) const;
+
+        /// <summary>Opens the wideband transport and filter bank for the given channel offsets.</summary>
+        bool open(const std::vector<int32_t>& offsets);
+        /// <summary>Starts the front end thread.</summary>
+        bool start();
+        /// <summary>Creates the receive only transport of the channel at the given offset.</summary>
+        transport::ISampleTransport* createTransport(int32_t offset, SampleFramePool* pool);
+
+        /// <summary>Stops the front end thread and closes the wideband transport.</summary>
+        void close();
+
+    private:
+        std::string m_endpoint;
+        IQ_FORMAT m_format;
+        uint32_t m_sampleRate;
+        uint32_t m_spacing;
+        ThreadPolicy m_policy;
+
+        std::vector<int32_t> m_offsets;
+        std::vector<transport::ChannelQueue*> m_queues;
+
+        transport::ISampleTransport* m_transport;
+        Channelizer m_channelizer;
+
+        std::vector<float> m_inI;
+        std::vector<float> m_inQ;
+        std::vector<std::vector<float> > m_out;
+        std::vector<float*> m_outPtr;
+
+        pthread_t m_thread;
+        bool m_started;
+        volatile bool m_running;
+
+        timespec m_stats;
+        uint64_t m_statsSamples;
+        uint64_t m_statsNs;
+        uint32_t m_statsLost;
+
+        /// <summary>Helper to channelize received wideband samples.</summary>
+        void process(const uint8_t* data, uint32_t length);
+        /// <summary>Helper to write the front end statistics to the log.</summary>
+        void logStats(const timespec& now);
+
+        /// <summary></summary>
+        static void* threadHelper(void* arg);
+    };
+} // namespace sdr
+
+#endif // __WIDEBAND_FRONT_END_H__
@@ -30,6 +30,21 @@
 #include <stdint.h>
 #include "sdr/arm_math.h"
 
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define ARM_MATH_X86
+#include <immintrin.h>
+#endif
+
+// ---------------------------------------------------------------------------
+//  Constants
+// ---------------------------------------------------------------------------
+
+const uint32_t FIR_INTERP_L_MAX = 16U;
+const uint32_t FIR_INTERP_PHASE_MAX = 16U;
+const uint32_t FIR_INTERP_CHUNK = 256U;
+
 // ---------------------------------------------------------------------------
 //  Macros
 // ---------------------------------------------------------------------------
@@ -74,13 +89,13 @@ static uint32_t __SMLADX(uint32_t x, uint32_t y, uint32_t sum)
 }
 
 /// <summary>
-/// Processing function for the Q15 FIR interpolator.
+/// Portable Q15 FIR interpolator.
 /// </summary>
 /// <param name="S">An instance of the Q15 FIR interpolator structure.</param>
 /// <param name="pSrc">Block of input data.</param>
 /// <param name="pDst">Block of output data.</param>
 /// <param name="blockSize">Number of input samples to process per call.</param>
-void arm_fir_interpolate_q15(const arm_fir_interpolate_instance_q15* S, q15_t* pSrc, q15_t* pDst, uint32_t blockSize)
+static void firInterpolateQ15Generic(const arm_fir_interpolate_instance_q15* S, q15_t* pSrc, q15_t* pDst, uint32_t blockSize)
 {
     q15_t* pState = S->pState;                     // State pointer
     q15_t* pCoeffs = S->pCoeffs;                   // Coefficient pointer
@@ -175,13 +190,13 @@ void arm_fir_interpolate_q15(const arm_fir_interpolate_instance_q15* S, q15_t* p
 }
 
 /// <summary>
-/// Processing function for the fast Q15 FIR filter for Cortex-M3 and Cortex-M4.
+/// Portable fast Q15 FIR filter, emulating the Cortex-M3 and Cortex-M4 SIMD instructions.
 /// </summary>
 /// <param name="S">An instance of the Q15 FIR interpolator structure.</param>
 /// <param name="pSrc">Block of input data.</param>
 /// <param name="pDst">Block of output data.</param>
 /// <param name="blockSize">Number of input samples to process per call.</param>
-void arm_fir_fast_q15(const arm_fir_instance_q15* S, q15_t* pSrc, q15_t* pDst, uint32_t blockSize)
+static void firFastQ15Generic(const arm_fir_instance_q15* S, q15_t* pSrc, q15_t* pDst, uint32_t blockSize)
 {
     q15_t *pState = S->pState;                     // State pointer
     q15_t *pCoeffs = S->pCoeffs;                   // Coefficient pointer
@@ -446,6 +461,521 @@ void arm_fir_fast_q15(const arm_fir_instance_q15* S, q15_t* pSrc, q15_t* pDst, u
     }
 }
 
+/// <summary>
+/// Fast Q15 FIR filter for symmetric coefficients, adding the mirrored samples ahead of the
+/// multiply so each coefficient pair takes one multiply.
+/// </summary>
+/// <remarks>The accumulator wraps exactly as it does in the generic kernel, so the outputs are bit exact.</remarks>
+/// <param name="S">An instance of the Q15 FIR interpolator structure.</param>
+/// <param name="pSrc">Block of input data.</param>
+/// <param name="pDst">Block of output data.</param>
+/// <param name="blockSize">Number of input samples to process per call.</param>
+static void firFastQ15Folded(const arm_fir_instance_q15* S, q15_t* pSrc, q15_t* pDst, uint32_t blockSize)
+{
+    q15_t* pState = S->pState;
+    uint32_t numTaps = S->numTaps;
+    uint32_t foldLength = S->foldLength;
+    uint32_t half = foldLength >> 1;
+    const q15_t* c = S->pCoeffs + S->foldStart;
+
+    ::memcpy(pState + (numTaps - 1U), pSrc, blockSize * sizeof(q15_t));
+
+    const q15_t* x = pState + S->foldStart;
+    uint32_t n = 0U;
+
+    // four outputs at a time share each coefficient load
+    for (; (n + 4U) <= blockSize; n += 4U, x += 4U) {
+        const q15_t* hi = x + foldLength - 1U;
+
+        // the mirrored sums need 17 bits, so the products are taken modulo 2^32
+        uint32_t acc0 = 0U, acc1 = 0U, acc2 = 0U, acc3 = 0U;
+        for (uint32_t k = 0U; k < half; k++, hi--) {
+            uint32_t ck = uint32_t(int32_t(c[k]));
+            acc0 += ck * uint32_t(int32_t(x[k + 0U]) + int32_t(hi[0]));
+            acc1 += ck * uint32_t(int32_t(x[k + 1U]) + int32_t(hi[1]));
+            acc2 += ck * uint32_t(int32_t(x[k + 2U]) + int32_t(hi[2]));
+            acc3 += ck * uint32_t(int32_t(x[k + 3U]) + int32_t(hi[3]));
+        }
+
+        if ((foldLength & 1U) != 0U) {
+            uint32_t ck = uint32_t(int32_t(c[half]));
+            acc0 += ck * uint32_t(int32_t(x[half + 0U]));
+            acc1 += ck * uint32_t(int32_t(x[half + 1U]));
+            acc2 += ck * uint32_t(int32_t(x[half + 2U]));
+            acc3 += ck * uint32_t(int32_t(x[half + 3U]));
+        }
+
+        pDst[n + 0U] = q15_t(__SSAT((q31_t(acc0) >> 15), 16));
+        pDst[n + 1U] = q15_t(__SSAT((q31_t(acc1) >> 15), 16));
+        pDst[n + 2U] = q15_t(__SSAT((q31_t(acc2) >> 15), 16));
+        pDst[n + 3U] = q15_t(__SSAT((q31_t(acc3) >> 15), 16));
+    }
+
+    for (; n < blockSize; n++, x++) {
+        const q15_t* hi = x + foldLength - 1U;
+
+        uint32_t acc = 0U;
+        for (uint32_t k = 0U; k < half; k++, hi--)
+            acc += uint32_t(int32_t(c[k])) * uint32_t(int32_t(x[k]) + int32_t(hi[0]));
+        if ((foldLength & 1U) != 0U)
+            acc += uint32_t(int32_t(c[half])) * uint32_t(int32_t(x[half]));
+
+        pDst[n] = q15_t(__SSAT((q31_t(acc) >> 15), 16));
+    }
+
+    ::memmove(pState, pState + blockSize, (numTaps - 1U) * sizeof(q15_t));
+}
+
+#if defined(ARM_MATH_X86)
+/// <summary>
+/// Sums each of the four accumulators across its lanes.
+/// </summary>
+/// <param name="a0"></param>
+/// <param name="a1"></param>
+/// <param name="a2"></param>
+/// <param name="a3"></param>
+/// <returns>The four sums, in order.</returns>
+__attribute__((target("sse2")))
+static inline __m128i firReduceSSE2(__m128i a0, __m128i a1, __m128i a2, __m128i a3)
+{
+    __m128i s0 = _mm_add_epi32(_mm_unpacklo_epi32(a0, a1), _mm_unpackhi_epi32(a0, a1));
+    __m128i s1 = _mm_add_epi32(_mm_unpacklo_epi32(a2, a3), _mm_unpackhi_epi32(a2, a3));
+    return _mm_add_epi32(_mm_unpacklo_epi64(s0, s1), _mm_unpackhi_epi64(s0, s1));
+}
+
+/// <summary>
+/// Accumulates the taps from k onwards, 8, 4 and then 2 at a time, of four consecutive outputs.
+/// </summary>
+/// <param name="x">State at the first output.</param>
+/// <param name="c">Coefficients.</param>
+/// <param name="k">First tap.</param>
+/// <param name="numTaps">Number of taps in the filter.</param>
+/// <param name="acc">Accumulators of the four outputs.</param>
+__attribute__((target("sse2")))
+static inline void firTapsSSE2(const q15_t* x, const q15_t* c, uint32_t k, uint32_t numTaps, __m128i* acc)
+{
+    for (; (k + 8U) <= numTaps; k += 8U) {
+        __m128i c0 = _mm_loadu_si128((const __m128i*)(c + k));
+        for (uint32_t i = 0U; i < 4U; i++)
+            acc[i] = _mm_add_epi32(acc[i], _mm_madd_epi16(_mm_loadu_si128((const __m128i*)(x + k + i)), c0));
+    }
+
+    if ((k + 4U) <= numTaps) {
+        __m128i c0 = _mm_loadl_epi64((const __m128i*)(c + k));
+        for (uint32_t i = 0U; i < 4U; i++)
+            acc[i] = _mm_add_epi32(acc[i], _mm_madd_epi16(_mm_loadl_epi64((const __m128i*)(x + k + i)), c0));
+        k += 4U;
+    }
+
+    if ((k + 2U) <= numTaps) {
+        int32_t pair;
+        ::memcpy(&pair, c + k, sizeof(pair));
+        __m128i c0 = _mm_cvtsi32_si128(pair);
+        for (uint32_t i = 0U; i < 4U; i++) {
+            ::memcpy(&pair, x + k + i, sizeof(pair));
+            acc[i] = _mm_add_epi32(acc[i], _mm_madd_epi16(_mm_cvtsi32_si128(pair), c0));
+        }
+    }
+}
+
+/// <summary>
+/// Computes a single output of the filter.
+/// </summary>
+/// <param name="x">State at the output.</param>
+/// <param name="c">Coefficients.</param>
+/// <param name="numTaps">Number of taps in the filter.</param>
+/// <returns>The output in 1.15 format.</returns>
+__attribute__((target("sse2")))
+static inline q15_t firOutputSSE2(const q15_t* x, const q15_t* c, uint32_t numTaps)
+{
+    __m128i acc = _mm_setzero_si128();
+
+    uint32_t k = 0U;
+    for (; (k + 8U) <= numTaps; k += 8U)
+        acc = _mm_add_epi32(acc, _mm_madd_epi16(_mm_loadu_si128((const __m128i*)(x + k)), _mm_loadu_si128((const __m128i*)(c + k))));
+
+    acc = _mm_add_epi32(acc, _mm_shuffle_epi32(acc, _MM_SHUFFLE(1, 0, 3, 2)));
+    acc = _mm_add_epi32(acc, _mm_shuffle_epi32(acc, _MM_SHUFFLE(2, 3, 0, 1)));
+
+    // the accumulator wraps exactly like the 32-bit SMLAD accumulation of the generic kernel
+    uint32_t sum = uint32_t(_mm_cvtsi128_si32(acc));
+    for (; k < numTaps; k++)
+        sum += uint32_t(q31_t(x[k]) * c[k]);
+
+    q31_t res = q31_t(sum) >> 15;
+    return q15_t(__SSAT(res, 16));
+}
+
+/// <summary>
+/// SSE2 fast Q15 FIR filter, bit exact with the generic kernel.
+/// </summary>
+/// <param name="S">An instance of the Q15 FIR interpolator structure.</param>
+/// <param name="pSrc">Block of input data.</param>
+/// <param name="pDst">Block of output data.</param>
+/// <param name="blockSize">Number of input samples to process per call.</param>
+__attribute__((target("sse2")))
+static void firFastQ15SSE2(const arm_fir_instance_q15* S, q15_t* pSrc, q15_t* pDst, uint32_t blockSize)
+{
+    q15_t* pState = S->pState;
+    const q15_t* pCoeffs = S->pCoeffs;
+    uint32_t numTaps = S->numTaps;
+
+    ::memcpy(pState + (numTaps - 1U), pSrc, blockSize * sizeof(q15_t));
+
+    // 4 outputs at a time; the 32-bit lane sums wrap the same as SMLAD so the order the
+    // taps are summed in does not change the result
+    uint32_t n = 0U;
+    for (; (n + 4U) <= blockSize; n += 4U) {
+        __m128i acc[4U] = { _mm_setzero_si128(), _mm_setzero_si128(), _mm_setzero_si128(), _mm_setzero_si128() };
+        firTapsSSE2(pState + n, pCoeffs, 0U, numTaps, acc);
+
+        __m128i sum = _mm_srai_epi32(firReduceSSE2(acc[0U], acc[1U], acc[2U], acc[3U]), 15);
+        _mm_storel_epi64((__m128i*)(pDst + n), _mm_packs_epi32(sum, sum));
+    }
+
+    for (; n < blockSize; n++)
+        pDst[n] = firOutputSSE2(pState + n, pCoeffs, numTaps);
+
+    ::memmove(pState, pState + blockSize, (numTaps - 1U) * sizeof(q15_t));
+}
+
+/// <summary>
+/// AVX2 fast Q15 FIR filter, bit exact with the generic kernel.
+/// </summary>
+/// <param name="S">An instance of the Q15 FIR interpolator structure.</param>
+/// <param name="pSrc">Block of input data.</param>
+/// <param name="pDst">Block of output data.</param>
+/// <param name="blockSize">Number of input samples to process per call.</param>
+__attribute__((target("avx2")))
+static void firFastQ15AVX2(const arm_fir_instance_q15* S, q15_t* pSrc, q15_t* pDst, uint32_t blockSize)
+{
+    q15_t* pState = S->pState;
+    const q15_t* pCoeffs = S->pCoeffs;
+    uint32_t numTaps = S->numTaps;
+
+    // the boxcar filters are too short to fill a 256-bit register
+    if (numTaps < 16U) {
+        firFastQ15SSE2(S, pSrc, pDst, blockSize);
+        return;
+    }
+
+    ::memcpy(pState + (numTaps - 1U), pSrc, blockSize * sizeof(q15_t));
+
+    uint32_t n = 0U;
+    for (; (n + 4U) <= blockSize; n += 4U) {
+        const q15_t* x = pState + n;
+
+        // 16 taps at a time, then the 128-bit kernel picks up the rest of the taps
+        __m256i wide[4U] = { _mm256_setzero_si256(), _mm256_setzero_si256(), _mm256_setzero_si256(), _mm256_setzero_si256() };
+        uint32_t k = 0U;
+        for (; (k + 16U) <= numTaps; k += 16U) {
+            __m256i c0 = _mm256_loadu_si256((const __m256i*)(pCoeffs + k));
+            for (uint32_t i = 0U; i < 4U; i++)
+                wide[i] = _mm256_add_epi32(wide[i], _mm256_madd_epi16(_mm256_loadu_si256((const __m256i*)(x + k + i)), c0));
+        }
+
+        __m128i acc[4U];
+        for (uint32_t i = 0U; i < 4U; i++)
+            acc[i] = _mm_add_epi32(_mm256_castsi256_si128(wide[i]), _mm256_extracti128_si256(wide[i], 1));
+        firTapsSSE2(x, pCoeffs, k, numTaps, acc);
+
+        __m128i sum = _mm_srai_epi32(firReduceSSE2(acc[0U], acc[1U], acc[2U], acc[3U]), 15);
+        _mm_storel_epi64((__m128i*)(pDst + n), _mm_packs_epi32(sum, sum));
+    }
+
+    for (; n < blockSize; n++)
+        pDst[n] = firOutputSSE2(pState + n, pCoeffs, numTaps);
+
+    ::memmove(pState, pState + blockSize, (numTaps - 1U) * sizeof(q15_t));
+}
+
+/// <summary>
+/// SSE2 Q15 FIR interpolator, bit exact with the generic interpolator.
+/// </summary>
+/// <remarks>
+/// Each phase of the filter is run as its own short FIR over the block, with its outputs
+/// interleaved into the destination. Only the first phaseLength - 1 samples of the state
+/// are used, so the state buffer needs no room for the block.
+/// </remarks>
+/// <param name="S">An instance of the Q15 FIR interpolator structure.</param>
+/// <param name="pSrc">Block of input data.</param>
+/// <param name="pDst">Block of output data.</param>
+/// <param name="blockSize">Number of input samples to process per call.</param>
+__attribute__((target("sse2")))
+static void firInterpolateQ15SSE2(const arm_fir_interpolate_instance_q15* S, q15_t* pSrc, q15_t* pDst, uint32_t blockSize)
+{
+    uint32_t L = S->L;
+    uint32_t phaseLen = S->phaseLength;
+    uint32_t taps = (phaseLen + 1U) & ~1U;     // the SSE2 taps run in pairs, odd phases get a zero tap
+    if (L > FIR_INTERP_L_MAX || taps > FIR_INTERP_PHASE_MAX) {
+        firInterpolateQ15Generic(S, pSrc, pDst, blockSize);
+        return;
+    }
+
+    // split the phases out into contiguous coefficients, in the order the generic
+    // interpolator writes its outputs
+    q15_t coeffs[FIR_INTERP_L_MAX][FIR_INTERP_PHASE_MAX];
+    for (uint32_t j = 0U; j < L; j++) {
+        uint32_t sum = 0U;
+        for (uint32_t k = 0U; k < taps; k++) {
+            q15_t c = (k < phaseLen) ? S->pCoeffs[(L - 1U - j) + (k * L)] : 0;
+            coeffs[j][k] = c;
+            sum += (c < 0) ? uint32_t(-c) : uint32_t(c);
+        }
+
+        // the generic interpolator sums in 64 bits; the 32-bit lanes only match it when
+        // no full scale input can overflow them
+        if (sum > 65535U) {
+            firInterpolateQ15Generic(S, pSrc, pDst, blockSize);
+            return;
+        }
+    }
+
+    q15_t x[FIR_INTERP_PHASE_MAX + FIR_INTERP_CHUNK];
+    ::memcpy(x, S->pState, (phaseLen - 1U) * sizeof(q15_t));
+
+    while (blockSize > 0U) {
+        uint32_t n = (blockSize < FIR_INTERP_CHUNK) ? blockSize : FIR_INTERP_CHUNK;
+        ::memcpy(x + (phaseLen - 1U), pSrc, n * sizeof(q15_t));
+        x[phaseLen - 1U + n] = 0;
+
+        for (uint32_t j = 0U; j < L; j++) {
+            q15_t* out = pDst + j;
+
+            uint32_t i = 0U;
+            for (; (i + 4U) <= n; i += 4U) {
+                __m128i acc[4U] = { _mm_setzero_si128(), _mm_setzero_si128(), _mm_setzero_si128(), _mm_setzero_si128() };
+                firTapsSSE2(x + i, coeffs[j], 0U, taps, acc);
+
+                __m128i sum = _mm_srai_epi32(firReduceSSE2(acc[0U], acc[1U], acc[2U], acc[3U]), 15);
+                sum = _mm_packs_epi32(sum, sum);
+                out[(i + 0U) * L] = q15_t(_mm_extract_epi16(sum, 0));
+                out[(i + 1U) * L] = q15_t(_mm_extract_epi16(sum, 1));
+                out[(i + 2U) * L] = q15_t(_mm_extract_epi16(sum, 2));
+                out[(i + 3U) * L] = q15_t(_mm_extract_epi16(sum, 3));
+            }
+
+            for (; i < n; i++)
+                out[i * L] = firOutputSSE2(x + i, coeffs[j], taps);
+        }
+
+        ::memmove(x, x + n, (phaseLen - 1U) * sizeof(q15_t));
+
+        pSrc += n;
+        pDst += n * L;
+        blockSize -= n;
+    }
+
+    ::memcpy(S->pState, x, (phaseLen - 1U) * sizeof(q15_t));
+}
+#endif // defined(ARM_MATH_X86)
+
+typedef void (*FirFastQ15Fn)(const arm_fir_instance_q15*, q15_t*, q15_t*, uint32_t);
+typedef void (*FirInterpolateQ15Fn)(const arm_fir_interpolate_instance_q15*, q15_t*, q15_t*, uint32_t);
+
+struct FirKernel {
+    const char* name;
+    FirFastQ15Fn fn;
+    FirFastQ15Fn foldedFn;
+    FirInterpolateQ15Fn interpolateFn;
+};
+
+// the interpolator phases are too short to fill a 256-bit register, AVX2 uses the SSE2 one; the
+// SIMD kernels already take two taps per multiply and the 17-bit folded sums do not fit their
+// 16-bit lanes, so only the generic kernel folds symmetric filters
+const FirKernel FIR_KERNELS[ARM_FIR_KERNEL_COUNT] = {
+    { "generic", firFastQ15Generic, firFastQ15Folded, firInterpolateQ15Generic },
+#if defined(ARM_MATH_X86)
+    { "sse2", firFastQ15SSE2, NULL, firInterpolateQ15SSE2 },
+    { "avx2", firFastQ15AVX2, NULL, firInterpolateQ15SSE2 },
+#else
+    { "sse2", NULL, NULL, NULL },
+    { "avx2", NULL, NULL, NULL },
+#endif
+};
+
+/// <summary>
+/// Helper to pick the fastest FIR kernel the CPU supports.
+/// </summary>
+/// <returns></returns>
+static ARM_FIR_KERNEL firSelectKernel()
+{
+    ARM_FIR_KERNEL kernel = ARM_FIR_KERNEL_GENERIC;
+    for (uint32_t i = 0U; i < ARM_FIR_KERNEL_COUNT; i++) {
+        if (arm_fir_kernel_supported(ARM_FIR_KERNEL(i)))
+            kernel = ARM_FIR_KERNEL(i);
+    }
+
+    return kernel;
+}
+
+static ARM_FIR_KERNEL m_firKernel = firSelectKernel();
+static FirFastQ15Fn m_firFastQ15 = FIR_KERNELS[m_firKernel].fn;
+static FirFastQ15Fn m_firFastQ15Folded = FIR_KERNELS[m_firKernel].foldedFn;
+static FirInterpolateQ15Fn m_firInterpolateQ15 = FIR_KERNELS[m_firKernel].interpolateFn;
+
+/// <summary>
+/// Processing function for the Q15 FIR interpolator.
+/// </summary>
+/// <param name="S">An instance of the Q15 FIR interpolator structure.</param>
+/// <param name="pSrc">Block of input data.</param>
+/// <param name="pDst">Block of output data.</param>
+/// <param name="blockSize">Number of input samples to process per call.</param>
+void arm_fir_interpolate_q15(const arm_fir_interpolate_instance_q15* S, q15_t* pSrc, q15_t* pDst, uint32_t blockSize)
+{
+    m_firInterpolateQ15(S, pSrc, pDst, blockSize);
+}
+
+/// <summary>
+/// Processing function for the fast Q15 FIR filter for Cortex-M3 and Cortex-M4.
+/// </summary>
+/// <remarks>The filter length must be even.</remarks>
+/// <param name="S">An instance of the Q15 FIR interpolator structure.</param>
+/// <param name="pSrc">Block of input data.</param>
+/// <param name="pDst">Block of output data.</param>
+/// <param name="blockSize">Number of input samples to process per call.</param>
+void arm_fir_fast_q15(const arm_fir_instance_q15* S, q15_t* pSrc, q15_t* pDst, uint32_t blockSize)
+{
+    if (S->foldLength > 0U && m_firFastQ15Folded != NULL) {
+        m_firFastQ15Folded(S, pSrc, pDst, blockSize);
+        return;
+    }
+
+    m_firFastQ15(S, pSrc, pDst, blockSize);
+}
+
+/// <summary>
+/// Initialization function for the Q15 FIR interpolator.
+/// </summary>
+/// <param name="S">An instance of the Q15 FIR interpolator structure.</param>
+/// <param name="L">Upsample factor.</param>
+/// <param name="numTaps">Number of filter coefficients in the filter, a multiple of the upsample factor.</param>
+/// <param name="pCoeffs">Filter coefficients.</param>
+/// <param name="pState">State buffer, of length numTaps/L+blockSize-1.</param>
+/// <param name="blockSize">Number of input samples processed per call.</param>
+/// <returns>ARM_MATH_SUCCESS, or ARM_MATH_LENGTH_ERROR if the filter length is not a multiple of L.</returns>
+arm_status arm_fir_interpolate_init_q15(arm_fir_interpolate_instance_q15* S, uint8_t L, uint16_t numTaps, q15_t* pCoeffs, q15_t* pState, uint32_t blockSize)
+{
+    if (L == 0U || (numTaps % L) != 0U)
+        return ARM_MATH_LENGTH_ERROR;
+
+    S->L = L;
+    S->phaseLength = numTaps / L;
+    S->pCoeffs = pCoeffs;
+    S->pState = pState;
+    ::memset(pState, 0x00U, (S->phaseLength + (blockSize - 1U)) * sizeof(q15_t));
+
+    return ARM_MATH_SUCCESS;
+}
+
+/// <summary>
+/// Initialization function for the Q15 FIR filter.
+/// </summary>
+/// <remarks>The coefficients are checked for symmetry here, ignoring the zero padding that keeps the
+/// filter length even, so arm_fir_fast_q15 can fold a linear phase filter. The emulation only
+/// uses numTaps+blockSize-1 state words; the CMSIS init on the MCU builds clears numTaps+blockSize
+/// and its fast kernel reads that far, so state sized for both builds must hold numTaps+blockSize.</remarks>
+/// <param name="S">An instance of the Q15 FIR filter structure.</param>
+/// <param name="numTaps">Number of filter coefficients in the filter, must be even.</param>
+/// <param name="pCoeffs">Filter coefficients.</param>
+/// <param name="pState">State buffer, of at least length numTaps+blockSize-1 (numTaps+blockSize under CMSIS).</param>
+/// <param name="blockSize">Number of samples processed per call.</param>
+/// <returns>ARM_MATH_SUCCESS, or ARM_MATH_ARGUMENT_ERROR if the filter length is not even.</returns>
+arm_status arm_fir_init_q15(arm_fir_instance_q15* S, uint16_t numTaps, q15_t* pCoeffs, q15_t* pState, uint32_t blockSize)
+{
+    if (numTaps == 0U || (numTaps % 2U) != 0U)
+        return ARM_MATH_ARGUMENT_ERROR;
+
+    S->numTaps = numTaps;
+    S->pCoeffs = pCoeffs;
+    S->pState = pState;
+    ::memset(pState, 0x00U, (numTaps + (blockSize - 1U)) * sizeof(q15_t));
+
+    uint16_t start = 0U;
+    uint16_t end = numTaps;
+    while (start < end && pCoeffs[start] == 0)
+        start++;
+    while (end > start && pCoeffs[end - 1U] == 0)
+        end--;
+
+    S->foldStart = start;
+    S->foldLength = end - start;
+    for (uint16_t i = start, j = end - 1U; i < j; i++, j--) {
+        if (pCoeffs[i] != pCoeffs[j]) {
+            S->foldLength = 0U;
+            break;
+        }
+    }
+
+    return ARM_MATH_SUCCESS;
+}
+
+/// <summary>
+/// Gets the name of the given FIR kernel.
+/// </summary>
+/// <param name="kernel"></param>
+/// <returns></returns>
+const char* arm_fir_kernel_name(ARM_FIR_KERNEL kernel)
+{
+    if (kernel >= ARM_FIR_KERNEL_COUNT)
+        return "unknown";
+
+    return FIR_KERNELS[kernel].name;
+}
+
+/// <summary>
+/// Checks whether the CPU can run the given FIR kernel.
+/// </summary>
+/// <param name="kernel"></param>
+/// <returns></returns>
+bool arm_fir_kernel_supported(ARM_FIR_KERNEL kernel)
+{
+    if (kernel >= ARM_FIR_KERNEL_COUNT || FIR_KERNELS[kernel].fn == NULL)
+        return false;
+
+#if defined(ARM_MATH_X86)
+    // the CPU features are read once, ahead of the static constructors using them
+    __builtin_cpu_init();
+    switch (kernel) {
+    case ARM_FIR_KERNEL_SSE2:
+        return __builtin_cpu_supports("sse2");
+    case ARM_FIR_KERNEL_AVX2:
+        return __builtin_cpu_supports("avx2");
+    default:
+        break;
+    }
+#endif
+
+    return true;
+}
+
+/// <summary>
+/// Gets the FIR kernel arm_fir_fast_q15 dispatches to.
+/// </summary>
+/// <returns></returns>
+ARM_FIR_KERNEL arm_fir_get_kernel()
+{
+    return m_firKernel;
+}
+
+/// <summary>
+/// Sets the FIR kernel arm_fir_fast_q15 dispatches to.
+/// </summary>
+/// <remarks>This is not thread safe, it is meant to be used before any filtering starts.</remarks>
+/// <param name="kernel"></param>
+/// <returns>True, if the CPU supports the kernel, otherwise false.</returns>
+bool arm_fir_set_kernel(ARM_FIR_KERNEL kernel)
+{
+    if (!arm_fir_kernel_supported(kernel))
+        return false;
+
+    m_firKernel = kernel;
+    m_firFastQ15 = FIR_KERNELS[kernel].fn;
+    m_firFastQ15Folded = FIR_KERNELS[kernel].foldedFn;
+    m_firInterpolateQ15 = FIR_KERNELS[kernel].interpolateFn;
+    return true;
+}
+
 /// <summary>
 /// Processing function for the Q31 Biquad cascade filter
 /// </summary>
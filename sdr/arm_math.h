@@ -88,6 +88,25 @@ typedef int16_t             q15_t;
 typedef int32_t             q31_t;
 typedef int64_t             q63_t;
 
+typedef enum {
+    ARM_MATH_SUCCESS = 0,           /**< No error */
+    ARM_MATH_ARGUMENT_ERROR = -1,   /**< One or more arguments are incorrect */
+    ARM_MATH_LENGTH_ERROR = -2      /**< Length of data buffer is incorrect */
+} arm_status;
+
+// ---------------------------------------------------------------------------
+//  Constants
+// ---------------------------------------------------------------------------
+
+/** Native implementations of arm_fir_fast_q15, picked at startup by the CPU features */
+enum ARM_FIR_KERNEL {
+    ARM_FIR_KERNEL_GENERIC = 0U,
+    ARM_FIR_KERNEL_SSE2 = 1U,
+    ARM_FIR_KERNEL_AVX2 = 2U,
+
+    ARM_FIR_KERNEL_COUNT
+};
+
 // ---------------------------------------------------------------------------
 //  Structures
 // ---------------------------------------------------------------------------
@@ -96,6 +115,8 @@ typedef struct {
     uint16_t numTaps;               /**< number of filter coefficients in the filter. */
     q15_t* pState;                  /**< points to the state variable array. The array is of length numTaps+blockSize-1. */
     q15_t* pCoeffs;                 /**< points to the coefficient array. The array is of length numTaps.*/
+    uint16_t foldStart;             /**< first tap of the symmetric span of the coefficients. */
+    uint16_t foldLength;            /**< length of the symmetric span of the coefficients, zero if they are not symmetric. */
 } arm_fir_instance_q15;
 
 typedef struct {
@@ -140,6 +161,50 @@ void arm_fir_interpolate_q15(const arm_fir_interpolate_instance_q15* S, q15_t* p
 /// <param name="blockSize">Number of input samples to process per call.</param>
 void arm_fir_fast_q15(const arm_fir_instance_q15* S, q15_t* pSrc, q15_t* pDst, uint32_t blockSize);
 
+/// <summary>
+/// Initialization function for the Q15 FIR interpolator.
+/// </summary>
+/// <param name="S">An instance of the Q15 FIR interpolator structure.</param>
+/// <param name="L">Upsample factor.</param>
+/// <param name="numTaps">Number of filter coefficients in the filter, a multiple of the upsample factor.</param>
+/// <param name="pCoeffs">Filter coefficients.</param>
+/// <param name="pState">State buffer, of length numTaps/L+blockSize-1.</param>
+/// <param name="blockSize">Number of input samples processed per call.</param>
+arm_status arm_fir_interpolate_init_q15(arm_fir_interpolate_instance_q15* S, uint8_t L, uint16_t numTaps, q15_t* pCoeffs, q15_t* pState, uint32_t blockSize);
+
+/// <summary>
+/// Initialization function for the Q15 FIR filter.
+/// </summary>
+/// <param name="S">An instance of the Q15 FIR filter structure.</param>
+/// <param name="numTaps">Number of filter coefficients in the filter, must be even.</param>
+/// <param name="pCoeffs">Filter coefficients.</param>
+/// <param name="pState">State buffer, of at least length numTaps+blockSize-1 (numTaps+blockSize under CMSIS).</param>
+/// <param name="blockSize">Number of samples processed per call.</param>
+arm_status arm_fir_init_q15(arm_fir_instance_q15* S, uint16_t numTaps, q15_t* pCoeffs, q15_t* pState, uint32_t blockSize);
+
+/// <summary>
+/// Gets the name of the given FIR kernel.
+/// </summary>
+/// <param name="kernel">FIR kernel.</param>
+const char* arm_fir_kernel_name(ARM_FIR_KERNEL kernel);
+
+/// <summary>
+/// Checks whether the CPU can run the given FIR kernel.
+/// </summary>
+/// <param name="kernel">FIR kernel.</param>
+bool arm_fir_kernel_supported(ARM_FIR_KERNEL kernel);
+
+/// <summary>
+/// Gets the FIR kernel arm_fir_fast_q15 dispatches to.
+/// </summary>
+ARM_FIR_KERNEL arm_fir_get_kernel();
+
+/// <summary>
+/// Sets the FIR kernel arm_fir_fast_q15 dispatches to.
+/// </summary>
+/// <param name="kernel">FIR kernel.</param>
+bool arm_fir_set_kernel(ARM_FIR_KERNEL kernel);
+
 /// <summary>
 /// Processing function for the Q31 Biquad cascade filter
 /// </summary>
@@ -49,6 +49,44 @@ using namespace sdr::port;
 	#include <util.h>
 #endif
 
+// ---------------------------------------------------------------------------
+//  Global Functions
+// ---------------------------------------------------------------------------
+
+/// <summary>
+/// Helper to read the target of a symbolic link.
+/// </summary>
+/// <param name="path"></param>
+/// <returns>Target of the link, or an empty string if the path is not a symbolic link.</returns>
+static std::string readLink(const std::string& path)
+{
+    struct stat st;
+    if (::lstat(path.c_str(), &st) != 0 || !S_ISLNK(st.st_mode))
+        return std::string();
+
+    char target[300];
+    ssize_t len = ::readlink(path.c_str(), target, sizeof(target) - 1U);
+    if (len <= 0)
+        return std::string();
+
+    target[len] = '\0';
+    return std::string(target);
+}
+
+/// <summary>
+/// Helper to check the path is a symbolic link to a PTY slave, as made by open().
+/// </summary>
+/// <param name="path"></param>
+/// <returns>True, if the path links to a /dev/pts/ slave, otherwise false.</returns>
+static bool isSlaveLink(const std::string& path)
+{
+    std::string target = readLink(path);
+    if (target.compare(0U, 9U, "/dev/pts/") != 0 || target.size() == 9U)
+        return false;
+
+    return target.find_first_not_of("0123456789", 9U) == std::string::npos;
+}
+
 // ---------------------------------------------------------------------------
 //  Public Class Members
 // ---------------------------------------------------------------------------
@@ -60,7 +98,8 @@ using namespace sdr::port;
 /// <param name="speed">Serial port speed.</param>
 /// <param name="assertRTS"></param>
 PseudoPTYPort::PseudoPTYPort(const std::string& symlink, SERIAL_SPEEDS speed, bool assertRTS) : UARTPort(speed, assertRTS),
-    m_symlink(symlink)
+    m_symlink(symlink),
+    m_slave()
 {
     /* stub */
 }
@@ -89,8 +128,18 @@ bool PseudoPTYPort::open()
 		return false;
 	}
 
-	// remove any previous stale symlink
-	::unlink(m_symlink.c_str());
+	// only a stale link to a slave left by an earlier run is replaced; anything else at
+	// the path (such as /dev/ptmx itself) is not ours to remove
+	struct stat st;
+	if (::lstat(m_symlink.c_str(), &st) == 0) {
+		if (!isSlaveLink(m_symlink)) {
+			::LogError(LOG_DSP, "Cannot make symlink to %s with %s, the path exists and is not a PTY symlink", slave, m_symlink.c_str());
+			close();
+			return false;
+		}
+
+		::unlink(m_symlink.c_str());
+	}
 
 	int ret = ::symlink(slave, m_symlink.c_str());
 	if (ret != 0) {
@@ -100,6 +149,7 @@ bool PseudoPTYPort::open()
 	}
 
 	::LogMessage(LOG_DSP, "Made symbolic link from %s to %s", slave, m_symlink.c_str());
+	m_slave = std::string(slave);
 	m_device = std::string(::ttyname(m_fd));
 	return setTermios();
 }
@@ -110,5 +160,9 @@ bool PseudoPTYPort::open()
 void PseudoPTYPort::close()
 {
     UARTPort::close();
-    ::unlink(m_symlink.c_str());
+
+    // the link is only removed if it is still the one this port made
+    if (!m_slave.empty() && readLink(m_symlink) == m_slave)
+        ::unlink(m_symlink.c_str());
+    m_slave = std::string();
 }
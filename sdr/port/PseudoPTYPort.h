@@ -61,6 +61,7 @@ namespace sdr
 
         protected:
             std::string m_symlink;
+            std::string m_slave;            // slave device the symlink was made to
         }; // class DSP_FW_API PseudoPTYPort : public UARTPort
     } // namespace port
 } // namespace sdr
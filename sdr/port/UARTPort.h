@@ -82,6 +82,9 @@ namespace sdr
             /// <summary>Closes the connection to the serial port.</summary>
             virtual void close();
 
+            /// <summary>Gets the file descriptor of the serial port.</summary>
+            int getFd() const { return m_fd; }
+
 #if defined(__APPLE__)
             /// <summary></summary>
             virtual int setNonblock(bool nonblock);
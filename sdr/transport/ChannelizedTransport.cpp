@@ -0,0 +1,331 @@
+/**
+* Digital Voice Modem - DSP Firmware
+* GPLv2 Open Source. Use is subject to license terms.
+* DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+*
+* @package DVM / DSP Firmware
+*
+*/
+/*
+*   Copyright (C) 2022 Bryan Biedenkapp N2PLL
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 2 of the License, or
+*   (at your option) any later version.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program; if not, write to the Free Software
+*   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*/
+#include "sdr/transport/ChannelizedTransport.h"
+#include "sdr/Log.h"
+
+#include <cstring>
+#include <time.h>
+
+using namespace sdr;
+using namespace sdr::transport;
+
+// ---------------------------------------------------------------------------
+//  Constants
+// ---------------------------------------------------------------------------
+
+// size of one queued complex sample, interleaved cf32
+const uint32_t CHANNEL_SAMPLE_SIZE = 2U * sizeof(float);
+
+// ---------------------------------------------------------------------------
+//  Public Class Members
+// ---------------------------------------------------------------------------
+
+/// <summary>
+/// Initializes a new instance of the ChannelQueue class.
+/// </summary>
+ChannelQueue::ChannelQueue() :
+    m_lock(),
+    m_cond(),
+    m_data(2U * CHANNEL_QUEUE_BLOCK_SIZE * CHANNEL_QUEUE_BLOCKS, 0.0F),
+    m_length(),
+    m_lost(),
+    m_head(0U),
+    m_count(0U),
+    m_reading(0U),
+    m_pendingLost(0U),
+    m_dropped(0U),
+    m_open(false)
+{
+    ::pthread_mutex_init(&m_lock, NULL);
+
+    pthread_condattr_t attr;
+    ::pthread_condattr_init(&attr);
+    ::pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    ::pthread_cond_init(&m_cond, &attr);
+    ::pthread_condattr_destroy(&attr);
+}
+
+/// <summary>
+/// Finalizes a instance of the ChannelQueue class.
+/// </summary>
+ChannelQueue::~ChannelQueue()
+{
+    ::pthread_cond_destroy(&m_cond);
+    ::pthread_mutex_destroy(&m_lock);
+}
+
+/// <summary>
+/// Starts accepting samples, discarding anything queued.
+/// </summary>
+void ChannelQueue::open()
+{
+    ::pthread_mutex_lock(&m_lock);
+    m_head = m_count = m_reading = 0U;
+    m_pendingLost = 0U;
+    m_open = true;
+    ::pthread_mutex_unlock(&m_lock);
+}
+
+/// <summary>
+/// Stops accepting samples.
+/// </summary>
+void ChannelQueue::close()
+{
+    ::pthread_mutex_lock(&m_lock);
+    m_open = false;
+    ::pthread_cond_broadcast(&m_cond);
+    ::pthread_mutex_unlock(&m_lock);
+}
+
+/// <summary>
+/// Queues interleaved complex samples; samples that do not fit are counted as lost.
+/// </summary>
+/// <param name="samples">Interleaved cf32 samples.</param>
+/// <param name="count">Number of complex samples.</param>
+void ChannelQueue::push(const float* samples, uint32_t count)
+{
+    ::pthread_mutex_lock(&m_lock);
+    if (!m_open) {
+        ::pthread_mutex_unlock(&m_lock);
+        return;
+    }
+
+    while (count > 0U) {
+        // top up the newest block unless the Rx thread is reading it
+        uint32_t block;
+        if (m_count > m_reading && m_length[(m_head + m_count - 1U) % CHANNEL_QUEUE_BLOCKS] < CHANNEL_QUEUE_BLOCK_SIZE * CHANNEL_SAMPLE_SIZE) {
+            block = (m_head + m_count - 1U) % CHANNEL_QUEUE_BLOCKS;
+        }
+        else {
+            if (m_count >= CHANNEL_QUEUE_BLOCKS) {
+                m_dropped += count;
+                m_pendingLost += count * CHANNEL_SAMPLE_SIZE;
+                break;
+            }
+
+            block = (m_head + m_count) % CHANNEL_QUEUE_BLOCKS;
+            m_length[block] = 0U;
+            m_lost[block] = m_pendingLost;
+            m_pendingLost = 0U;
+            m_count++;
+        }
+
+        uint32_t used = m_length[block] / CHANNEL_SAMPLE_SIZE;
+        uint32_t n = CHANNEL_QUEUE_BLOCK_SIZE - used;
+        if (n > count)
+            n = count;
+
+        ::memcpy(&m_data[2U * ((block * CHANNEL_QUEUE_BLOCK_SIZE) + used)], samples, n * CHANNEL_SAMPLE_SIZE);
+        m_length[block] += n * CHANNEL_SAMPLE_SIZE;
+
+        samples += 2U * n;
+        count -= n;
+    }
+
+    ::pthread_cond_signal(&m_cond);
+    ::pthread_mutex_unlock(&m_lock);
+}
+
+/// <summary>
+/// Counts complex samples lost ahead of the wideband stream.
+/// </summary>
+/// <param name="count">Number of complex samples at the channel rate.</param>
+void ChannelQueue::lose(uint32_t count)
+{
+    ::pthread_mutex_lock(&m_lock);
+    if (m_open)
+        m_pendingLost += count * CHANNEL_SAMPLE_SIZE;
+    ::pthread_mutex_unlock(&m_lock);
+}
+
+/// <summary>
+/// Waits for queued samples; returns the number of buffers, valid until release().
+/// </summary>
+/// <param name="buffers"></param>
+/// <returns></returns>
+uint32_t ChannelQueue::read(TransportBuffer* buffers)
+{
+    timespec ts;
+    ::clock_gettime(CLOCK_MONOTONIC, &ts);
+    ts.tv_nsec += long(TRANSPORT_READ_TIMEOUT) * 1000000L;
+    if (ts.tv_nsec >= 1000000000L) {
+        ts.tv_sec++;
+        ts.tv_nsec -= 1000000000L;
+    }
+
+    ::pthread_mutex_lock(&m_lock);
+    while (m_open && m_count == 0U) {
+        if (::pthread_cond_timedwait(&m_cond, &m_lock, &ts) != 0)
+            break;
+    }
+
+    if (!m_open || m_count == 0U) {
+        ::pthread_mutex_unlock(&m_lock);
+        return 0U;
+    }
+
+    uint32_t n = (m_count < TRANSPORT_MAX_BUFFERS) ? m_count : TRANSPORT_MAX_BUFFERS;
+    for (uint32_t i = 0U; i < n; i++) {
+        uint32_t block = (m_head + i) % CHANNEL_QUEUE_BLOCKS;
+        buffers[i].data = (const uint8_t*)&m_data[2U * block * CHANNEL_QUEUE_BLOCK_SIZE];
+        buffers[i].length = m_length[block];
+        buffers[i].lost = m_lost[block];
+    }
+
+    m_reading = n;
+    ::pthread_mutex_unlock(&m_lock);
+
+    return n;
+}
+
+/// <summary>
+/// Releases the buffers returned by the last read.
+/// </summary>
+void ChannelQueue::release()
+{
+    ::pthread_mutex_lock(&m_lock);
+    m_head = (m_head + m_reading) % CHANNEL_QUEUE_BLOCKS;
+    m_count -= m_reading;
+    m_reading = 0U;
+    ::pthread_mutex_unlock(&m_lock);
+}
+
+/// <summary>
+/// Gets and clears the number of complex samples dropped since the last call.
+/// </summary>
+/// <returns></returns>
+uint32_t ChannelQueue::getDropped()
+{
+    ::pthread_mutex_lock(&m_lock);
+    uint32_t dropped = m_dropped;
+    m_dropped = 0U;
+    ::pthread_mutex_unlock(&m_lock);
+
+    return dropped;
+}
+
+/// <summary>
+/// Gets the number of queued complex samples.
+/// </summary>
+/// <returns></returns>
+uint32_t ChannelQueue::getQueued()
+{
+    ::pthread_mutex_lock(&m_lock);
+    uint32_t queued = 0U;
+    for (uint32_t i = 0U; i < m_count; i++)
+        queued += m_length[(m_head + i) % CHANNEL_QUEUE_BLOCKS] / CHANNEL_SAMPLE_SIZE;
+    ::pthread_mutex_unlock(&m_lock);
+
+    return queued;
+}
+
+/// <summary>
+/// Initializes a new instance of the ChannelizedTransport class.
+/// </summary>
+/// <param name="queue">Queue of the channel, owned by the wideband front end.</param>
+/// <param name="offset">Channel offset from the wideband center (in Hz).</param>
+/// <param name="pool">Pool Tx frames are returned to.</param>
+ChannelizedTransport::ChannelizedTransport(ChannelQueue* queue, int32_t offset, SampleFramePool* pool) :
+    m_queue(queue),
+    m_offset(offset),
+    m_pool(pool),
+    m_txDiscarded(0U)
+{
+    /* stub */
+}
+
+/// <summary>
+/// Finalizes a instance of the ChannelizedTransport class.
+/// </summary>
+ChannelizedTransport::~ChannelizedTransport()
+{
+    close();
+}
+
+/// <summary>
+/// Opens the transport.
+/// </summary>
+/// <returns></returns>
+bool ChannelizedTransport::open()
+{
+    m_queue->open();
+
+    ::LogMessage(LOG_DSP, "Receiving the wideband channel at %+d Hz, Tx is discarded", m_offset);
+    return true;
+}
+
+/// <summary>
+/// Waits for received samples; returns the number of buffers, valid until release().
+/// </summary>
+/// <param name="buffers"></param>
+/// <returns></returns>
+uint32_t ChannelizedTransport::read(TransportBuffer* buffers)
+{
+    return m_queue->read(buffers);
+}
+
+/// <summary>
+/// Releases the buffers returned by the last read.
+/// </summary>
+void ChannelizedTransport::release()
+{
+    m_queue->release();
+}
+
+/// <summary>
+/// Writes a Tx frame; the transport returns the frame to its pool once sent.
+/// </summary>
+/// <remarks>The wideband front end only receives, Tx frames are discarded.</remarks>
+/// <param name="frame"></param>
+/// <param name="length">Length in samples.</param>
+/// <returns></returns>
+bool ChannelizedTransport::write(short* frame, uint32_t length)
+{
+    m_pool->release(frame);
+    m_txDiscarded++;
+    return true;
+}
+
+/// <summary>
+/// Writes the transport statistics to the log and clears them.
+/// </summary>
+void ChannelizedTransport::logStats()
+{
+    uint32_t dropped = m_queue->getDropped();
+    uint32_t queued = m_queue->getQueued();
+
+    ::LogMessage(LOG_DSP, "Channelized transport at %+d Hz, queued = %u, dropped = %u, Tx discarded = %u", m_offset, queued, dropped, m_txDiscarded);
+    m_txDiscarded = 0U;
+}
+
+/// <summary>
+/// Closes the transport.
+/// </summary>
+void ChannelizedTransport::close()
+{
+    m_queue->release();
+    m_queue->close();
+}
@@ -0,0 +1,138 @@
+/**
+* Digital Voice Modem - DSP Firmware
+* GPLv2 Open Source. Use is subject to license terms.
+* DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+*
+* @package DVM / DSP Firmware
+*
+*/
+/*
+*   Copyright (C) 2022 Bryan Biedenkapp N2PLL
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 2 of the License, or
+*   (at your option) any later version.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program; if not, write to the Free Software
+*   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*/
+#if !defined(__CHANNELIZED_TRANSPORT_H__)
+#define __CHANNELIZED_TRANSPORT_H__
+
+#include "Defines.h"
+#include "sdr/transport/ISampleTransport.h"
+#include "sdr/SampleFramePool.h"
+
+#include <pthread.h>
+
+#include <vector>
+
+namespace sdr
+{
+    namespace transport
+    {
+        // ---------------------------------------------------------------------------
+        //  Constants
+        // ---------------------------------------------------------------------------
+
+        // complex samples per queued block, and blocks per channel; a little over a
+        // second of a 25 kHz channel before the wideband front end drops samples
+        const uint32_t CHANNEL_QUEUE_BLOCK_SIZE = 1024U;
+        const uint32_t CHANNEL_QUEUE_BLOCKS = 32U;
+
+        // ---------------------------------------------------------------------------
+        //  Class Declaration
+        //      Implements the queue of channelized cf32 samples between the
+        //      wideband front end and the Rx thread of one channel.
+        // ---------------------------------------------------------------------------
+
+        class DSP_FW_API ChannelQueue {
+        public:
+            /// <summary>Initializes a new instance of the ChannelQueue class.</summary>
+            ChannelQueue();
+            /// <summary>Finalizes a instance of the ChannelQueue class.</summary>
+            ~ChannelQueue();
+
+            /// <summary>Starts accepting samples, discarding anything queued.</summary>
+            void open();
+            /// <summary>Stops accepting samples.</summary>
+            void close();
+
+            /// <summary>Queues interleaved complex samples; samples that do not fit are counted as lost.</summary>
+            void push(const float* samples, uint32_t count);
+            /// <summary>Counts complex samples lost ahead of the wideband stream.</summary>
+            void lose(uint32_t count);
+
+            /// <summary>Waits for queued samples; returns the number of buffers, valid until release().</summary>
+            uint32_t read(TransportBuffer* buffers);
+            /// <summary>Releases the buffers returned by the last read.</summary>
+            void release();
+
+            /// <summary>Gets and clears the number of complex samples dropped since the last call.</summary>
+            uint32_t getDropped();
+            /// <summary>Gets the number of queued complex samples.</summary>
+            uint32_t getQueued();
+
+        private:
+            pthread_mutex_t m_lock;
+            pthread_cond_t m_cond;
+
+            std::vector<float> m_data;
+            uint32_t m_length[CHANNEL_QUEUE_BLOCKS];
+            uint32_t m_lost[CHANNEL_QUEUE_BLOCKS];
+            uint32_t m_head;
+            uint32_t m_count;
+            uint32_t m_reading;
+
+            uint32_t m_pendingLost;
+            uint32_t m_dropped;
+            bool m_open;
+        }; // class DSP_FW_API ChannelQueue
+
+        // ---------------------------------------------------------------------------
+        //  Class Declaration
+        //      Implements a receive only sample transport over one channel of the
+        //      wideband front end.
+        // ---------------------------------------------------------------------------
+
+        class DSP_FW_API ChannelizedTransport : public ISampleTransport {
+        public:
+            /// <summary>Initializes a new instance of the ChannelizedTransport class.</summary>
+            ChannelizedTransport(ChannelQueue* queue, int32_t offset, SampleFramePool* pool);
+            /// <summary>Finalizes a instance of the ChannelizedTransport class.</summary>
+            virtual ~ChannelizedTransport();
+
+            /// <summary>Opens the transport.</summary>
+            virtual bool open();
+
+            /// <summary>Waits for received samples; returns the number of buffers, valid until release().</summary>
+            virtual uint32_t read(TransportBuffer* buffers);
+            /// <summary>Releases the buffers returned by the last read.</summary>
+            virtual void release();
+            /// <summary>Writes a Tx frame; the transport returns the frame to its pool once sent.</summary>
+            virtual bool write(short* frame, uint32_t length);
+
+            /// <summary>Writes the transport statistics to the log and clears them.</summary>
+            virtual void logStats();
+
+            /// <summary>Closes the transport.</summary>
+            virtual void close();
+
+        private:
+            ChannelQueue* m_queue;
+            int32_t m_offset;
+            SampleFramePool* m_pool;
+
+            uint32_t m_txDiscarded;
+        }; // class DSP_FW_API ChannelizedTransport : public ISampleTransport
+    } // namespace transport
+} // namespace sdr
+
+#endif // __CHANNELIZED_TRANSPORT_H__
@@ -0,0 +1,497 @@
+/**
+* Digital Voice Modem - DSP Firmware
+* GPLv2 Open Source. Use is subject to license terms.
+* DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+*
+* @package DVM / DSP Firmware
+*
+*/
+/*
+*   Copyright (C) 2022 Bryan Biedenkapp N2PLL
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 2 of the License, or
+*   (at your option) any later version.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program; if not, write to the Free Software
+*   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*/
+#include "sdr/transport/DatagramTransport.h"
+#include "sdr/Log.h"
+
+#include <sys/un.h>
+#include <netinet/in.h>
+#include <netdb.h>
+#include <unistd.h>
+#include <cerrno>
+
+using namespace sdr;
+using namespace sdr::transport;
+
+// ---------------------------------------------------------------------------
+//  Constants
+// ---------------------------------------------------------------------------
+
+const uint32_t PACKET_SIZE = sizeof(DatagramHeader) + DGRAM_MAX_PAYLOAD;
+
+const int RX_SOCKET_BUFFER = 4 * 1024 * 1024;
+
+// upper bounds of the batch size histogram buckets; the last bucket is a full batch
+const uint32_t BATCH_BOUNDS[DGRAM_BATCH_BUCKETS] = { 1U, 3U, 7U, 15U, DGRAM_BATCH_SIZE - 1U, DGRAM_BATCH_SIZE };
+
+// ---------------------------------------------------------------------------
+//  Public Class Members
+// ---------------------------------------------------------------------------
+
+/// <summary>
+/// Initializes a new instance of the DatagramTransport class.
+/// </summary>
+/// <param name="rxAddress">udp://host:port or unix:///path address to receive on.</param>
+/// <param name="txAddress">udp://host:port or unix:///path address to send to, may be empty.</param>
+/// <param name="pool">Pool Tx frames are returned to.</param>
+DatagramTransport::DatagramTransport(const std::string& rxAddress, const std::string& txAddress, SampleFramePool* pool) :
+    m_rxAddress(rxAddress),
+    m_txAddress(txAddress),
+    m_pool(pool),
+    m_rxFd(-1),
+    m_txFd(-1),
+    m_rxPath(),
+    m_rxBuffers(NULL),
+    m_rxMsgs(),
+    m_rxIov(),
+    m_rxSynced(false),
+    m_rxSequence(0U),
+    m_txSequence(0U),
+    m_packets(0U),
+    m_batches(0U),
+    m_maxBatch(0U),
+    m_batchHist(),
+    m_lost(0U),
+    m_late(0U),
+    m_resyncs(0U),
+    m_malformed(0U),
+    m_txPackets(0U),
+    m_txBatches(0U),
+    m_txDropped(0U)
+{
+    m_rxBuffers = new uint8_t[DGRAM_BATCH_SIZE * PACKET_SIZE];
+    clearStats();
+}
+
+/// <summary>
+/// Finalizes a instance of the DatagramTransport class.
+/// </summary>
+DatagramTransport::~DatagramTransport()
+{
+    close();
+    delete[] m_rxBuffers;
+}
+
+/// <summary>
+/// Opens the transport.
+/// </summary>
+/// <returns></returns>
+bool DatagramTransport::open()
+{
+    if (!openRx())
+        return false;
+
+    if (!m_txAddress.empty() && !openTx())
+        return false;
+
+    clearStats();
+    return true;
+}
+
+/// <summary>
+/// Waits for received samples; returns the number of buffers, valid until release().
+/// </summary>
+/// <remarks>Blocks until the first packet arrives (or the receive timeout expires), then
+/// takes whatever else is already queued on the socket.</remarks>
+/// <param name="buffers"></param>
+/// <returns></returns>
+uint32_t DatagramTransport::read(TransportBuffer* buffers)
+{
+    if (m_rxFd < 0)
+        return 0U;
+
+    int n = ::recvmmsg(m_rxFd, m_rxMsgs, DGRAM_BATCH_SIZE, MSG_WAITFORONE, NULL);
+    if (n <= 0) {
+        if (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)
+            ::LogError(LOG_DSP, "DatagramTransport::read(), recvmmsg failed, err = %d", errno);
+        return 0U;
+    }
+
+    m_batches++;
+    if (uint32_t(n) > m_maxBatch)
+        m_maxBatch = uint32_t(n);
+    for (uint32_t b = 0U; b < DGRAM_BATCH_BUCKETS; b++) {
+        if (uint32_t(n) <= BATCH_BOUNDS[b]) {
+            m_batchHist[b]++;
+            break;
+        }
+    }
+
+    // validate each packet and check its sequence; unusable packets are skipped
+    uint32_t count = 0U;
+    for (int i = 0; i < n; i++) {
+        const uint8_t* packet = (const uint8_t*)m_rxIov[i].iov_base;
+        uint32_t size = m_rxMsgs[i].msg_len;
+        m_packets++;
+
+        DatagramHeader header;
+        if (size < sizeof(DatagramHeader)) {
+            m_malformed++;
+            continue;
+        }
+
+        ::memcpy(&header, packet, sizeof(DatagramHeader));
+        if (header.length > (size - sizeof(DatagramHeader))) {
+            m_malformed++;
+            continue;
+        }
+
+        uint32_t lost = 0U;
+        if (m_rxSynced) {
+            uint32_t gap = header.sequence - m_rxSequence;
+            if (gap > 0x80000000U) {
+                // behind the expected sequence, a duplicate or reordered packet
+                m_late++;
+                continue;
+            }
+
+            if (gap > DGRAM_MAX_GAP) {
+                ::LogWarning(LOG_DSP, "DatagramTransport::read(), sequence jumped by %u packets, resynchronizing", gap);
+                m_resyncs++;
+            }
+            else {
+                lost = gap;
+                m_lost += gap;
+            }
+        }
+
+        m_rxSynced = true;
+        m_rxSequence = header.sequence + 1U;
+
+        // the lost payload is estimated from the length of this packet
+        buffers[count].data = packet + sizeof(DatagramHeader);
+        buffers[count].length = header.length;
+        buffers[count].lost = lost * header.length;
+        count++;
+    }
+
+    return count;
+}
+
+/// <summary>
+/// Releases the buffers returned by the last read.
+/// </summary>
+void DatagramTransport::release()
+{
+    /* stub */
+}
+
+/// <summary>
+/// Writes a Tx frame; the transport returns the frame to its pool once sent.
+/// </summary>
+/// <param name="frame"></param>
+/// <param name="length">Length in samples.</param>
+/// <returns>True, if every packet was sent, otherwise false.</returns>
+bool DatagramTransport::write(short* frame, uint32_t length)
+{
+    bool sent = send((const uint8_t*)frame, length * sizeof(short));
+    m_pool->release(frame);
+    return sent;
+}
+
+/// <summary>
+/// Closes both sockets.
+/// </summary>
+void DatagramTransport::close()
+{
+    if (m_rxFd >= 0) {
+        ::close(m_rxFd);
+        m_rxFd = -1;
+    }
+
+    if (!m_rxPath.empty()) {
+        ::unlink(m_rxPath.c_str());
+        m_rxPath.clear();
+    }
+
+    if (m_txFd >= 0) {
+        ::close(m_txFd);
+        m_txFd = -1;
+    }
+}
+
+/// <summary>
+/// Sends a buffer, split into as many packets as needed, in one batch.
+/// </summary>
+/// <param name="data"></param>
+/// <param name="length">Length in bytes.</param>
+/// <returns>True, if every packet was sent, otherwise false.</returns>
+bool DatagramTransport::send(const uint8_t* data, uint32_t length)
+{
+    if (m_txFd < 0)
+        return false;
+
+    DatagramHeader headers[DGRAM_BATCH_SIZE];
+    iovec iov[DGRAM_BATCH_SIZE * 2U];
+    mmsghdr msgs[DGRAM_BATCH_SIZE];
+
+    bool sent = true;
+    uint32_t offset = 0U;
+    while (offset < length) {
+        uint32_t count = 0U;
+        while (offset < length && count < DGRAM_BATCH_SIZE) {
+            uint32_t n = length - offset;
+            if (n > DGRAM_MAX_PAYLOAD)
+                n = DGRAM_MAX_PAYLOAD;
+
+            headers[count].sequence = m_txSequence++;
+            headers[count].length = uint16_t(n);
+            headers[count].reserved = 0U;
+
+            // gather the header and payload, the payload is not copied
+            iov[count * 2U].iov_base = &headers[count];
+            iov[count * 2U].iov_len = sizeof(DatagramHeader);
+            iov[(count * 2U) + 1U].iov_base = (void*)(data + offset);
+            iov[(count * 2U) + 1U].iov_len = n;
+
+            ::memset(&msgs[count], 0x00U, sizeof(mmsghdr));
+            msgs[count].msg_hdr.msg_iov = &iov[count * 2U];
+            msgs[count].msg_hdr.msg_iovlen = 2U;
+
+            offset += n;
+            count++;
+        }
+
+        int n = ::sendmmsg(m_txFd, msgs, count, MSG_DONTWAIT);
+        m_txBatches++;
+        if (n > 0)
+            m_txPackets += uint32_t(n);
+
+        if (n < int(count)) {
+            // the sequence numbers were spent, the receiver sees the rest as lost
+            m_txDropped += count - uint32_t((n > 0) ? n : 0);
+            sent = false;
+        }
+    }
+
+    return sent;
+}
+
+/// <summary>
+/// Writes the transport statistics to the log and clears them.
+/// </summary>
+void DatagramTransport::logStats()
+{
+    char hist[256U];
+    int len = 0;
+    for (uint32_t i = 0U; i < DGRAM_BATCH_BUCKETS && len < (int)sizeof(hist); i++) {
+        uint32_t low = (i == 0U) ? 1U : (BATCH_BOUNDS[i - 1U] + 1U);
+        len += ::snprintf(hist + len, sizeof(hist) - len, "%s%u-%u: %u", (i == 0U) ? "" : ", ", low, BATCH_BOUNDS[i], m_batchHist[i]);
+    }
+
+    float mean = (m_batches > 0U) ? float(m_packets) / float(m_batches) : 0.0F;
+    ::LogMessage(LOG_DSP, "Datagram Rx, packets = %llu, batches = %u, mean batch = %.2f, max batch = %u, lost = %u, late = %u, resyncs = %u, malformed = %u",
+        (unsigned long long)m_packets, m_batches, mean, m_maxBatch, m_lost, m_late, m_resyncs, m_malformed);
+    ::LogMessage(LOG_DSP, "Datagram Rx batch sizes, %s", hist);
+    ::LogMessage(LOG_DSP, "Datagram Tx, packets = %llu, batches = %u, dropped = %u", (unsigned long long)m_txPackets, m_txBatches, m_txDropped);
+
+    clearStats();
+}
+
+/// <summary>
+/// Clears the transport statistics.
+/// </summary>
+void DatagramTransport::clearStats()
+{
+    m_packets = 0U;
+    m_batches = 0U;
+    m_maxBatch = 0U;
+    for (uint32_t i = 0U; i < DGRAM_BATCH_BUCKETS; i++)
+        m_batchHist[i] = 0U;
+    m_lost = 0U;
+    m_late = 0U;
+    m_resyncs = 0U;
+    m_malformed = 0U;
+    m_txPackets = 0U;
+    m_txBatches = 0U;
+    m_txDropped = 0U;
+}
+
+/// <summary>
+/// Helper to check whether an endpoint is a datagram address.
+/// </summary>
+/// <param name="address"></param>
+/// <returns></returns>
+bool DatagramTransport::isDatagram(const std::string& address)
+{
+    return hasScheme(address, "udp://") || hasScheme(address, "unix://");
+}
+
+// ---------------------------------------------------------------------------
+//  Private Class Members
+// ---------------------------------------------------------------------------
+
+/// <summary>
+/// Helper to bind the receive socket.
+/// </summary>
+/// <returns>True, if the socket was bound, otherwise false.</returns>
+bool DatagramTransport::openRx()
+{
+    if (m_rxFd >= 0) {
+        ::close(m_rxFd);
+        m_rxFd = -1;
+    }
+
+    m_rxFd = openSocket(m_rxAddress, true);
+    if (m_rxFd < 0)
+        return false;
+
+    int size = RX_SOCKET_BUFFER;
+    ::setsockopt(m_rxFd, SOL_SOCKET, SO_RCVBUF, &size, sizeof(size));
+
+    timeval tv;
+    tv.tv_sec = 0;
+    tv.tv_usec = long(TRANSPORT_READ_TIMEOUT) * 1000L;
+    ::setsockopt(m_rxFd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+
+    for (uint32_t i = 0U; i < DGRAM_BATCH_SIZE; i++) {
+        m_rxIov[i].iov_base = m_rxBuffers + (i * PACKET_SIZE);
+        m_rxIov[i].iov_len = PACKET_SIZE;
+
+        ::memset(&m_rxMsgs[i], 0x00U, sizeof(mmsghdr));
+        m_rxMsgs[i].msg_hdr.msg_iov = &m_rxIov[i];
+        m_rxMsgs[i].msg_hdr.msg_iovlen = 1U;
+    }
+
+    m_rxSynced = false;
+
+    ::LogMessage(LOG_DSP, "Receiving sample datagrams on %s", m_rxAddress.c_str());
+    return true;
+}
+
+/// <summary>
+/// Helper to connect the transmit socket.
+/// </summary>
+/// <returns>True, if the socket was connected, otherwise false.</returns>
+bool DatagramTransport::openTx()
+{
+    if (m_txFd >= 0) {
+        ::close(m_txFd);
+        m_txFd = -1;
+    }
+
+    m_txFd = openSocket(m_txAddress, false);
+    if (m_txFd < 0)
+        return false;
+
+    m_txSequence = 0U;
+
+    ::LogMessage(LOG_DSP, "Sending sample datagrams to %s", m_txAddress.c_str());
+    return true;
+}
+
+/// <summary>
+/// Helper to open a datagram socket for the given address.
+/// </summary>
+/// <param name="address">udp://host:port or unix:///path address.</param>
+/// <param name="bind">Flag indicating whether to bind to (rather than connect to) the address.</param>
+/// <returns>Socket descriptor, or -1 on failure.</returns>
+int DatagramTransport::openSocket(const std::string& address, bool bind)
+{
+    if (address.compare(0U, 7U, "unix://") == 0) {
+        std::string path = address.substr(7U);
+
+        sockaddr_un addr;
+        ::memset(&addr, 0x00U, sizeof(addr));
+        addr.sun_family = AF_UNIX;
+        if (path.empty() || path.length() >= sizeof(addr.sun_path)) {
+            ::LogError(LOG_DSP, "DatagramTransport::openSocket(), invalid Unix socket path %s", address.c_str());
+            return -1;
+        }
+        ::strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path) - 1U);
+
+        int fd = ::socket(AF_UNIX, SOCK_DGRAM, 0);
+        if (fd < 0) {
+            ::LogError(LOG_DSP, "DatagramTransport::openSocket(), failed to create socket, err = %d", errno);
+            return -1;
+        }
+
+        int ret = 0;
+        if (bind) {
+            ::unlink(path.c_str());
+            ret = ::bind(fd, (sockaddr*)&addr, sizeof(addr));
+            if (ret == 0)
+                m_rxPath = path;
+        }
+        else {
+            ret = ::connect(fd, (sockaddr*)&addr, sizeof(addr));
+        }
+
+        if (ret != 0) {
+            ::LogError(LOG_DSP, "DatagramTransport::openSocket(), failed to %s %s, err = %d", bind ? "bind" : "connect", address.c_str(), errno);
+            ::close(fd);
+            return -1;
+        }
+
+        return fd;
+    }
+
+    // udp://host:port, with IPv6 hosts in brackets
+    std::string hostPort = address.substr(6U);
+    size_t colon = hostPort.rfind(':');
+    if (colon == std::string::npos) {
+        ::LogError(LOG_DSP, "DatagramTransport::openSocket(), missing port in %s", address.c_str());
+        return -1;
+    }
+
+    std::string host = hostPort.substr(0U, colon);
+    std::string port = hostPort.substr(colon + 1U);
+    if (host.length() >= 2U && host[0U] == '[' && host[host.length() - 1U] == ']')
+        host = host.substr(1U, host.length() - 2U);
+
+    addrinfo hints;
+    ::memset(&hints, 0x00U, sizeof(hints));
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_DGRAM;
+    hints.ai_flags = bind ? AI_PASSIVE : 0;
+
+    addrinfo* res = NULL;
+    int err = ::getaddrinfo(host.empty() ? NULL : host.c_str(), port.c_str(), &hints, &res);
+    if (err != 0) {
+        ::LogError(LOG_DSP, "DatagramTransport::openSocket(), failed to resolve %s, %s", address.c_str(), ::gai_strerror(err));
+        return -1;
+    }
+
+    int fd = -1;
+    for (addrinfo* ai = res; ai != NULL; ai = ai->ai_next) {
+        fd = ::socket(ai->ai_family, ai->ai_socktype, ai->ai_protocol);
+        if (fd < 0)
+            continue;
+
+        int ret = bind ? ::bind(fd, ai->ai_addr, ai->ai_addrlen) : ::connect(fd, ai->ai_addr, ai->ai_addrlen);
+        if (ret == 0)
+            break;
+
+        ::close(fd);
+        fd = -1;
+    }
+
+    ::freeaddrinfo(res);
+
+    if (fd < 0)
+        ::LogError(LOG_DSP, "DatagramTransport::openSocket(), failed to %s %s, err = %d", bind ? "bind" : "connect", address.c_str(), errno);
+
+    return fd;
+}
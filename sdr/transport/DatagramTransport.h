@@ -0,0 +1,151 @@
+/**
+* Digital Voice Modem - DSP Firmware
+* GPLv2 Open Source. Use is subject to license terms.
+* DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+*
+* @package DVM / DSP Firmware
+*
+*/
+/*
+*   Copyright (C) 2022 Bryan Biedenkapp N2PLL
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 2 of the License, or
+*   (at your option) any later version.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program; if not, write to the Free Software
+*   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*/
+#if !defined(__DATAGRAM_TRANSPORT_H__)
+#define __DATAGRAM_TRANSPORT_H__
+
+#include "Defines.h"
+#include "sdr/transport/ISampleTransport.h"
+#include "sdr/SampleFramePool.h"
+
+#include <sys/socket.h>
+#include <sys/uio.h>
+
+namespace sdr
+{
+    namespace transport
+    {
+        // ---------------------------------------------------------------------------
+        //  Constants
+        // ---------------------------------------------------------------------------
+
+        // packets moved per recvmmsg/sendmmsg call
+        const uint32_t DGRAM_BATCH_SIZE = TRANSPORT_MAX_BUFFERS;
+
+        // payload bytes per packet; fits an Ethernet MTU with the UDP/IP headers and is
+        // a multiple of every sample size so no sample is split across packets
+        const uint32_t DGRAM_MAX_PAYLOAD = 1440U;
+
+        // a sequence jump larger than this many packets resynchronizes instead of filling
+        const uint32_t DGRAM_MAX_GAP = 64U;
+
+        const uint32_t DGRAM_BATCH_BUCKETS = 6U;
+
+        // ---------------------------------------------------------------------------
+        //  Structure Declaration
+        //      Header at the start of every sample packet, in host byte order.
+        // ---------------------------------------------------------------------------
+
+        struct DatagramHeader {
+            uint32_t sequence;                  // packet counter, wraps
+            uint16_t length;                    // payload length in bytes
+            uint16_t reserved;
+        };
+
+        // ---------------------------------------------------------------------------
+        //  Class Declaration
+        //      Implements a UDP or Unix datagram sample transport that moves a batch
+        //      of packets per system call with recvmmsg/sendmmsg, detecting lost
+        //      packets from a sequence number in every packet.
+        // ---------------------------------------------------------------------------
+
+        class DSP_FW_API DatagramTransport : public ISampleTransport {
+        public:
+            /// <summary>Initializes a new instance of the DatagramTransport class.</summary>
+            DatagramTransport(const std::string& rxAddress, const std::string& txAddress, SampleFramePool* pool);
+            /// <summary>Finalizes a instance of the DatagramTransport class.</summary>
+            virtual ~DatagramTransport();
+
+            /// <summary>Opens the transport.</summary>
+            virtual bool open();
+
+            /// <summary>Waits for received samples; returns the number of buffers, valid until release().</summary>
+            virtual uint32_t read(TransportBuffer* buffers);
+            /// <summary>Releases the buffers returned by the last read.</summary>
+            virtual void release();
+            /// <summary>Writes a Tx frame; the transport returns the frame to its pool once sent.</summary>
+            virtual bool write(short* frame, uint32_t length);
+
+            /// <summary>Writes the transport statistics to the log and clears them.</summary>
+            virtual void logStats();
+
+            /// <summary>Closes the transport.</summary>
+            virtual void close();
+
+            /// <summary>Sends a buffer, split into as many packets as needed, in one batch.</summary>
+            bool send(const uint8_t* data, uint32_t length);
+
+            /// <summary>Gets the number of packets received.</summary>
+            uint64_t getPackets() const { return m_packets; }
+            /// <summary>Gets the number of receive calls that returned packets.</summary>
+            uint32_t getBatches() const { return m_batches; }
+            /// <summary>Gets the number of packets lost.</summary>
+            uint32_t getLost() const { return m_lost; }
+            /// <summary>Clears the transport statistics.</summary>
+            void clearStats();
+
+            /// <summary>Helper to check whether an endpoint is a datagram address.</summary>
+            static bool isDatagram(const std::string& address);
+
+        private:
+            std::string m_rxAddress;
+            std::string m_txAddress;
+            SampleFramePool* m_pool;
+
+            int m_rxFd;
+            int m_txFd;
+            std::string m_rxPath;
+
+            uint8_t* m_rxBuffers;
+            mmsghdr m_rxMsgs[DGRAM_BATCH_SIZE];
+            iovec m_rxIov[DGRAM_BATCH_SIZE];
+
+            bool m_rxSynced;
+            uint32_t m_rxSequence;
+            uint32_t m_txSequence;
+
+            uint64_t m_packets;
+            uint32_t m_batches;
+            uint32_t m_maxBatch;
+            uint32_t m_batchHist[DGRAM_BATCH_BUCKETS];
+            uint32_t m_lost;
+            uint32_t m_late;
+            uint32_t m_resyncs;
+            uint32_t m_malformed;
+            uint64_t m_txPackets;
+            uint32_t m_txBatches;
+            uint32_t m_txDropped;
+
+            /// <summary>Helper to bind the receive socket.</summary>
+            bool openRx();
+            /// <summary>Helper to connect the transmit socket.</summary>
+            bool openTx();
+            /// <summary>Helper to open a datagram socket for the given address.</summary>
+            int openSocket(const std::string& address, bool bind);
+        }; // class DSP_FW_API DatagramTransport : public ISampleTransport
+    } // namespace transport
+} // namespace sdr
+
+#endif // __DATAGRAM_TRANSPORT_H__
@@ -0,0 +1,258 @@
+/**
+* Digital Voice Modem - DSP Firmware
+* GPLv2 Open Source. Use is subject to license terms.
+* DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+*
+* @package DVM / DSP Firmware
+*
+*/
+/*
+*   Copyright (C) 2022 Bryan Biedenkapp N2PLL
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 2 of the License, or
+*   (at your option) any later version.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program; if not, write to the Free Software
+*   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*/
+#include "sdr/transport/FileTransport.h"
+#include "sdr/Log.h"
+
+#include <cerrno>
+
+using namespace sdr;
+using namespace sdr::transport;
+
+// ---------------------------------------------------------------------------
+//  Constants
+// ---------------------------------------------------------------------------
+
+const int64_t NSEC_PER_SEC = 1000000000LL;
+
+// ---------------------------------------------------------------------------
+//  Public Class Members
+// ---------------------------------------------------------------------------
+
+/// <summary>
+/// Initializes a new instance of the FileTransport class.
+/// </summary>
+/// <param name="rxPath">file:// path to read Rx samples from, may be empty.</param>
+/// <param name="txPath">file:// path to write Tx samples to, may be empty.</param>
+/// <param name="rxSampleRate">Sample rate of the Rx file.</param>
+/// <param name="sampleSize">Size (in bytes) of a Rx sample.</param>
+/// <param name="pool">Pool Tx frames are returned to.</param>
+/// <param name="paced">Flag indicating Rx samples are delivered in real time rather than as fast as they are read.</param>
+FileTransport::FileTransport(const std::string& rxPath, const std::string& txPath, uint32_t rxSampleRate, uint32_t sampleSize, SampleFramePool* pool, bool paced) :
+    m_rxPath(getPath(rxPath)),
+    m_txPath(getPath(txPath)),
+    m_rxSampleRate(rxSampleRate),
+    m_sampleSize(sampleSize),
+    m_pool(pool),
+    m_paced(paced),
+    m_rxFile(NULL),
+    m_txFile(NULL),
+    m_block(NULL),
+    m_blockLength(0U),
+    m_eof(false),
+    m_anchored(false),
+    m_epoch(),
+    m_blocks(0U),
+    m_rxBytes(0U),
+    m_txBytes(0U),
+    m_txErrors(0U)
+{
+    m_blockLength = ((m_rxSampleRate * FILE_BLOCK_TIME) / 1000U) * m_sampleSize;
+    m_block = new uint8_t[m_blockLength];
+}
+
+/// <summary>
+/// Finalizes a instance of the FileTransport class.
+/// </summary>
+FileTransport::~FileTransport()
+{
+    close();
+    delete[] m_block;
+}
+
+/// <summary>
+/// Opens the transport.
+/// </summary>
+/// <returns></returns>
+bool FileTransport::open()
+{
+    close();
+
+    if (!m_rxPath.empty()) {
+        m_rxFile = ::fopen(m_rxPath.c_str(), "rb");
+        if (m_rxFile == NULL) {
+            ::LogError(LOG_DSP, "FileTransport::open(), failed to open %s, err = %d", m_rxPath.c_str(), errno);
+            return false;
+        }
+
+        ::LogMessage(LOG_DSP, "Reading Rx samples from %s%s", m_rxPath.c_str(), m_paced ? "" : ", unpaced");
+    }
+
+    if (!m_txPath.empty()) {
+        m_txFile = ::fopen(m_txPath.c_str(), "wb");
+        if (m_txFile == NULL) {
+            ::LogError(LOG_DSP, "FileTransport::open(), failed to create %s, err = %d", m_txPath.c_str(), errno);
+            close();
+            return false;
+        }
+
+        ::LogMessage(LOG_DSP, "Writing Tx samples to %s", m_txPath.c_str());
+    }
+
+    m_eof = false;
+    m_anchored = false;
+    m_blocks = 0U;
+    return true;
+}
+
+/// <summary>
+/// Waits for received samples; returns the number of buffers, valid until release().
+/// </summary>
+/// <remarks>When paced, each block is held until the time it would have arrived from a
+/// live SDR, so the DSP sees the same timing as on air.</remarks>
+/// <param name="buffers"></param>
+/// <returns></returns>
+uint32_t FileTransport::read(TransportBuffer* buffers)
+{
+    if (m_rxFile == NULL || m_eof) {
+        timespec ts;
+        ts.tv_sec = 0;
+        ts.tv_nsec = long(TRANSPORT_READ_TIMEOUT) * 1000000L;
+        ::clock_nanosleep(CLOCK_MONOTONIC, 0, &ts, NULL);
+        return 0U;
+    }
+
+    size_t n = ::fread(m_block, 1U, m_blockLength, m_rxFile);
+    n -= n % m_sampleSize;
+    if (n == 0U) {
+        ::LogMessage(LOG_DSP, "End of Rx file %s, %llu bytes read", m_rxPath.c_str(), (unsigned long long)m_rxBytes);
+        m_eof = true;
+        return 0U;
+    }
+
+    if (m_paced) {
+        if (!m_anchored) {
+            ::clock_gettime(CLOCK_MONOTONIC, &m_epoch);
+            m_anchored = true;
+        }
+
+        // a block is due once the block before it would have been played out
+        int64_t due = (int64_t(m_blocks) * int64_t(FILE_BLOCK_TIME) * NSEC_PER_SEC) / 1000;
+        timespec ts = m_epoch;
+        ts.tv_sec += time_t(due / NSEC_PER_SEC);
+        ts.tv_nsec += long(due % NSEC_PER_SEC);
+        if (ts.tv_nsec >= NSEC_PER_SEC) {
+            ts.tv_sec++;
+            ts.tv_nsec -= NSEC_PER_SEC;
+        }
+
+        while (::clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) == EINTR)
+            ;
+    }
+
+    m_blocks++;
+    m_rxBytes += n;
+
+    buffers[0U].data = m_block;
+    buffers[0U].length = uint32_t(n);
+    buffers[0U].lost = 0U;
+    return 1U;
+}
+
+/// <summary>
+/// Releases the buffers returned by the last read.
+/// </summary>
+void FileTransport::release()
+{
+    /* stub */
+}
+
+/// <summary>
+/// Writes a Tx frame; the transport returns the frame to its pool once sent.
+/// </summary>
+/// <param name="frame"></param>
+/// <param name="length">Length in samples.</param>
+/// <returns>True, if the frame was written, otherwise false.</returns>
+bool FileTransport::write(short* frame, uint32_t length)
+{
+    bool written = true;
+    if (m_txFile != NULL) {
+        size_t n = ::fwrite(frame, sizeof(short), length, m_txFile);
+        m_txBytes += n * sizeof(short);
+        if (n < length) {
+            m_txErrors++;
+            written = false;
+        }
+    }
+
+    m_pool->release(frame);
+    return written;
+}
+
+/// <summary>
+/// Writes the transport statistics to the log and clears them.
+/// </summary>
+void FileTransport::logStats()
+{
+    ::LogMessage(LOG_DSP, "File transport, Rx bytes = %llu, Tx bytes = %llu, Tx errors = %u%s", (unsigned long long)m_rxBytes,
+        (unsigned long long)m_txBytes, m_txErrors, m_eof ? ", Rx at end of file" : "");
+
+    m_rxBytes = 0U;
+    m_txBytes = 0U;
+    m_txErrors = 0U;
+}
+
+/// <summary>
+/// Closes the transport.
+/// </summary>
+void FileTransport::close()
+{
+    if (m_rxFile != NULL) {
+        ::fclose(m_rxFile);
+        m_rxFile = NULL;
+    }
+
+    if (m_txFile != NULL) {
+        ::fclose(m_txFile);
+        m_txFile = NULL;
+    }
+}
+
+/// <summary>
+/// Helper to check whether an endpoint is a file path.
+/// </summary>
+/// <param name="endpoint"></param>
+/// <returns></returns>
+bool FileTransport::isFile(const std::string& endpoint)
+{
+    return hasScheme(endpoint, "file://");
+}
+
+// ---------------------------------------------------------------------------
+//  Private Class Members
+// ---------------------------------------------------------------------------
+
+/// <summary>
+/// Helper to strip the file:// scheme from an endpoint.
+/// </summary>
+/// <param name="endpoint"></param>
+/// <returns></returns>
+std::string FileTransport::getPath(const std::string& endpoint)
+{
+    if (!isFile(endpoint))
+        return endpoint;
+
+    return endpoint.substr(7U);
+}
@@ -0,0 +1,112 @@
+/**
+* Digital Voice Modem - DSP Firmware
+* GPLv2 Open Source. Use is subject to license terms.
+* DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+*
+* @package DVM / DSP Firmware
+*
+*/
+/*
+*   Copyright (C) 2022 Bryan Biedenkapp N2PLL
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 2 of the License, or
+*   (at your option) any later version.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program; if not, write to the Free Software
+*   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*/
+#if !defined(__FILE_TRANSPORT_H__)
+#define __FILE_TRANSPORT_H__
+
+#include "Defines.h"
+#include "sdr/transport/ISampleTransport.h"
+#include "sdr/SampleFramePool.h"
+
+#include <cstdio>
+#include <time.h>
+
+namespace sdr
+{
+    namespace transport
+    {
+        // ---------------------------------------------------------------------------
+        //  Constants
+        // ---------------------------------------------------------------------------
+
+        // length of a block read from the Rx file, in milliseconds
+        const uint32_t FILE_BLOCK_TIME = 10U;
+
+        // ---------------------------------------------------------------------------
+        //  Class Declaration
+        //      Implements a sample transport that reads raw Rx samples from a file
+        //      and writes raw Tx samples to a file, in the same sample format as the
+        //      SDR front end would use.
+        // ---------------------------------------------------------------------------
+
+        class DSP_FW_API FileTransport : public ISampleTransport {
+        public:
+            /// <summary>Initializes a new instance of the FileTransport class.</summary>
+            FileTransport(const std::string& rxPath, const std::string& txPath, uint32_t rxSampleRate, uint32_t sampleSize, SampleFramePool* pool, bool paced = true);
+            /// <summary>Finalizes a instance of the FileTransport class.</summary>
+            virtual ~FileTransport();
+
+            /// <summary>Opens the transport.</summary>
+            virtual bool open();
+
+            /// <summary>Waits for received samples; returns the number of buffers, valid until release().</summary>
+            virtual uint32_t read(TransportBuffer* buffers);
+            /// <summary>Releases the buffers returned by the last read.</summary>
+            virtual void release();
+            /// <summary>Writes a Tx frame; the transport returns the frame to its pool once sent.</summary>
+            virtual bool write(short* frame, uint32_t length);
+
+            /// <summary>Writes the transport statistics to the log and clears them.</summary>
+            virtual void logStats();
+
+            /// <summary>Closes the transport.</summary>
+            virtual void close();
+
+            /// <summary>Flag indicating the whole Rx file has been read.</summary>
+            bool isEOF() const { return m_eof; }
+
+            /// <summary>Helper to check whether an endpoint is a file path.</summary>
+            static bool isFile(const std::string& endpoint);
+
+        private:
+            std::string m_rxPath;
+            std::string m_txPath;
+            uint32_t m_rxSampleRate;
+            uint32_t m_sampleSize;
+            SampleFramePool* m_pool;
+            bool m_paced;
+
+            FILE* m_rxFile;
+            FILE* m_txFile;
+
+            uint8_t* m_block;
+            uint32_t m_blockLength;
+
+            bool m_eof;
+            bool m_anchored;
+            timespec m_epoch;
+            uint64_t m_blocks;
+
+            uint64_t m_rxBytes;
+            uint64_t m_txBytes;
+            uint32_t m_txErrors;
+
+            /// <summary>Helper to strip the file:// scheme from an endpoint.</summary>
+            static std::string getPath(const std::string& endpoint);
+        }; // class DSP_FW_API FileTransport : public ISampleTransport
+    } // namespace transport
+} // namespace sdr
+
+#endif // __FILE_TRANSPORT_H__
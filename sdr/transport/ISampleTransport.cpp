@@ -0,0 +1,51 @@
+/**
+* Digital Voice Modem - DSP Firmware
+* GPLv2 Open Source. Use is subject to license terms.
+* DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+*
+* @package DVM / DSP Firmware
+*
+*/
+/*
+*   Copyright (C) 2022 Bryan Biedenkapp N2PLL
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 2 of the License, or
+*   (at your option) any later version.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program; if not, write to the Free Software
+*   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*/
+#include "sdr/transport/ISampleTransport.h"
+
+using namespace sdr::transport;
+
+// ---------------------------------------------------------------------------
+//  Public Class Members
+// ---------------------------------------------------------------------------
+
+/// <summary>
+/// Finalizes a instance of the ISampleTransport class.
+/// </summary>
+ISampleTransport::~ISampleTransport()
+{
+    /* stub */
+}
+
+/// <summary>
+/// Helper to check whether an endpoint uses the given scheme.
+/// </summary>
+/// <param name="endpoint">Endpoint (e.g. "udp://host:port").</param>
+/// <param name="scheme">Scheme including the separator (e.g. "udp://").</param>
+/// <returns></returns>
+bool ISampleTransport::hasScheme(const std::string& endpoint, const char* scheme)
+{
+    return endpoint.compare(0U, ::strlen(scheme), scheme) == 0;
+}
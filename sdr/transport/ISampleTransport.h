@@ -0,0 +1,90 @@
+/**
+* Digital Voice Modem - DSP Firmware
+* GPLv2 Open Source. Use is subject to license terms.
+* DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+*
+* @package DVM / DSP Firmware
+*
+*/
+/*
+*   Copyright (C) 2022 Bryan Biedenkapp N2PLL
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 2 of the License, or
+*   (at your option) any later version.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program; if not, write to the Free Software
+*   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*/
+#if !defined(__I_SAMPLE_TRANSPORT_H__)
+#define __I_SAMPLE_TRANSPORT_H__
+
+#include "Defines.h"
+
+#include <string>
+
+namespace sdr
+{
+    namespace transport
+    {
+        // ---------------------------------------------------------------------------
+        //  Constants
+        // ---------------------------------------------------------------------------
+
+        // most buffers a single read can return
+        const uint32_t TRANSPORT_MAX_BUFFERS = 32U;
+
+        // how long a read waits for samples before returning empty, in milliseconds
+        const uint32_t TRANSPORT_READ_TIMEOUT = 100U;
+
+        // ---------------------------------------------------------------------------
+        //  Structure Declaration
+        //      Received payload handed out by a sample transport.
+        // ---------------------------------------------------------------------------
+
+        struct TransportBuffer {
+            const uint8_t* data;
+            uint32_t length;                    // payload length in bytes
+            uint32_t lost;                      // bytes lost immediately before this payload
+        };
+
+        // ---------------------------------------------------------------------------
+        //  Class Declaration
+        //      Defines a sample transport between the DSP and the SDR front end.
+        // ---------------------------------------------------------------------------
+
+        class DSP_FW_API ISampleTransport {
+        public:
+            /// <summary>Finalizes a instance of the ISampleTransport class.</summary>
+            virtual ~ISampleTransport() = 0;
+
+            /// <summary>Opens the transport.</summary>
+            virtual bool open() = 0;
+
+            /// <summary>Waits for received samples; returns the number of buffers, valid until release().</summary>
+            virtual uint32_t read(TransportBuffer* buffers) = 0;
+            /// <summary>Releases the buffers returned by the last read.</summary>
+            virtual void release() = 0;
+            /// <summary>Writes a Tx frame; the transport returns the frame to its pool once sent.</summary>
+            virtual bool write(short* frame, uint32_t length) = 0;
+
+            /// <summary>Writes the transport statistics to the log and clears them.</summary>
+            virtual void logStats() = 0;
+
+            /// <summary>Closes the transport.</summary>
+            virtual void close() = 0;
+
+            /// <summary>Helper to check whether an endpoint uses the given scheme.</summary>
+            static bool hasScheme(const std::string& endpoint, const char* scheme);
+        }; // class DSP_FW_API ISampleTransport
+    } // namespace transport
+} // namespace sdr
+
+#endif // __I_SAMPLE_TRANSPORT_H__
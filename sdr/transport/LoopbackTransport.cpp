@@ -0,0 +1,212 @@
+/**
+* Digital Voice Modem - DSP Firmware
+* GPLv2 Open Source. Use is subject to license terms.
+* DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+*
+* @package DVM / DSP Firmware
+*
+*/
+/*
+*   Copyright (C) 2022 Bryan Biedenkapp N2PLL
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 2 of the License, or
+*   (at your option) any later version.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program; if not, write to the Free Software
+*   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*/
+#include "sdr/transport/LoopbackTransport.h"
+#include "sdr/Log.h"
+
+#include <time.h>
+
+using namespace sdr;
+using namespace sdr::transport;
+
+// ---------------------------------------------------------------------------
+//  Constants
+// ---------------------------------------------------------------------------
+
+// the Tx path amplifies the 12-bit DAC samples by 12 dB, the loop undoes it so the
+// Rx path sees the same levels a 12-bit ADC would deliver
+const short LOOPBACK_ATTENUATION = 5;
+
+// frames queued before Tx overruns; queued frames are held out of the Tx frame pool, so
+// this stays well below the pool size when the Rx thread stalls
+const uint32_t LOOPBACK_MAX_FRAMES = 8U;
+
+// ---------------------------------------------------------------------------
+//  Public Class Members
+// ---------------------------------------------------------------------------
+
+/// <summary>
+/// Initializes a new instance of the LoopbackTransport class.
+/// </summary>
+/// <param name="pool">Pool Tx frames are returned to.</param>
+LoopbackTransport::LoopbackTransport(SampleFramePool* pool) :
+    m_pool(pool),
+    m_lock(),
+    m_cond(),
+    m_queue(),
+    m_current(NULL),
+    m_frames(0U)
+{
+    ::pthread_mutex_init(&m_lock, NULL);
+
+    pthread_condattr_t attr;
+    ::pthread_condattr_init(&attr);
+    ::pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    ::pthread_cond_init(&m_cond, &attr);
+    ::pthread_condattr_destroy(&attr);
+}
+
+/// <summary>
+/// Finalizes a instance of the LoopbackTransport class.
+/// </summary>
+LoopbackTransport::~LoopbackTransport()
+{
+    close();
+
+    ::pthread_cond_destroy(&m_cond);
+    ::pthread_mutex_destroy(&m_lock);
+}
+
+/// <summary>
+/// Opens the transport.
+/// </summary>
+/// <returns></returns>
+bool LoopbackTransport::open()
+{
+    ::LogMessage(LOG_DSP, "Looping Tx samples back to Rx");
+    return true;
+}
+
+/// <summary>
+/// Waits for received samples; returns the number of buffers, valid until release().
+/// </summary>
+/// <param name="buffers"></param>
+/// <returns></returns>
+uint32_t LoopbackTransport::read(TransportBuffer* buffers)
+{
+    timespec ts;
+    ::clock_gettime(CLOCK_MONOTONIC, &ts);
+    ts.tv_nsec += long(TRANSPORT_READ_TIMEOUT) * 1000000L;
+    if (ts.tv_nsec >= 1000000000L) {
+        ts.tv_sec++;
+        ts.tv_nsec -= 1000000000L;
+    }
+
+    ::pthread_mutex_lock(&m_lock);
+    while (m_queue.empty()) {
+        if (::pthread_cond_timedwait(&m_cond, &m_lock, &ts) != 0)
+            break;
+    }
+
+    if (m_queue.empty()) {
+        ::pthread_mutex_unlock(&m_lock);
+        return 0U;
+    }
+
+    Frame frame = m_queue.front();
+    m_queue.pop_front();
+    ::pthread_mutex_unlock(&m_lock);
+
+    // resampler overshoot can dip below zero, which a 12-bit ADC cannot deliver
+    for (uint32_t i = 0U; i < frame.length; i++) {
+        short v = frame.samples[i] / LOOPBACK_ATTENUATION;
+        frame.samples[i] = (v < 0) ? 0 : v;
+    }
+
+    m_current = frame.samples;
+    buffers[0U].data = (const uint8_t*)frame.samples;
+    buffers[0U].length = frame.length * sizeof(short);
+    buffers[0U].lost = 0U;
+    return 1U;
+}
+
+/// <summary>
+/// Releases the buffers returned by the last read.
+/// </summary>
+void LoopbackTransport::release()
+{
+    if (m_current != NULL) {
+        m_pool->release(m_current);
+        m_current = NULL;
+    }
+}
+
+/// <summary>
+/// Writes a Tx frame; the transport returns the frame to its pool once sent.
+/// </summary>
+/// <remarks>The frame itself is queued, it is returned to the pool once the Rx side has
+/// consumed it.</remarks>
+/// <param name="frame"></param>
+/// <param name="length">Length in samples.</param>
+/// <returns>True, if the frame was queued, otherwise false.</returns>
+bool LoopbackTransport::write(short* frame, uint32_t length)
+{
+    Frame f;
+    f.samples = frame;
+    f.length = length;
+
+    ::pthread_mutex_lock(&m_lock);
+    if (m_queue.size() >= LOOPBACK_MAX_FRAMES) {
+        ::pthread_mutex_unlock(&m_lock);
+        m_pool->release(frame);
+        return false;
+    }
+
+    m_queue.push_back(f);
+    m_frames++;
+    ::pthread_cond_signal(&m_cond);
+    ::pthread_mutex_unlock(&m_lock);
+
+    return true;
+}
+
+/// <summary>
+/// Writes the transport statistics to the log and clears them.
+/// </summary>
+void LoopbackTransport::logStats()
+{
+    ::pthread_mutex_lock(&m_lock);
+    uint32_t frames = m_frames;
+    uint32_t queued = uint32_t(m_queue.size());
+    m_frames = 0U;
+    ::pthread_mutex_unlock(&m_lock);
+
+    ::LogMessage(LOG_DSP, "Loopback transport, frames = %u, queued = %u", frames, queued);
+}
+
+/// <summary>
+/// Closes the transport.
+/// </summary>
+void LoopbackTransport::close()
+{
+    ::pthread_mutex_lock(&m_lock);
+    while (!m_queue.empty()) {
+        m_pool->release(m_queue.front().samples);
+        m_queue.pop_front();
+    }
+    ::pthread_mutex_unlock(&m_lock);
+
+    release();
+}
+
+/// <summary>
+/// Helper to check whether an endpoint is the loopback endpoint.
+/// </summary>
+/// <param name="endpoint"></param>
+/// <returns></returns>
+bool LoopbackTransport::isLoopback(const std::string& endpoint)
+{
+    return hasScheme(endpoint, "loopback://");
+}
@@ -0,0 +1,91 @@
+/**
+* Digital Voice Modem - DSP Firmware
+* GPLv2 Open Source. Use is subject to license terms.
+* DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+*
+* @package DVM / DSP Firmware
+*
+*/
+/*
+*   Copyright (C) 2022 Bryan Biedenkapp N2PLL
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 2 of the License, or
+*   (at your option) any later version.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program; if not, write to the Free Software
+*   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*/
+#if !defined(__LOOPBACK_TRANSPORT_H__)
+#define __LOOPBACK_TRANSPORT_H__
+
+#include "Defines.h"
+#include "sdr/transport/ISampleTransport.h"
+#include "sdr/SampleFramePool.h"
+
+#include <pthread.h>
+
+#include <deque>
+
+namespace sdr
+{
+    namespace transport
+    {
+        // ---------------------------------------------------------------------------
+        //  Class Declaration
+        //      Implements a sample transport that loops Tx frames back as Rx
+        //      samples, so the whole DSP can run without an SDR.
+        // ---------------------------------------------------------------------------
+
+        class DSP_FW_API LoopbackTransport : public ISampleTransport {
+        public:
+            /// <summary>Initializes a new instance of the LoopbackTransport class.</summary>
+            LoopbackTransport(SampleFramePool* pool);
+            /// <summary>Finalizes a instance of the LoopbackTransport class.</summary>
+            virtual ~LoopbackTransport();
+
+            /// <summary>Opens the transport.</summary>
+            virtual bool open();
+
+            /// <summary>Waits for received samples; returns the number of buffers, valid until release().</summary>
+            virtual uint32_t read(TransportBuffer* buffers);
+            /// <summary>Releases the buffers returned by the last read.</summary>
+            virtual void release();
+            /// <summary>Writes a Tx frame; the transport returns the frame to its pool once sent.</summary>
+            virtual bool write(short* frame, uint32_t length);
+
+            /// <summary>Writes the transport statistics to the log and clears them.</summary>
+            virtual void logStats();
+
+            /// <summary>Closes the transport.</summary>
+            virtual void close();
+
+            /// <summary>Helper to check whether an endpoint is the loopback endpoint.</summary>
+            static bool isLoopback(const std::string& endpoint);
+
+        private:
+            SampleFramePool* m_pool;
+
+            pthread_mutex_t m_lock;
+            pthread_cond_t m_cond;
+
+            struct Frame {
+                short* samples;
+                uint32_t length;
+            };
+            std::deque<Frame> m_queue;
+            short* m_current;
+
+            uint32_t m_frames;
+        }; // class DSP_FW_API LoopbackTransport : public ISampleTransport
+    } // namespace transport
+} // namespace sdr
+
+#endif // __LOOPBACK_TRANSPORT_H__
@@ -0,0 +1,158 @@
+/**
+* Digital Voice Modem - DSP Firmware
+* GPLv2 Open Source. Use is subject to license terms.
+* DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+*
+* @package DVM / DSP Firmware
+*
+*/
+/*
+*   Copyright (C) 2022 Bryan Biedenkapp N2PLL
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 2 of the License, or
+*   (at your option) any later version.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program; if not, write to the Free Software
+*   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*/
+#include "sdr/transport/ShmTransport.h"
+#include "sdr/Log.h"
+
+using namespace sdr;
+using namespace sdr::transport;
+
+// ---------------------------------------------------------------------------
+//  Public Class Members
+// ---------------------------------------------------------------------------
+
+/// <summary>
+/// Initializes a new instance of the ShmTransport class.
+/// </summary>
+/// <param name="name">Base name of the shared memory objects.</param>
+/// <param name="rxSampleRate">Sample rate of the Rx stream.</param>
+/// <param name="txSampleRate">Sample rate of the Tx stream.</param>
+/// <param name="sampleSize">Size (in bytes) of one Rx sample; only whole samples are handed out.</param>
+/// <param name="pool">Pool Tx frames are returned to.</param>
+ShmTransport::ShmTransport(const std::string& name, uint32_t rxSampleRate, uint32_t txSampleRate, uint32_t sampleSize, SampleFramePool* pool) :
+    m_name(name),
+    m_rxSampleRate(rxSampleRate),
+    m_txSampleRate(txSampleRate),
+    m_sampleSize(sampleSize),
+    m_pool(pool),
+    m_rxRing(),
+    m_txRing(),
+    m_words(0U),
+    m_overruns(0U)
+{
+    /* stub */
+}
+
+/// <summary>
+/// Finalizes a instance of the ShmTransport class.
+/// </summary>
+ShmTransport::~ShmTransport()
+{
+    close();
+}
+
+/// <summary>
+/// Opens the transport.
+/// </summary>
+/// <returns></returns>
+bool ShmTransport::open()
+{
+    return m_rxRing.open(m_name + "-rx", m_rxSampleRate) && m_txRing.open(m_name + "-tx", m_txSampleRate);
+}
+
+/// <summary>
+/// Waits for received samples; returns the number of buffers, valid until release().
+/// </summary>
+/// <param name="buffers"></param>
+/// <returns></returns>
+uint32_t ShmTransport::read(TransportBuffer* buffers)
+{
+    m_words = 0U;
+    if (!m_rxRing.waitData(TRANSPORT_READ_TIMEOUT))
+        return 0U;
+
+    ShmSpan spans[2U];
+    m_rxRing.beginRead(spans);
+
+    // hand out the samples in place, only whole samples are consumed
+    uint32_t count = 0U;
+    for (uint8_t s = 0U; s < 2U; s++) {
+        uint32_t length = spans[s].length * sizeof(uint16_t);
+        length -= length % m_sampleSize;
+        if (length == 0U)
+            break;
+
+        buffers[count].data = (const uint8_t*)spans[s].data;
+        buffers[count].length = length;
+        buffers[count].lost = 0U;
+        count++;
+
+        m_words += length / sizeof(uint16_t);
+    }
+
+    return count;
+}
+
+/// <summary>
+/// Releases the buffers returned by the last read.
+/// </summary>
+void ShmTransport::release()
+{
+    if (m_words > 0U) {
+        m_rxRing.commitRead(m_words);
+        m_words = 0U;
+    }
+}
+
+/// <summary>
+/// Writes a Tx frame; the transport returns the frame to its pool once sent.
+/// </summary>
+/// <param name="frame"></param>
+/// <param name="length">Length in samples.</param>
+/// <returns>True, if the whole frame fit in the ring, otherwise false.</returns>
+bool ShmTransport::write(short* frame, uint32_t length)
+{
+    uint32_t written = m_txRing.write((const uint16_t*)frame, length);
+    m_pool->release(frame);
+
+    if (written < length) {
+        m_overruns++;
+        return false;
+    }
+
+    return true;
+}
+
+/// <summary>
+/// Writes the transport statistics to the log and clears them.
+/// </summary>
+void ShmTransport::logStats()
+{
+    if (!m_rxRing.isOpen() || !m_txRing.isOpen())
+        return;
+
+    ::LogMessage(LOG_DSP, "Shared memory transport, Rx queued = %u, Tx queued = %u, Rx sleeps = %u, Tx overruns = %u",
+        m_rxRing.getData(), m_txRing.getData(), m_rxRing.getSleeps(), m_overruns);
+    m_overruns = 0U;
+}
+
+/// <summary>
+/// Closes the transport.
+/// </summary>
+void ShmTransport::close()
+{
+    m_rxRing.close();
+    m_txRing.close();
+}
@@ -0,0 +1,84 @@
+/**
+* Digital Voice Modem - DSP Firmware
+* GPLv2 Open Source. Use is subject to license terms.
+* DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+*
+* @package DVM / DSP Firmware
+*
+*/
+/*
+*   Copyright (C) 2022 Bryan Biedenkapp N2PLL
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 2 of the License, or
+*   (at your option) any later version.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program; if not, write to the Free Software
+*   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*/
+#if !defined(__SHM_TRANSPORT_H__)
+#define __SHM_TRANSPORT_H__
+
+#include "Defines.h"
+#include "sdr/transport/ISampleTransport.h"
+#include "sdr/SampleFramePool.h"
+#include "sdr/ShmRing.h"
+
+namespace sdr
+{
+    namespace transport
+    {
+        // ---------------------------------------------------------------------------
+        //  Class Declaration
+        //      Implements a sample transport over a pair of POSIX shared memory
+        //      rings, <name>-rx and <name>-tx; received samples are handed out in
+        //      place from the shared memory.
+        // ---------------------------------------------------------------------------
+
+        class DSP_FW_API ShmTransport : public ISampleTransport {
+        public:
+            /// <summary>Initializes a new instance of the ShmTransport class.</summary>
+            ShmTransport(const std::string& name, uint32_t rxSampleRate, uint32_t txSampleRate, uint32_t sampleSize, SampleFramePool* pool);
+            /// <summary>Finalizes a instance of the ShmTransport class.</summary>
+            virtual ~ShmTransport();
+
+            /// <summary>Opens the transport.</summary>
+            virtual bool open();
+
+            /// <summary>Waits for received samples; returns the number of buffers, valid until release().</summary>
+            virtual uint32_t read(TransportBuffer* buffers);
+            /// <summary>Releases the buffers returned by the last read.</summary>
+            virtual void release();
+            /// <summary>Writes a Tx frame; the transport returns the frame to its pool once sent.</summary>
+            virtual bool write(short* frame, uint32_t length);
+
+            /// <summary>Writes the transport statistics to the log and clears them.</summary>
+            virtual void logStats();
+
+            /// <summary>Closes the transport.</summary>
+            virtual void close();
+
+        private:
+            std::string m_name;
+            uint32_t m_rxSampleRate;
+            uint32_t m_txSampleRate;
+            uint32_t m_sampleSize;
+            SampleFramePool* m_pool;
+
+            ShmRing m_rxRing;
+            ShmRing m_txRing;
+
+            uint32_t m_words;
+            uint32_t m_overruns;
+        }; // class DSP_FW_API ShmTransport : public ISampleTransport
+    } // namespace transport
+} // namespace sdr
+
+#endif // __SHM_TRANSPORT_H__
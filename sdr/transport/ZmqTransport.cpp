@@ -0,0 +1,204 @@
+/**
+* Digital Voice Modem - DSP Firmware
+* GPLv2 Open Source. Use is subject to license terms.
+* DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+*
+* @package DVM / DSP Firmware
+*
+*/
+/*
+*   Copyright (C) 2022 Bryan Biedenkapp N2PLL
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation; either version 2 of the License, or
+*   (at your option) any later version.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program; if not, write to the Free Software
+*   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*/
+#include "sdr/transport/ZmqTransport.h"
+#include "sdr/Log.h"
+
+using namespace sdr;
+using namespace sdr::transport;
+
+// ---------------------------------------------------------------------------
+//  Public Class Members
+// ---------------------------------------------------------------------------
+
+/// <summary>
+/// Initializes a new instance of the ZmqTransport class.
+/// </summary>
+/// <param name="rxEndpoint">Endpoint to connect the Rx PULL socket to.</param>
+/// <param name="txEndpoint">Endpoint to bind the Tx PUSH socket to, may be empty.</param>
+/// <param name="pool">Pool Tx frames are returned to.</param>
+ZmqTransport::ZmqTransport(const std::string& rxEndpoint, const std::string& txEndpoint, SampleFramePool* pool) :
+    m_rxEndpoint(rxEndpoint),
+    m_txEndpoint(txEndpoint),
+    m_pool(pool),
+    m_contextTx(),
+    m_socketTx(),
+    m_contextRx(),
+    m_socketRx(),
+    m_msg()
+{
+    /* stub */
+}
+
+/// <summary>
+/// Finalizes a instance of the ZmqTransport class.
+/// </summary>
+ZmqTransport::~ZmqTransport()
+{
+    /* stub */
+}
+
+/// <summary>
+/// Opens the transport.
+/// </summary>
+/// <remarks>A Rx listener that is not up yet is not an error, the socket keeps retrying.</remarks>
+/// <returns></returns>
+bool ZmqTransport::open()
+{
+    m_contextTx = zmq::context_t(1);
+    m_socketTx = zmq::socket_t(m_contextTx, ZMQ_PUSH);
+
+    m_contextRx = zmq::context_t(1);
+    m_socketRx = zmq::socket_t(m_contextRx, ZMQ_PULL);
+
+    // a receive only transport (e.g. the wideband front end) has no Tx endpoint
+    if (!m_txEndpoint.empty()) {
+        try
+        {
+            ::LogMessage(LOG_DSP, "Binding Tx socket to %s", m_txEndpoint.c_str());
+            m_socketTx.bind(m_txEndpoint);
+        }
+        catch(const zmq::error_t& zmqE) { ::LogError(LOG_DSP, "ZmqTransport::open(), Tx Socket: %s", zmqE.what()); }
+        catch(const std::exception& e) { ::LogError(LOG_DSP, "ZmqTransport::open(), Tx Socket: %s", e.what()); }
+    }
+
+    try
+    {
+        ::LogMessage(LOG_DSP, "Connecting Rx socket to %s", m_rxEndpoint.c_str());
+        m_socketRx.connect(m_rxEndpoint);
+        if (m_socketRx.connected()) {
+            ::LogMessage(LOG_DSP, "ZmqTransport::open(), connected to remote ZMQ listener %s", m_rxEndpoint.c_str());
+        } else {
+            ::LogWarning(LOG_DSP, "ZmqTransport::open(), failed to remote ZMQ listener %s, will continue to retry to connect", m_rxEndpoint.c_str());
+        }
+    }
+    catch(const zmq::error_t& zmqE) { ::LogError(LOG_DSP, "ZmqTransport::open(), Rx Socket: %s", zmqE.what()); }
+    catch(const std::exception& e) { ::LogError(LOG_DSP, "ZmqTransport::open(), Rx Socket: %s", e.what()); }
+
+    return true;
+}
+
+/// <summary>
+/// Waits for received samples; returns the number of buffers, valid until release().
+/// </summary>
+/// <param name="buffers"></param>
+/// <returns></returns>
+uint32_t ZmqTransport::read(TransportBuffer* buffers)
+{
+    try
+    {
+        zmq::recv_result_t recv = m_socketRx.recv(m_msg, zmq::recv_flags::none);
+        if (!recv)
+            return 0U;
+    }
+    catch(const zmq::error_t& zmqE)
+    {
+        if (zmqE.num() == ENOTSOCK || zmqE.num() == ENOTCONN ||
+            zmqE.num() == ECONNABORTED || zmqE.num() == ECONNRESET ||
+            zmqE.num() == ENETDOWN || zmqE.num() == ENETUNREACH || zmqE.num() == ENETRESET) {
+            try
+            {
+                m_socketRx.connect(m_rxEndpoint);
+            }
+            catch(const zmq::error_t& zmqE) { /* stub */}
+        } else {
+            ::LogError(LOG_DSP, "ZmqTransport::read(): %s (%u)", zmqE.what(), zmqE.num());
+        }
+
+        return 0U;
+    }
+
+    if (m_msg.size() < 1U)
+        return 0U;
+
+    buffers[0U].data = (const uint8_t*)m_msg.data();
+    buffers[0U].length = uint32_t(m_msg.size());
+    buffers[0U].lost = 0U;
+    return 1U;
+}
+
+/// <summary>
+/// Releases the buffers returned by the last read.
+/// </summary>
+void ZmqTransport::release()
+{
+    /* stub */
+}
+
+/// <summary>
+/// Writes a Tx frame; the transport returns the frame to its pool once sent.
+/// </summary>
+/// <param name="frame"></param>
+/// <param name="length">Length in samples.</param>
+/// <returns>True, if the frame was queued, otherwise false.</returns>
+bool ZmqTransport::write(short* frame, uint32_t length)
+{
+    // hand the frame to ZeroMQ without copying, it is returned to the pool once sent
+    zmq::message_t msg = zmq::message_t(frame, length * sizeof(short), SampleFramePool::freeFrame, m_pool);
+
+    try
+    {
+        zmq::send_result_t sent = m_socketTx.send(msg, zmq::send_flags::dontwait);
+        if (!sent)
+            return false;
+    }
+    // a failed send leaves the frame with the message, which returns it to the pool
+    catch(const zmq::error_t& zmqE) { return false; }
+
+    return true;
+}
+
+/// <summary>
+/// Writes the transport statistics to the log and clears them.
+/// </summary>
+void ZmqTransport::logStats()
+{
+    /* stub */
+}
+
+/// <summary>
+/// Closes the transport.
+/// </summary>
+void ZmqTransport::close()
+{
+    try
+    {
+        m_socketTx.close();
+        m_socketRx.close();
+    }
+    catch(const zmq::error_t& zmqE) { /* stub */ }
+    catch(const std::exception& e) { /* stub */ }
+}
+
+/// <summary>
+/// Helper to check whether an endpoint is a ZeroMQ endpoint.
+/// </summary>
+/// <param name="endpoint"></param>
+/// <returns></returns>
+bool ZmqTransport::isZmq(const std::string& endpoint)
+{
+    return hasScheme(endpoint, "ipc://") || hasScheme(endpoint, "tcp://") || hasScheme(endpoint, "inproc://") ||
+        hasScheme(endpoint, "pgm://") || hasScheme(endpoint, "epgm://");
+}